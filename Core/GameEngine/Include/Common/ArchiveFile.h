@@ -64,6 +64,9 @@ public:
 
 	void									addFile(const AsciiString& path, const ArchivedFileInfo *fileInfo); ///< add this file to our directory tree.
 
+	const ArchivedFileInfo *		friend_getArchivedFileInfo(const AsciiString& filename) const { return getArchivedFileInfo(filename); }
+	const DetailedArchivedDirectoryInfo *	friend_getRootDirectory( void ) const { return &m_rootDirectory; }
+
 protected:
 	const ArchivedFileInfo *		getArchivedFileInfo(const AsciiString& filename) const;	///< return the ArchivedFileInfo from the directory tree.
 
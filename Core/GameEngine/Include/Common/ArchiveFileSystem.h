@@ -50,6 +50,7 @@
 //----------------------------------------------------------------------------
 
 #include "Common/SubsystemInterface.h"
+#include "Common/ArchiveIndexCache.h"
 #include "Common/AsciiString.h"
 #include "Common/FileSystem.h" // for typedefs, etc.
 #include "Common/STLTypedefs.h"
@@ -167,8 +168,11 @@ protected:
 
 	virtual void loadIntoDirectoryTree(ArchiveFile *archiveFile, Bool overwrite = FALSE);	///< load the archive file's header information and apply it to the global archive directory tree.
 
+	void loadIndexCache( void );		///< read the archive index cache from the user data folder
+
 	ArchiveFileMap m_archiveFileMap;
 	ArchivedDirectoryInfo m_rootDirectory;
+	ArchiveIndexCache m_indexCache;	///< directories of the archives that were loaded before
 };
 
 
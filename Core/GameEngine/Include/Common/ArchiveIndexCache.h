@@ -0,0 +1,69 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Common/AsciiString.h"
+#include "Common/STLTypedefs.h"
+
+class ArchiveFile;
+
+// TheSuperHackers @performance Remembers the directory of every archive file on disk, keyed by the
+// archive path, size and time stamp. An unchanged archive is then added to the archive file system
+// from one packed buffer, without opening and parsing its directory again. The cache is read with
+// one read and is only written when an archive was added or changed, or when archives that were not
+// loaded this time have to be dropped from it.
+class ArchiveIndexCache
+{
+public:
+	ArchiveIndexCache();
+
+	void load( const AsciiString& cacheFilename );		///< read the cache file, if there is one
+	void save( void );																///< write the cache file with the archives loaded so far, if it changed
+
+	Bool restoreArchive( const AsciiString& archiveFilename, ArchiveFile *archiveFile );			///< add the cached files of the archive if it did not change
+	void storeArchive( const AsciiString& archiveFilename, const ArchiveFile *archiveFile );	///< remember the files of the archive
+
+private:
+	struct ArchiveStamp
+	{
+		Int sizeHigh;
+		Int sizeLow;
+		Int timestampHigh;
+		Int timestampLow;
+	};
+
+	struct ArchiveIndex
+	{
+		ArchiveIndex() : loaded(FALSE), saved(FALSE) {}
+
+		ArchiveStamp stamp;
+		std::vector<char> entries;			///< packed offset, size, path and file name of each file
+		Bool loaded;										///< the archive was loaded since the cache was read
+		Bool saved;											///< the archive is in the cache file
+	};
+
+	typedef std::map<AsciiString, ArchiveIndex> ArchiveIndexMap;
+
+	static Bool getArchiveStamp( const AsciiString& archiveFilename, ArchiveStamp &stamp );
+
+	ArchiveIndexMap m_archives;
+	AsciiString m_cacheFilename;
+	Bool m_loaded;
+	Bool m_dirty;
+};
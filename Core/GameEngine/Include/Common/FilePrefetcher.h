@@ -0,0 +1,104 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Common/AsciiString.h"
+#include "Common/STLTypedefs.h"
+
+#include "mutex.h"
+
+class FilePrefetchThreadClass;
+
+// TheSuperHackers @performance Reads a known sequence of files ahead of time on worker threads, so
+// the main thread finds the contents in memory when it gets to each file. Only files that live in
+// archives are prefetched, because their bytes are read raw from a known offset and size. Loose
+// files are left to the regular file system, which may translate their line endings. The main thread
+// resolves every file and allocates its buffer; the workers only open the archive and read into it.
+// The workers are started once and serve every directory of the INI load. They sleep while there is
+// nothing to read.
+class FilePrefetcher
+{
+public:
+	FilePrefetcher();		///< starts the workers
+	~FilePrefetcher();	///< stops the workers
+
+	void start( const std::vector<AsciiString>& filenames );	///< begin reading the files, in this order
+	void stop( void );																				///< wait for the workers to put down the files and free everything that was not taken
+	Bool isActive( void ) const { return !m_jobs.empty(); }		///< between start and stop
+
+	Bool takeFile( const AsciiString& filename, char *&data, UnsignedInt &size );	///< wait for the file and hand over its contents, to be freed with delete []
+
+private:
+	friend class FilePrefetchThreadClass;
+
+	struct ArchiveHandle
+	{
+		ArchiveHandle() : file(NULL), path(NULL) {}
+
+		Bool read( const char *archivePath, UnsignedInt offset, UnsignedInt size, char *data );
+		void close( void );
+
+		FILE *file;
+		const char *path;
+	};
+
+	enum
+	{
+		NumWorkerThreads = 2,
+		MaxFilesAhead = 32			///< how many files past the one being taken may be resolved and read
+	};
+
+	enum JobState
+	{
+		JOB_UNRESOLVED,				///< not looked up yet, or not an archived file
+		JOB_PENDING,					///< waiting for a worker
+		JOB_READING,					///< a worker is reading it
+		JOB_DONE,							///< data is ready
+		JOB_FAILED,						///< could not be read, the caller falls back to the file system
+		JOB_TAKEN							///< handed over to the caller
+	};
+
+	struct Job
+	{
+		AsciiString filename;
+		AsciiString archivePath;	///< set before the job becomes pending, then only read
+		UnsignedInt offset;
+		UnsignedInt size;
+		char *data;
+		JobState state;
+	};
+
+	void resolveJobs( Int upTo );
+	Bool waitAndReadJob( ArchiveHandle &archive );
+	void readJob( Int index, ArchiveHandle &archive );
+
+	std::vector<Job> m_jobs;
+	Int m_nextToTake;						///< main thread only
+	Int m_nextToResolve;				///< guarded by m_mutex
+	Int m_nextToRead;						///< guarded by m_mutex
+	Int m_jobsReading;					///< number of jobs the workers are reading, guarded by m_mutex
+	Bool m_quitting;						///< the workers exit, guarded by m_mutex
+	CriticalSectionClass m_mutex;
+	void *m_jobsPending;				///< semaphore, counts the jobs that became pending
+	void *m_jobFinished;				///< event, set when a worker finished reading a job
+	ArchiveHandle m_archive;		///< used when the main thread reads a file itself
+	FilePrefetchThreadClass *m_workerThreads[NumWorkerThreads];
+};
+
+extern FilePrefetcher *TheFilePrefetcher;
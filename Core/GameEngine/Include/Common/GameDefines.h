@@ -50,6 +50,46 @@
 #define RETAIL_COMPATIBLE_AIGROUP (1) // AIGroup logic is expected to be CRC compatible with retail Generals 1.08, Zero Hour 1.04
 #endif
 
+// Schedule sleepy update modules on a timing wheel instead of the binary heap. The wheel calls modules that are due
+// on the same frame and phase in the order they were scheduled, which is not the order the retail heap calls them in.
+#ifndef USE_SLEEPY_UPDATE_WHEEL
+#if RETAIL_COMPATIBLE_CRC
+#define USE_SLEEPY_UPDATE_WHEEL (0)
+#else
+#define USE_SLEEPY_UPDATE_WHEEL (1)
+#endif
+#endif
+
+// Let the members of a large group that is ordered to move share one flow field towards the goal, instead of
+// each running its own A* search. The paths read off a flow field are not the paths the retail game finds.
+#ifndef USE_GROUP_FLOW_FIELDS
+#if RETAIL_COMPATIBLE_CRC
+#define USE_GROUP_FLOW_FIELDS (0)
+#else
+#define USE_GROUP_FLOW_FIELDS (1)
+#endif
+#endif
+
+// Keep the zone block routes found by the hierarchical pathfinder, and reuse them for later searches between the
+// same zones of the same two zone blocks. A reused route can differ from the one a new search would find.
+#ifndef USE_HIERARCHICAL_ROUTE_CACHE
+#if RETAIL_COMPATIBLE_CRC
+#define USE_HIERARCHICAL_ROUTE_CACHE (0)
+#else
+#define USE_HIERARCHICAL_ROUTE_CACHE (1)
+#endif
+#endif
+
+// Update the pathfinding zones of the zone blocks under a structure that is placed or removed, instead of
+// recalculating the zones of the whole map a while later. The zones then change on another frame than in retail.
+#ifndef USE_INCREMENTAL_PATHFIND_ZONES
+#if RETAIL_COMPATIBLE_CRC
+#define USE_INCREMENTAL_PATHFIND_ZONES (0)
+#else
+#define USE_INCREMENTAL_PATHFIND_ZONES (1)
+#endif
+#endif
+
 #ifndef ENABLE_GAMETEXT_SUBSTITUTES
 #define ENABLE_GAMETEXT_SUBSTITUTES (1) // The code can provide substitute texts when labels and strings are missing in the STR or CSF translation file
 #endif
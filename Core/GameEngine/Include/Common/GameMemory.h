@@ -59,6 +59,13 @@
 	#define MEMORYPOOL_DEBUG
 #endif
 
+// TheSuperHackers @performance Keep small per thread caches of free blocks in front of every pool,
+// so that most allocations and frees do not take TheMemoryPoolCriticalSection. The debug pool
+// features track every block individually, so the caches are off when those are compiled in.
+#if !defined(MEMORYPOOL_DEBUG) && !defined(DISABLE_MEMORYPOOL_THREAD_CACHE)
+	#define MEMORYPOOL_THREAD_CACHE
+#endif
+
 // SYSTEM INCLUDES ////////////////////////////////////////////////////////////
 
 #include <new.h>
@@ -243,7 +250,10 @@ struct PoolInitRec
 
 enum
 {
-	MAX_DYNAMICMEMORYALLOCATOR_SUBPOOLS = 8	///< The max number of subpools allowed in a DynamicMemoryAllocator
+	MAX_DYNAMICMEMORYALLOCATOR_SUBPOOLS = 8,	///< The max number of subpools allowed in a DynamicMemoryAllocator
+	MEMORYPOOL_THREAD_CACHE_SLOTS = 4,				///< The max number of threads that get their own block caches; later threads always lock
+	MEMORYPOOL_THREAD_CACHE_SIZE = 32,				///< The max number of free blocks a thread keeps per pool
+	MEMORYPOOL_THREAD_CACHE_BATCH = 16				///< The number of blocks moved between a thread cache and the blobs at once
 };
 
 #ifdef MEMORYPOOL_CHECKPOINTING
@@ -306,6 +316,14 @@ private:
 	MemoryPoolBlob		*m_firstBlob;								///< head of linked list: first blob for this pool.
 	MemoryPoolBlob		*m_lastBlob;								///< tail of linked list: last blob for this pool. (needed for efficiency)
 	MemoryPoolBlob		*m_firstBlobWithFreeBlocks;	///< first blob in this pool that has at least one unallocated block.
+#ifdef MEMORYPOOL_THREAD_CACHE
+	struct ThreadCache
+	{
+		MemoryPoolSingleBlock	*m_firstBlock;				///< blocks that are taken from the blobs but not in use, linked through their free block link
+		Int										m_blockCount;					///< number of blocks in the list
+	};
+	ThreadCache				m_threadCaches[MEMORYPOOL_THREAD_CACHE_SLOTS];	///< each slot is only ever touched by the thread that owns it
+#endif
 
 private:
 	/// create a new blob with the given number of blocks.
@@ -314,12 +332,26 @@ private:
 	/// destroy a blob.
 	Int freeBlob(MemoryPoolBlob *blob);
 
+#ifdef MEMORYPOOL_THREAD_CACHE
+	/// return the block cache of the calling thread, or null if it has none.
+	ThreadCache *getThreadCache();
+	/// move free blocks from the blobs into the cache, without growing the pool. must hold the lock.
+	void fillThreadCache(ThreadCache *cache);
+	/// move blocks from the cache back to the blobs until 'keep' are left. must hold the lock.
+	void drainThreadCache(ThreadCache *cache, Int keep);
+	/// return the number of blocks sitting in all thread caches of this pool.
+	Int getThreadCachedBlockCount();
+#endif
+
 public:
 
 	// 'public' funcs that are really only for use by MemoryPoolFactory
 	MemoryPool *getNextPoolInList();					///< return next pool in linked list
 	void addToList(MemoryPool **pHead);				///< add this pool to head of the linked list
 	void removeFromList(MemoryPool **pHead);	///< remove this pool from the linked list
+	#ifdef MEMORYPOOL_THREAD_CACHE
+		void releaseThreadCache(Int slot);				///< hand all blocks in the given thread cache slot back to the blobs. must hold the lock.
+	#endif
 	#ifdef MEMORYPOOL_DEBUG
 		static void debugPoolInfoReport( MemoryPool *pool, FILE *fp = NULL );	///< dump a report about this pool to the logfile
 		const char *debugGetBlockTagString(void *pBlock);		///< return the tagstring for the given block (assumed to belong to this pool)
@@ -533,6 +565,9 @@ public:
 	/// return the pool with the given name. if no such pool exists, return null.
 	MemoryPool *findMemoryPool(const char *poolName);
 
+	/// return the first pool in the factory. use MemoryPool::getNextPoolInList() to iterate all pools.
+	MemoryPool *getFirstMemoryPool() { return m_firstPoolInFactory; }
+
 	/// destroy the given pool.
 	void destroyMemoryPool(MemoryPool *pMemoryPool);
 
@@ -777,7 +812,11 @@ inline MemoryPool *MemoryPool::getNextPoolInList() { return m_nextPoolInFactory;
 inline const char *MemoryPool::getPoolName() { return m_poolName; }
 inline Int MemoryPool::getAllocationSize() { return m_allocationSize; }
 inline Int MemoryPool::getFreeBlockCount() { return getTotalBlockCount() - getUsedBlockCount(); }
+#ifdef MEMORYPOOL_THREAD_CACHE
+inline Int MemoryPool::getUsedBlockCount() { return m_usedBlocksInPool - getThreadCachedBlockCount(); }
+#else
 inline Int MemoryPool::getUsedBlockCount() { return m_usedBlocksInPool; }
+#endif
 inline Int MemoryPool::getTotalBlockCount() { return m_totalBlocksInPool; }
 inline Int MemoryPool::getPeakBlockCount() { return m_peakUsedBlocksInPool; }
 inline Int MemoryPool::getInitialBlockCount() { return m_initialAllocationCount; }
@@ -817,6 +856,23 @@ extern Bool isMemoryManagerOfficiallyInited();
 */
 extern void shutdownMemoryManager();
 
+/**
+	TheSuperHackers @performance Hand the blocks that the calling thread keeps cached in the memory
+	pools back to the pools, and free the thread's cache slot for another thread. Threads other than
+	the main thread call this before they exit, see ScopedThreadMemoryPoolCaches.
+*/
+extern void releaseThreadMemoryPoolCaches();
+
+/**
+	Calls releaseThreadMemoryPoolCaches() when it goes out of scope. Put one at the top of
+	the function of a thread that may allocate from the memory pools.
+*/
+class ScopedThreadMemoryPoolCaches
+{
+public:
+	~ScopedThreadMemoryPoolCaches() { releaseThreadMemoryPoolCaches(); }
+};
+
 extern MemoryPoolFactory *TheMemoryPoolFactory;
 extern DynamicMemoryAllocator *TheDynamicMemoryAllocator;
 
@@ -0,0 +1,76 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Common/AsciiString.h"
+#include "Common/STLTypedefs.h"
+
+class Object;
+class Path;
+class Pathfinder;
+
+// TheSuperHackers @feature Loads a map without graphics and times a workload of pathfinding requests
+// on it, so that changes to the pathfinder can be measured without playing a game. The workload is
+// generated from a seed, or read from a file that an earlier run wrote. Prints the cells examined,
+// the paths per second, the median and 99th percentile latency and a hash of the resulting paths
+// per request kind. The hash changes whenever the pathfinder finds different paths.
+class PathfindBenchmark
+{
+public:
+
+	// Returns exit code 1 if the map or the workload could not be loaded
+	// Returns exit code 0 if the workload was run
+	static int run(const AsciiString &mapName);
+
+private:
+
+	enum RequestKind
+	{
+		REQUEST_PATH,					///< findPath
+		REQUEST_CLOSEST_PATH,	///< findClosestPath
+		REQUEST_ATTACK_PATH,	///< findAttackPath against a victim at the goal
+		REQUEST_PATCH_PATH,		///< patchPath from a position next to a path found with findPath
+
+		REQUEST_KIND_COUNT
+	};
+
+	struct Request
+	{
+		RequestKind kind;
+		ICoord2D from;
+		ICoord2D to;
+		ICoord2D patchFrom;		///< where the mover stands when it patches its path, for REQUEST_PATCH_PATH
+	};
+
+	struct Result
+	{
+		std::vector<Int64> ticks;
+		Int64 cells;
+		Int pathsFound;
+		UnsignedInt hash;
+	};
+
+	static Bool startMap(const AsciiString &mapName);
+	static Bool generateRequests(std::vector<Request> &requests, Int count, UnsignedInt seed);
+	static Bool readRequests(const AsciiString &path, std::vector<Request> &requests);
+	static Bool writeRequests(const AsciiString &path, const std::vector<Request> &requests);
+	static void runRequest(Pathfinder *pathfinder, Object *mover, Object *victim, const Request &request, Result &result);
+	static void hashPath(Path *path, Result &result);
+	static void printResult(const char *name, Result &result);
+};
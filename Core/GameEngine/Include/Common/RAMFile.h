@@ -75,6 +75,7 @@ class RAMFile : public File
 		Char				*m_data;											///< File data in memory
 		Int					m_pos;												///< current read position
 		Int					m_size;												///< size of file in memory
+		Bool				m_ownsData;										///< m_data is deleted on close, FALSE for views of memory owned by someone else
 
 	public:
 
@@ -102,6 +103,7 @@ class RAMFile : public File
 
 		virtual Bool	open( File *file );																	///< Open file for fast RAM access
 		virtual Bool	openFromArchive(File *archiveFile, const AsciiString& filename, Int offset, Int size); ///< copy file data from the given file at the given offset for the given size.
+		virtual Bool	openFromMemory(const AsciiString& filename, const Char *data, Int size); ///< view the given memory without copying it. The memory must outlive the file.
 		virtual Bool	copyDataToFile(File *localFile);										///< write the contents of the RAM file to the given local file.  This could be REALLY slow.
 
 		/**
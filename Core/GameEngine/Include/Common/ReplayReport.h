@@ -0,0 +1,86 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+enum ReplayReportSection CPP_11(: Int)
+{
+	REPLAYREPORT_SCRIPT_ENGINE,
+	REPLAYREPORT_TERRAIN_LOGIC,
+	REPLAYREPORT_CRC,
+	REPLAYREPORT_COMMAND_LIST,
+	REPLAYREPORT_SLEEPY_UPDATES,
+	REPLAYREPORT_AI,
+	REPLAYREPORT_PARTITION_MANAGER,
+	REPLAYREPORT_DESTROY_LIST,
+
+	REPLAYREPORT_SECTION_COUNT
+};
+
+// TheSuperHackers @feature Collects performance numbers of the headless replay simulation and
+// writes them to a JSON file, so that simulation throughput can be tracked across builds.
+// Each replay is written as a single line inside the "replays" array, which allows the worker
+// process driver to merge the reports of its workers without a JSON parser.
+class ReplayReport
+{
+public:
+
+	static void setEnabled(Bool enabled) { s_enabled = enabled; }
+	static Bool isEnabled() { return s_enabled; }
+
+	static Int64 getTicks();
+	static Int64 getTicksPerSecond();
+
+	static void addSectionTicks(ReplayReportSection section, Int64 ticks) { s_sectionTicks[section] += ticks; }
+
+	static void beginReplay();
+	static void addFrame(Int64 frameTicks);
+	static void addObjectCount(UnsignedInt objectCount);
+
+	// Returns the single line JSON object that describes the current replay.
+	static AsciiString endReplay(const AsciiString &filename, const char *result);
+
+	static Bool writeFile(const AsciiString &path, const std::vector<AsciiString> &replayEntries, UnsignedInt totalWallTimeMillis);
+	static Bool readReplayEntries(const AsciiString &path, std::vector<AsciiString> &replayEntries);
+
+	class ScopedSection
+	{
+	public:
+		ScopedSection(ReplayReportSection section) : m_section(section), m_startTicks(s_enabled ? getTicks() : 0) {}
+		~ScopedSection() { if (s_enabled) addSectionTicks(m_section, getTicks() - m_startTicks); }
+
+	private:
+		ReplayReportSection m_section;
+		Int64 m_startTicks;
+	};
+
+private:
+
+	enum { FRAME_HISTOGRAM_BUCKETS = 10 };
+
+	static Bool s_enabled;
+	static Int64 s_sectionTicks[REPLAYREPORT_SECTION_COUNT];
+	static UnsignedInt s_frameHistogram[FRAME_HISTOGRAM_BUCKETS];
+	static UnsignedInt s_frameCount;
+	static Int64 s_frameTicks;
+	static Int64 s_maxFrameTicks;
+	static Int64 s_startTicks;
+	static UnsignedInt s_peakObjectCount;
+};
+
+#define REPLAY_REPORT_SECTION(section) ReplayReport::ScopedSection replayReportSection(section);
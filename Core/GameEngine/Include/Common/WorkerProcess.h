@@ -18,16 +18,30 @@
 
 #pragma once
 
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
 // Helper class that allows you to start a worker process and retrieve its exit code
 // and console output as a string.
 // It also makes sure that the started process is killed in case our process exits in any way.
 class WorkerProcess
 {
 public:
+	// Function that is run in a forked worker. The return value becomes the exit code of the worker.
+	typedef int (*ForkedFunction)(void *userData);
+
 	WorkerProcess();
 
 	bool startProcess(UnicodeString command);
 
+	// TheSuperHackers @feature Fork a copy-on-write clone of this process that runs func and exits.
+	// The clone shares all memory that was loaded before the fork, so it does not need to
+	// initialize the engine again. Not supported on Windows.
+	bool startForkedProcess(ForkedFunction func, void *userData);
+
+	static bool canForkProcess();
+
 	void update();
 
 	bool isRunning() const;
@@ -47,9 +61,14 @@ private:
 	bool fetchStdOutput();
 
 private:
+#ifdef _WIN32
 	HANDLE m_processHandle;
 	HANDLE m_readHandle;
 	HANDLE m_jobHandle;
+#else
+	pid_t m_processId;
+	int m_readHandle;
+#endif
 	AsciiString m_stdOutput;
 	DWORD m_exitcode;
 	bool m_isDone;
@@ -57,6 +57,10 @@ public:
 	// Xfer CRC methods
 	virtual UnsignedInt getCRC( void );										///< get computed CRC in network byte order
 
+	// TheSuperHackers @feature Groups the following data into a node of a hierarchical CRC, see XferCRCTree
+	virtual void beginNode( const char *label, UnsignedInt id ) { }
+	virtual void endNode( void ) { }
+
 protected:
 
 	virtual void xferImplementation( void *data, Int dataSize );
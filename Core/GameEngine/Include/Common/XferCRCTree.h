@@ -0,0 +1,92 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: XferCRCTree.h ////////////////////////////////////////////////////////////////////////////
+// Desc:   Xfer CRC implementation that additionally records a tree of sub CRCs
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include "Common/XferCRC.h"
+
+// FORWARD REFERENCES /////////////////////////////////////////////////////////////////////////////
+class Snapshot;
+
+// The binary CRC tree file starts with CRCTREE_FILE_MAGIC and CRCTREE_FILE_VERSION, followed by
+// a sequence of records. A label record ('L') appends a name to the label table, a frame record ('F')
+// holds the frame number, the regular CRC, the node count and the nodes in pre-order.
+// All values are little endian. Core/Tools/CRCDiff reads this format.
+#define CRCTREE_FILE_MAGIC		0x54435243	// "CRCT"
+#define CRCTREE_FILE_VERSION	1
+
+//-------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature Computes the exact same CRC as XferCRC, but also records every
+	* marker, object and nested snapshot as a node with its own CRC. Comparing the trees of two runs
+	* only needs to descend into nodes whose CRC differs, which localizes a mismatch to the first
+	* diverging object and snapshot. */
+//-------------------------------------------------------------------------------------------------
+class XferCRCTree : public XferCRC
+{
+
+public:
+
+	struct Node
+	{
+		UnsignedShort label;				///< index into the label table
+		UnsignedShort depth;				///< depth in the tree, the root is at zero
+		UnsignedInt id;							///< object ID, or ordinal among its siblings
+		UnsignedInt crc;						///< CRC of the data of this node and the CRCs of its children
+		UnsignedInt subtreeSize;		///< number of nodes in this subtree, including this node
+	};
+
+	XferCRCTree( void );
+	virtual ~XferCRCTree( void );
+
+	// Xfer methods
+	virtual void open( AsciiString identifier );		///< start a CRC session with this xfer instance
+	virtual void close( void );											///< stop CRC session
+
+	virtual void xferSnapshot( Snapshot *snapshot );		///< entry point for xfering a snapshot
+	virtual void xferAsciiString( AsciiString *asciiStringData );  ///< starts a new top level node for markers
+
+	// Xfer CRC methods
+	virtual void beginNode( const char *label, UnsignedInt id );
+	virtual void endNode( void );
+
+	const std::vector<Node> &getNodes( void ) const { return m_nodes; }
+	Bool writeFrame( FILE *fp, UnsignedInt frame );		///< append the recorded tree to the file
+
+protected:
+
+	virtual void xferImplementation( void *data, Int dataSize );
+
+	typedef std::map<AsciiString, UnsignedShort> LabelMap;
+
+	UnsignedShort findLabel( const char *label );
+
+	std::vector<Node> m_nodes;												///< recorded nodes in pre-order
+	std::vector<Int> m_openNodes;											///< indices of the nodes that are not ended yet
+	std::vector<UnsignedInt> m_openCRCs;							///< running CRCs of the open nodes
+	std::vector<UnsignedInt> m_openChildCounts;				///< number of children of the open nodes so far
+	std::vector<AsciiString> m_labels;								///< label table, shared by all frames
+	LabelMap m_labelIndices;													///< label name to index into m_labels
+	size_t m_labelsWritten;														///< number of labels already in the file
+	Bool m_inMarker;																	///< a marker node is open below the root
+	Bool m_fileHeaderWritten;
+};
@@ -61,3 +61,28 @@ protected:
 
 	FILE * m_fileFP;																			///< pointer to file
 };
+
+//-------------------------------------------------------------------------------------------------
+// TheSuperHackers @feature Collects the deep CRC data in a memory buffer instead of a file.
+//-------------------------------------------------------------------------------------------------
+class XferDeepCRCMemory : public XferDeepCRC
+{
+
+public:
+
+	XferDeepCRCMemory( void );
+	virtual ~XferDeepCRCMemory( void );
+
+	// Xfer methods
+	virtual void open( AsciiString identifier );		///< start a CRC session with this xfer instance
+	virtual void close( void );											///< stop CRC session
+
+	const std::vector<UnsignedByte> &getData( void ) const { return m_data; }
+	void swapData( std::vector<UnsignedByte> &data ) { m_data.swap( data ); }	///< take the collected data without copying
+
+protected:
+
+	virtual void xferImplementation( void *data, Int dataSize );
+
+	std::vector<UnsignedByte> m_data;											///< collected data
+};
@@ -76,12 +76,17 @@ public:
 	void setQuitting( void );
 	Bool isQuitting( void ) { return m_isQuitting; }
 
+	// TheSuperHackers @performance The other end sent a packet in the compact format, so it can read them too.
+	void enableCompactFormat( void ) { m_compactFormat = TRUE; }
+	Bool usesCompactFormat( void ) { return m_compactFormat; }
+
 #if defined(RTS_DEBUG)
 	void debugPrintCommands();
 #endif
 
 protected:
 	void doRetryMetrics();
+	void announceCompactFormat( time_t curtime );
 
 	Bool m_isQuitting;
 	UnsignedInt m_quitTime;
@@ -98,4 +103,8 @@ protected:
 	time_t m_lastTimeSent;				///< The time of the last packet send.
 	Int m_numRetries;							///< The number of retries for the last second.
 	time_t m_retryMetricsTime;		///< The start time of the current retry metrics thing.
+
+	Bool m_compactFormat;					///< Send the packets in the compact format.
+	Int m_numFormatAnnouncements;	///< The number of packets sent so far to tell the other end that we read the compact format.
+	time_t m_lastFormatAnnouncement;
 };
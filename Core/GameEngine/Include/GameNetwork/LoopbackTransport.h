@@ -0,0 +1,134 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// LoopbackTransport.h ////////////////////////////////////////////////////////
+// A simulated network in memory for the transport layer.
+
+#pragma once
+
+#include "GameNetwork/udp.h"
+
+#include <map>
+#include <vector>
+
+class LoopbackSocket;
+
+// TheSuperHackers @feature A network in memory that the Transports of several game instances in one
+// process can talk over, so that run-ahead, frame grouping and resends can be measured under the same
+// conditions every time, without a real network. Each Transport gets a LoopbackSocket on the network
+// through Transport::init() and is then attached to its ConnectionManager as usual. Packets take the
+// configured latency plus a random jitter to arrive, may be lost, and leave each socket no faster than
+// the bandwidth allows. It is not thread safe, all the instances must be updated from one thread.
+class LoopbackNetwork
+{
+public:
+
+	struct Settings
+	{
+		Settings();
+
+		UnsignedInt latency;				///< milliseconds a packet is on its way
+		UnsignedInt jitter;					///< up to this many milliseconds more, picked at random for each packet
+		Real packetLoss;						///< percentage of the packets that get lost on the way
+		UnsignedInt bandwidth;			///< bytes per second each socket can send, 0 for no limit
+		UnsignedInt maxQueueDelay;	///< milliseconds a packet may wait for the bandwidth before it is dropped, 0 for no limit
+		UnsignedInt seed;						///< of the jitter and the packet loss
+	};
+
+	struct Statistics
+	{
+		UnsignedInt sentPackets;
+		UnsignedInt sentBytes;
+		UnsignedInt deliveredPackets;			///< read by the socket they were sent to
+		UnsignedInt lostPackets;					///< to the packet loss
+		UnsignedInt droppedPackets;				///< waited too long for the bandwidth
+		UnsignedInt unreachablePackets;		///< sent to an address that no socket is bound to
+	};
+
+	LoopbackNetwork();
+	~LoopbackNetwork();
+
+	void setSettings( const Settings &settings );
+	const Settings &getSettings( void ) const { return m_settings; }
+
+	const Statistics &getStatistics( void ) const { return m_statistics; }
+	void resetStatistics( void );
+
+	/// The network runs on timeGetTime() until it is given a clock of its own, which then only moves
+	/// with advanceClock(), so that a test does not depend on how fast the machine is.
+	void useManualClock( UnsignedInt now );
+	void advanceClock( UnsignedInt milliseconds );
+	UnsignedInt getTime( void ) const;
+
+private:
+
+	friend class LoopbackSocket;
+
+	struct Packet
+	{
+		UnsignedInt fromIP;
+		UnsignedShort fromPort;
+		std::vector<UnsignedByte> data;
+	};
+
+	Int bind( LoopbackSocket *socket, UnsignedInt ip, UnsignedShort port );
+	void unbind( LoopbackSocket *socket );
+	void send( LoopbackSocket *from, const UnsignedByte *buf, Int len, UnsignedInt ip, UnsignedShort port );
+	void deliver( LoopbackSocket *to, const Packet &packet, UnsignedInt deliveryTime );
+	LoopbackSocket *findSocket( UnsignedInt ip, UnsignedShort port ) const;
+	UnsignedInt nextRandom( void );
+
+	Settings m_settings;
+	Statistics m_statistics;
+	std::vector<LoopbackSocket *> m_sockets;	///< the bound ones
+	UnsignedInt m_randomState;
+	Bool m_manualClock;
+	UnsignedInt m_now;												///< of the manual clock
+	UnsignedShort m_nextEphemeralPort;
+};
+
+// TheSuperHackers @feature A socket on a LoopbackNetwork, for Transport::init(). The network must
+// outlive its sockets or the sockets stop sending and receiving.
+class LoopbackSocket : public TransportSocket
+{
+public:
+
+	LoopbackSocket( LoopbackNetwork *network );
+	virtual ~LoopbackSocket();
+
+	virtual Int Bind( UnsignedInt IP, UnsignedShort port );
+	virtual Int Write( const unsigned char *msg, UnsignedInt len, UnsignedInt IP, UnsignedShort port );
+	virtual Int Read( unsigned char *msg, UnsignedInt len, sockaddr_in *from );
+	virtual sockStat GetStatus( void ) { return m_status; }
+	virtual Int AllowBroadcasts( Bool status ) { m_allowBroadcasts = status; return TRUE; }
+
+private:
+
+	friend class LoopbackNetwork;
+
+	typedef std::multimap<UnsignedInt, LoopbackNetwork::Packet> PacketQueue;
+
+	LoopbackNetwork *m_network;
+	Bool m_bound;
+	UnsignedInt m_ip;
+	UnsignedShort m_port;
+	Bool m_allowBroadcasts;
+	sockStat m_status;
+	UnsignedInt64 m_sendFreeTime;		///< in microseconds, when the packets sent so far will have left
+	PacketQueue m_incoming;					///< by the time they arrive
+};
@@ -77,6 +77,7 @@ public:
 	//virtual ~NetGameCommandMsg();
 
 	GameMessage *constructGameMessage();
+	GameMessage *constructGameMessageArguments();
 	void addArgument(const GameMessageArgumentDataType type, GameMessageArgumentType arg);
 	void setGameMessageType(GameMessage::Type type);
 
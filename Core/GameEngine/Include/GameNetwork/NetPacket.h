@@ -69,6 +69,16 @@ public:
 	UnsignedInt getAddr();
 	UnsignedShort getPort();
 
+	// TheSuperHackers @performance A packet in the compact format starts with a byte that tells whether
+	// the rest of it is compressed. Its game commands carry their frame as the difference to the frame
+	// before, their integers and IDs as variable length integers, and each object ID as the difference
+	// to the object ID before it in the packet, so that the long lists of a large selection take a byte
+	// or two per object. The other commands are written as before. It goes out with the compact magic
+	// number, and only to clients that sent such a packet themselves.
+	void setCompact( Bool compact );	///< call on an empty packet
+	Bool isCompact() { return m_compact; }
+	void compress();									///< call once all the commands are in, compresses the packet if that makes it smaller
+
 protected:
 	static UnsignedInt GetBufferSizeNeededForCommand(NetCommandMsg *msg);
 	static void FillBufferWithCommand(UnsignedByte *buffer, NetCommandRef *msg);
@@ -135,6 +145,7 @@ protected:
 	Bool isRoomForAckMessage(NetCommandRef *msg);
 	Bool addGameCommand(NetCommandRef *msg);
 	Bool isRoomForGameMessage(NetCommandRef *msg, GameMessage *gmsg);
+	Bool addCompactGameCommand(NetCommandRef *msg);
 	Bool addPlayerLeaveCommand(NetCommandRef *msg);
 	Bool isRoomForPlayerLeaveMessage(NetCommandRef *msg);
 	Bool addRunAheadMetricsCommand(NetCommandRef *msg);
@@ -187,6 +198,7 @@ protected:
 	Bool isFrameRepeat(NetCommandRef *msg);
 
 	static NetCommandMsg * readGameMessage(UnsignedByte *data, Int &i);
+	static NetCommandMsg * readCompactGameMessage(UnsignedByte *data, Int &i, Int length, ObjectID &lastObjectID);
 	static NetCommandMsg * readAckBothMessage(UnsignedByte *data, Int &i);
 	static NetCommandMsg * readAckStage1Message(UnsignedByte *data, Int &i);
 	static NetCommandMsg * readAckStage2Message(UnsignedByte *data, Int &i);
@@ -231,4 +243,6 @@ protected:
 	UnsignedByte		m_lastPlayerID;
 	UnsignedByte		m_lastCommandType;
 	UnsignedByte		m_lastRelay;
+	Bool						m_compact;
+	ObjectID				m_lastObjectID;		///< of the game commands in a compact packet
 };
@@ -172,6 +172,10 @@ enum PlayerLeaveCode CPP_11(: Int) {
 // Magic number for identifying a Generals packet.
 static const UnsignedShort GENERALS_MAGIC_NUMBER = 0xF00D;
 
+// TheSuperHackers @feature Magic number of the packets in the compact command format. Clients that
+// do not know the format drop these as foreign packets instead of misreading them. See NetPacket.h.
+static const UnsignedShort GENERALS_COMPACT_MAGIC_NUMBER = 0xF00E;
+
 // The number of fps history entries.
 //static const Int NETWORK_FPS_HISTORY_LENGTH = 30;
 
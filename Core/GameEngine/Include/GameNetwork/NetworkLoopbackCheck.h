@@ -0,0 +1,67 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// NetworkLoopbackCheck.h /////////////////////////////////////////////////////
+// Sends game commands between two Transports over a LoopbackNetwork.
+
+#pragma once
+
+#include "Common/MessageStream.h"
+
+#include <vector>
+
+class LoopbackNetwork;
+class NetCommandRef;
+class NetPacket;
+class Transport;
+
+// TheSuperHackers @feature Sends game commands from one Transport to another over a LoopbackNetwork,
+// with latency and jitter, and checks that the commands read from the packets that arrive are the ones
+// that were sent, in the legacy and in the compact packet format. The commands are a large selection,
+// a move with waypoints and arguments of every type with negative and extreme values. Nothing executes
+// them, so they do not have to make sense to the logic. Also checks that compact packets which are cut
+// off or have arguments of an unknown type are dropped rather than read past their end.
+class NetworkLoopbackCheck
+{
+public:
+
+	// Returns exit code 1 if a command got lost or changed on the way
+	// Returns exit code 0 if all commands arrived unchanged
+	static int run();
+
+private:
+
+	struct Command
+	{
+		GameMessage *message;
+		UnsignedInt frame;
+	};
+
+	typedef std::vector<Command> Commands;
+
+	static void makeCommands(Commands &commands);
+	static void freeCommands(Commands &commands);
+	static Bool checkRoundTrip(const char *name, LoopbackNetwork &network, Transport *from, Transport *to, const Commands &commands, Bool compact);
+	static Bool checkMalformedPackets(const Commands &commands);
+	static Bool checkPacket(const char *name, NetPacket *packet, const Commands &commands, std::vector<Bool> &received);
+	static Bool checkDropped(const char *name, const UnsignedByte *data, Int length);
+	static NetCommandRef *newCommandRef(const Commands &commands, size_t index);
+	static void sendPacket(Transport *from, NetPacket *packet, Int &numPackets, Int &numBytes);
+	static Bool isSameMessage(GameMessage *sent, GameMessage *received);
+	static Bool isSameArgument(GameMessageArgumentDataType type, const GameMessageArgumentType *sent, const GameMessageArgumentType *received);
+};
@@ -47,6 +47,7 @@ public:
 
 	Bool init( AsciiString ip, UnsignedShort port );
 	Bool init( UnsignedInt ip, UnsignedShort port );
+	Bool init( TransportSocket *socket, UnsignedInt ip, UnsignedShort port );	///< Binds the given socket instead of a UDP socket, and deletes it on reset()
 	void reset( void );
 	Bool update( void );									///< Call this once a GameEngine tick, regardless of whether the frame advances.
 
@@ -54,9 +55,9 @@ public:
 	Bool doSend( void );		///< call this to service the send queue.
 
 	Bool queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedByte *buf, Int len /*,
-		NetMessageFlags flags, Int id */);				///< Queue a packet for sending to the specified address and port.  This will be sent on the next update() call.
+		NetMessageFlags flags, Int id */, UnsignedShort magic = GENERALS_MAGIC_NUMBER);				///< Queue a packet for sending to the specified address and port.  This will be sent on the next update() call.
 
-	inline Bool allowBroadcasts(Bool val) { if (!m_udpsock) return false; return (m_udpsock->AllowBroadcasts(val))?true:false; }
+	inline Bool allowBroadcasts(Bool val) { if (!m_socket) return false; return (m_socket->AllowBroadcasts(val))?true:false; }
 
 	// Latency insertion and packet loss
 	void setLatency( Bool val ) { m_useLatency = val; }
@@ -79,8 +80,20 @@ public:
 
 	UnsignedShort m_port;
 private:
+	enum { BATCH_SIZE = 32 };	///< packets handed to the socket at once
+
 	Bool m_winsockInit;
-	UDP *m_udpsock;
+	TransportSocket *m_socket;
+
+	// TheSuperHackers @performance The free slots of m_outBuffer and the ones waiting to be sent, in
+	// the order they were queued, so that neither queueSend() nor doSend() has to look at every slot.
+	Int m_outFree[MAX_MESSAGES];
+	Int m_numOutFree;
+	Int m_outQueue[MAX_MESSAGES];	///< a ring, starting at m_outQueueHead
+	Int m_outQueueHead;
+	Int m_numOutQueued;
+
+	TransportMessage m_recvBatch[BATCH_SIZE];	///< what doRecv() read from the socket, before it goes into m_inBuffer
 
 	// Latency insertion and packet loss
 	Bool m_useLatency;
@@ -97,4 +110,5 @@ private:
 	UnsignedInt m_lastSecond;
 
 	Bool isGeneralsPacket( TransportMessage *msg );
+	void clearOutQueue( void );
 };
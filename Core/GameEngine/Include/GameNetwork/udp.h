@@ -58,15 +58,10 @@
 //#include "wlib/wstypes.h"
 //#include "wlib/wtime.h"
 
-class UDP
+// TheSuperHackers @feature The datagram socket the Transport sends and receives its packets through,
+// so that something other than a real UDP socket can stand in for it. See LoopbackTransport.h.
+class TransportSocket
 {
- // DATA
- private:
-  Int       fd;
-  UnsignedInt       myIP;
-  UnsignedShort       myPort;
-  struct       sockaddr_in  addr;
-
  public:
   // These defines specify a system independent way to
   //   get error codes for socket services.
@@ -92,6 +87,38 @@ class UDP
     TIMEDOUT     =-15      // Timeout
   };
 
+  virtual         ~TransportSocket() {}
+
+  virtual Int      Bind(UnsignedInt IP,UnsignedShort port) = 0;                              ///< returns OK or an error
+  virtual Int      Write(const unsigned char *msg,UnsignedInt len,UnsignedInt IP,UnsignedShort port) = 0; ///< returns the bytes sent or -1
+  virtual Int      Read(unsigned char *msg,UnsignedInt len,sockaddr_in *from) = 0;           ///< returns the bytes read, 0 if there is nothing to read or -1
+  virtual sockStat GetStatus(void) = 0;
+  virtual Int      AllowBroadcasts(Bool status) = 0;
+
+  // TheSuperHackers @performance Reads and writes of several packets at once, for sockets that can
+  // move them with one system call. By default they call Read() and Write() for each packet.
+  struct Packet
+  {
+    unsigned char *buf;
+    UnsignedInt     len;     ///< the size of buf for ReadMany(), the bytes to send for WriteMany()
+    UnsignedInt     IP;      ///< host order, where it came from or where it goes to
+    UnsignedShort   port;    ///< host order
+    Int             result;  ///< the bytes read or sent, or what Write() returned if it was not sent
+  };
+
+  virtual Int      ReadMany(Packet *packets,Int count);   ///< returns the packets read up to the first that could not be, 0 if there was nothing to read, or -1
+  virtual void     WriteMany(Packet *packets,Int count);  ///< sends every packet, and sets its result
+};
+
+class UDP : public TransportSocket
+{
+ // DATA
+ private:
+  Int       fd;
+  UnsignedInt       myIP;
+  UnsignedShort       myPort;
+  struct       sockaddr_in  addr;
+
 // CODE
  private:
   Int           SetBlocking(Int block);
@@ -101,11 +128,11 @@ class UDP
  public:
                    UDP();
                   ~UDP();
-  Int           Bind(UnsignedInt IP,UnsignedShort port);
+  virtual Int   Bind(UnsignedInt IP,UnsignedShort port);
   Int           Bind(const char *Host,UnsignedShort port);
-  Int           Write(const unsigned char *msg,UnsignedInt len,UnsignedInt IP,UnsignedShort port);
-  Int           Read(unsigned char *msg,UnsignedInt len,sockaddr_in *from);
-  sockStat         GetStatus(void);
+  virtual Int   Write(const unsigned char *msg,UnsignedInt len,UnsignedInt IP,UnsignedShort port);
+  virtual Int   Read(unsigned char *msg,UnsignedInt len,sockaddr_in *from);
+  virtual sockStat GetStatus(void);
   void             ClearStatus(void);
   //int              Wait(Int sec,Int usec,fd_set &returnSet);
   //int              Wait(Int sec,Int usec,fd_set &givenSet,fd_set &returnSet);
@@ -117,7 +144,15 @@ class UDP
   Int             SetOutputBuffer(UnsignedInt bytes);
   int              GetInputBuffer(void);
   int              GetOutputBuffer(void);
-	Int						AllowBroadcasts(Bool status);
+	virtual Int				AllowBroadcasts(Bool status);
+
+#if defined(__linux__)
+  virtual Int      ReadMany(Packet *packets,Int count);
+  virtual void     WriteMany(Packet *packets,Int count);
+
+ private:
+  enum { MAX_BATCH = 32 };   // packets given to one recvmmsg() or sendmmsg() call
+#endif
 };
 
 #ifdef DEBUG_LOGGING
@@ -0,0 +1,431 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "Common/PathfindBenchmark.h"
+
+#include "Common/file.h"
+#include "Common/FileSystem.h"
+#include "Common/LocalFileSystem.h"
+#include "Common/MessageStream.h"
+#include "Common/Player.h"
+#include "Common/PlayerList.h"
+#include "Common/RandomValue.h"
+#include "Common/ReplayReport.h"
+#include "Common/ThingFactory.h"
+#include "Common/ThingTemplate.h"
+#include "GameClient/GameClient.h"
+#include "GameLogic/AI.h"
+#include "GameLogic/AIPathfind.h"
+#include "GameLogic/GameLogic.h"
+#include "GameLogic/Module/AIUpdate.h"
+#include "GameLogic/Object.h"
+#include "GameLogic/TerrainLogic.h"
+#include "GameLogic/Weapon.h"
+
+#include <algorithm>
+
+
+namespace
+{
+const char *const RequestKindNames[] =
+{
+	"path",
+	"closest",
+	"attack",
+	"patch",
+};
+
+const char *const WorkloadHeader = "PathfindBenchmark 1";
+
+const UnsignedInt HashOffsetBasis = 2166136261U;
+const UnsignedInt HashPrime = 16777619U;
+
+void hashInt(UnsignedInt &hash, Int value)
+{
+	for (Int i = 0; i < 4; ++i)
+	{
+		hash ^= (UnsignedInt)(value >> (i * 8)) & 0xff;
+		hash *= HashPrime;
+	}
+}
+
+// A generator of its own, so that the workload does not depend on the game logic random seed.
+UnsignedInt nextRandom(UnsignedInt &state)
+{
+	state = state * 1664525U + 1013904223U;
+	return state >> 8;
+}
+
+Coord3D toWorld(const ICoord2D &pos)
+{
+	Coord3D world;
+	world.x = (Real)pos.x;
+	world.y = (Real)pos.y;
+	world.z = TheTerrainLogic->getGroundHeight(world.x, world.y);
+	return world;
+}
+
+Real ticksToMillis(Int64 ticks)
+{
+	return (Real)((double)ticks * 1000.0 / (double)ReplayReport::getTicksPerSecond());
+}
+}
+
+//-------------------------------------------------------------------------------------------------
+int PathfindBenchmark::run(const AsciiString &mapName)
+{
+	// Note that we use printf here because this is run from cmd.
+	if (!startMap(mapName))
+	{
+		printf("Cannot load map \"%s\"\n", mapName.str());
+		return 1;
+	}
+
+	Pathfinder *pathfinder = TheAI->pathfinder();
+
+	// The map was classified while it loaded. Do it once more to time it.
+	Int64 startTicks = ReplayReport::getTicks();
+	pathfinder->newMap();
+	const Int64 classifyTicks = ReplayReport::getTicks() - startTicks;
+
+	std::vector<Request> requests;
+	const AsciiString &workloadFile = TheGlobalData->m_benchmarkPathfindWorkload;
+	if (workloadFile.isNotEmpty() && TheFileSystem->doesFileExist(workloadFile.str()))
+	{
+		if (!readRequests(workloadFile, requests))
+		{
+			printf("Cannot read pathfind workload \"%s\"\n", workloadFile.str());
+			return 1;
+		}
+	}
+	else
+	{
+		if (!generateRequests(requests, TheGlobalData->m_benchmarkPathfindRequests, TheGlobalData->m_benchmarkPathfindSeed))
+		{
+			printf("Map \"%s\" has no area to pick positions in\n", mapName.str());
+			return 1;
+		}
+		if (workloadFile.isNotEmpty() && !writeRequests(workloadFile, requests))
+		{
+			printf("Cannot write pathfind workload \"%s\"\n", workloadFile.str());
+			return 1;
+		}
+	}
+
+	const ThingTemplate *unitTemplate = TheThingFactory->findTemplate(TheGlobalData->m_benchmarkPathfindUnit, FALSE);
+	if (unitTemplate == NULL)
+	{
+		printf("Cannot find unit \"%s\"\n", TheGlobalData->m_benchmarkPathfindUnit.str());
+		return 1;
+	}
+
+	Team *team = ThePlayerList->getNeutralPlayer()->getDefaultTeam();
+	Object *mover = TheThingFactory->newObject(unitTemplate, team);
+	Object *victim = TheThingFactory->newObject(unitTemplate, team);
+	if (mover->getAI() == NULL || mover->getCurrentWeapon() == NULL)
+	{
+		printf("Unit \"%s\" cannot move and attack\n", TheGlobalData->m_benchmarkPathfindUnit.str());
+		TheGameLogic->destroyObject(mover);
+		TheGameLogic->destroyObject(victim);
+		return 1;
+	}
+
+	Result results[REQUEST_KIND_COUNT];
+	Int kind;
+	for (kind = 0; kind < REQUEST_KIND_COUNT; ++kind)
+	{
+		results[kind].cells = 0;
+		results[kind].pathsFound = 0;
+		results[kind].hash = HashOffsetBasis;
+	}
+
+	printf("Benchmarking %d pathfind requests on map \"%s\"\n", (Int)requests.size(), mapName.str());
+	fflush(stdout);
+
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		runRequest(pathfinder, mover, victim, requests[i], results[requests[i].kind]);
+	}
+
+	TheGameLogic->destroyObject(mover);
+	TheGameLogic->destroyObject(victim);
+
+	printf("Classify map: %.3f ms\n", ticksToMillis(classifyTicks));
+
+	Result total;
+	total.cells = 0;
+	total.pathsFound = 0;
+	total.hash = HashOffsetBasis;
+	for (kind = 0; kind < REQUEST_KIND_COUNT; ++kind)
+	{
+		Result &result = results[kind];
+		total.ticks.insert(total.ticks.end(), result.ticks.begin(), result.ticks.end());
+		total.cells += result.cells;
+		total.pathsFound += result.pathsFound;
+		hashInt(total.hash, (Int)result.hash);
+
+		if (!result.ticks.empty())
+			printResult(RequestKindNames[kind], result);
+	}
+	printResult("total", total);
+
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Load the map like the -file option does and let the logic run until the game has started. */
+//-------------------------------------------------------------------------------------------------
+Bool PathfindBenchmark::startMap(const AsciiString &mapName)
+{
+	if (!TheFileSystem->doesFileExist(mapName.str()))
+		return FALSE;
+
+	TheWritableGlobalData->m_pendingFile = mapName;
+
+	// We send the New Game message here directly to the command list and bypass the TheMessageStream,
+	// like the replay simulation does, because we don't update TheMessageStream here.
+	GameMessage *msg = newInstance(GameMessage)(GameMessage::MSG_NEW_GAME);
+	msg->appendIntegerArgument(GAME_SINGLE_PLAYER);
+	msg->appendIntegerArgument(DIFFICULTY_NORMAL);
+	msg->appendIntegerArgument(0);
+	TheCommandList->appendMessage(msg);
+	InitRandom(0);
+
+	for (Int frame = 0; frame < LOGICFRAMES_PER_SECOND; ++frame)
+	{
+		TheGameClient->updateHeadless();
+		TheGameLogic->UPDATE();
+		if (TheGameLogic->isInGame() && TheGameLogic->getFrame() > 0)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Pick random positions on the map. Many of them are unreachable or inside of structures, which
+	* is intended, because the game asks for such paths all the time. */
+//-------------------------------------------------------------------------------------------------
+Bool PathfindBenchmark::generateRequests(std::vector<Request> &requests, Int count, UnsignedInt seed)
+{
+	Region3D extent;
+	TheTerrainLogic->getExtent(&extent);
+	const Int lowX = REAL_TO_INT_CEIL(extent.lo.x);
+	const Int lowY = REAL_TO_INT_CEIL(extent.lo.y);
+	const Int width = REAL_TO_INT_FLOOR(extent.hi.x) - lowX;
+	const Int height = REAL_TO_INT_FLOOR(extent.hi.y) - lowY;
+	if (width <= 0 || height <= 0)
+		return FALSE;
+
+	const Int patchOffset = (Int)(PATHFIND_CELL_SIZE_F * 4);
+
+	UnsignedInt state = seed;
+	requests.resize(count);
+	for (Int i = 0; i < count; ++i)
+	{
+		Request &request = requests[i];
+		request.kind = (RequestKind)(nextRandom(state) % REQUEST_KIND_COUNT);
+		request.from.x = lowX + (Int)(nextRandom(state) % width);
+		request.from.y = lowY + (Int)(nextRandom(state) % height);
+		request.to.x = lowX + (Int)(nextRandom(state) % width);
+		request.to.y = lowY + (Int)(nextRandom(state) % height);
+
+		// Step off the start of the path, like a unit that made way for another one.
+		request.patchFrom.x = request.from.x + (Int)(nextRandom(state) % (2 * patchOffset + 1)) - patchOffset;
+		request.patchFrom.y = request.from.y + (Int)(nextRandom(state) % (2 * patchOffset + 1)) - patchOffset;
+		request.patchFrom.x = std::min(std::max(request.patchFrom.x, lowX), lowX + width);
+		request.patchFrom.y = std::min(std::max(request.patchFrom.y, lowY), lowY + height);
+	}
+
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** The workload is a text file with one request per line, made of the request kind and the world
+	* positions of the start, the goal and the position to patch the path from. */
+//-------------------------------------------------------------------------------------------------
+Bool PathfindBenchmark::readRequests(const AsciiString &path, std::vector<Request> &requests)
+{
+	File *fp = TheFileSystem->openFile(path.str(), File::READ | File::TEXT);
+	if (fp == NULL)
+		return FALSE;
+
+	std::vector<char> text(fp->size() + 1);
+	const Int length = fp->read(&text[0], (Int)text.size() - 1);
+	fp->close();
+	if (length < 0)
+		return FALSE;
+	text[length] = 0;
+
+	char *line = &text[0];
+	char *lineEnd = strchr(line, '\n');
+	Bool success = strncmp(line, WorkloadHeader, strlen(WorkloadHeader)) == 0;
+	while (success && lineEnd != NULL)
+	{
+		line = lineEnd + 1;
+		lineEnd = strchr(line, '\n');
+		if (lineEnd != NULL)
+			*lineEnd = 0;
+		if (strspn(line, " \t\r") == strlen(line))
+			continue;
+
+		char kindName[32];
+		Request request;
+		if (sscanf(line, "%31s %d %d %d %d %d %d", kindName,
+				&request.from.x, &request.from.y, &request.to.x, &request.to.y, &request.patchFrom.x, &request.patchFrom.y) != 7)
+		{
+			success = FALSE;
+			break;
+		}
+
+		Int kind = 0;
+		while (kind < REQUEST_KIND_COUNT && strcmp(kindName, RequestKindNames[kind]) != 0)
+			++kind;
+		if (kind == REQUEST_KIND_COUNT)
+		{
+			success = FALSE;
+			break;
+		}
+
+		request.kind = (RequestKind)kind;
+		requests.push_back(request);
+	}
+
+	return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool PathfindBenchmark::writeRequests(const AsciiString &path, const std::vector<Request> &requests)
+{
+	File *fp = TheLocalFileSystem->openFile(path.str(), File::WRITE | File::CREATE | File::TRUNCATE | File::TEXT);
+	if (fp == NULL)
+		return FALSE;
+
+	Bool success = fp->writeFormat("%s\n", WorkloadHeader) > 0;
+	for (size_t i = 0; success && i < requests.size(); ++i)
+	{
+		const Request &request = requests[i];
+		success = fp->writeFormat("%s %d %d %d %d %d %d\n", RequestKindNames[request.kind],
+			request.from.x, request.from.y, request.to.x, request.to.y, request.patchFrom.x, request.patchFrom.y) > 0;
+	}
+
+	fp->close();
+	return success;
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::runRequest(Pathfinder *pathfinder, Object *mover, Object *victim, const Request &request, Result &result)
+{
+	const LocomotorSet &locomotorSet = mover->getAI()->getLocomotorSet();
+	const Coord3D from = toWorld(request.from);
+	Coord3D to = toWorld(request.to);
+	mover->setPosition(&from);
+
+	// The path to patch is found before the clock starts.
+	Path *originalPath = NULL;
+	if (request.kind == REQUEST_PATCH_PATH)
+	{
+		originalPath = pathfinder->findPath(mover, locomotorSet, &from, &to);
+		if (originalPath == NULL)
+		{
+			hashPath(NULL, result);
+			return;
+		}
+		const Coord3D patchFrom = toWorld(request.patchFrom);
+		mover->setPosition(&patchFrom);
+	}
+	else if (request.kind == REQUEST_ATTACK_PATH)
+	{
+		victim->setPosition(&to);
+	}
+
+	const Int startCells = pathfinder->m_cumulativeCellsAllocated;
+	const Int64 startTicks = ReplayReport::getTicks();
+
+	Path *path = NULL;
+	switch (request.kind)
+	{
+		case REQUEST_PATH:
+			path = pathfinder->findPath(mover, locomotorSet, &from, &to);
+			break;
+		case REQUEST_CLOSEST_PATH:
+			path = pathfinder->findClosestPath(mover, locomotorSet, &from, &to, FALSE, 0.0f, FALSE);
+			break;
+		case REQUEST_ATTACK_PATH:
+			path = pathfinder->findAttackPath(mover, locomotorSet, &from, victim, victim->getPosition(), mover->getCurrentWeapon());
+			break;
+		case REQUEST_PATCH_PATH:
+			path = pathfinder->patchPath(mover, locomotorSet, originalPath, FALSE);
+			break;
+	}
+
+	result.ticks.push_back(ReplayReport::getTicks() - startTicks);
+	result.cells += pathfinder->m_cumulativeCellsAllocated - startCells;
+
+	hashPath(path, result);
+	if (path != NULL)
+	{
+		++result.pathsFound;
+		deleteInstance(path);
+	}
+	deleteInstance(originalPath);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Fold the nodes of the path into the hash. Positions are rounded to a sixteenth of a world unit
+	* so that the hash only changes when the path does. A missing path is hashed as an empty one. */
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::hashPath(Path *path, Result &result)
+{
+	Int nodeCount = 0;
+	if (path != NULL)
+	{
+		for (const PathNode *node = path->getFirstNode(); node != NULL; node = node->getNext())
+		{
+			hashInt(result.hash, REAL_TO_INT_FLOOR(node->getPosition()->x * 16.0f));
+			hashInt(result.hash, REAL_TO_INT_FLOOR(node->getPosition()->y * 16.0f));
+			hashInt(result.hash, node->getLayer());
+			++nodeCount;
+		}
+	}
+	hashInt(result.hash, nodeCount);
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::printResult(const char *name, Result &result)
+{
+	std::sort(result.ticks.begin(), result.ticks.end());
+
+	Int64 totalTicks = 0;
+	for (size_t i = 0; i < result.ticks.size(); ++i)
+	{
+		totalTicks += result.ticks[i];
+	}
+
+	const size_t count = result.ticks.size();
+	const Int64 p50 = count > 0 ? result.ticks[count / 2] : 0;
+	const Int64 p99 = count > 0 ? result.ticks[(count * 99) / 100] : 0;
+	const Real totalMillis = ticksToMillis(totalTicks);
+	const Real pathsPerSecond = totalMillis > 0.0f ? (Real)count * 1000.0f / totalMillis : 0.0f;
+
+	printf("%-8s requests: %6d found: %6d cells: %10.0f paths/s: %10.1f p50: %8.3f ms p99: %8.3f ms hash: 0x%8.8X\n",
+		name, (Int)count, result.pathsFound, (double)result.cells, pathsPerSecond, ticksToMillis(p50), ticksToMillis(p99), result.hash);
+	fflush(stdout);
+}
@@ -0,0 +1,258 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "Common/ReplayReport.h"
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+
+Bool ReplayReport::s_enabled = false;
+Int64 ReplayReport::s_sectionTicks[REPLAYREPORT_SECTION_COUNT];
+UnsignedInt ReplayReport::s_frameHistogram[FRAME_HISTOGRAM_BUCKETS];
+UnsignedInt ReplayReport::s_frameCount = 0;
+Int64 ReplayReport::s_frameTicks = 0;
+Int64 ReplayReport::s_maxFrameTicks = 0;
+Int64 ReplayReport::s_startTicks = 0;
+UnsignedInt ReplayReport::s_peakObjectCount = 0;
+
+namespace
+{
+const char *const SectionNames[REPLAYREPORT_SECTION_COUNT] =
+{
+	"scriptEngine",
+	"terrainLogic",
+	"crc",
+	"commandList",
+	"sleepyUpdates",
+	"ai",
+	"partitionManager",
+	"destroyList",
+};
+
+// Upper bound of each frame time histogram bucket in microseconds. The last bucket is unbounded.
+const UnsignedInt FrameHistogramLimits[] = { 250, 500, 1000, 2000, 4000, 8000, 16000, 33000, 66000 };
+
+const Int MaxReportedMemoryPools = 10;
+
+Int64 ticksToMicroseconds(Int64 ticks)
+{
+	return ticks * 1000000 / ReplayReport::getTicksPerSecond();
+}
+
+AsciiString escapeJsonString(const AsciiString &str)
+{
+	AsciiString escaped;
+	for (const char *c = str.str(); *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+			escaped.concat('\\');
+		escaped.concat(*c);
+	}
+	return escaped;
+}
+} // namespace
+
+Int64 ReplayReport::getTicks()
+{
+#ifdef _WIN32
+	LARGE_INTEGER ticks;
+	QueryPerformanceCounter(&ticks);
+	return ticks.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (Int64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+Int64 ReplayReport::getTicksPerSecond()
+{
+#ifdef _WIN32
+	static Int64 s_ticksPerSecond = 0;
+	if (s_ticksPerSecond == 0)
+	{
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		s_ticksPerSecond = frequency.QuadPart;
+	}
+	return s_ticksPerSecond;
+#else
+	return 1000000000;
+#endif
+}
+
+void ReplayReport::beginReplay()
+{
+	Int i;
+	for (i = 0; i < REPLAYREPORT_SECTION_COUNT; ++i)
+		s_sectionTicks[i] = 0;
+	for (i = 0; i < FRAME_HISTOGRAM_BUCKETS; ++i)
+		s_frameHistogram[i] = 0;
+	s_frameCount = 0;
+	s_frameTicks = 0;
+	s_maxFrameTicks = 0;
+	s_peakObjectCount = 0;
+	s_startTicks = getTicks();
+}
+
+void ReplayReport::addFrame(Int64 frameTicks)
+{
+	++s_frameCount;
+	s_frameTicks += frameTicks;
+	if (frameTicks > s_maxFrameTicks)
+		s_maxFrameTicks = frameTicks;
+
+	const Int64 frameMicroseconds = ticksToMicroseconds(frameTicks);
+	Int bucket = 0;
+	while (bucket < ARRAY_SIZE(FrameHistogramLimits) && frameMicroseconds >= FrameHistogramLimits[bucket])
+		++bucket;
+	++s_frameHistogram[bucket];
+}
+
+void ReplayReport::addObjectCount(UnsignedInt objectCount)
+{
+	if (objectCount > s_peakObjectCount)
+		s_peakObjectCount = objectCount;
+}
+
+AsciiString ReplayReport::endReplay(const AsciiString &filename, const char *result)
+{
+	const Int64 wallMicroseconds = ticksToMicroseconds(getTicks() - s_startTicks);
+	const Int64 logicMicroseconds = ticksToMicroseconds(s_frameTicks);
+
+	AsciiString entry;
+	AsciiString str;
+	Int i;
+	str.format("{\"replay\":\"%s\",\"result\":\"%s\",\"frames\":%u,\"wallTimeMs\":%.3f,\"logicFramesPerSecond\":%.2f",
+		escapeJsonString(filename).str(), result, s_frameCount,
+		wallMicroseconds / 1000.0,
+		logicMicroseconds > 0 ? s_frameCount * 1000000.0 / logicMicroseconds : 0.0);
+	entry.concat(str);
+
+	str.format(",\"avgFrameUs\":%.1f,\"maxFrameUs\":%.1f,\"peakObjectCount\":%u",
+		s_frameCount > 0 ? (double)logicMicroseconds / s_frameCount : 0.0,
+		(double)ticksToMicroseconds(s_maxFrameTicks),
+		s_peakObjectCount);
+	entry.concat(str);
+
+	entry.concat(",\"sectionsMs\":{");
+	for (i = 0; i < REPLAYREPORT_SECTION_COUNT; ++i)
+	{
+		str.format("%s\"%s\":%.3f", i > 0 ? "," : "", SectionNames[i], ticksToMicroseconds(s_sectionTicks[i]) / 1000.0);
+		entry.concat(str);
+	}
+	entry.concat("}");
+
+	entry.concat(",\"frameHistogram\":[");
+	for (i = 0; i < FRAME_HISTOGRAM_BUCKETS; ++i)
+	{
+		if (i < ARRAY_SIZE(FrameHistogramLimits))
+			str.format("%s{\"maxUs\":%u,\"count\":%u}", i > 0 ? "," : "", FrameHistogramLimits[i], s_frameHistogram[i]);
+		else
+			str.format("%s{\"maxUs\":null,\"count\":%u}", i > 0 ? "," : "", s_frameHistogram[i]);
+		entry.concat(str);
+	}
+	entry.concat("]");
+
+#ifndef DISABLE_GAMEMEMORY
+	// Note that the peak block counts of the pools are kept for the life time of the process.
+	MemoryPool *topPools[MaxReportedMemoryPools] = { 0 };
+	Int64 totalPeakBytes = 0;
+	for (MemoryPool *pool = TheMemoryPoolFactory->getFirstMemoryPool(); pool; pool = pool->getNextPoolInList())
+	{
+		const Int64 peakBytes = (Int64)pool->getPeakBlockCount() * pool->getAllocationSize();
+		totalPeakBytes += peakBytes;
+
+		// Insertion into the short list of largest pools
+		MemoryPool *candidate = pool;
+		for (i = 0; i < MaxReportedMemoryPools && candidate; ++i)
+		{
+			if (topPools[i] == NULL || (Int64)topPools[i]->getPeakBlockCount() * topPools[i]->getAllocationSize() < (Int64)candidate->getPeakBlockCount() * candidate->getAllocationSize())
+			{
+				MemoryPool *tmp = topPools[i];
+				topPools[i] = candidate;
+				candidate = tmp;
+			}
+		}
+	}
+
+	str.format(",\"memoryPools\":{\"peakKB\":%u,\"largest\":[", (UnsignedInt)(totalPeakBytes / 1024));
+	entry.concat(str);
+	for (i = 0; i < MaxReportedMemoryPools && topPools[i]; ++i)
+	{
+		str.format("%s{\"name\":\"%s\",\"peakBlocks\":%d,\"peakKB\":%u}",
+			i > 0 ? "," : "",
+			topPools[i]->getPoolName(),
+			topPools[i]->getPeakBlockCount(),
+			(UnsignedInt)((Int64)topPools[i]->getPeakBlockCount() * topPools[i]->getAllocationSize() / 1024));
+		entry.concat(str);
+	}
+	entry.concat("]}");
+#endif
+
+	entry.concat("}");
+	return entry;
+}
+
+Bool ReplayReport::writeFile(const AsciiString &path, const std::vector<AsciiString> &replayEntries, UnsignedInt totalWallTimeMillis)
+{
+	FILE *fp = fopen(path.str(), "w");
+	if (fp == NULL)
+		return false;
+
+	fprintf(fp, "{\n\"version\":1,\n\"totalWallTimeMs\":%u,\n\"replays\":[\n", totalWallTimeMillis);
+	for (size_t i = 0; i < replayEntries.size(); ++i)
+	{
+		fprintf(fp, "%s%s\n", replayEntries[i].str(), i + 1 < replayEntries.size() ? "," : "");
+	}
+	fprintf(fp, "]\n}\n");
+	fclose(fp);
+	return true;
+}
+
+Bool ReplayReport::readReplayEntries(const AsciiString &path, std::vector<AsciiString> &replayEntries)
+{
+	FILE *fp = fopen(path.str(), "r");
+	if (fp == NULL)
+		return false;
+
+	// Every replay entry is written on its own line, see writeFile
+	AsciiString line;
+	char buffer[1024];
+	while (fgets(buffer, ARRAY_SIZE(buffer), fp) != NULL)
+	{
+		line.concat(buffer);
+		if (!line.endsWith("\n") && !feof(fp))
+			continue;
+
+		line.trim();
+		if (line.startsWith("{\"replay\":"))
+		{
+			if (line.endsWith(","))
+				line.removeLastChar();
+			replayEntries.push_back(line);
+		}
+		line.clear();
+	}
+	fclose(fp);
+	return true;
+}
@@ -20,13 +20,21 @@
 
 #include "Common/ReplaySimulation.h"
 
+#include "Common/file.h"
+#include "Common/FileSystem.h"
 #include "Common/GameEngine.h"
 #include "Common/LocalFileSystem.h"
 #include "Common/Recorder.h"
+#include "Common/ReplayReport.h"
 #include "Common/WorkerProcess.h"
+#include "Common/XferDeepCRC.h"
 #include "GameLogic/GameLogic.h"
 #include "GameClient/GameClient.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 
 Bool ReplaySimulation::s_isRunning = false;
 UnsignedInt ReplaySimulation::s_replayIndex = 0;
@@ -45,8 +53,146 @@ int countProcessesRunning(const std::vector<WorkerProcess>& processes)
 	}
 	return numProcessesRunning;
 }
+
+// TheSuperHackers @feature Keeps the most recent deep CRC snapshots of the game logic in memory,
+// so that they can be written to disk once a mismatch is seen.
+class ReplaySnapshotRing
+{
+public:
+	struct Snapshot
+	{
+		UnsignedInt frame;
+		UnsignedInt crc;
+		std::vector<UnsignedByte> data;
+	};
+
+	ReplaySnapshotRing(Int interval, Int count)
+		: m_interval(interval)
+		, m_next(0)
+	{
+		if (m_interval > 0)
+			m_snapshots.resize(count);
+		clear();
+	}
+
+	Bool isEnabled() const { return m_interval > 0; }
+
+	void clear()
+	{
+		for (size_t i = 0; i < m_snapshots.size(); ++i)
+			m_snapshots[i].frame = ~0u;
+		m_next = 0;
+	}
+
+	void update(UnsignedInt frame)
+	{
+		if (!isEnabled() || frame == 0 || frame % m_interval != 0)
+			return;
+
+		// Reuse the memory of the oldest snapshot
+		Snapshot &snapshot = m_snapshots[m_next];
+		m_xfer.swapData(snapshot.data);
+		AsciiString identifier;
+		identifier.format("ReplaySnapshot%u", frame);
+		m_xfer.open(identifier);
+		snapshot.crc = TheGameLogic->recalculateCRC(&m_xfer);
+		snapshot.frame = frame;
+		m_xfer.swapData(snapshot.data);
+		m_next = (m_next + 1) % m_snapshots.size();
+	}
+
+	// Writes all snapshots from oldest to newest. Returns the number of files written.
+	Int write(const AsciiString &replayFilename) const
+	{
+		if (!isEnabled())
+			return 0;
+
+		AsciiString dir;
+		dir.format("%sReplaySnapshots", TheGlobalData->getPath_UserData().str());
+		TheLocalFileSystem->createDirectory(dir);
+
+		AsciiString replayName = replayFilename;
+		replayName.truncateBy(RecorderClass::getReplayExtention().getLength());
+		for (Int pos = replayName.getLength() - 1; pos >= 0; --pos)
+		{
+			const char c = replayName.getCharAt(pos);
+			if (c == '/' || c == '\\')
+			{
+				AsciiString leaf = replayName.str() + pos + 1;
+				replayName = leaf;
+				break;
+			}
+		}
+
+		Int numWritten = 0;
+		for (size_t i = 0; i < m_snapshots.size(); ++i)
+		{
+			const Snapshot &snapshot = m_snapshots[(m_next + i) % m_snapshots.size()];
+			if (snapshot.frame == ~0u)
+				continue;
+
+			AsciiString path;
+			path.format("%s/%s_%06u.crc", dir.str(), replayName.str(), snapshot.frame);
+			File *file = TheFileSystem->openFile(path.str(), File::WRITE | File::CREATE | File::TRUNCATE | File::BINARY);
+			if (file == NULL)
+				continue;
+			file->write(snapshot.data.empty() ? NULL : &snapshot.data[0], (Int)snapshot.data.size());
+			file->close();
+			printf("Wrote snapshot of frame %u with CRC 0x%8.8X to \"%s\"\n", snapshot.frame, snapshot.crc, path.str());
+			++numWritten;
+		}
+		fflush(stdout);
+		return numWritten;
+	}
+
+private:
+	std::vector<Snapshot> m_snapshots;
+	XferDeepCRCMemory m_xfer;
+	UnsignedInt m_interval;
+	size_t m_next;
+};
+
+struct ForkedReplayJob
+{
+	AsciiString filename;
+	AsciiString reportFile;
+};
+
+AsciiString getWorkerReportFile(int filenamePosition)
+{
+	AsciiString reportFile;
+	if (TheGlobalData->m_replayReportFile.isNotEmpty())
+		reportFile.format("%s.part%d", TheGlobalData->m_replayReportFile.str(), filenamePosition);
+	return reportFile;
+}
+
+UnicodeString getExecutablePath()
+{
+	UnicodeString exePathWide;
+#ifdef _WIN32
+	WideChar exePath[1024];
+	GetModuleFileNameW(NULL, exePath, ARRAY_SIZE(exePath));
+	exePathWide = exePath;
+#else
+	char exePath[1024];
+	ssize_t len = readlink("/proc/self/exe", exePath, ARRAY_SIZE(exePath)-1);
+	exePath[len > 0 ? len : 0] = 0;
+	exePathWide.translate(AsciiString(exePath));
+#endif
+	return exePathWide;
+}
 } // namespace
 
+int ReplaySimulation::simulateReplayInForkedProcess(void *userData)
+{
+	// This runs in a copy-on-write clone of the engine that was initialized by the parent process.
+	const ForkedReplayJob *job = static_cast<const ForkedReplayJob *>(userData);
+	TheWritableGlobalData->m_replayReportFile = job->reportFile;
+	std::vector<AsciiString> filenames;
+	filenames.push_back(job->filename);
+	return simulateReplaysInThisProcess(filenames);
+}
+
 int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString> &filenames)
 {
 	int numErrors = 0;
@@ -75,14 +221,20 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 	}
 	// Note that we use printf here because this is run from cmd.
 	DWORD totalStartTimeMillis = GetTickCount();
+	ReplaySnapshotRing snapshots(TheGlobalData->m_replaySnapshotInterval, TheGlobalData->m_replaySnapshotCount);
+	std::vector<AsciiString> reportEntries;
+	ReplayReport::setEnabled(TheGlobalData->m_replayReportFile.isNotEmpty());
 	for (size_t i = 0; i < filenames.size(); i++)
 	{
 		AsciiString filename = filenames[i];
 		printf("Simulating Replay \"%s\"\n", filename.str());
 		fflush(stdout);
 		DWORD startTimeMillis = GetTickCount();
+		snapshots.clear();
+		ReplayReport::beginReplay();
 		if (TheRecorder->simulateReplay(filename))
 		{
+			Bool sawMismatch = FALSE;
 			UnsignedInt totalTimeSec = TheRecorder->getPlaybackFrameCount() / LOGICFRAMES_PER_SECOND;
 			while (TheRecorder->isPlaybackInProgress())
 			{
@@ -98,13 +250,30 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 							realTimeSec/60, realTimeSec%60, gameTimeSec/60, gameTimeSec%60, totalTimeSec/60, totalTimeSec%60);
 					fflush(stdout);
 				}
-				TheGameLogic->UPDATE();
+				if (ReplayReport::isEnabled())
+				{
+					const Int64 frameStartTicks = ReplayReport::getTicks();
+					TheGameLogic->UPDATE();
+					ReplayReport::addFrame(ReplayReport::getTicks() - frameStartTicks);
+					if (TheGameLogic->getFrame() % LOGICFRAMES_PER_SECOND == 0)
+						ReplayReport::addObjectCount(TheGameLogic->getObjectCount());
+				}
+				else
+				{
+					TheGameLogic->UPDATE();
+				}
 				if (TheRecorder->sawCRCMismatch())
 				{
 					numErrors++;
+					sawMismatch = TRUE;
 					break;
 				}
+				snapshots.update(TheGameLogic->getFrame());
 			}
+			if (sawMismatch || TheGlobalData->m_replaySnapshotDump)
+				snapshots.write(filename);
+			if (ReplayReport::isEnabled())
+				reportEntries.push_back(ReplayReport::endReplay(filename, sawMismatch ? "mismatch" : "ok"));
 			UnsignedInt gameTimeSec = TheGameLogic->getFrame() / LOGICFRAMES_PER_SECOND;
 			UnsignedInt realTimeSec = (GetTickCount()-startTimeMillis) / 1000;
 			printf("Elapsed Time: %02d:%02d Game Time: %02d:%02d/%02d:%02d\n",
@@ -115,6 +284,17 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 		{
 			printf("Cannot open replay\n");
 			numErrors++;
+			if (ReplayReport::isEnabled())
+				reportEntries.push_back(ReplayReport::endReplay(filename, "error"));
+		}
+	}
+	if (ReplayReport::isEnabled())
+	{
+		ReplayReport::setEnabled(FALSE);
+		if (!ReplayReport::writeFile(TheGlobalData->m_replayReportFile, reportEntries, GetTickCount()-totalStartTimeMillis))
+		{
+			printf("Cannot write replay report \"%s\"\n", TheGlobalData->m_replayReportFile.str());
+			numErrors++;
 		}
 	}
 	if (filenames.size() > 1)
@@ -133,8 +313,15 @@ int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiSt
 {
 	DWORD totalStartTimeMillis = GetTickCount();
 
-	WideChar exePath[1024];
-	GetModuleFileNameW(NULL, exePath, ARRAY_SIZE(exePath));
+	UnicodeString exePath = getExecutablePath();
+
+	// TheSuperHackers @performance Where possible, the engine is initialized once in this process and
+	// each worker is forked from it right before the replay simulation starts. This avoids loading
+	// all INI and BIG data again per replay and keeps the loaded assets shared between the workers.
+	const Bool useForkedProcesses = TheGlobalData->m_headless && WorkerProcess::canForkProcess();
+
+	std::vector<ForkedReplayJob> forkedJobs(filenames.size());
+	std::vector<AsciiString> reportEntries;
 
 	std::vector<WorkerProcess> processes;
 	int filenamePositionStarted = 0;
@@ -157,6 +344,13 @@ int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiSt
 			DWORD exitcode = processes[0].getExitCode();
 			if (exitcode != 0)
 				printf("Error!\n");
+			if (TheGlobalData->m_replayReportFile.isNotEmpty())
+			{
+				// Merge the report of the worker into ours
+				AsciiString workerReportFile = getWorkerReportFile(filenamePositionDone);
+				ReplayReport::readReplayEntries(workerReportFile, reportEntries);
+				remove(workerReportFile.str());
+			}
 			fflush(stdout);
 			numErrors += exitcode == 0 ? 0 : 1;
 			processes.erase(processes.begin());
@@ -168,17 +362,46 @@ int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiSt
 		// Add new processes when we are below the limit and there are replays left
 		while (numProcessesRunning < maxProcesses && filenamePositionStarted < filenames.size())
 		{
-			UnicodeString filenameWide;
-			filenameWide.translate(filenames[filenamePositionStarted]);
-			UnicodeString command;
-			command.format(L"\"%s\"%s%s -replay \"%s\"",
-				exePath,
-				TheGlobalData->m_windowed ? L" -win" : L"",
-				TheGlobalData->m_headless ? L" -headless" : L"",
-				filenameWide.str());
-
 			processes.push_back(WorkerProcess());
-			processes.back().startProcess(command);
+
+			if (useForkedProcesses)
+			{
+				ForkedReplayJob &job = forkedJobs[filenamePositionStarted];
+				job.filename = filenames[filenamePositionStarted];
+				job.reportFile = getWorkerReportFile(filenamePositionStarted);
+				processes.back().startForkedProcess(simulateReplayInForkedProcess, &job);
+			}
+			else
+			{
+				UnicodeString filenameWide;
+				filenameWide.translate(filenames[filenamePositionStarted]);
+				UnicodeString extraArgs;
+				if (TheGlobalData->m_replaySnapshotInterval > 0)
+				{
+					extraArgs.format(L" -replaySnapshotInterval %d -replaySnapshotCount %d%s",
+						TheGlobalData->m_replaySnapshotInterval,
+						TheGlobalData->m_replaySnapshotCount,
+						TheGlobalData->m_replaySnapshotDump ? L" -replaySnapshotDump" : L"");
+				}
+				AsciiString workerReportFile = getWorkerReportFile(filenamePositionStarted);
+				if (workerReportFile.isNotEmpty())
+				{
+					UnicodeString reportFileWide;
+					reportFileWide.translate(workerReportFile);
+					UnicodeString reportArgs;
+					reportArgs.format(L" -replayReport \"%s\"", reportFileWide.str());
+					extraArgs.concat(reportArgs);
+				}
+				UnicodeString command;
+				command.format(L"\"%s\"%s%s%s -replay \"%s\"",
+					exePath.str(),
+					TheGlobalData->m_windowed ? L" -win" : L"",
+					TheGlobalData->m_headless ? L" -headless" : L"",
+					extraArgs.str(),
+					filenameWide.str());
+
+				processes.back().startProcess(command);
+			}
 
 			filenamePositionStarted++;
 			numProcessesRunning++;
@@ -194,6 +417,15 @@ int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiSt
 	DEBUG_ASSERTCRASH(filenamePositionStarted == filenames.size(), ("inconsistent file position 1"));
 	DEBUG_ASSERTCRASH(filenamePositionDone == filenames.size(), ("inconsistent file position 2"));
 
+	if (TheGlobalData->m_replayReportFile.isNotEmpty())
+	{
+		if (!ReplayReport::writeFile(TheGlobalData->m_replayReportFile, reportEntries, GetTickCount()-totalStartTimeMillis))
+		{
+			printf("Cannot write replay report \"%s\"\n", TheGlobalData->m_replayReportFile.str());
+			numErrors++;
+		}
+	}
+
 	printf("Simulation of all replays completed. Errors occurred: %d\n", numErrors);
 
 	UnsignedInt realTime = (GetTickCount()-totalStartTimeMillis) / 1000;
@@ -248,7 +480,8 @@ std::vector<AsciiString> ReplaySimulation::resolveFilenameWildcards(const std::v
 int ReplaySimulation::simulateReplays(const std::vector<AsciiString> &filenames, int maxProcesses)
 {
 	std::vector<AsciiString> filenamesResolved = resolveFilenameWildcards(filenames);
-	if (maxProcesses == SIMULATE_REPLAYS_SEQUENTIAL)
+	// TheSuperHackers @info The CRC tree is appended to a single file, so the replays must not run in parallel.
+	if (maxProcesses == SIMULATE_REPLAYS_SEQUENTIAL || TheGlobalData->m_crcTreeFile.isNotEmpty())
 		return simulateReplaysInThisProcess(filenamesResolved);
 	else
 		return simulateReplaysInWorkerProcesses(filenamesResolved, maxProcesses);
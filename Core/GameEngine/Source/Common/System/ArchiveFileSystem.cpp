@@ -210,6 +210,17 @@ void ArchiveFileSystem::loadIntoDirectoryTree(ArchiveFile *archiveFile, Bool ove
 	}
 }
 
+void ArchiveFileSystem::loadIndexCache()
+{
+	// The tools create the archive file system without any global data
+	if (TheGlobalData == NULL)
+		return;
+
+	AsciiString cacheFilename;
+	cacheFilename.format("%sArchiveIndex.cache", TheGlobalData->getPath_UserData().str());
+	m_indexCache.load(cacheFilename);
+}
+
 void ArchiveFileSystem::loadMods()
 {
 	if (TheGlobalData->m_modBIG.isNotEmpty())
@@ -236,6 +247,8 @@ void ArchiveFileSystem::loadMods()
 		loadBigFilesFromDirectory(TheGlobalData->m_modDir, "*.big", TRUE);
 		DEBUG_ASSERTLOG(ret, ("loadBigFilesFromDirectory(%s) returned FALSE!", TheGlobalData->m_modDir.str()));
 	}
+
+	m_indexCache.save();
 }
 
 Bool ArchiveFileSystem::doesFileExist(const Char *filename, FileInstance instance) const
@@ -0,0 +1,318 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "Common/ArchiveIndexCache.h"
+
+#include "Common/ArchiveFile.h"
+#include "Common/ArchiveFileSystem.h"
+#include "Common/file.h"
+#include "Common/LocalFileSystem.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+const UnsignedInt ArchiveIndexCacheMagic = 0x49474942; // "BIGI"
+const UnsignedInt ArchiveIndexCacheVersion = 1;
+
+struct PackedEntryHeader
+{
+	UnsignedInt offset;
+	UnsignedInt size;
+	UnsignedShort pathLength;
+	UnsignedShort filenameLength;
+};
+
+template <typename Type>
+void appendValue(std::vector<char> &buffer, const Type &value)
+{
+	const char *bytes = reinterpret_cast<const char *>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(Type));
+}
+
+template <typename Type>
+Bool readValue(const char *&pos, const char *end, Type &value)
+{
+	if (end - pos < (ptrdiff_t)sizeof(Type))
+		return FALSE;
+	memcpy(&value, pos, sizeof(Type));
+	pos += sizeof(Type);
+	return TRUE;
+}
+
+// Pack the files of the directory and of all the directories below it, the way restoreArchive adds them.
+Bool packDirectory(const DetailedArchivedDirectoryInfo &dirInfo, const AsciiString &path, std::vector<char> &entries)
+{
+	for (ArchivedFileInfoMap::const_iterator it = dirInfo.m_files.begin(); it != dirInfo.m_files.end(); ++it)
+	{
+		const ArchivedFileInfo &fileInfo = it->second;
+		if (path.getLength() > 0xffff || fileInfo.m_filename.getLength() > 0xffff)
+			return FALSE;
+
+		PackedEntryHeader header;
+		header.offset = fileInfo.m_offset;
+		header.size = fileInfo.m_size;
+		header.pathLength = (UnsignedShort)path.getLength();
+		header.filenameLength = (UnsignedShort)fileInfo.m_filename.getLength();
+
+		appendValue(entries, header);
+		entries.insert(entries.end(), path.str(), path.str() + header.pathLength);
+		entries.insert(entries.end(), fileInfo.m_filename.str(), fileInfo.m_filename.str() + header.filenameLength);
+	}
+
+	for (DetailedArchivedDirectoryInfoMap::const_iterator it = dirInfo.m_directories.begin(); it != dirInfo.m_directories.end(); ++it)
+	{
+		AsciiString subPath;
+		subPath.format("%s%s\\", path.str(), it->second.m_directoryName.str());
+		if (!packDirectory(it->second, subPath, entries))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+} // namespace
+
+ArchiveIndexCache::ArchiveIndexCache()
+	: m_loaded(FALSE)
+	, m_dirty(FALSE)
+{
+}
+
+Bool ArchiveIndexCache::getArchiveStamp( const AsciiString& archiveFilename, ArchiveStamp &stamp )
+{
+	FileInfo fileInfo;
+	if (!TheLocalFileSystem->getFileInfo(archiveFilename, &fileInfo))
+		return FALSE;
+
+	stamp.sizeHigh = fileInfo.sizeHigh;
+	stamp.sizeLow = fileInfo.sizeLow;
+	stamp.timestampHigh = fileInfo.timestampHigh;
+	stamp.timestampLow = fileInfo.timestampLow;
+	return TRUE;
+}
+
+void ArchiveIndexCache::load( const AsciiString& cacheFilename )
+{
+	m_cacheFilename = cacheFilename;
+	m_loaded = TRUE;
+
+	if (!TheLocalFileSystem->doesFileExist(cacheFilename.str()))
+		return;
+
+	File *file = TheLocalFileSystem->openFile(cacheFilename.str(), File::READ | File::BINARY);
+	if (file == NULL)
+		return;
+
+	std::vector<char> buffer(file->size());
+	Int bytesRead = buffer.empty() ? 0 : file->read(&buffer[0], (Int)buffer.size());
+	file->close();
+
+	if (bytesRead != (Int)buffer.size() || buffer.empty())
+		return;
+
+	const char *pos = &buffer[0];
+	const char *end = pos + buffer.size();
+
+	UnsignedInt magic = 0;
+	UnsignedInt version = 0;
+	UnsignedInt numArchives = 0;
+	if (!readValue(pos, end, magic) || !readValue(pos, end, version) || !readValue(pos, end, numArchives) ||
+		magic != ArchiveIndexCacheMagic || version != ArchiveIndexCacheVersion)
+	{
+		DEBUG_LOG(("ArchiveIndexCache::load - ignoring outdated cache %s", cacheFilename.str()));
+		return;
+	}
+
+	for (UnsignedInt i = 0; i < numArchives; ++i)
+	{
+		UnsignedShort nameLength = 0;
+		ArchiveStamp stamp;
+		UnsignedInt entriesSize = 0;
+		if (!readValue(pos, end, nameLength) || end - pos < nameLength)
+			break;
+		AsciiString archiveFilename;
+		archiveFilename.set(pos, nameLength);
+		pos += nameLength;
+
+		if (!readValue(pos, end, stamp) || !readValue(pos, end, entriesSize) || (UnsignedInt)(end - pos) < entriesSize)
+			break;
+
+		ArchiveIndex &index = m_archives[archiveFilename];
+		index.stamp = stamp;
+		index.saved = TRUE;
+		index.entries.assign(pos, pos + entriesSize);
+		pos += entriesSize;
+	}
+
+	DEBUG_LOG(("ArchiveIndexCache::load - %d archives in %s", (Int)m_archives.size(), cacheFilename.str()));
+}
+
+void ArchiveIndexCache::save( void )
+{
+	if (m_cacheFilename.isEmpty())
+		return;
+
+	// Archives that were not loaded are left out of the file, so that the archives that are gone do not
+	// stay in it forever. They are kept in memory in case they are still loaded later, by loadMods.
+	Bool dirty = m_dirty;
+	UnsignedInt numArchives = 0;
+	ArchiveIndexMap::iterator it;
+	for (it = m_archives.begin(); it != m_archives.end(); ++it)
+	{
+		if (it->second.loaded)
+			++numArchives;
+		else if (it->second.saved)
+			dirty = TRUE;
+	}
+
+	if (!dirty)
+		return;
+
+	std::vector<char> buffer;
+	appendValue(buffer, ArchiveIndexCacheMagic);
+	appendValue(buffer, ArchiveIndexCacheVersion);
+	appendValue(buffer, numArchives);
+
+	for (it = m_archives.begin(); it != m_archives.end(); ++it)
+	{
+		if (!it->second.loaded)
+			continue;
+
+		appendValue(buffer, (UnsignedShort)it->first.getLength());
+		buffer.insert(buffer.end(), it->first.str(), it->first.str() + it->first.getLength());
+		appendValue(buffer, it->second.stamp);
+		appendValue(buffer, (UnsignedInt)it->second.entries.size());
+		buffer.insert(buffer.end(), it->second.entries.begin(), it->second.entries.end());
+	}
+
+	// Write to a file of our own and move it in place, so that processes starting at the
+	// same time never read a partially written cache.
+	AsciiString tempFilename;
+#ifdef _WIN32
+	tempFilename.format("%s.%u", m_cacheFilename.str(), (UnsignedInt)GetCurrentProcessId());
+#else
+	tempFilename.format("%s.%u", m_cacheFilename.str(), (UnsignedInt)getpid());
+#endif
+
+	File *file = TheLocalFileSystem->openFile(tempFilename.str(), File::WRITE | File::CREATE | File::TRUNCATE | File::BINARY);
+	if (file == NULL)
+		return;
+
+	Int bytesWritten = file->write(&buffer[0], (Int)buffer.size());
+	file->close();
+
+	if (bytesWritten != (Int)buffer.size())
+	{
+		remove(tempFilename.str());
+		return;
+	}
+
+#ifdef _WIN32
+	if (!MoveFileExA(tempFilename.str(), m_cacheFilename.str(), MOVEFILE_REPLACE_EXISTING))
+#else
+	if (rename(tempFilename.str(), m_cacheFilename.str()) != 0)
+#endif
+	{
+		remove(tempFilename.str());
+		return;
+	}
+
+	for (it = m_archives.begin(); it != m_archives.end(); ++it)
+		it->second.saved = it->second.loaded;
+	m_dirty = FALSE;
+}
+
+Bool ArchiveIndexCache::restoreArchive( const AsciiString& archiveFilename, ArchiveFile *archiveFile )
+{
+	if (!m_loaded)
+		return FALSE;
+
+	ArchiveIndexMap::iterator it = m_archives.find(archiveFilename);
+	if (it == m_archives.end())
+		return FALSE;
+
+	ArchiveStamp stamp;
+	if (!getArchiveStamp(archiveFilename, stamp) || memcmp(&stamp, &it->second.stamp, sizeof(stamp)) != 0)
+		return FALSE;
+
+	const std::vector<char> &entries = it->second.entries;
+	if (entries.empty())
+		return FALSE;
+
+	ArchivedFileInfo fileInfo;
+	fileInfo.m_archiveFilename = archiveFilename;
+	fileInfo.m_archiveFilename.toLower();
+
+	AsciiString path;
+	const char *pos = &entries[0];
+	const char *end = pos + entries.size();
+	while (pos < end)
+	{
+		PackedEntryHeader header;
+		if (!readValue(pos, end, header) || end - pos < header.pathLength + header.filenameLength)
+		{
+			DEBUG_CRASH(("ArchiveIndexCache::restoreArchive - corrupt index of %s", archiveFilename.str()));
+			return FALSE;
+		}
+
+		path.set(pos, header.pathLength);
+		pos += header.pathLength;
+		fileInfo.m_filename.set(pos, header.filenameLength);
+		pos += header.filenameLength;
+		fileInfo.m_offset = header.offset;
+		fileInfo.m_size = header.size;
+
+		archiveFile->addFile(path, &fileInfo);
+	}
+
+	it->second.loaded = TRUE;
+	if (!it->second.saved)
+		m_dirty = TRUE;
+	return TRUE;
+}
+
+void ArchiveIndexCache::storeArchive( const AsciiString& archiveFilename, const ArchiveFile *archiveFile )
+{
+	if (!m_loaded)
+		return;
+
+	ArchiveIndex index;
+	if (!getArchiveStamp(archiveFilename, index.stamp))
+		return;
+
+	// Walk the directory tree of the archive, which has every file it was given.
+	if (!packDirectory(*archiveFile->friend_getRootDirectory(), AsciiString::TheEmptyString, index.entries))
+	{
+		DEBUG_LOG(("ArchiveIndexCache::storeArchive - not caching %s, a path is too long", archiveFilename.str()));
+		if (m_archives.erase(archiveFilename) > 0)
+			m_dirty = TRUE;
+		return;
+	}
+
+	ArchiveIndex &cachedIndex = m_archives[archiveFilename];
+	cachedIndex.stamp = index.stamp;
+	cachedIndex.entries.swap(index.entries);
+	cachedIndex.loaded = TRUE;
+	m_dirty = TRUE;
+}
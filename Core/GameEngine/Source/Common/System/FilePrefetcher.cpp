@@ -0,0 +1,320 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "Common/FilePrefetcher.h"
+
+#include "Common/ArchiveFile.h"
+#include "Common/ArchiveFileSystem.h"
+#include "Common/LocalFileSystem.h"
+
+#include "thread.h"
+
+FilePrefetcher *TheFilePrefetcher = NULL;
+
+//-------------------------------------------------------------------------------------------------
+class FilePrefetchThreadClass : public ThreadClass
+{
+public:
+	FilePrefetchThreadClass( FilePrefetcher *prefetcher ) : ThreadClass("FilePrefetch"), m_prefetcher(prefetcher) {}
+
+	void Thread_Function();
+
+private:
+	FilePrefetcher *m_prefetcher;
+	FilePrefetcher::ArchiveHandle m_archive;
+};
+
+//-------------------------------------------------------------------------------------------------
+void FilePrefetchThreadClass::Thread_Function()
+{
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
+
+	while (m_prefetcher->waitAndReadJob(m_archive))
+	{
+		// each call sleeps until there is a job to read
+	}
+
+	m_archive.close();
+}
+
+//-------------------------------------------------------------------------------------------------
+void FilePrefetcher::ArchiveHandle::close( void )
+{
+	if (file != NULL)
+	{
+		fclose(file);
+		file = NULL;
+	}
+	path = NULL;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Read the raw bytes of an archived file through a file handle of our own, which stays open for
+	* the next file from the same archive. Runs on any thread and must not use the engine file systems
+	* or the memory manager. */
+//-------------------------------------------------------------------------------------------------
+Bool FilePrefetcher::ArchiveHandle::read( const char *archivePath, UnsignedInt offset, UnsignedInt size, char *data )
+{
+	if (path == NULL || strcmp(path, archivePath) != 0)
+	{
+		close();
+		file = fopen(archivePath, "rb");
+		if (file == NULL)
+			return FALSE;
+		path = archivePath;
+	}
+
+	return fseek(file, (long)offset, SEEK_SET) == 0 && fread(data, 1, size, file) == size;
+}
+
+//-------------------------------------------------------------------------------------------------
+FilePrefetcher::FilePrefetcher()
+	: m_nextToTake(0)
+	, m_nextToResolve(0)
+	, m_nextToRead(0)
+	, m_jobsReading(0)
+	, m_quitting(FALSE)
+{
+	m_jobsPending = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+	m_jobFinished = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	for (Int i = 0; i < NumWorkerThreads; ++i)
+	{
+		m_workerThreads[i] = NEW FilePrefetchThreadClass(this);
+		m_workerThreads[i]->Execute();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+FilePrefetcher::~FilePrefetcher()
+{
+	stop();
+
+	{
+		CriticalSectionClass::LockClass lock(m_mutex);
+		m_quitting = TRUE;
+	}
+	ReleaseSemaphore((HANDLE)m_jobsPending, NumWorkerThreads, NULL);
+
+	for (Int i = 0; i < NumWorkerThreads; ++i)
+	{
+		delete m_workerThreads[i];
+		m_workerThreads[i] = NULL;
+	}
+
+	CloseHandle((HANDLE)m_jobsPending);
+	CloseHandle((HANDLE)m_jobFinished);
+}
+
+//-------------------------------------------------------------------------------------------------
+void FilePrefetcher::start( const std::vector<AsciiString>& filenames )
+{
+	stop();
+
+	m_jobs.resize(filenames.size());
+	for (size_t i = 0; i < filenames.size(); ++i)
+	{
+		Job &job = m_jobs[i];
+		job.filename = filenames[i];
+		job.offset = 0;
+		job.size = 0;
+		job.data = NULL;
+		job.state = JOB_UNRESOLVED;
+	}
+
+	resolveJobs(MaxFilesAhead);
+}
+
+//-------------------------------------------------------------------------------------------------
+void FilePrefetcher::stop( void )
+{
+	// keep the workers from claiming more jobs, then wait until they put down the ones they hold
+	for (;;)
+	{
+		{
+			CriticalSectionClass::LockClass lock(m_mutex);
+			m_nextToRead = m_nextToResolve;
+			if (m_jobsReading == 0)
+				break;
+		}
+		WaitForSingleObject((HANDLE)m_jobFinished, INFINITE);
+	}
+
+	m_archive.close();
+
+	for (size_t j = 0; j < m_jobs.size(); ++j)
+	{
+		if (m_jobs[j].state != JOB_TAKEN)
+		{
+			delete [] m_jobs[j].data;
+		}
+	}
+
+	m_jobs.clear();
+	m_nextToTake = 0;
+	m_nextToResolve = 0;
+	m_nextToRead = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Look up where the next files live, up to but not including job 'upTo'. This touches the file
+	* systems and the memory manager, so it only ever runs on the main thread. */
+//-------------------------------------------------------------------------------------------------
+void FilePrefetcher::resolveJobs( Int upTo )
+{
+	const Int jobCount = (Int)m_jobs.size();
+	if (upTo > jobCount)
+		upTo = jobCount;
+
+	for (Int i = m_nextToResolve; i < upTo; ++i)
+	{
+		Job &job = m_jobs[i];
+		JobState state = JOB_FAILED;
+
+		// A loose file takes precedence over the archives, see FileSystem::openFile
+		if (TheArchiveFileSystem != NULL && !TheLocalFileSystem->doesFileExist(job.filename.str()))
+		{
+			ArchiveFile *archive = TheArchiveFileSystem->getArchiveFile(job.filename);
+			const ArchivedFileInfo *fileInfo = archive ? archive->friend_getArchivedFileInfo(job.filename) : NULL;
+			if (fileInfo != NULL)
+			{
+				job.archivePath = archive->getName();
+				job.offset = fileInfo->m_offset;
+				job.size = fileInfo->m_size;
+				job.data = MSGNEW("RAMFILE") char [ job.size ];
+				state = JOB_PENDING;
+			}
+		}
+
+		{
+			CriticalSectionClass::LockClass lock(m_mutex);
+			job.state = state;
+			m_nextToResolve = i + 1;
+		}
+
+		if (state == JOB_PENDING)
+			ReleaseSemaphore((HANDLE)m_jobsPending, 1, NULL);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Sleep until a job becomes pending, then claim the oldest pending job and read it. The main thread
+	* may have read the job itself in the meantime, in which case there is nothing to do. Returns FALSE
+	* when the workers are told to exit. */
+//-------------------------------------------------------------------------------------------------
+Bool FilePrefetcher::waitAndReadJob( ArchiveHandle &archive )
+{
+	WaitForSingleObject((HANDLE)m_jobsPending, INFINITE);
+
+	Int index = -1;
+	{
+		CriticalSectionClass::LockClass lock(m_mutex);
+		if (m_quitting)
+			return FALSE;
+
+		while (m_nextToRead < m_nextToResolve)
+		{
+			Int candidate = m_nextToRead++;
+			if (m_jobs[candidate].state == JOB_PENDING)
+			{
+				m_jobs[candidate].state = JOB_READING;
+				++m_jobsReading;
+				index = candidate;
+				break;
+			}
+		}
+	}
+
+	if (index >= 0)
+	{
+		readJob(index, archive);
+
+		{
+			CriticalSectionClass::LockClass lock(m_mutex);
+			--m_jobsReading;
+		}
+		SetEvent((HANDLE)m_jobFinished);
+	}
+
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+void FilePrefetcher::readJob( Int index, ArchiveHandle &archive )
+{
+	Job &job = m_jobs[index];
+	const Bool success = archive.read(job.archivePath.str(), job.offset, job.size, job.data);
+
+	CriticalSectionClass::LockClass lock(m_mutex);
+	job.state = success ? JOB_DONE : JOB_FAILED;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Hand over the contents of the next file in the sequence. Files must be taken in the order they
+	* were given to start(). Returns FALSE if the file was not prefetched, in which case the caller
+	* opens it through the file system as usual. */
+//-------------------------------------------------------------------------------------------------
+Bool FilePrefetcher::takeFile( const AsciiString& filename, char *&data, UnsignedInt &size )
+{
+	if (m_nextToTake >= (Int)m_jobs.size() || m_jobs[m_nextToTake].filename != filename)
+		return FALSE;
+
+	const Int index = m_nextToTake++;
+	resolveJobs(index + 1 + MaxFilesAhead);
+
+	Job &job = m_jobs[index];
+	for (;;)
+	{
+		JobState state;
+		{
+			CriticalSectionClass::LockClass lock(m_mutex);
+			state = job.state;
+			if (state == JOB_PENDING)
+			{
+				// no worker got to it yet, read it here rather than wait
+				job.state = JOB_READING;
+			}
+			else if (state == JOB_DONE)
+			{
+				job.state = JOB_TAKEN;
+			}
+		}
+
+		switch (state)
+		{
+			case JOB_PENDING:
+				readJob(index, m_archive);
+				break;
+
+			case JOB_READING:
+				// a worker has it, sleep until one of them finishes a job
+				WaitForSingleObject((HANDLE)m_jobFinished, INFINITE);
+				break;
+
+			case JOB_DONE:
+				data = job.data;
+				size = job.size;
+				return TRUE;
+
+			default:
+				return FALSE;
+		}
+	}
+}
@@ -1491,6 +1491,126 @@ void Checkpointable::debugResetCheckpoints()
 // METHODS for MemoryPool
 //-----------------------------------------------------------------------------
 
+#ifdef MEMORYPOOL_THREAD_CACHE
+// the thread cache slot of the calling thread: 0 if not yet assigned, -1 if the thread has none, else slot+1
+#if defined(_MSC_VER) && _MSC_VER < 1900
+static __declspec(thread) Int theThreadCacheSlot = 0;
+#else
+static thread_local Int theThreadCacheSlot = 0;
+#endif
+static Bool theThreadCacheSlotInUse[MEMORYPOOL_THREAD_CACHE_SLOTS];
+
+//-----------------------------------------------------------------------------
+/**
+	give the calling thread the first free cache slot. a thread that exits should hand its slot
+	back with releaseThreadMemoryPoolCaches(), or the slot and its cached blocks stay taken.
+*/
+static Int assignThreadCacheSlot()
+{
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	theThreadCacheSlot = -1;
+	for (Int i = 0; i < MEMORYPOOL_THREAD_CACHE_SLOTS; ++i)
+	{
+		if (!theThreadCacheSlotInUse[i])
+		{
+			theThreadCacheSlotInUse[i] = TRUE;
+			theThreadCacheSlot = i + 1;
+			break;
+		}
+	}
+
+	return theThreadCacheSlot;
+}
+
+//-----------------------------------------------------------------------------
+inline MemoryPool::ThreadCache *MemoryPool::getThreadCache()
+{
+	Int slot = theThreadCacheSlot;
+	if (slot == 0)
+		slot = assignThreadCacheSlot();
+
+	return slot > 0 ? &m_threadCaches[slot - 1] : NULL;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	take up to MEMORYPOOL_THREAD_CACHE_BATCH blocks from the blobs that have free blocks.
+	never creates a blob; the caller does that when the pool is really out of blocks.
+*/
+void MemoryPool::fillThreadCache(ThreadCache *cache)
+{
+	while (cache->m_blockCount < MEMORYPOOL_THREAD_CACHE_BATCH)
+	{
+		if (m_firstBlobWithFreeBlocks == NULL || !m_firstBlobWithFreeBlocks->hasAnyFreeBlocks())
+		{
+			MemoryPoolBlob *blob = m_firstBlob;
+			for (; blob != NULL; blob = blob->getNextInList())
+			{
+				if (blob->hasAnyFreeBlocks())
+					break;
+			}
+			m_firstBlobWithFreeBlocks = blob;
+			if (blob == NULL)
+				break;
+		}
+
+		MemoryPoolSingleBlock *block = m_firstBlobWithFreeBlocks->allocateSingleBlock();
+		block->setNextFreeBlock(cache->m_firstBlock);
+		cache->m_firstBlock = block;
+		++cache->m_blockCount;
+
+		// the blobs count cached blocks as used; getUsedBlockCount() subtracts them again
+		++m_usedBlocksInPool;
+	}
+}
+
+//-----------------------------------------------------------------------------
+/**
+	hand blocks back to their blobs until only 'keep' blocks are left in the cache.
+*/
+void MemoryPool::drainThreadCache(ThreadCache *cache, Int keep)
+{
+	while (cache->m_blockCount > keep)
+	{
+		MemoryPoolSingleBlock *block = cache->m_firstBlock;
+		cache->m_firstBlock = block->getNextFreeBlock();
+		--cache->m_blockCount;
+
+		MemoryPoolBlob *blob = block->getOwningBlob();
+		blob->freeSingleBlock(block);
+		if (!m_firstBlobWithFreeBlocks)
+			m_firstBlobWithFreeBlocks = blob;
+
+		--m_usedBlocksInPool;
+	}
+}
+
+//-----------------------------------------------------------------------------
+/**
+	the counts of other threads' caches are read without locking, so the result is only
+	exact when no other thread is using this pool at the same time.
+*/
+Int MemoryPool::getThreadCachedBlockCount()
+{
+	Int cached = 0;
+	for (Int i = 0; i < MEMORYPOOL_THREAD_CACHE_SLOTS; ++i)
+	{
+		cached += m_threadCaches[i].m_blockCount;
+	}
+	return cached;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	hand all blocks in the given slot's cache back to the blobs. must hold the lock.
+*/
+void MemoryPool::releaseThreadCache(Int slot)
+{
+	drainThreadCache(&m_threadCaches[slot], 0);
+}
+#endif // MEMORYPOOL_THREAD_CACHE
+
 //-----------------------------------------------------------------------------
 /**
 	init to safe values.
@@ -1509,6 +1629,9 @@ MemoryPool::MemoryPool() :
 	m_lastBlob(NULL),
 	m_firstBlobWithFreeBlocks(NULL)
 {
+#ifdef MEMORYPOOL_THREAD_CACHE
+	memset(m_threadCaches, 0, sizeof(m_threadCaches));
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -1529,6 +1652,9 @@ void MemoryPool::init(MemoryPoolFactory *factory, const char *poolName, Int allo
 	m_firstBlob = NULL;
 	m_lastBlob = NULL;
 	m_firstBlobWithFreeBlocks = NULL;
+#ifdef MEMORYPOOL_THREAD_CACHE
+	DEBUG_ASSERTCRASH(getThreadCachedBlockCount() == 0, ("thread caches of pool %s are not empty", poolName));
+#endif
 
 	// go ahead and init the initial block here (will throw on failure)
 	createBlob(m_initialAllocationCount);
@@ -1628,6 +1754,17 @@ Int MemoryPool::freeBlob(MemoryPoolBlob* blob)
 */
 void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG1)
 {
+#ifdef MEMORYPOOL_THREAD_CACHE
+	ThreadCache *cache = getThreadCache();
+	if (cache != NULL && cache->m_firstBlock != NULL)
+	{
+		MemoryPoolSingleBlock *cachedBlock = cache->m_firstBlock;
+		cache->m_firstBlock = cachedBlock->getNextFreeBlock();
+		--cache->m_blockCount;
+		return cachedBlock->getUserData();
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
 
 	if (m_firstBlobWithFreeBlocks != NULL && !m_firstBlobWithFreeBlocks->hasAnyFreeBlocks())
@@ -1675,8 +1812,19 @@ void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG
 
 	// bookkeeping
 	++m_usedBlocksInPool;
+#ifdef MEMORYPOOL_THREAD_CACHE
+	// the peak is only sampled here, so it may miss up to a cache's worth of blocks
+	const Int usedBlocks = getUsedBlockCount();
+	if (m_peakUsedBlocksInPool < usedBlocks)
+		m_peakUsedBlocksInPool = usedBlocks;
+
+	// take the next few blocks while we hold the lock anyway
+	if (cache != NULL)
+		fillThreadCache(cache);
+#else
 	if (m_peakUsedBlocksInPool < m_usedBlocksInPool)
 		m_peakUsedBlocksInPool = m_usedBlocksInPool;
+#endif
 
 #ifdef MEMORYPOOL_DEBUG
 	m_factory->adjustTotals(debugLiteralTagString, 1*getAllocationSize(), 0);
@@ -1713,6 +1861,26 @@ void MemoryPool::freeBlock(void* pBlockPtr)
 	if (!pBlockPtr)
 		return;	// my, that was easy
 
+#ifdef MEMORYPOOL_THREAD_CACHE
+	ThreadCache *cache = getThreadCache();
+	if (cache != NULL)
+	{
+		MemoryPoolSingleBlock *cachedBlock = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
+		DEBUG_ASSERTCRASH(cachedBlock->getOwningBlob() && cachedBlock->getOwningBlob()->getOwningPool() == this, ("block does not belong to this pool"));
+		if (cache->m_blockCount >= MEMORYPOOL_THREAD_CACHE_SIZE)
+		{
+			// full; give a batch back to the blobs. blocks freed by other threads than the
+			// one that allocated them also find their way back here.
+			ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+			drainThreadCache(cache, MEMORYPOOL_THREAD_CACHE_SIZE - MEMORYPOOL_THREAD_CACHE_BATCH);
+		}
+		cachedBlock->setNextFreeBlock(cache->m_firstBlock);
+		cache->m_firstBlock = cachedBlock;
+		++cache->m_blockCount;
+		return;
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
 
 	MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
@@ -1795,6 +1963,15 @@ void MemoryPool::reset()
 {
 	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
 
+#ifdef MEMORYPOOL_THREAD_CACHE
+	// the cached blocks live in the blobs that are about to go. the other threads must not be
+	// using this pool during a reset, so their caches can be emptied from here.
+	for (Int slot = 0; slot < MEMORYPOOL_THREAD_CACHE_SLOTS; ++slot)
+	{
+		releaseThreadCache(slot);
+	}
+#endif
+
 	// toss everything. we could do this slightly more efficiently,
 	// but not really worth the extra code to do so.
 	while (m_firstBlob)
@@ -2161,6 +2338,16 @@ void DynamicMemoryAllocator::debugIgnoreLeaksForThisBlock(void* pBlockPtr)
 */
 void *DynamicMemoryAllocator::allocateBytesDoNotZeroImplementation(Int numBytes DECLARE_LITERALSTRING_ARG2)
 {
+#ifdef MEMORYPOOL_THREAD_CACHE
+	// the subpools are fixed after init and do their own locking, so only the raw blocks need the
+	// dma lock. m_usedBlocksInDma then only counts raw blocks.
+	{
+		MemoryPool *pool = findPoolForSize(numBytes);
+		if (pool != NULL)
+			return pool->allocateBlockDoNotZeroImplementation(PASS_LITERALSTRING_ARG1);
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheDmaCriticalSection);
 
 	void *result = NULL;
@@ -2277,6 +2464,17 @@ void DynamicMemoryAllocator::freeBytes(void* pBlockPtr)
 	if (!pBlockPtr)
 		return;
 
+#ifdef MEMORYPOOL_THREAD_CACHE
+	{
+		MemoryPoolBlob *blob = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr)->getOwningBlob();
+		if (blob != NULL)
+		{
+			blob->getOwningPool()->freeBlock(pBlockPtr);
+			return;
+		}
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheDmaCriticalSection);
 
 #ifdef MEMORYPOOL_CHECK_BLOCK_OWNERSHIP
@@ -3545,6 +3743,32 @@ void shutdownMemoryManager()
 	DEBUG_SHUTDOWN();
 }
 
+//-----------------------------------------------------------------------------
+/**
+	hand the blocks the calling thread keeps cached back to their pools and free its cache slot
+	for the next thread. safe to call from threads that never used the pools.
+*/
+void releaseThreadMemoryPoolCaches()
+{
+#ifdef MEMORYPOOL_THREAD_CACHE
+	const Int slot = theThreadCacheSlot;
+	theThreadCacheSlot = 0;
+	if (slot <= 0)
+		return;
+
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	if (TheMemoryPoolFactory)
+	{
+		for (MemoryPool *pool = TheMemoryPoolFactory->getFirstMemoryPool(); pool; pool = pool->getNextPoolInList())
+		{
+			pool->releaseThreadCache(slot - 1);
+		}
+	}
+	theThreadCacheSlotInUse[slot - 1] = FALSE;
+#endif
+}
+
 //-----------------------------------------------------------------------------
 void* createW3DMemPool(const char *poolName, int allocationSize)
 {
@@ -26,7 +26,6 @@ static PoolSizeRec PoolSizes[] =
 	{ "MusicTrack", 32, 32 },
 	{ "PositionalSoundPool", 32, 32 },
 	{ "GameMessage", 2048, 32 },
-	{ "NameKeyBucketPool", 9000, 1024 },
 	{ "ObjectSellInfo", 16, 16 },
 	{ "ProductionPrerequisitePool", 1024, 32 },
 	{ "RadarObject", 512, 32 },
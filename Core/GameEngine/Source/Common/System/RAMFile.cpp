@@ -104,7 +104,8 @@
 RAMFile::RAMFile()
 : m_size(0),
 	m_data(NULL),
-	m_pos(0)
+	m_pos(0),
+	m_ownsData(TRUE)
 {
 
 }
@@ -211,7 +212,7 @@ Bool RAMFile::openFromArchive(File *archiveFile, const AsciiString& filename, In
 		return FALSE;
 	}
 
-	delete[] m_data;
+	closeFile();
 	m_data = MSGNEW("RAMFILE") Char [size];	// pool[]ify
 	m_size = size;
 
@@ -226,6 +227,36 @@ Bool RAMFile::openFromArchive(File *archiveFile, const AsciiString& filename, In
 	return TRUE;
 }
 
+//============================================================================
+// RAMFile::openFromMemory
+//============================================================================
+/**
+	* TheSuperHackers @performance Opens a read only view of memory that is owned by
+	* someone else, for example a memory mapped archive, instead of copying it.
+	*/
+//============================================================================
+
+Bool RAMFile::openFromMemory(const AsciiString& filename, const Char *data, Int size)
+{
+	if (data == NULL && size > 0) {
+		return FALSE;
+	}
+
+	if (File::open(filename.str(), File::READ | File::BINARY) == FALSE) {
+		return FALSE;
+	}
+
+	closeFile();
+	m_data = const_cast<Char *>(data);
+	m_ownsData = FALSE;
+	m_size = size;
+	m_pos = 0;
+
+	m_nameStr = filename;
+
+	return TRUE;
+}
+
 //=================================================================
 // RAMFile::close
 //=================================================================
@@ -245,8 +276,12 @@ void RAMFile::close( void )
 
 void RAMFile::closeFile()
 {
-	delete [] m_data;
+	if (m_ownsData)
+	{
+		delete [] m_data;
+	}
 	m_data = NULL;
+	m_ownsData = TRUE;
 }
 
 //=================================================================
@@ -556,6 +591,12 @@ char* RAMFile::readEntireAndClose()
 	}
 
 	char* tmp = m_data;
+	if (!m_ownsData)
+	{
+		// the caller needs a buffer it can delete
+		tmp = NEW char[m_size];
+		memcpy(tmp, m_data, m_size);
+	}
 	m_data = NULL;	// will belong to our caller!
 
 	close();
@@ -31,6 +31,7 @@
 #include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
 
 #include "Common/XferCRC.h"
+#include "Common/XferCRCTree.h"
 #include "Common/XferDeepCRC.h"
 #include "Common/crc.h"
 #include "Common/Snapshot.h"
@@ -341,3 +342,313 @@ void XferDeepCRC::xferUnicodeString( UnicodeString *unicodeStringData )
 		xferUser( (void *)unicodeStringData->str(), sizeof( WideChar ) * len );
 
 }
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferDeepCRCMemory::XferDeepCRCMemory( void )
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferDeepCRCMemory::~XferDeepCRCMemory( void )
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Start collecting data for 'identifier' */
+//-------------------------------------------------------------------------------------------------
+void XferDeepCRCMemory::open( AsciiString identifier )
+{
+
+	m_xferMode = XFER_SAVE;
+
+	// call base class of the file implementation
+	Xfer::open( identifier );
+
+	// keep the capacity of the previous session, snapshots tend to have a similar size
+	m_data.clear();
+
+	// initialize CRC to brand new one at zero
+	m_crc = 0;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Stop collecting data */
+//-------------------------------------------------------------------------------------------------
+void XferDeepCRCMemory::close( void )
+{
+
+	// erase the identifier
+	m_identifier.clear();
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Perform a single CRC operation on the data passed in and store the data */
+//-------------------------------------------------------------------------------------------------
+void XferDeepCRCMemory::xferImplementation( void *data, Int dataSize )
+{
+
+	if (!data || dataSize < 1)
+	{
+		return;
+	}
+
+	const UnsignedByte *bytes = static_cast<const UnsignedByte *>(data);
+	m_data.insert( m_data.end(), bytes, bytes + dataSize );
+
+	XferCRC::xferImplementation( data, dataSize );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferCRCTree::XferCRCTree( void )
+{
+
+	m_labelsWritten = 0;
+	m_inMarker = FALSE;
+	m_fileHeaderWritten = FALSE;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferCRCTree::~XferCRCTree( void )
+{
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Start a new tree, the labels are kept across sessions */
+//-------------------------------------------------------------------------------------------------
+void XferCRCTree::open( AsciiString identifier )
+{
+
+	// call base class
+	XferCRC::open( identifier );
+
+	// keep the capacity of the previous session, the trees of consecutive frames are alike
+	m_nodes.clear();
+	m_openNodes.clear();
+	m_openCRCs.clear();
+	m_openChildCounts.clear();
+	m_inMarker = FALSE;
+
+	beginNode( "Frame", 0 );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** End all nodes that are still open */
+//-------------------------------------------------------------------------------------------------
+void XferCRCTree::close( void )
+{
+
+	while( !m_openNodes.empty() )
+	{
+		endNode();
+	}
+	m_inMarker = FALSE;
+
+	XferCRC::close();
+
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+UnsignedShort XferCRCTree::findLabel( const char *label )
+{
+
+	// snapshots are labeled by their class, so there can be a few hundred distinct labels
+	AsciiString name( label );
+	LabelMap::const_iterator it = m_labelIndices.find( name );
+	if( it != m_labelIndices.end() )
+		return it->second;
+
+	UnsignedShort count = (UnsignedShort)m_labels.size();
+	DEBUG_ASSERTCRASH( m_labels.size() < 0xFFFF, ("Too many CRC tree labels") );
+	m_labels.push_back( name );
+	m_labelIndices[name] = count;
+	return count;
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Start a child node of the current node */
+//-------------------------------------------------------------------------------------------------
+void XferCRCTree::beginNode( const char *label, UnsignedInt id )
+{
+
+	if( !m_openChildCounts.empty() )
+	{
+		++m_openChildCounts.back();
+	}
+
+	Node node;
+	node.label = findLabel( label );
+	node.depth = (UnsignedShort)m_openNodes.size();
+	node.id = id;
+	node.crc = 0;
+	node.subtreeSize = 1;
+
+	m_openNodes.push_back( (Int)m_nodes.size() );
+	m_openCRCs.push_back( 0 );
+	m_openChildCounts.push_back( 0 );
+	m_nodes.push_back( node );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** End the current node and fold its CRC into the parent node */
+//-------------------------------------------------------------------------------------------------
+void XferCRCTree::endNode( void )
+{
+
+	if( m_openNodes.empty() )
+	{
+		DEBUG_CRASH(( "XferCRCTree::endNode - no open node" ));
+		return;
+	}
+
+	Int index = m_openNodes.back();
+	UnsignedInt crc = m_openCRCs.back();
+	m_openNodes.pop_back();
+	m_openCRCs.pop_back();
+	m_openChildCounts.pop_back();
+
+	Node &node = m_nodes[index];
+	node.crc = crc;
+	node.subtreeSize = (UnsignedInt)(m_nodes.size() - index);
+
+	if( !m_openCRCs.empty() )
+	{
+		UnsignedInt &parentCRC = m_openCRCs.back();
+		parentCRC = (parentCRC << 1) + crc + ((parentCRC >> 31) & 0x01);
+	}
+
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Every snapshot becomes a node named after its class, identified by its ordinal among its siblings */
+// ------------------------------------------------------------------------------------------------
+void XferCRCTree::xferSnapshot( Snapshot *snapshot )
+{
+
+	if( snapshot == NULL )
+	{
+
+		return;
+
+	}
+
+	beginNode( snapshot->getSnapshotName().str(), m_openChildCounts.empty() ? 0 : m_openChildCounts.back() );
+	snapshot->crc( this );
+	endNode();
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Top level markers like "MARKER:Objects" start a new node that lasts until the next marker */
+//-------------------------------------------------------------------------------------------------
+void XferCRCTree::xferAsciiString( AsciiString *asciiStringData )
+{
+
+	static const char markerPrefix[] = "MARKER:";
+	const size_t markerPrefixLength = sizeof( markerPrefix ) - 1;
+
+	size_t topLevelDepth = m_inMarker ? 2 : 1;
+	if( m_openNodes.size() == topLevelDepth &&
+			strncmp( asciiStringData->str(), markerPrefix, markerPrefixLength ) == 0 )
+	{
+		if( m_inMarker )
+		{
+			endNode();
+		}
+		beginNode( asciiStringData->str() + markerPrefixLength, 0 );
+		m_inMarker = TRUE;
+	}
+
+	XferCRC::xferAsciiString( asciiStringData );
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** CRC the data exactly like XferCRC and also into the current node */
+//-------------------------------------------------------------------------------------------------
+void XferCRCTree::xferImplementation( void *data, Int dataSize )
+{
+
+	XferCRC::xferImplementation( data, dataSize );
+
+	if( !m_openCRCs.empty() )
+	{
+		UnsignedInt crc = m_crc;
+		m_crc = m_openCRCs.back();
+		XferCRC::xferImplementation( data, dataSize );
+		m_openCRCs.back() = m_crc;
+		m_crc = crc;
+	}
+
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Append the tree of the last session to the file, preceded by the labels the file lacks */
+//-------------------------------------------------------------------------------------------------
+Bool XferCRCTree::writeFrame( FILE *fp, UnsignedInt frame )
+{
+
+	if( fp == NULL )
+		return FALSE;
+
+	if( !m_fileHeaderWritten )
+	{
+		UnsignedInt header[2];
+		header[0] = htole( (UnsignedInt)CRCTREE_FILE_MAGIC );
+		header[1] = htole( (UnsignedInt)CRCTREE_FILE_VERSION );
+		if( fwrite( header, sizeof( header ), 1, fp ) != 1 )
+			return FALSE;
+		m_fileHeaderWritten = TRUE;
+	}
+
+	for( ; m_labelsWritten < m_labels.size(); ++m_labelsWritten )
+	{
+		const AsciiString &label = m_labels[m_labelsWritten];
+		UnsignedByte tag = 'L';
+		UnsignedShort length = htole( (UnsignedShort)label.getLength() );
+		if( fwrite( &tag, sizeof( tag ), 1, fp ) != 1 ||
+				fwrite( &length, sizeof( length ), 1, fp ) != 1 ||
+				fwrite( label.str(), label.getLength(), 1, fp ) != 1 )
+			return FALSE;
+	}
+
+	UnsignedByte tag = 'F';
+	UnsignedInt frameHeader[3];
+	frameHeader[0] = htole( frame );
+	frameHeader[1] = htole( getCRC() );
+	frameHeader[2] = htole( (UnsignedInt)m_nodes.size() );
+	if( fwrite( &tag, sizeof( tag ), 1, fp ) != 1 ||
+			fwrite( frameHeader, sizeof( frameHeader ), 1, fp ) != 1 )
+		return FALSE;
+
+	std::vector<Node>::const_iterator it;
+	for( it = m_nodes.begin(); it != m_nodes.end(); ++it )
+	{
+		Node node;
+		node.label = htole( it->label );
+		node.depth = htole( it->depth );
+		node.id = htole( it->id );
+		node.crc = htole( it->crc );
+		node.subtreeSize = htole( it->subtreeSize );
+		if( fwrite( &node, sizeof( node ), 1, fp ) != 1 )
+			return FALSE;
+	}
+
+	fflush( fp );
+	return TRUE;
+
+}
@@ -19,6 +19,17 @@
 #include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
 #include "Common/WorkerProcess.h"
 
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#endif
+
 // We need Job-related functions, but these aren't defined in the Windows-headers that VC6 uses.
 // So we define them here and load them dynamically.
 #if defined(_MSC_VER) && _MSC_VER < 1300
@@ -67,13 +78,35 @@ static PFN_AssignProcessToJobObject AssignProcessToJobObject = (PFN_AssignProces
 
 WorkerProcess::WorkerProcess()
 {
+#ifdef _WIN32
 	m_processHandle = NULL;
 	m_readHandle = NULL;
 	m_jobHandle = NULL;
+#else
+	m_processId = -1;
+	m_readHandle = -1;
+#endif
 	m_exitcode = 0;
 	m_isDone = false;
 }
 
+bool WorkerProcess::isDone() const
+{
+	return m_isDone;
+}
+
+DWORD WorkerProcess::getExitCode() const
+{
+	return m_exitcode;
+}
+
+AsciiString WorkerProcess::getStdOutput() const
+{
+	return m_stdOutput;
+}
+
+#ifdef _WIN32
+
 bool WorkerProcess::startProcess(UnicodeString command)
 {
 	m_stdOutput.clear();
@@ -123,24 +156,19 @@ bool WorkerProcess::startProcess(UnicodeString command)
 	return true;
 }
 
-bool WorkerProcess::isRunning() const
+bool WorkerProcess::startForkedProcess(ForkedFunction func, void *userData)
 {
-	return m_processHandle != NULL;
+	return false;
 }
 
-bool WorkerProcess::isDone() const
+bool WorkerProcess::canForkProcess()
 {
-	return m_isDone;
+	return false;
 }
 
-DWORD WorkerProcess::getExitCode() const
-{
-	return m_exitcode;
-}
-
-AsciiString WorkerProcess::getStdOutput() const
+bool WorkerProcess::isRunning() const
 {
-	return m_stdOutput;
+	return m_processHandle != NULL;
 }
 
 bool WorkerProcess::fetchStdOutput()
@@ -229,3 +257,193 @@ void WorkerProcess::kill()
 	m_isDone = false;
 }
 
+
+#else // _WIN32
+
+namespace
+{
+// Creates the pipe that receives the console output of the worker.
+// The read end is non-blocking so that update() never stalls.
+bool createOutputPipe(int &readHandle, int &writeHandle)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+		return false;
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+	readHandle = fds[0];
+	writeHandle = fds[1];
+	return true;
+}
+
+// Must be called in the child right after fork. Only uses async-signal-safe functions.
+void setupChildProcess(int writeHandle)
+{
+#ifdef __linux__
+	// We want to make sure that when our process is killed, our workers automatically terminate as well.
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+	dup2(writeHandle, STDOUT_FILENO);
+	dup2(writeHandle, STDERR_FILENO);
+	if (writeHandle != STDOUT_FILENO && writeHandle != STDERR_FILENO)
+		close(writeHandle);
+}
+} // namespace
+
+bool WorkerProcess::startProcess(UnicodeString command)
+{
+	m_stdOutput.clear();
+	m_isDone = false;
+
+	AsciiString commandAscii;
+	commandAscii.translate(command);
+
+	int writeHandle = -1;
+	if (!createOutputPipe(m_readHandle, writeHandle))
+		return false;
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(writeHandle);
+		close(m_readHandle);
+		m_readHandle = -1;
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		setupChildProcess(writeHandle);
+		execl("/bin/sh", "sh", "-c", commandAscii.str(), (char *)NULL);
+		_exit(127);
+	}
+
+	close(writeHandle);
+	m_processId = pid;
+	return true;
+}
+
+bool WorkerProcess::startForkedProcess(ForkedFunction func, void *userData)
+{
+	m_stdOutput.clear();
+	m_isDone = false;
+
+	int writeHandle = -1;
+	if (!createOutputPipe(m_readHandle, writeHandle))
+		return false;
+
+	// Flush pending output now, otherwise the child would print it a second time.
+	fflush(stdout);
+	fflush(stderr);
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(writeHandle);
+		close(m_readHandle);
+		m_readHandle = -1;
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		setupChildProcess(writeHandle);
+		int exitcode = func(userData);
+		fflush(stdout);
+		fflush(stderr);
+		// Skip all static destructors and atexit handlers. They belong to the parent.
+		_exit(exitcode);
+	}
+
+	close(writeHandle);
+	m_processId = pid;
+	return true;
+}
+
+bool WorkerProcess::canForkProcess()
+{
+	return true;
+}
+
+bool WorkerProcess::isRunning() const
+{
+	return m_processId > 0;
+}
+
+bool WorkerProcess::fetchStdOutput()
+{
+	while (true)
+	{
+		DEBUG_ASSERTCRASH(m_readHandle >= 0, ("Is not expected invalid"));
+		char buffer[1024];
+		ssize_t readBytes = read(m_readHandle, buffer, ARRAY_SIZE(buffer)-1);
+		if (readBytes < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				// Child process is still running and we have all output so far
+				return false;
+			}
+			return true;
+		}
+		if (readBytes == 0)
+		{
+			// All write ends are closed, the child has exited
+			return true;
+		}
+
+		buffer[readBytes] = 0;
+		m_stdOutput.concat(buffer);
+	}
+}
+
+void WorkerProcess::update()
+{
+	if (!isRunning())
+		return;
+
+	if (!fetchStdOutput())
+	{
+		// There is still potential output pending
+		return;
+	}
+
+	// Pipe broke, that means the process already exited. But we call this just to make sure
+	int status = 0;
+	while (waitpid(m_processId, &status, 0) < 0 && errno == EINTR)
+	{
+	}
+	m_exitcode = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+	m_processId = -1;
+
+	close(m_readHandle);
+	m_readHandle = -1;
+
+	m_isDone = true;
+}
+
+void WorkerProcess::kill()
+{
+	if (!isRunning())
+		return;
+
+	if (m_processId > 0)
+	{
+		::kill(m_processId, SIGKILL);
+		waitpid(m_processId, NULL, 0);
+		m_processId = -1;
+	}
+
+	if (m_readHandle >= 0)
+	{
+		close(m_readHandle);
+		m_readHandle = -1;
+	}
+
+	m_stdOutput.clear();
+	m_isDone = false;
+}
+
+#endif // _WIN32
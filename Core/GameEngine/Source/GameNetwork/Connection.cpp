@@ -30,6 +30,8 @@
 #include "GameLogic/GameLogic.h"
 
 enum { MaxQuitFlushTime = 30000 }; // wait this many milliseconds at most to retry things before quitting
+enum { FormatAnnouncementInterval = 1000 }; // milliseconds between the packets that tell the other end we read the compact format
+enum { MaxFormatAnnouncements = 30 }; // give up on an other end that never answers them, it does not know the format
 
 /**
  * The constructor.
@@ -44,6 +46,9 @@ Connection::Connection() {
 	m_isQuitting = false;
 	m_quitTime = 0;
 	m_averageLatency = 0.0f;
+	m_compactFormat = FALSE;
+	m_numFormatAnnouncements = 0;
+	m_lastFormatAnnouncement = 0;
 	Int i;
 	for(i = 0; i < CONNECTION_LATENCY_HISTORY_LENGTH; i++)
 	{
@@ -88,6 +93,10 @@ void Connection::init() {
 	m_averageLatency = 0;
 	m_isQuitting = FALSE;
 	m_quitTime = 0;
+
+	m_compactFormat = FALSE;
+	m_numFormatAnnouncements = 0;
+	m_lastFormatAnnouncement = 0;
 }
 
 /**
@@ -148,10 +157,16 @@ void Connection::sendNetCommandMsg(NetCommandMsg *msg, UnsignedByte relay) {
 		// resend the ENTIRE command (i.e. multiple packets work of data) and only do the retry
 		// one wrapper command at a time.
 		packet->reset();
+		packet->setCompact(m_compactFormat);
 
 		NetCommandRef *tempref = NEW_NETCOMMANDREF(msg);
 
 		Bool msgFits = packet->addCommand(tempref);
+		if (!msgFits && m_compactFormat) {
+			// a few commands take more room in the compact format, doSend() sends those in the old one.
+			packet->reset();
+			msgFits = packet->addCommand(tempref);
+		}
 		deleteInstance(tempref); // delete the temporary reference.
 		tempref = NULL;
 
@@ -261,6 +276,8 @@ UnsignedInt Connection::doSend() {
 		return 0;
 	}
 
+	announceCompactFormat(curtime);
+
 	if ((curtime - m_lastTimeSent) < m_frameGrouping) {
 //		DEBUG_LOG(("not sending packet, time = %d, m_lastFrameSent = %d, m_frameGrouping = %d", curtime, m_lastTimeSent, m_frameGrouping));
 		return 0;
@@ -273,6 +290,7 @@ UnsignedInt Connection::doSend() {
 		NetPacket *packet = newInstance(NetPacket);
 		packet->init();
 		packet->setAddress(m_user->GetIPAddr(), m_user->GetPort());
+		packet->setCompact(m_compactFormat);
 
 		Bool notDone = TRUE;
 
@@ -284,6 +302,11 @@ UnsignedInt Connection::doSend() {
 
 			if (((curtime - timeLastSent) > m_retryTime) || (timeLastSent == -1)) {
 				notDone = packet->addCommand(msg);
+				if (!notDone && packet->getNumCommands() == 0 && packet->isCompact()) {
+					// the command only fits into a packet in the old format.
+					packet->setCompact(FALSE);
+					notDone = packet->addCommand(msg);
+				}
 				if (notDone) {
 					// the msg command was added to the packet.
 					if (CommandRequiresAck(msg->getCommand())) {
@@ -311,7 +334,9 @@ UnsignedInt Connection::doSend() {
 		if (packet->getNumCommands() > 0) {
 			// If the packet actually has any information to give, give it to the transport object
 			// for transmission.
-			couldQueue = m_transport->queueSend(packet->getAddr(), packet->getPort(), packet->getData(), packet->getLength());
+			packet->compress();
+			couldQueue = m_transport->queueSend(packet->getAddr(), packet->getPort(), packet->getData(), packet->getLength(),
+				packet->isCompact() ? GENERALS_COMPACT_MAGIC_NUMBER : GENERALS_MAGIC_NUMBER);
 			m_lastTimeSent = curtime;
 		}
 
@@ -321,6 +346,27 @@ UnsignedInt Connection::doSend() {
 	return numpackets;
 }
 
+/**
+ * Until the other end sends us a packet in the compact format, send it an empty one every so often to
+ * tell it that it may. An other end that does not know the format drops these as foreign packets.
+ */
+void Connection::announceCompactFormat(time_t curtime) {
+	if (m_compactFormat || m_isQuitting || m_numFormatAnnouncements >= MaxFormatAnnouncements) {
+		return;
+	}
+	if (m_numFormatAnnouncements > 0 && (curtime - m_lastFormatAnnouncement) < FormatAnnouncementInterval) {
+		return;
+	}
+
+	NetPacket *packet = newInstance(NetPacket);
+	packet->setCompact(TRUE);
+	if (m_transport->queueSend(m_user->GetIPAddr(), m_user->GetPort(), packet->getData(), packet->getLength(), GENERALS_COMPACT_MAGIC_NUMBER)) {
+		++m_numFormatAnnouncements;
+		m_lastFormatAnnouncement = curtime;
+	}
+	deleteInstance(packet);
+}
+
 NetCommandRef * Connection::processAck(NetAckStage1CommandMsg *msg) {
 	return processAck(msg->getCommandID(), msg->getOriginalPlayerID());
 }
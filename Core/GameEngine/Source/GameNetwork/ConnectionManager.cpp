@@ -356,6 +356,17 @@ void ConnectionManager::doRelay() {
 			// make a NetPacket out of this data so it can be broken up into individual commands.
 			packet = newInstance(NetPacket)(&(m_transport->m_inBuffer[i]));
 
+			// TheSuperHackers @performance Answer a packet in the compact format in kind.
+			if (packet->isCompact()) {
+				for (Int slot = 0; slot < MAX_SLOTS; ++slot) {
+					Connection *connection = m_connections[slot];
+					if (connection != NULL && !connection->usesCompactFormat() && connection->getUser() != NULL &&
+						connection->getUser()->GetIPAddr() == packet->getAddr() && connection->getUser()->GetPort() == packet->getPort()) {
+						connection->enableCompactFormat();
+					}
+				}
+			}
+
 			//DEBUG_LOG(("ConnectionManager::doRelay() - got a packet with %d commands", packet->getNumCommands()));
 			//LOGBUFFER( packet->getData(), packet->getLength() );
 
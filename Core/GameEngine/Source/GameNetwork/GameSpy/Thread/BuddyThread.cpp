@@ -257,6 +257,8 @@ GPProfile GameSpyBuddyMessageQueue::getLocalProfileID( void )
 
 void BuddyThreadClass::Thread_Function()
 {
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
+
 	try {
 	GPConnection gpCon;
 	GPConnection *con = &gpCon;
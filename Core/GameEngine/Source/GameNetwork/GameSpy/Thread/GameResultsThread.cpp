@@ -205,6 +205,8 @@ Bool GameResultsQueue::areGameResultsBeingSent( void )
 
 void GameResultsThreadClass::Thread_Function()
 {
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
+
 	try {
 	GameResultsRequest req;
 
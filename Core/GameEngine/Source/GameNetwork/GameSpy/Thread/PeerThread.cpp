@@ -1152,6 +1152,8 @@ static UnsignedInt localIP = 0;
 
 void PeerThreadClass::Thread_Function()
 {
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
+
 	try {
 
 	PEER peer;
@@ -805,6 +805,8 @@ static void getPreorderCallback(int localid, int profileid, persisttype_t type,
 
 void PSThreadClass::Thread_Function()
 {
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
+
 	try {
 	/*********
 	First step, set our game authentication info
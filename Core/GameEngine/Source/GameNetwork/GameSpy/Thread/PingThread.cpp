@@ -243,6 +243,8 @@ AsciiString Pinger::getPingString( Int timeout )
 
 void PingThreadClass::Thread_Function()
 {
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
+
 	try {
 	PingRequest req;
 
@@ -0,0 +1,298 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "GameNetwork/LoopbackTransport.h"
+
+namespace
+{
+const UnsignedInt LoopbackAddress = 0x7f000001;	// where packets from a socket bound to any address come from
+const UnsignedInt BroadcastAddress = 0xffffffff;
+const UnsignedShort FirstEphemeralPort = 49152;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+LoopbackNetwork::Settings::Settings()
+{
+	latency = 0;
+	jitter = 0;
+	packetLoss = 0.0f;
+	bandwidth = 0;
+	maxQueueDelay = 0;
+	seed = 0;
+}
+
+LoopbackNetwork::LoopbackNetwork()
+{
+	m_randomState = m_settings.seed;
+	m_manualClock = FALSE;
+	m_now = 0;
+	m_nextEphemeralPort = FirstEphemeralPort;
+	resetStatistics();
+}
+
+LoopbackNetwork::~LoopbackNetwork()
+{
+	for (size_t i = 0; i < m_sockets.size(); ++i)
+	{
+		m_sockets[i]->m_network = NULL;
+		m_sockets[i]->m_bound = FALSE;
+	}
+}
+
+void LoopbackNetwork::setSettings( const Settings &settings )
+{
+	m_settings = settings;
+	m_randomState = settings.seed;
+}
+
+void LoopbackNetwork::resetStatistics( void )
+{
+	memset(&m_statistics, 0, sizeof(m_statistics));
+}
+
+void LoopbackNetwork::useManualClock( UnsignedInt now )
+{
+	m_manualClock = TRUE;
+	m_now = now;
+}
+
+void LoopbackNetwork::advanceClock( UnsignedInt milliseconds )
+{
+	DEBUG_ASSERTCRASH(m_manualClock, ("LoopbackNetwork::advanceClock - the network runs on timeGetTime()"));
+	m_now += milliseconds;
+}
+
+UnsignedInt LoopbackNetwork::getTime( void ) const
+{
+	return m_manualClock ? m_now : timeGetTime();
+}
+
+// A generator of its own, so that the jitter and the losses do not depend on the game's random seeds.
+UnsignedInt LoopbackNetwork::nextRandom( void )
+{
+	m_randomState = m_randomState * 1664525U + 1013904223U;
+	return m_randomState >> 8;
+}
+
+LoopbackSocket *LoopbackNetwork::findSocket( UnsignedInt ip, UnsignedShort port ) const
+{
+	LoopbackSocket *anyAddress = NULL;
+	for (size_t i = 0; i < m_sockets.size(); ++i)
+	{
+		LoopbackSocket *socket = m_sockets[i];
+		if (socket->m_port != port)
+			continue;
+		if (socket->m_ip == ip)
+			return socket;
+		if (socket->m_ip == 0)
+			anyAddress = socket;
+	}
+	return anyAddress;
+}
+
+Int LoopbackNetwork::bind( LoopbackSocket *socket, UnsignedInt ip, UnsignedShort port )
+{
+	if (port == 0)
+	{
+		// pick a free port, like the system does for a real socket
+		for (Int tries = 0; tries < 0x10000 - FirstEphemeralPort; ++tries)
+		{
+			UnsignedShort candidate = m_nextEphemeralPort;
+			m_nextEphemeralPort = (m_nextEphemeralPort == 0xffff) ? FirstEphemeralPort : m_nextEphemeralPort + 1;
+			if (findSocket(ip, candidate) == NULL)
+			{
+				port = candidate;
+				break;
+			}
+		}
+		if (port == 0)
+			return TransportSocket::ADDRINUSE;
+	}
+
+	LoopbackSocket *other = findSocket(ip, port);
+	if (other != NULL && other->m_ip == ip)
+		return TransportSocket::ADDRINUSE;
+
+	socket->m_ip = ip;
+	socket->m_port = port;
+	socket->m_bound = TRUE;
+	m_sockets.push_back(socket);
+	return TransportSocket::OK;
+}
+
+void LoopbackNetwork::unbind( LoopbackSocket *socket )
+{
+	for (size_t i = 0; i < m_sockets.size(); ++i)
+	{
+		if (m_sockets[i] == socket)
+		{
+			m_sockets.erase(m_sockets.begin() + i);
+			break;
+		}
+	}
+	socket->m_bound = FALSE;
+}
+
+void LoopbackNetwork::send( LoopbackSocket *from, const UnsignedByte *buf, Int len, UnsignedInt ip, UnsignedShort port )
+{
+	++m_statistics.sentPackets;
+	m_statistics.sentBytes += len;
+
+	UnsignedInt now = getTime();
+	UnsignedInt departureTime = now;
+	if (m_settings.bandwidth > 0)
+	{
+		// the packet leaves once the ones sent before it have
+		UnsignedInt64 nowMicroseconds = (UnsignedInt64)now * 1000;
+		UnsignedInt64 start = from->m_sendFreeTime > nowMicroseconds ? from->m_sendFreeTime : nowMicroseconds;
+		if (m_settings.maxQueueDelay > 0 && start - nowMicroseconds > (UnsignedInt64)m_settings.maxQueueDelay * 1000)
+		{
+			++m_statistics.droppedPackets;
+			return;
+		}
+		from->m_sendFreeTime = start + (UnsignedInt64)len * 1000000 / m_settings.bandwidth;
+		departureTime = (UnsignedInt)(from->m_sendFreeTime / 1000);
+	}
+
+	if (m_settings.packetLoss > 0.0f && (Real)(nextRandom() % 10000) < m_settings.packetLoss * 100.0f)
+	{
+		++m_statistics.lostPackets;
+		return;
+	}
+
+	UnsignedInt deliveryTime = departureTime + m_settings.latency;
+	if (m_settings.jitter > 0)
+		deliveryTime += nextRandom() % (m_settings.jitter + 1);
+
+	Packet packet;
+	packet.fromIP = (from->m_ip != 0) ? from->m_ip : LoopbackAddress;
+	packet.fromPort = from->m_port;
+	packet.data.assign(buf, buf + len);
+
+	if (ip == BroadcastAddress)
+	{
+		Bool delivered = FALSE;
+		for (size_t i = 0; i < m_sockets.size(); ++i)
+		{
+			if (m_sockets[i] != from && m_sockets[i]->m_port == port)
+			{
+				deliver(m_sockets[i], packet, deliveryTime);
+				delivered = TRUE;
+			}
+		}
+		if (!delivered)
+			++m_statistics.unreachablePackets;
+		return;
+	}
+
+	LoopbackSocket *to = findSocket(ip, port);
+	if (to == NULL)
+	{
+		++m_statistics.unreachablePackets;
+		return;
+	}
+	deliver(to, packet, deliveryTime);
+}
+
+void LoopbackNetwork::deliver( LoopbackSocket *to, const Packet &packet, UnsignedInt deliveryTime )
+{
+	to->m_incoming.insert(LoopbackSocket::PacketQueue::value_type(deliveryTime, packet));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+LoopbackSocket::LoopbackSocket( LoopbackNetwork *network )
+{
+	m_network = network;
+	m_bound = FALSE;
+	m_ip = 0;
+	m_port = 0;
+	m_allowBroadcasts = FALSE;
+	m_status = OK;
+	m_sendFreeTime = 0;
+}
+
+LoopbackSocket::~LoopbackSocket()
+{
+	if (m_network && m_bound)
+		m_network->unbind(this);
+}
+
+Int LoopbackSocket::Bind( UnsignedInt IP, UnsignedShort port )
+{
+	if (!m_network)
+		m_status = NOTSOCK;
+	else if (m_bound)
+		m_status = INVAL;
+	else
+		m_status = (sockStat)m_network->bind(this, IP, port);
+	return m_status;
+}
+
+Int LoopbackSocket::Write( const unsigned char *msg, UnsignedInt len, UnsignedInt IP, UnsignedShort port )
+{
+	// This happens frequently
+	if ((IP == 0) || (port == 0))
+		return ADDRNOTAVAIL;
+
+	m_status = OK;
+	if (!m_network || !m_bound)
+	{
+		m_status = NOTSOCK;
+		return -1;
+	}
+	if (IP == BroadcastAddress && !m_allowBroadcasts)
+	{
+		m_status = INVAL;
+		return -1;
+	}
+
+	m_network->send(this, msg, len, IP, port);
+	return len;
+}
+
+Int LoopbackSocket::Read( unsigned char *msg, UnsignedInt len, sockaddr_in *from )
+{
+	if (!m_network || !m_bound)
+	{
+		m_status = NOTSOCK;
+		return -1;
+	}
+
+	// nothing has arrived yet
+	if (m_incoming.empty() || m_incoming.begin()->first > m_network->getTime())
+		return 0;
+
+	const LoopbackNetwork::Packet &packet = m_incoming.begin()->second;
+	UnsignedInt size = packet.data.size() < len ? (UnsignedInt)packet.data.size() : len;
+	if (size > 0)
+		memcpy(msg, &packet.data[0], size);
+	if (from != NULL)
+	{
+		memset(from, 0, sizeof(*from));
+		from->sin_family = AF_INET;
+		from->sin_addr.s_addr = htonl(packet.fromIP);
+		from->sin_port = htons(packet.fromPort);
+	}
+	m_incoming.erase(m_incoming.begin());
+	++m_network->m_statistics.deliveredPackets;
+	return size;
+}
@@ -160,14 +160,30 @@ static Int indexFromMask(UnsignedInt mask)
 
 /**
  * Construct a new GameMessage object from the data in this object.
+ * Returns NULL if the command comes from a player that is not in the game.
  */
 GameMessage *NetGameCommandMsg::constructGameMessage()
 {
-	GameMessage *retval = newInstance(GameMessage)(m_type);
-
 	AsciiString name;
 	name.format("player%d", getPlayerID());
-	retval->friend_setPlayerIndex( ThePlayerList->findPlayerWithNameKey(TheNameKeyGenerator->nameToKey(name))->getPlayerIndex());
+	Player *player = ThePlayerList->findPlayerWithNameKey(TheNameKeyGenerator->nameToKey(name));
+	if (player == NULL) {
+		DEBUG_CRASH(("NetGameCommandMsg::constructGameMessage - command %d of type %d comes from unknown player %d", getID(), m_type, getPlayerID()));
+		return NULL;
+	}
+
+	GameMessage *retval = constructGameMessageArguments();
+	retval->friend_setPlayerIndex(player->getPlayerIndex());
+	return retval;
+}
+
+/**
+ * Construct a new GameMessage object with the type and arguments of this object only.
+ * The player index is not set, so this is only good for writing the command into a packet.
+ */
+GameMessage *NetGameCommandMsg::constructGameMessageArguments()
+{
+	GameMessage *retval = newInstance(GameMessage)(m_type);
 
 	GameMessageArgument *arg = m_argList;
 	while (arg != NULL) {
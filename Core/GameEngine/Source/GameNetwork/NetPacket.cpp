@@ -31,6 +31,7 @@
 #include "GameNetwork/NetworkDefs.h"
 #include "GameNetwork/networkutil.h"
 #include "GameNetwork/GameMessageParser.h"
+#include "Compression.h"
 
 // TheSuperHackers @refactor BobTista 10/06/2025 Extract magic character literals into named constants for improved readability
 typedef UnsignedByte NetPacketFieldType;
@@ -42,6 +43,164 @@ namespace NetPacketFieldTypes {
 	constexpr const NetPacketFieldType CommandId = 'C';			// Command ID field
 	constexpr const NetPacketFieldType Frame = 'F';				// Frame field
 	constexpr const NetPacketFieldType Data = 'D';				// Data payload field
+	constexpr const NetPacketFieldType FrameDelta = 'f';		// Frame field, as the difference to the frame before (compact packets only)
+}
+
+// TheSuperHackers @performance The first byte of a compact packet.
+namespace CompactPacketFormats {
+	constexpr const UnsignedByte Plain = 0;
+	constexpr const UnsignedByte Compressed = 1;				// the rest of the packet went through the CompressionManager
+}
+
+namespace
+{
+// Smaller packets are not worth compressing, the compressed data has a header of some 14 bytes.
+const Int MinCompressedPacketLength = 128;
+
+// Writes the fields of a compact packet, and remembers if they did not fit.
+class CompactWriter
+{
+public:
+	CompactWriter( UnsignedByte *buffer, Int size ) : m_buffer(buffer), m_size(size), m_length(0) {}
+
+	void writeByte( UnsignedByte value )
+	{
+		if (m_length < m_size)
+			m_buffer[m_length] = value;
+		++m_length;
+	}
+
+	void writeBytes( const void *data, Int length )
+	{
+		for (Int i = 0; i < length; ++i)
+			writeByte(((const UnsignedByte *)data)[i]);
+	}
+
+	// Seven bits to the byte, lowest first. The top bit is set on all but the last byte.
+	void writeVarInt( UnsignedInt value )
+	{
+		while (value >= 0x80)
+		{
+			writeByte((UnsignedByte)(value | 0x80));
+			value >>= 7;
+		}
+		writeByte((UnsignedByte)value);
+	}
+
+	// Zigzag encoded, so that small negative values take a byte too.
+	void writeSignedVarInt( Int value )
+	{
+		writeVarInt(((UnsignedInt)value << 1) ^ (UnsignedInt)(value >> 31));
+	}
+
+	Int getLength() const { return m_length; }
+	Bool fits() const { return m_length <= m_size; }
+
+private:
+	UnsignedByte *m_buffer;
+	Int m_size;
+	Int m_length;
+};
+
+// The readers return FALSE rather than read past the length of the packet.
+Bool readBytes( const UnsignedByte *data, Int &i, Int length, void *value, Int size )
+{
+	if (i + size > length)
+		return FALSE;
+	memcpy(value, data + i, size);
+	i += size;
+	return TRUE;
+}
+
+// Also FALSE for a value of more than five bytes, which no writer makes.
+Bool readVarInt( const UnsignedByte *data, Int &i, Int length, UnsignedInt &value )
+{
+	value = 0;
+	for (Int shift = 0; shift < 35; shift += 7)
+	{
+		if (i >= length)
+			return FALSE;
+		UnsignedByte b = data[i++];
+		value |= (UnsignedInt)(b & 0x7f) << shift;
+		if ((b & 0x80) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+Bool readSignedVarInt( const UnsignedByte *data, Int &i, Int length, Int &value )
+{
+	UnsignedInt zigzag = 0;
+	if (!readVarInt(data, i, length, zigzag))
+		return FALSE;
+	value = (Int)(zigzag >> 1) ^ -(Int)(zigzag & 1);
+	return TRUE;
+}
+
+// The data section of a game command in a compact packet. Each object ID is written as the difference
+// to the one before it, which is passed on from command to command.
+void writeCompactGameMessage( CompactWriter &writer, GameMessage *gmsg, ObjectID &lastObjectID )
+{
+	writer.writeVarInt((UnsignedInt)gmsg->getType());
+
+	GameMessageParser *parser = newInstance(GameMessageParser)(gmsg);
+	writer.writeByte((UnsignedByte)parser->getNumTypes());
+	GameMessageParserArgumentType *argType = parser->getFirstArgumentType();
+	while (argType != NULL) {
+		writer.writeByte((UnsignedByte)argType->getType());
+		writer.writeByte((UnsignedByte)argType->getArgCount());
+		argType = argType->getNext();
+	}
+	deleteInstance(parser);
+	parser = NULL;
+
+	Int numArgs = gmsg->getArgumentCount();
+	for (Int i = 0; i < numArgs; ++i) {
+		const GameMessageArgumentType *arg = gmsg->getArgument(i);
+
+		switch (gmsg->getArgumentDataType(i)) {
+
+		case ARGUMENTDATATYPE_INTEGER:
+			writer.writeSignedVarInt(arg->integer);
+			break;
+		case ARGUMENTDATATYPE_REAL:
+			writer.writeBytes(&arg->real, sizeof(arg->real));
+			break;
+		case ARGUMENTDATATYPE_BOOLEAN:
+			writer.writeByte(arg->boolean ? 1 : 0);
+			break;
+		case ARGUMENTDATATYPE_OBJECTID:
+			writer.writeSignedVarInt((Int)((UnsignedInt)arg->objectID - (UnsignedInt)lastObjectID));
+			lastObjectID = arg->objectID;
+			break;
+		case ARGUMENTDATATYPE_DRAWABLEID:
+			writer.writeVarInt((UnsignedInt)arg->drawableID);
+			break;
+		case ARGUMENTDATATYPE_TEAMID:
+			writer.writeVarInt(arg->teamID);
+			break;
+		case ARGUMENTDATATYPE_LOCATION:
+			writer.writeBytes(&arg->location, sizeof(arg->location));
+			break;
+		case ARGUMENTDATATYPE_PIXEL:
+			writer.writeSignedVarInt(arg->pixel.x);
+			writer.writeSignedVarInt(arg->pixel.y);
+			break;
+		case ARGUMENTDATATYPE_PIXELREGION:
+			writer.writeSignedVarInt(arg->pixelRegion.lo.x);
+			writer.writeSignedVarInt(arg->pixelRegion.lo.y);
+			writer.writeSignedVarInt(arg->pixelRegion.hi.x);
+			writer.writeSignedVarInt(arg->pixelRegion.hi.y);
+			break;
+		case ARGUMENTDATATYPE_TIMESTAMP:
+			writer.writeVarInt(arg->timestamp);
+			break;
+		case ARGUMENTDATATYPE_WIDECHAR:
+			writer.writeVarInt((UnsignedInt)arg->wChar);
+			break;
+		}
+	}
+}
 }
 
 // This function assumes that all of the fields are either of default value or are
@@ -361,7 +520,7 @@ UnsignedInt NetPacket::GetGameCommandSize(NetCommandMsg *msg) {
 	msglen += sizeof(UnsignedShort) + sizeof(UnsignedByte); // command ID
 	msglen += sizeof(UnsignedByte); // the NetPacketFieldTypes::Data for the data section.
 
-	GameMessage *gmsg = cmdMsg->constructGameMessage();
+	GameMessage *gmsg = cmdMsg->constructGameMessageArguments();
 	GameMessageParser *parser = newInstance(GameMessageParser)(gmsg);
 
 	msglen += sizeof(GameMessage::Type);
@@ -892,7 +1051,7 @@ void NetPacket::FillBufferWithGameCommand(UnsignedByte *buffer, NetCommandRef *m
 	NetGameCommandMsg *cmdMsg = (NetGameCommandMsg *)(msg->getCommand());
 	UnsignedShort offset = 0;
 	// get the game message from the NetCommandMsg
-	GameMessage *gmsg = cmdMsg->constructGameMessage();
+	GameMessage *gmsg = cmdMsg->constructGameMessageArguments();
 
 	//DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::FillBufferWithGameCommand for command ID %d", cmdMsg->getID()));
 
@@ -2001,11 +2160,30 @@ NetPacket::NetPacket() {
  */
 NetPacket::NetPacket(TransportMessage *msg) {
 	init();
-	m_packetLen = msg->length;
+	// TheSuperHackers @bugfix Only MAX_PACKET_SIZE bytes fit into the packet, so a longer one must not be read any further.
+	m_packetLen = (msg->length < MAX_PACKET_SIZE) ? msg->length : MAX_PACKET_SIZE;
 	memcpy(m_packet, msg->data, MAX_PACKET_SIZE);
 	m_numCommands = -1;
 	m_addr = msg->addr;
 	m_port = msg->port;
+
+	m_compact = (msg->header.magic == GENERALS_COMPACT_MAGIC_NUMBER);
+	if (m_compact && m_packetLen > 0 && m_packet[0] == CompactPacketFormats::Compressed) {
+		// Only zlib checks the size of what it unpacks, so that is the only compression taken from the network.
+		m_packetLen = 0;
+		CompressionType compType = CompressionManager::getCompressionType(msg->data + 1, msg->length - 1);
+		if (compType >= COMPRESSION_ZLIB1 && compType <= COMPRESSION_ZLIB9) {
+			Int len = CompressionManager::decompressData(msg->data + 1, msg->length - 1, m_packet + 1, MAX_PACKET_SIZE - 1);
+			if (len > 0) {
+				m_packet[0] = CompactPacketFormats::Plain;
+				m_packetLen = len + 1;
+			}
+		}
+		if (m_packetLen == 0) {
+			DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket - could not decompress a packet of %d bytes from %d.%d.%d.%d:%d",
+				msg->length, PRINTF_IP_AS_4_INTS(m_addr), m_port));
+		}
+	}
 }
 
 /**
@@ -2033,6 +2211,9 @@ void NetPacket::init() {
 	m_lastRelay = 0;
 
 	m_lastCommand = NULL;
+
+	m_compact = FALSE;
+	m_lastObjectID = INVALID_ID;
 }
 
 void NetPacket::reset() {
@@ -2042,6 +2223,41 @@ void NetPacket::reset() {
 	init();
 }
 
+/**
+ * Switch an empty packet to the compact format, or back.
+ */
+void NetPacket::setCompact(Bool compact) {
+	DEBUG_ASSERTCRASH(m_numCommands == 0, ("NetPacket::setCompact - the packet already has commands"));
+	m_compact = compact;
+	if (m_compact) {
+		m_packet[0] = CompactPacketFormats::Plain;
+		m_packetLen = 1;
+	} else {
+		m_packetLen = 0;
+	}
+}
+
+/**
+ * Compress the commands of a compact packet, if that saves anything. The packet takes no more
+ * commands after this.
+ */
+void NetPacket::compress() {
+	if (!m_compact || m_packet[0] != CompactPacketFormats::Plain || m_packetLen < MinCompressedPacketLength) {
+		return;
+	}
+
+	const CompressionType compType = COMPRESSION_ZLIB1;
+	UnsignedByte buffer[MAX_PACKET_SIZE * 2];
+	DEBUG_ASSERTCRASH(CompressionManager::getMaxCompressedSize(m_packetLen - 1, compType) <= (Int)sizeof(buffer), ("NetPacket::compress - buffer too small"));
+
+	Int len = CompressionManager::compressData(compType, m_packet + 1, m_packetLen - 1, buffer, sizeof(buffer));
+	if (len > 0 && len + 1 < m_packetLen) {
+		m_packet[0] = CompactPacketFormats::Compressed;
+		memcpy(m_packet + 1, buffer, len);
+		m_packetLen = len + 1;
+	}
+}
+
 /**
  * Set the address to which this packet is to be sent.
  */
@@ -4729,10 +4945,14 @@ Bool NetPacket::isAckStage2Repeat(NetCommandRef *msg) {
  * Adds this game command to the packet.  Returns true if successful.
  */
 Bool NetPacket::addGameCommand(NetCommandRef *msg) {
+	if (m_compact) {
+		return addCompactGameCommand(msg);
+	}
+
 	Bool retval = FALSE;
 	NetGameCommandMsg *cmdMsg = (NetGameCommandMsg *)(msg->getCommand());
 	// get the game message from the NetCommandMsg
-	GameMessage *gmsg = cmdMsg->constructGameMessage();
+	GameMessage *gmsg = cmdMsg->constructGameMessageArguments();
 
 //	DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::addGameCommand for command ID %d", cmdMsg->getID()));
 
@@ -4849,6 +5069,71 @@ Bool NetPacket::addGameCommand(NetCommandRef *msg) {
 	return retval;
 }
 
+/**
+ * Adds this game command to a compact packet.  Returns true if successful.
+ */
+Bool NetPacket::addCompactGameCommand(NetCommandRef *msg) {
+	NetGameCommandMsg *cmdMsg = (NetGameCommandMsg *)(msg->getCommand());
+	GameMessage *gmsg = cmdMsg->constructGameMessageArguments();
+
+	// The size of the command depends on the one before it, so it is written aside until it is known to fit.
+	UnsignedByte buffer[MAX_PACKET_SIZE];
+	CompactWriter writer(buffer, MAX_PACKET_SIZE - m_packetLen);
+
+	Bool needNewCommandID = FALSE;
+	if (m_lastCommandType != cmdMsg->getNetCommandType()) {
+		writer.writeByte(NetPacketFieldTypes::CommandType);
+		writer.writeByte(cmdMsg->getNetCommandType());
+	}
+	if (m_lastFrame != cmdMsg->getExecutionFrame()) {
+		writer.writeByte(NetPacketFieldTypes::FrameDelta);
+		writer.writeSignedVarInt((Int)(cmdMsg->getExecutionFrame() - m_lastFrame));
+	}
+	if (m_lastRelay != msg->getRelay()) {
+		writer.writeByte(NetPacketFieldTypes::Relay);
+		writer.writeByte(msg->getRelay());
+	}
+	if (m_lastPlayerID != cmdMsg->getPlayerID()) {
+		writer.writeByte(NetPacketFieldTypes::PlayerId);
+		writer.writeByte(cmdMsg->getPlayerID());
+		needNewCommandID = TRUE;
+	}
+	if (((m_lastCommandID + 1) != (UnsignedShort)(cmdMsg->getID())) || (needNewCommandID == TRUE)) {
+		writer.writeByte(NetPacketFieldTypes::CommandId);
+		UnsignedShort newID = cmdMsg->getID();
+		writer.writeBytes(&newID, sizeof(newID));
+	}
+	writer.writeByte(NetPacketFieldTypes::Data);
+
+	ObjectID lastObjectID = m_lastObjectID;
+	writeCompactGameMessage(writer, gmsg, lastObjectID);
+
+	deleteInstance(gmsg);
+	gmsg = NULL;
+
+	if (!writer.fits()) {
+		return FALSE;
+	}
+
+	memcpy(m_packet + m_packetLen, buffer, writer.getLength());
+	m_packetLen += writer.getLength();
+
+	m_lastCommandType = cmdMsg->getNetCommandType();
+	m_lastFrame = cmdMsg->getExecutionFrame();
+	m_lastRelay = msg->getRelay();
+	m_lastPlayerID = cmdMsg->getPlayerID();
+	m_lastCommandID = cmdMsg->getID();
+	m_lastObjectID = lastObjectID;
+
+	++m_numCommands;
+
+	deleteInstance(m_lastCommand);
+	m_lastCommand = NEW_NETCOMMANDREF(msg->getCommand());
+	m_lastCommand->setRelay(msg->getRelay());
+
+	return TRUE;
+}
+
 void NetPacket::writeGameMessageArgumentToPacket(GameMessageArgumentDataType type, GameMessageArgumentType arg) {
 
 	switch(type) {
@@ -5007,9 +5292,11 @@ NetCommandList * NetPacket::getCommandList() {
 	UnsignedByte commandType = 0;
 	UnsignedByte relay = 0;
 	NetCommandRef *lastCommand = NULL;
+	ObjectID lastObjectID = INVALID_ID;
+	Bool malformed = FALSE;
 
-	Int i = 0;
-	while (i < m_packetLen) {
+	Int i = m_compact ? 1 : 0; // skip the format of a compact packet
+	while (i < m_packetLen && !malformed) {
 
 		switch(m_packet[i]) {
 
@@ -5023,6 +5310,16 @@ NetCommandList * NetPacket::getCommandList() {
 			memcpy(&frame, m_packet + i, sizeof(UnsignedInt));
 			i += sizeof(UnsignedInt);
 			break;
+		case NetPacketFieldTypes::FrameDelta: {
+			++i;
+			Int frameDelta = 0;
+			if (readSignedVarInt(m_packet, i, m_packetLen, frameDelta)) {
+				frame += (UnsignedInt)frameDelta;
+			} else {
+				malformed = TRUE;
+			}
+			break;
+		}
 		case NetPacketFieldTypes::PlayerId:
 			++i;
 			memcpy(&playerID, m_packet + i, sizeof(UnsignedByte));
@@ -5048,7 +5345,12 @@ NetCommandList * NetPacket::getCommandList() {
 			switch((NetCommandType)commandType)
 			{
 			case NETCOMMANDTYPE_GAMECOMMAND:
-				msg = readGameMessage(m_packet, i);
+				if (m_compact) {
+					msg = readCompactGameMessage(m_packet, i, m_packetLen, lastObjectID);
+					malformed = (msg == NULL);
+				} else {
+					msg = readGameMessage(m_packet, i);
+				}
 				//DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("read game command from player %d for frame %d", playerID, frame));
 				break;
 			case NETCOMMANDTYPE_ACKBOTH:
@@ -5156,6 +5458,10 @@ NetCommandList * NetPacket::getCommandList() {
 				break;
 			}
 
+			if (malformed) {
+				break;
+			}
+
 			if (msg == NULL) {
 				DEBUG_CRASH(("Didn't read a message from the packet. Things are about to go wrong."));
 				continue;
@@ -5282,6 +5588,14 @@ NetCommandList * NetPacket::getCommandList() {
 	deleteInstance(lastCommand);
 	lastCommand = NULL;
 
+	// TheSuperHackers @bugfix A compact packet that ends in the middle of a command, or has an argument of a type
+	// that does not exist, is dropped as a whole. Its other commands cannot be trusted either.
+	if (malformed) {
+		DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::getCommandList - dropping a malformed compact packet of %d bytes from %d.%d.%d.%d:%d",
+			m_packetLen, PRINTF_IP_AS_4_INTS(m_addr), m_port));
+		retval->reset();
+	}
+
 	return retval;
 }
 
@@ -5354,6 +5668,97 @@ NetCommandMsg * NetPacket::readGameMessage(UnsignedByte *data, Int &i)
 	return (NetCommandMsg *)msg;
 }
 
+/**
+ * Reads the data portion of a game message from the given position in a compact packet. Returns NULL
+ * if the message goes past the length of the packet or has an argument of an unknown type.
+ */
+NetCommandMsg * NetPacket::readCompactGameMessage(UnsignedByte *data, Int &i, Int length, ObjectID &lastObjectID)
+{
+	NetGameCommandMsg *msg = newInstance(NetGameCommandMsg);
+
+	UnsignedInt type = 0;
+	Bool valid = readVarInt(data, i, length, type);
+	msg->setGameMessageType((GameMessage::Type)type);
+
+	// Get the types and the number of arguments of those types.
+	UnsignedByte numArgTypes = 0;
+	valid = valid && readBytes(data, i, length, &numArgTypes, sizeof(numArgTypes));
+	UnsignedByte types[256];
+	UnsignedByte counts[256];
+	Int j = 0;
+	for (; valid && j < numArgTypes; ++j) {
+		valid = readBytes(data, i, length, &types[j], sizeof(types[j])) && readBytes(data, i, length, &counts[j], sizeof(counts[j]));
+	}
+
+	for (j = 0; valid && j < numArgTypes; ++j) {
+		const GameMessageArgumentDataType argType = (GameMessageArgumentDataType)types[j];
+		for (Int k = 0; valid && k < counts[j]; ++k) {
+			GameMessageArgumentType arg;
+			UnsignedByte byteValue = 0;
+			UnsignedInt value = 0;
+			Int signedValue = 0;
+
+			switch (argType) {
+
+			case ARGUMENTDATATYPE_INTEGER:
+				valid = readSignedVarInt(data, i, length, arg.integer);
+				break;
+			case ARGUMENTDATATYPE_REAL:
+				valid = readBytes(data, i, length, &arg.real, sizeof(arg.real));
+				break;
+			case ARGUMENTDATATYPE_BOOLEAN:
+				valid = readBytes(data, i, length, &byteValue, sizeof(byteValue));
+				arg.boolean = (byteValue != 0);
+				break;
+			case ARGUMENTDATATYPE_OBJECTID:
+				valid = readSignedVarInt(data, i, length, signedValue);
+				lastObjectID = (ObjectID)((UnsignedInt)lastObjectID + (UnsignedInt)signedValue);
+				arg.objectID = lastObjectID;
+				break;
+			case ARGUMENTDATATYPE_DRAWABLEID:
+				valid = readVarInt(data, i, length, value);
+				arg.drawableID = (DrawableID)value;
+				break;
+			case ARGUMENTDATATYPE_TEAMID:
+				valid = readVarInt(data, i, length, arg.teamID);
+				break;
+			case ARGUMENTDATATYPE_LOCATION:
+				valid = readBytes(data, i, length, &arg.location, sizeof(arg.location));
+				break;
+			case ARGUMENTDATATYPE_PIXEL:
+				valid = readSignedVarInt(data, i, length, arg.pixel.x) && readSignedVarInt(data, i, length, arg.pixel.y);
+				break;
+			case ARGUMENTDATATYPE_PIXELREGION:
+				valid = readSignedVarInt(data, i, length, arg.pixelRegion.lo.x) && readSignedVarInt(data, i, length, arg.pixelRegion.lo.y)
+					&& readSignedVarInt(data, i, length, arg.pixelRegion.hi.x) && readSignedVarInt(data, i, length, arg.pixelRegion.hi.y);
+				break;
+			case ARGUMENTDATATYPE_TIMESTAMP:
+				valid = readVarInt(data, i, length, arg.timestamp);
+				break;
+			case ARGUMENTDATATYPE_WIDECHAR:
+				valid = readVarInt(data, i, length, value);
+				arg.wChar = (WideChar)value;
+				break;
+			default:
+				DEBUG_LOG_LEVEL(DEBUG_LEVEL_NET, ("NetPacket::readCompactGameMessage - unknown argument type %d", (Int)argType));
+				valid = FALSE;
+				break;
+			}
+
+			if (valid) {
+				msg->addArgument(argType, arg);
+			}
+		}
+	}
+
+	if (!valid) {
+		msg->detach();
+		return NULL;
+	}
+
+	return (NetCommandMsg *)msg;
+}
+
 void NetPacket::readGameMessageArgumentFromPacket(GameMessageArgumentDataType type, NetGameCommandMsg *msg, UnsignedByte *data, Int &i) {
 
 	GameMessageArgumentType arg;
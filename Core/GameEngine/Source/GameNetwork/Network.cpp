@@ -589,7 +589,11 @@ void Network::RelayCommandsToCommandList(UnsignedInt frame) {
 		NetCommandType cmdType = msg->getCommand()->getNetCommandType();
 		if (cmdType == NETCOMMANDTYPE_GAMECOMMAND) {
 			//DEBUG_LOG(("Network::RelayCommandsToCommandList - appending command %d of type %s to command list on frame %d", msg->getCommand()->getID(), ((NetGameCommandMsg *)msg->getCommand())->constructGameMessage()->getCommandAsString(), TheGameLogic->getFrame()));
-			TheCommandList->appendMessage(((NetGameCommandMsg *)msg->getCommand())->constructGameMessage());
+			// TheSuperHackers @bugfix A command from a player that is not in the game is dropped.
+			GameMessage *gameMsg = ((NetGameCommandMsg *)msg->getCommand())->constructGameMessage();
+			if (gameMsg != NULL) {
+				TheCommandList->appendMessage(gameMsg);
+			}
 		} else {
 			processFrameSynchronizedNetCommand(msg);
 		}
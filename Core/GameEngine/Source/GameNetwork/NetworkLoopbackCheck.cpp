@@ -0,0 +1,445 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "GameNetwork/NetworkLoopbackCheck.h"
+
+#include "GameNetwork/LoopbackTransport.h"
+#include "GameNetwork/NetCommandList.h"
+#include "GameNetwork/NetCommandMsg.h"
+#include "GameNetwork/NetCommandRef.h"
+#include "GameNetwork/NetPacket.h"
+#include "GameNetwork/Transport.h"
+
+
+namespace
+{
+const UnsignedInt SenderIP = 0x7f000001;
+const UnsignedInt ReceiverIP = 0x7f000002;
+const UnsignedShort Port = 8088;
+
+const UnsignedByte PlayerID = 1;
+const UnsignedShort FirstCommandID = 100;
+
+const Int SelectionSize = 100;
+const Int WaypointCount = 8;
+
+Coord3D makeLocation(Real x, Real y, Real z)
+{
+	Coord3D location;
+	location.x = x;
+	location.y = y;
+	location.z = z;
+	return location;
+}
+}
+
+//-------------------------------------------------------------------------------------------------
+int NetworkLoopbackCheck::run()
+{
+	// Note that we use printf here because this is run from cmd.
+	LoopbackNetwork network;
+	LoopbackNetwork::Settings settings;
+	settings.latency = 40;
+	settings.jitter = 20;
+	settings.seed = 1;
+	network.setSettings(settings);
+	network.useManualClock(0);
+
+	Transport *sender = new Transport;
+	Transport *receiver = new Transport;
+	if (!sender->init(new LoopbackSocket(&network), SenderIP, Port) || !receiver->init(new LoopbackSocket(&network), ReceiverIP, Port))
+	{
+		printf("Cannot bind the loopback sockets\n");
+		delete sender;
+		delete receiver;
+		return 1;
+	}
+
+	// The debug latency and packet loss of the real network would only get in the way here.
+	sender->setLatency(FALSE);
+	sender->setPacketLoss(FALSE);
+	receiver->setLatency(FALSE);
+	receiver->setPacketLoss(FALSE);
+
+	Commands commands;
+	makeCommands(commands);
+
+	Bool passed = checkRoundTrip("legacy", network, sender, receiver, commands, FALSE);
+	passed = checkRoundTrip("compact", network, sender, receiver, commands, TRUE) && passed;
+	passed = checkMalformedPackets(commands) && passed;
+
+	const LoopbackNetwork::Statistics &statistics = network.getStatistics();
+	if (statistics.deliveredPackets != statistics.sentPackets)
+	{
+		printf("The loopback network delivered %u of %u packets\n", statistics.deliveredPackets, statistics.sentPackets);
+		passed = FALSE;
+	}
+
+	freeCommands(commands);
+
+	// The sockets must go before the network they are on.
+	delete sender;
+	delete receiver;
+
+	printf(passed ? "Network loopback check passed\n" : "Network loopback check FAILED\n");
+	return passed ? 0 : 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+void NetworkLoopbackCheck::makeCommands(Commands &commands)
+{
+	Command command;
+	command.frame = 300;
+
+	// A large selection. The object IDs mostly go up in small steps, like those of units built one
+	// after the other, but also jump up and back down.
+	command.message = newInstance(GameMessage)(GameMessage::MSG_CREATE_SELECTED_GROUP);
+	command.message->appendBooleanArgument(TRUE);
+	ObjectID objectID = (ObjectID)5000;
+	Int i = 0;
+	for (; i < SelectionSize; ++i)
+	{
+		if (i == SelectionSize / 2)
+			objectID = (ObjectID)0x7ffffff0;
+		else if (i == SelectionSize / 2 + 1)
+			objectID = (ObjectID)1;
+		else
+			objectID = (ObjectID)(objectID + 1 + i % 3);
+		command.message->appendObjectIDArgument(objectID);
+	}
+	commands.push_back(command);
+
+	// A move with waypoints, partly off the map.
+	command.message = newInstance(GameMessage)(GameMessage::MSG_DO_MOVETO);
+	command.message->appendLocationArgument(makeLocation(1250.5f, 830.25f, 12.0f));
+	commands.push_back(command);
+	for (i = 0; i < WaypointCount; ++i)
+	{
+		command.message = newInstance(GameMessage)(GameMessage::MSG_ADD_WAYPOINT);
+		command.message->appendLocationArgument(makeLocation(1250.5f - i * 160.0f, 830.25f - i * 130.0f, -0.5f * i));
+		commands.push_back(command);
+	}
+
+	// Every argument type with negative and extreme values, for a frame before the one of the
+	// commands before it.
+	command.frame = 299;
+	command.message = newInstance(GameMessage)(GameMessage::MSG_DO_WEAPON_AT_LOCATION);
+	command.message->appendIntegerArgument(0);
+	command.message->appendIntegerArgument(-1);
+	command.message->appendIntegerArgument(-64);
+	command.message->appendIntegerArgument(-65);
+	command.message->appendIntegerArgument((Int)0x80000000);
+	command.message->appendIntegerArgument(0x7fffffff);
+	command.message->appendRealArgument(-0.0f);
+	command.message->appendRealArgument(-3.5e30f);
+	command.message->appendBooleanArgument(FALSE);
+	command.message->appendObjectIDArgument(INVALID_ID);
+	command.message->appendDrawableIDArgument((DrawableID)0xffffffff);
+	command.message->appendTeamIDArgument(0xfffffffe);
+	command.message->appendLocationArgument(makeLocation(-1.0f, -100000.0f, 0.0f));
+	ICoord2D pixel;
+	pixel.x = -1;
+	pixel.y = -32768;
+	command.message->appendPixelArgument(pixel);
+	IRegion2D region;
+	region.lo.x = -640;
+	region.lo.y = -480;
+	region.hi.x = 0x7fffffff;
+	region.hi.y = (Int)0x80000000;
+	command.message->appendPixelRegionArgument(region);
+	command.message->appendTimestampArgument(0xffffffff);
+	command.message->appendWideCharArgument((WideChar)0xfffe);
+	commands.push_back(command);
+
+	// And one much later.
+	command.frame = 100000;
+	command.message = newInstance(GameMessage)(GameMessage::MSG_DO_MOVETO);
+	command.message->appendLocationArgument(makeLocation(0.0f, 0.0f, 0.0f));
+	commands.push_back(command);
+}
+
+//-------------------------------------------------------------------------------------------------
+void NetworkLoopbackCheck::freeCommands(Commands &commands)
+{
+	for (size_t i = 0; i < commands.size(); ++i)
+		deleteInstance(commands[i].message);
+	commands.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Pack the commands into as few packets as they fit in, like Connection::doSend does, send them
+	* and check what comes out at the other end once the packets had the time to get there. */
+//-------------------------------------------------------------------------------------------------
+Bool NetworkLoopbackCheck::checkRoundTrip(const char *name, LoopbackNetwork &network, Transport *from, Transport *to, const Commands &commands, Bool compact)
+{
+	Bool passed = TRUE;
+	Int numPackets = 0;
+	Int numBytes = 0;
+
+	NetPacket *packet = newInstance(NetPacket);
+	packet->setAddress(ReceiverIP, Port);
+	packet->setCompact(compact);
+	size_t c = 0;
+	for (; c < commands.size(); ++c)
+	{
+		NetCommandRef *ref = newCommandRef(commands, c);
+
+		Bool added = packet->addCommand(ref);
+		if (!added && packet->getNumCommands() > 0)
+		{
+			sendPacket(from, packet, numPackets, numBytes);
+			packet->reset();
+			packet->setAddress(ReceiverIP, Port);
+			packet->setCompact(compact);
+			added = packet->addCommand(ref);
+		}
+		if (!added && packet->isCompact())
+		{
+			// the command only fits into a packet in the old format.
+			packet->setCompact(FALSE);
+			added = packet->addCommand(ref);
+		}
+		if (!added)
+		{
+			printf("%s: command %d does not fit into a packet\n", name, (Int)c);
+			passed = FALSE;
+		}
+
+		NetCommandMsg *msg = ref->getCommand();
+		deleteInstance(ref);
+		msg->detach();
+	}
+	if (packet->getNumCommands() > 0)
+	{
+		sendPacket(from, packet, numPackets, numBytes);
+	}
+	deleteInstance(packet);
+	packet = NULL;
+
+	from->doSend();
+	network.advanceClock(network.getSettings().latency + network.getSettings().jitter);
+	to->doRecv();
+
+	// The jitter may have swapped the packets, so the commands are told apart by their IDs.
+	std::vector<Bool> received(commands.size(), FALSE);
+	for (Int i = 0; i < MAX_MESSAGES; ++i)
+	{
+		TransportMessage &message = to->m_inBuffer[i];
+		if (message.length == 0)
+			continue;
+
+		packet = newInstance(NetPacket)(&message);
+		if (packet->isCompact() != compact)
+		{
+			printf("%s: received a packet in the other format\n", name);
+			passed = FALSE;
+		}
+		passed = checkPacket(name, packet, commands, received) && passed;
+		deleteInstance(packet);
+		packet = NULL;
+
+		// signal that this has been processed.
+		message.length = 0;
+	}
+
+	for (c = 0; c < commands.size(); ++c)
+	{
+		if (!received[c])
+		{
+			printf("%s: command %d did not arrive\n", name, (Int)c);
+			passed = FALSE;
+		}
+	}
+
+	printf("%s: %d commands in %d packets of %d bytes\n", name, (Int)commands.size(), numPackets, numBytes);
+	return passed;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Cut a compact packet off at every length, and build some that are broken in other ways. None of
+	* them may be read past their end, and what is read from them must be right. */
+//-------------------------------------------------------------------------------------------------
+Bool NetworkLoopbackCheck::checkMalformedPackets(const Commands &commands)
+{
+	Bool passed = TRUE;
+
+	// The commands that fit into one packet, not compressed so that each cut ends in a different place.
+	NetPacket *packet = newInstance(NetPacket);
+	packet->setCompact(TRUE);
+	for (size_t c = 0; c < commands.size(); ++c)
+	{
+		NetCommandRef *ref = newCommandRef(commands, c);
+		packet->addCommand(ref);
+		NetCommandMsg *msg = ref->getCommand();
+		deleteInstance(ref);
+		msg->detach();
+	}
+
+	TransportMessage message;
+	message.header.magic = GENERALS_COMPACT_MAGIC_NUMBER;
+	message.addr = SenderIP;
+	message.port = Port;
+	memcpy(message.data, packet->getData(), packet->getLength());
+	const Int fullLength = packet->getLength();
+	deleteInstance(packet);
+	packet = NULL;
+
+	for (Int length = 1; length < fullLength; ++length)
+	{
+		message.length = length;
+		packet = newInstance(NetPacket)(&message);
+		std::vector<Bool> received(commands.size(), FALSE);
+		passed = checkPacket("cut off", packet, commands, received) && passed;
+		deleteInstance(packet);
+		packet = NULL;
+	}
+
+	// The field types are those of NetPacket.cpp, after the byte that tells the packet is not compressed.
+	const UnsignedByte unknownArgumentType[] = { 0, 'T', NETCOMMANDTYPE_GAMECOMMAND, 'C', 1, 0, 'D', 1, 1, 200, 1, 0 };
+	const UnsignedByte endsInFrame[] = { 0, 'T', NETCOMMANDTYPE_GAMECOMMAND, 'f', 0x80 };
+	const UnsignedByte tooLongMessageType[] = { 0, 'T', NETCOMMANDTYPE_GAMECOMMAND, 'C', 1, 0, 'D', 0x81, 0x80, 0x80, 0x80, 0x80, 0x00, 0 };
+	passed = checkDropped("unknown argument type", unknownArgumentType, sizeof(unknownArgumentType)) && passed;
+	passed = checkDropped("ends in frame", endsInFrame, sizeof(endsInFrame)) && passed;
+	passed = checkDropped("too long message type", tooLongMessageType, sizeof(tooLongMessageType)) && passed;
+
+	printf("malformed: %d cut off packets and 3 broken ones\n", fullLength - 1);
+	return passed;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Check that each command in the packet is one that was sent, unchanged, and not received before. */
+//-------------------------------------------------------------------------------------------------
+Bool NetworkLoopbackCheck::checkPacket(const char *name, NetPacket *packet, const Commands &commands, std::vector<Bool> &received)
+{
+	Bool passed = TRUE;
+	NetCommandList *cmdList = packet->getCommandList();
+	for (NetCommandRef *ref = cmdList->getFirstMessage(); ref != NULL; ref = ref->getNext())
+	{
+		NetCommandMsg *msg = ref->getCommand();
+		const size_t c = (size_t)(msg->getID() - FirstCommandID);
+		if (msg->getNetCommandType() != NETCOMMANDTYPE_GAMECOMMAND || c >= commands.size() || received[c])
+		{
+			printf("%s: received a command that was not sent, type %d, ID %d\n", name, (Int)msg->getNetCommandType(), (Int)msg->getID());
+			passed = FALSE;
+			continue;
+		}
+		received[c] = TRUE;
+
+		GameMessage *gmsg = ((NetGameCommandMsg *)msg)->constructGameMessageArguments();
+		if (msg->getExecutionFrame() != commands[c].frame || msg->getPlayerID() != PlayerID || !isSameMessage(commands[c].message, gmsg))
+		{
+			printf("%s: command %d changed on the way\n", name, (Int)c);
+			passed = FALSE;
+		}
+		deleteInstance(gmsg);
+	}
+	deleteInstance(cmdList);
+	return passed;
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool NetworkLoopbackCheck::checkDropped(const char *name, const UnsignedByte *data, Int length)
+{
+	TransportMessage message;
+	message.header.magic = GENERALS_COMPACT_MAGIC_NUMBER;
+	message.addr = SenderIP;
+	message.port = Port;
+	message.length = length;
+	memcpy(message.data, data, length);
+
+	NetPacket *packet = newInstance(NetPacket)(&message);
+	NetCommandList *cmdList = packet->getCommandList();
+	const Bool dropped = (cmdList->getFirstMessage() == NULL);
+	deleteInstance(cmdList);
+	deleteInstance(packet);
+
+	if (!dropped)
+		printf("%s: the packet was not dropped\n", name);
+	return dropped;
+}
+
+//-------------------------------------------------------------------------------------------------
+NetCommandRef *NetworkLoopbackCheck::newCommandRef(const Commands &commands, size_t index)
+{
+	NetCommandMsg *msg = newInstance(NetGameCommandMsg)(commands[index].message);
+	msg->setExecutionFrame(commands[index].frame);
+	msg->setPlayerID(PlayerID);
+	msg->setID((UnsignedShort)(FirstCommandID + index));
+	return NEW_NETCOMMANDREF(msg);
+}
+
+//-------------------------------------------------------------------------------------------------
+void NetworkLoopbackCheck::sendPacket(Transport *from, NetPacket *packet, Int &numPackets, Int &numBytes)
+{
+	packet->compress();
+	from->queueSend(packet->getAddr(), packet->getPort(), packet->getData(), packet->getLength(),
+		packet->isCompact() ? GENERALS_COMPACT_MAGIC_NUMBER : GENERALS_MAGIC_NUMBER);
+	++numPackets;
+	numBytes += packet->getLength();
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool NetworkLoopbackCheck::isSameMessage(GameMessage *sent, GameMessage *received)
+{
+	if (sent->getType() != received->getType() || sent->getArgumentCount() != received->getArgumentCount())
+		return FALSE;
+
+	for (Int i = 0; i < sent->getArgumentCount(); ++i)
+	{
+		const GameMessageArgumentDataType type = sent->getArgumentDataType(i);
+		if (type != received->getArgumentDataType(i) || !isSameArgument(type, sent->getArgument(i), received->getArgument(i)))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Reals are compared by their bits, so that -0 does not pass for 0. */
+//-------------------------------------------------------------------------------------------------
+Bool NetworkLoopbackCheck::isSameArgument(GameMessageArgumentDataType type, const GameMessageArgumentType *sent, const GameMessageArgumentType *received)
+{
+	switch (type)
+	{
+		case ARGUMENTDATATYPE_INTEGER:
+			return sent->integer == received->integer;
+		case ARGUMENTDATATYPE_REAL:
+			return memcmp(&sent->real, &received->real, sizeof(sent->real)) == 0;
+		case ARGUMENTDATATYPE_BOOLEAN:
+			return (sent->boolean != 0) == (received->boolean != 0);
+		case ARGUMENTDATATYPE_OBJECTID:
+			return sent->objectID == received->objectID;
+		case ARGUMENTDATATYPE_DRAWABLEID:
+			return sent->drawableID == received->drawableID;
+		case ARGUMENTDATATYPE_TEAMID:
+			return sent->teamID == received->teamID;
+		case ARGUMENTDATATYPE_LOCATION:
+			return memcmp(&sent->location, &received->location, sizeof(sent->location)) == 0;
+		case ARGUMENTDATATYPE_PIXEL:
+			return sent->pixel.x == received->pixel.x && sent->pixel.y == received->pixel.y;
+		case ARGUMENTDATATYPE_PIXELREGION:
+			return sent->pixelRegion.lo.x == received->pixelRegion.lo.x && sent->pixelRegion.lo.y == received->pixelRegion.lo.y
+				&& sent->pixelRegion.hi.x == received->pixelRegion.hi.x && sent->pixelRegion.hi.y == received->pixelRegion.hi.y;
+		case ARGUMENTDATATYPE_TIMESTAMP:
+			return sent->timestamp == received->timestamp;
+		case ARGUMENTDATATYPE_WIDECHAR:
+			return sent->wChar == received->wChar;
+	}
+	return FALSE;
+}
@@ -70,7 +70,8 @@ static inline void decryptBuf( unsigned char *buf, Int len )
 Transport::Transport(void)
 {
 	m_winsockInit = false;
-	m_udpsock = NULL;
+	m_socket = NULL;
+	clearOutQueue();
 }
 
 Transport::~Transport(void)
@@ -103,24 +104,29 @@ Bool Transport::init( UnsignedInt ip, UnsignedShort port )
 		m_winsockInit = true;
 	}
 
+	return init(NEW UDP(), ip, port);
+}
+
+Bool Transport::init( TransportSocket *socket, UnsignedInt ip, UnsignedShort port )
+{
 	// ------- Bind our port --------
-	delete m_udpsock;
-	m_udpsock = NEW UDP();
+	delete m_socket;
+	m_socket = socket;
 
-	if (!m_udpsock)
+	if (!m_socket)
 		return false;
 
 	int retval = -1;
 	time_t now = timeGetTime();
 	while ((retval != 0) && ((timeGetTime() - now) < 1000)) {
-		retval = m_udpsock->Bind(ip, port);
+		retval = m_socket->Bind(ip, port);
 	}
 
 	if (retval != 0) {
 		DEBUG_CRASH(("Could not bind to 0x%8.8X:%d", ip, port));
 		DEBUG_LOG(("Transport::init - Failure to bind socket with error code %x", retval));
-		delete m_udpsock;
-		m_udpsock = NULL;
+		delete m_socket;
+		m_socket = NULL;
 		return false;
 	}
 
@@ -134,6 +140,7 @@ Bool Transport::init( UnsignedInt ip, UnsignedShort port )
 		m_delayedInBuffer[i].message.length = 0;
 #endif
 	}
+	clearOutQueue();
 	for (i=0; i<MAX_TRANSPORT_STATISTICS_SECONDS; ++i)
 	{
 		m_incomingBytes[i] = 0;
@@ -161,8 +168,8 @@ Bool Transport::init( UnsignedInt ip, UnsignedShort port )
 
 void Transport::reset( void )
 {
-	delete m_udpsock;
-	m_udpsock = NULL;
+	delete m_socket;
+	m_socket = NULL;
 
 	if (m_winsockInit)
 	{
@@ -171,15 +178,27 @@ void Transport::reset( void )
 	}
 }
 
+void Transport::clearOutQueue( void )
+{
+	for (Int i=0; i<MAX_MESSAGES; ++i)
+	{
+		// the lowest slot is handed out first
+		m_outFree[i] = MAX_MESSAGES - 1 - i;
+	}
+	m_numOutFree = MAX_MESSAGES;
+	m_outQueueHead = 0;
+	m_numOutQueued = 0;
+}
+
 Bool Transport::update( void )
 {
 	Bool retval = TRUE;
-	if (doRecv() == FALSE && m_udpsock && m_udpsock->GetStatus() == UDP::ADDRNOTAVAIL)
+	if (doRecv() == FALSE && m_socket && m_socket->GetStatus() == TransportSocket::ADDRNOTAVAIL)
 	{
 		retval = FALSE;
 	}
 	DEBUG_ASSERTLOG(retval, ("WSA error is %s", GetWSAErrorString(WSAGetLastError()).str()));
-	if (doSend() == FALSE && m_udpsock && m_udpsock->GetStatus() == UDP::ADDRNOTAVAIL)
+	if (doSend() == FALSE && m_socket && m_socket->GetStatus() == TransportSocket::ADDRNOTAVAIL)
 	{
 		retval = FALSE;
 	}
@@ -188,9 +207,9 @@ Bool Transport::update( void )
 }
 
 Bool Transport::doSend() {
-	if (!m_udpsock)
+	if (!m_socket)
 	{
-		DEBUG_LOG(("Transport::doSend() - m_udpSock is NULL!"));
+		DEBUG_LOG(("Transport::doSend() - m_socket is NULL!"));
 		return FALSE;
 	}
 
@@ -211,30 +230,54 @@ Bool Transport::doSend() {
 	}
 
 	// Send all messages
-	int i;
-	for (i=0; i<MAX_MESSAGES; ++i)
+	// TheSuperHackers @performance They are handed to the socket in batches, oldest first. The ones
+	// that could not be sent go to the back of the queue, to be tried again on the next call.
+	TransportSocket::Packet packets[BATCH_SIZE];
+	Int batchSlots[BATCH_SIZE];
+	Int numToSend = m_numOutQueued;
+	while (numToSend > 0)
 	{
-		if (m_outBuffer[i].length != 0)
+		Int count = 0;
+		for (; count < BATCH_SIZE && count < numToSend; ++count)
+		{
+			Int slot = m_outQueue[m_outQueueHead];
+			m_outQueueHead = (m_outQueueHead + 1) % MAX_MESSAGES;
+			batchSlots[count] = slot;
+			packets[count].buf = (unsigned char *)(&m_outBuffer[slot]);
+			packets[count].len = m_outBuffer[slot].length + sizeof(TransportMessageHeader);
+			packets[count].IP = m_outBuffer[slot].addr;
+			packets[count].port = m_outBuffer[slot].port;
+		}
+		m_numOutQueued -= count;
+		numToSend -= count;
+
+		m_socket->WriteMany(packets, count);
+
+		for (Int p=0; p<count; ++p)
 		{
-			int bytesSent = 0;
-			int bytesToSend = m_outBuffer[i].length + sizeof(TransportMessageHeader);
+			Int slot = batchSlots[p];
+			Int bytesSent = packets[p].result;
+			Int bytesToSend = packets[p].len;
 			// Send this message
-			if ((bytesSent = m_udpsock->Write((unsigned char *)(&m_outBuffer[i]), bytesToSend, m_outBuffer[i].addr, m_outBuffer[i].port)) > 0)
+			if (bytesSent > 0)
 			{
-				//DEBUG_LOG(("Sending %d bytes to %d.%d.%d.%d:%d", bytesToSend, PRINTF_IP_AS_4_INTS(m_outBuffer[i].addr), m_outBuffer[i].port));
+				//DEBUG_LOG(("Sending %d bytes to %d.%d.%d.%d:%d", bytesToSend, PRINTF_IP_AS_4_INTS(m_outBuffer[slot].addr), m_outBuffer[slot].port));
 				m_outgoingPackets[m_statisticsSlot]++;
-				m_outgoingBytes[m_statisticsSlot] += m_outBuffer[i].length + sizeof(TransportMessageHeader);
-				m_outBuffer[i].length = 0;  // Remove from queue
+				m_outgoingBytes[m_statisticsSlot] += m_outBuffer[slot].length + sizeof(TransportMessageHeader);
+				m_outBuffer[slot].length = 0;  // Remove from queue
+				m_outFree[m_numOutFree++] = slot;
 				if (bytesSent != bytesToSend)
 				{
 					DEBUG_LOG(("Transport::doSend - wanted to send %d bytes, only sent %d bytes to %d.%d.%d.%d:%d",
 						bytesToSend, bytesSent,
-						PRINTF_IP_AS_4_INTS(m_outBuffer[i].addr), m_outBuffer[i].port));
+						PRINTF_IP_AS_4_INTS(m_outBuffer[slot].addr), m_outBuffer[slot].port));
 				}
 			}
 			else
 			{
 				//DEBUG_LOG(("Could not write to socket!!!  Not discarding message!"));
+				m_outQueue[(m_outQueueHead + m_numOutQueued) % MAX_MESSAGES] = slot;
+				++m_numOutQueued;
 				retval = FALSE;
 				//DEBUG_LOG(("Transport::doSend returning FALSE"));
 			}
@@ -245,7 +288,7 @@ Bool Transport::doSend() {
 	// Latency simulation - deliver anything we're holding on to that is ready
 	if (m_useLatency)
 	{
-		for (i=0; i<MAX_MESSAGES; ++i)
+		for (int i=0; i<MAX_MESSAGES; ++i)
 		{
 			if (m_delayedInBuffer[i].message.length != 0 && m_delayedInBuffer[i].deliveryTime <= now)
 			{
@@ -268,101 +311,122 @@ Bool Transport::doSend() {
 
 Bool Transport::doRecv()
 {
-	if (!m_udpsock)
+	if (!m_socket)
 	{
-		DEBUG_LOG(("Transport::doRecv() - m_udpSock is NULL!"));
+		DEBUG_LOG(("Transport::doRecv() - m_socket is NULL!"));
 		return FALSE;
 	}
 
 	Bool retval = TRUE;
 
 	// Read in anything on our socket
-	sockaddr_in from;
 #if defined(RTS_DEBUG)
 	UnsignedInt now = timeGetTime();
 #endif
 
-	TransportMessage incomingMessage;
-	unsigned char *buf = (unsigned char *)&incomingMessage;
-	int len = MAX_MESSAGE_LEN;
+	// TheSuperHackers @performance The free slots of m_inBuffer are found once rather than for each
+	// packet. The slots are freed by whoever reads m_inBuffer, so this cannot be kept between calls.
+	Int freeSlots[MAX_MESSAGES];
+	Int numFreeSlots = 0;
+	for (Int slot=MAX_MESSAGES-1; slot>=0; --slot)
+	{
+		if (m_inBuffer[slot].length == 0)
+			freeSlots[numFreeSlots++] = slot;
+	}
+
+	TransportSocket::Packet packets[BATCH_SIZE];
+	Int count = 0;
 //	DEBUG_LOG(("Transport::doRecv - checking"));
-	while ( (len=m_udpsock->Read(buf, MAX_MESSAGE_LEN, &from)) > 0 )
+	for (;;)
 	{
-#if defined(RTS_DEBUG)
-		// Packet loss simulation
-		if (m_usePacketLoss)
+		for (Int b=0; b<BATCH_SIZE; ++b)
+		{
+			packets[b].buf = (unsigned char *)&m_recvBatch[b];
+			packets[b].len = MAX_MESSAGE_LEN;
+		}
+		count = m_socket->ReadMany(packets, BATCH_SIZE);
+		if (count <= 0)
+			break;
+
+		for (Int p=0; p<count; ++p)
 		{
-			if ( TheGlobalData->m_packetLoss >= GameClientRandomValue(0, 100) )
+			TransportMessage &incomingMessage = m_recvBatch[p];
+			unsigned char *buf = (unsigned char *)&incomingMessage;
+			int len = packets[p].result;
+
+#if defined(RTS_DEBUG)
+			// Packet loss simulation
+			if (m_usePacketLoss)
 			{
-				continue;
+				if ( TheGlobalData->m_packetLoss >= GameClientRandomValue(0, 100) )
+				{
+					continue;
+				}
 			}
-		}
 #endif
 
-//		DEBUG_LOG(("Transport::doRecv - Got something! len = %d", len));
-		// Decrypt the packet
-//		DEBUG_LOG_RAW(("buffer = "));
-//		for (Int munkee = 0; munkee < len; ++munkee) {
-//			DEBUG_LOG_RAW(("%02x", *(buf + munkee)));
-//		}
-//		DEBUG_LOG_RAW(("\n"));
-		decryptBuf(buf, len);
+//			DEBUG_LOG(("Transport::doRecv - Got something! len = %d", len));
+			// Decrypt the packet
+//			DEBUG_LOG_RAW(("buffer = "));
+//			for (Int munkee = 0; munkee < len; ++munkee) {
+//				DEBUG_LOG_RAW(("%02x", *(buf + munkee)));
+//			}
+//			DEBUG_LOG_RAW(("\n"));
+			decryptBuf(buf, len);
 
-		incomingMessage.length = len - sizeof(TransportMessageHeader);
+			incomingMessage.length = len - sizeof(TransportMessageHeader);
 
-		if (len <= sizeof(TransportMessageHeader) || !isGeneralsPacket( &incomingMessage ))
-		{
-			DEBUG_LOG(("Transport::doRecv - unknownPacket! len = %d", len));
-			m_unknownPackets[m_statisticsSlot]++;
-			m_unknownBytes[m_statisticsSlot] += len;
-			continue;
-		}
+			if (len <= sizeof(TransportMessageHeader) || !isGeneralsPacket( &incomingMessage ))
+			{
+				DEBUG_LOG(("Transport::doRecv - unknownPacket! len = %d", len));
+				m_unknownPackets[m_statisticsSlot]++;
+				m_unknownBytes[m_statisticsSlot] += len;
+				continue;
+			}
 
-		// Something there; stick it somewhere
-//		DEBUG_LOG(("Saw %d bytes from %d:%d", len, ntohl(from.sin_addr.S_un.S_addr), ntohs(from.sin_port)));
-		m_incomingPackets[m_statisticsSlot]++;
-		m_incomingBytes[m_statisticsSlot] += len;
+			// Something there; stick it somewhere
+//			DEBUG_LOG(("Saw %d bytes from %d:%d", len, packets[p].IP, packets[p].port));
+			m_incomingPackets[m_statisticsSlot]++;
+			m_incomingBytes[m_statisticsSlot] += len;
 
-		for (int i=0; i<MAX_MESSAGES; ++i)
-		{
 #if defined(RTS_DEBUG)
 			// Latency simulation
 			if (m_useLatency)
 			{
-				if (m_delayedInBuffer[i].message.length == 0)
+				for (int i=0; i<MAX_MESSAGES; ++i)
 				{
-					// Empty slot; use it
-					m_delayedInBuffer[i].deliveryTime =
-						now + TheGlobalData->m_latencyAverage +
-						(Int)(TheGlobalData->m_latencyAmplitude * sin(now * TheGlobalData->m_latencyPeriod)) +
-						GameClientRandomValue(-TheGlobalData->m_latencyNoise, TheGlobalData->m_latencyNoise);
-					m_delayedInBuffer[i].message.length = incomingMessage.length;
-					m_delayedInBuffer[i].message.addr = ntohl(from.sin_addr.S_un.S_addr);
-					m_delayedInBuffer[i].message.port = ntohs(from.sin_port);
-					memcpy(&m_delayedInBuffer[i].message, buf, len);
-					break;
+					if (m_delayedInBuffer[i].message.length == 0)
+					{
+						// Empty slot; use it
+						m_delayedInBuffer[i].deliveryTime =
+							now + TheGlobalData->m_latencyAverage +
+							(Int)(TheGlobalData->m_latencyAmplitude * sin(now * TheGlobalData->m_latencyPeriod)) +
+							GameClientRandomValue(-TheGlobalData->m_latencyNoise, TheGlobalData->m_latencyNoise);
+						m_delayedInBuffer[i].message.length = incomingMessage.length;
+						m_delayedInBuffer[i].message.addr = packets[p].IP;
+						m_delayedInBuffer[i].message.port = packets[p].port;
+						memcpy(&m_delayedInBuffer[i].message, buf, len);
+						break;
+					}
 				}
+				continue;
 			}
-			else
-			{
 #endif
-				if (m_inBuffer[i].length == 0)
-				{
-					// Empty slot; use it
-					m_inBuffer[i].length = incomingMessage.length;
-					m_inBuffer[i].addr = ntohl(from.sin_addr.S_un.S_addr);
-					m_inBuffer[i].port = ntohs(from.sin_port);
-					memcpy(&m_inBuffer[i], buf, len);
-					break;
-				}
-#if defined(RTS_DEBUG)
+
+			if (numFreeSlots > 0)
+			{
+				// Empty slot; use it
+				Int i = freeSlots[--numFreeSlots];
+				m_inBuffer[i].length = incomingMessage.length;
+				m_inBuffer[i].addr = packets[p].IP;
+				m_inBuffer[i].port = packets[p].port;
+				memcpy(&m_inBuffer[i], buf, len);
 			}
-#endif
+			//DEBUG_ASSERTCRASH(numFreeSlots>0, ("Message lost!"));
 		}
-		//DEBUG_ASSERTCRASH(i<MAX_MESSAGES, ("Message lost!"));
 	}
 
-	if (len == -1) {
+	if (count == -1) {
 		// there was a socket error trying to perform a read.
 		//DEBUG_LOG(("Transport::doRecv returning FALSE"));
 		retval = FALSE;
@@ -372,7 +436,7 @@ Bool Transport::doRecv()
 }
 
 Bool Transport::queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedByte *buf, Int len /*,
-						  NetMessageFlags flags, Int id */)
+						  NetMessageFlags flags, Int id */, UnsignedShort magic)
 {
 	int i;
 
@@ -382,31 +446,31 @@ Bool Transport::queueSend(UnsignedInt addr, UnsignedShort port, const UnsignedBy
 		return false;
 	}
 
-	for (i=0; i<MAX_MESSAGES; ++i)
+	if (m_numOutFree > 0)
 	{
-		if (m_outBuffer[i].length == 0)
-		{
-			// Insert data here
-			m_outBuffer[i].length = len;
-			memcpy(m_outBuffer[i].data, buf, len);
-			m_outBuffer[i].addr = addr;
-			m_outBuffer[i].port = port;
-//			m_outBuffer[i].header.flags = flags;
-//			m_outBuffer[i].header.id = id;
-			m_outBuffer[i].header.magic = GENERALS_MAGIC_NUMBER;
-
-			CRC crc;
-			crc.computeCRC( (unsigned char *)(&(m_outBuffer[i].header.magic)), m_outBuffer[i].length + sizeof(TransportMessageHeader) - sizeof(UnsignedInt) );
-//			DEBUG_LOG(("About to assign the CRC for the packet"));
-			m_outBuffer[i].header.crc = crc.get();
-
-			// Encrypt packet
-//			DEBUG_LOG(("buffer: "));
-			encryptBuf((unsigned char *)&m_outBuffer[i], len + sizeof(TransportMessageHeader));
-//			DEBUG_LOG((""));
-
-			return true;
-		}
+		i = m_outFree[--m_numOutFree];
+		// Insert data here
+		m_outBuffer[i].length = len;
+		memcpy(m_outBuffer[i].data, buf, len);
+		m_outBuffer[i].addr = addr;
+		m_outBuffer[i].port = port;
+//		m_outBuffer[i].header.flags = flags;
+//		m_outBuffer[i].header.id = id;
+		m_outBuffer[i].header.magic = magic;
+
+		CRC crc;
+		crc.computeCRC( (unsigned char *)(&(m_outBuffer[i].header.magic)), m_outBuffer[i].length + sizeof(TransportMessageHeader) - sizeof(UnsignedInt) );
+//		DEBUG_LOG(("About to assign the CRC for the packet"));
+		m_outBuffer[i].header.crc = crc.get();
+
+		// Encrypt packet
+//		DEBUG_LOG(("buffer: "));
+		encryptBuf((unsigned char *)&m_outBuffer[i], len + sizeof(TransportMessageHeader));
+//		DEBUG_LOG((""));
+
+		m_outQueue[(m_outQueueHead + m_numOutQueued) % MAX_MESSAGES] = i;
+		++m_numOutQueued;
+		return true;
 	}
 	DEBUG_LOG(("Send Queue is getting full, dropping packets"));
 	return false;
@@ -427,7 +491,7 @@ Bool Transport::isGeneralsPacket( TransportMessage *msg )
 	if (crc.get() != msg->header.crc)
 		return false;
 
-	if (msg->header.magic != GENERALS_MAGIC_NUMBER)
+	if (msg->header.magic != GENERALS_MAGIC_NUMBER && msg->header.magic != GENERALS_COMPACT_MAGIC_NUMBER)
 		return false;
 
 	return true;
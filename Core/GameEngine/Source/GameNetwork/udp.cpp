@@ -114,6 +114,38 @@ AsciiString GetWSAErrorString( Int error )
 
 //-------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------
+
+Int TransportSocket::ReadMany(Packet *packets,Int count)
+{
+  sockaddr_in from;
+  Int i=0;
+  for (; i<count; ++i)
+  {
+    Int len=Read(packets[i].buf,packets[i].len,&from);
+    if (len<=0)
+    {
+      if (len==-1 && i==0)
+        return(-1);
+      break;
+    }
+    packets[i].result=len;
+    packets[i].IP=ntohl(from.sin_addr.s_addr);
+    packets[i].port=ntohs(from.sin_port);
+  }
+  return(i);
+}
+
+void TransportSocket::WriteMany(Packet *packets,Int count)
+{
+  for (Int i=0; i<count; ++i)
+  {
+    packets[i].result=Write(packets[i].buf,packets[i].len,packets[i].IP,packets[i].port);
+  }
+}
+
+//-------------------------------------------------------------------------
+
 UDP::UDP()
 {
   fd=0;
@@ -532,3 +564,104 @@ Int UDP::AllowBroadcasts(Bool status)
 	else
 		return FALSE;
 }
+
+#if defined(__linux__)
+
+Int UDP::ReadMany(Packet *packets,Int count)
+{
+  struct mmsghdr msgs[MAX_BATCH];
+  struct iovec iov[MAX_BATCH];
+  struct sockaddr_in from[MAX_BATCH];
+
+  if (count>MAX_BATCH)
+    count=MAX_BATCH;
+
+  memset(msgs,0,sizeof(msgs[0])*count);
+  for (Int i=0; i<count; ++i)
+  {
+    iov[i].iov_base=packets[i].buf;
+    iov[i].iov_len=packets[i].len;
+    msgs[i].msg_hdr.msg_name=&from[i];
+    msgs[i].msg_hdr.msg_namelen=sizeof(from[i]);
+    msgs[i].msg_hdr.msg_iov=&iov[i];
+    msgs[i].msg_hdr.msg_iovlen=1;
+  }
+
+  Int retval=recvmmsg(fd,msgs,count,MSG_DONTWAIT,NULL);
+  if (retval==-1)
+  {
+    // failing because of a blocking error isn't really such a bad thing.
+    if (errno==EAGAIN || errno==EWOULDBLOCK)
+      return(0);
+    m_lastError=errno;
+    return(-1);
+  }
+
+  for (Int r=0; r<retval; ++r)
+  {
+    packets[r].result=msgs[r].msg_len;
+    packets[r].IP=ntohl(from[r].sin_addr.s_addr);
+    packets[r].port=ntohs(from[r].sin_port);
+  }
+  return(retval);
+}
+
+void UDP::WriteMany(Packet *packets,Int count)
+{
+  struct mmsghdr msgs[MAX_BATCH];
+  struct iovec iov[MAX_BATCH];
+  struct sockaddr_in to[MAX_BATCH];
+  Int index[MAX_BATCH];
+
+  ClearStatus();
+  Int next=0;
+  while (next<count)
+  {
+    // gather the packets that have somewhere to go
+    Int numMsgs=0;
+    for (; next<count && numMsgs<MAX_BATCH; ++next)
+    {
+      Packet &packet=packets[next];
+      // This happens frequently
+      if ((packet.IP==0)||(packet.port==0))
+      {
+        packet.result=ADDRNOTAVAIL;
+        continue;
+      }
+      memset(&to[numMsgs],0,sizeof(to[numMsgs]));
+      to[numMsgs].sin_family=AF_INET;
+      to[numMsgs].sin_port=htons(packet.port);
+      to[numMsgs].sin_addr.s_addr=htonl(packet.IP);
+      iov[numMsgs].iov_base=packet.buf;
+      iov[numMsgs].iov_len=packet.len;
+      memset(&msgs[numMsgs],0,sizeof(msgs[numMsgs]));
+      msgs[numMsgs].msg_hdr.msg_name=&to[numMsgs];
+      msgs[numMsgs].msg_hdr.msg_namelen=sizeof(to[numMsgs]);
+      msgs[numMsgs].msg_hdr.msg_iov=&iov[numMsgs];
+      msgs[numMsgs].msg_hdr.msg_iovlen=1;
+      index[numMsgs]=next;
+      ++numMsgs;
+    }
+
+    Int sent=0;
+    while (sent<numMsgs)
+    {
+      Int retval=sendmmsg(fd,msgs+sent,numMsgs-sent,0);
+      if (retval>0)
+      {
+        for (Int m=sent; m<sent+retval; ++m)
+          packets[index[m]].result=msgs[m].msg_len;
+        sent+=retval;
+      }
+      else
+      {
+        // this one can't be sent, the ones after it may
+        m_lastError=errno;
+        packets[index[sent]].result=-1;
+        ++sent;
+      }
+    }
+  }
+}
+
+#endif
@@ -46,8 +46,16 @@ class Win32BIGFile : public ArchiveFile
 		virtual void					setSearchPriority( Int new_priority );	///< Set this BIG file's search priority
 		virtual void					close( void );													///< Close this BIG file
 
+		Bool									mapArchive( const Char *filename );			///< Map the whole BIG file into memory
+		const Char*						getMappedData( void ) const { return m_mappedData; }	///< Returns the mapped BIG file, or NULL
+		size_t								getMappedSize( void ) const { return m_mappedSize; }	///< Returns the size of the mapped BIG file
+
 	protected:
 
+		void									unmapArchive( void );
+
 		AsciiString		m_name;		///< BIG file name
 		AsciiString		m_path;		///< BIG file path
+		const Char*		m_mappedData;	///< BIG file mapped into memory, files are opened as views into it
+		size_t				m_mappedSize;	///< size of the mapping
 };
@@ -34,6 +34,15 @@
 #include "Common/PerfTimer.h"
 #include "StdDevice/Common/StdBIGFile.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 //============================================================================
 // StdBIGFile::StdBIGFile
 //============================================================================
@@ -41,6 +50,8 @@
 StdBIGFile::StdBIGFile(AsciiString name, AsciiString path)
 	: m_name(name)
 	, m_path(path)
+	, m_mappedData(NULL)
+	, m_mappedSize(0)
 {
 
 }
@@ -51,7 +62,95 @@ StdBIGFile::StdBIGFile(AsciiString name, AsciiString path)
 
 StdBIGFile::~StdBIGFile()
 {
+	unmapArchive();
+}
+
+//============================================================================
+// StdBIGFile::mapArchive
+//============================================================================
+/**
+	* TheSuperHackers @performance Maps the whole BIG file into memory, so that its
+	* directory can be parsed from one buffer and its files can be opened without
+	* copying them. Returns FALSE if the file could not be mapped, for example when
+	* the address space is exhausted, in which case the files are read as before.
+	*/
+//============================================================================
+
+Bool StdBIGFile::mapArchive( const Char *filename )
+{
+	unmapArchive();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return FALSE;
+	}
 
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0 || fileSize.QuadPart > INT_MAX) {
+		CloseHandle(fileHandle);
+		return FALSE;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fileHandle);
+	if (mappingHandle == NULL) {
+		return FALSE;
+	}
+
+	// the view keeps the mapping alive
+	void *data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mappingHandle);
+	if (data == NULL) {
+		return FALSE;
+	}
+
+	m_mappedData = static_cast<const Char *>(data);
+	m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0) {
+		return FALSE;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 || fileStat.st_size > INT_MAX) {
+		::close(fd);
+		return FALSE;
+	}
+
+	// the mapping stays valid after closing the descriptor
+	void *data = mmap(NULL, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED) {
+		return FALSE;
+	}
+
+	m_mappedData = static_cast<const Char *>(data);
+	m_mappedSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	return TRUE;
+}
+
+//============================================================================
+// StdBIGFile::unmapArchive
+//============================================================================
+
+void StdBIGFile::unmapArchive( void )
+{
+	if (m_mappedData == NULL) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_mappedData);
+#else
+	munmap(const_cast<Char *>(m_mappedData), m_mappedSize);
+#endif
+
+	m_mappedData = NULL;
+	m_mappedSize = 0;
 }
 
 //============================================================================
@@ -68,16 +167,33 @@ File* StdBIGFile::openFile( const Char *filename, Int access )
 
 	RAMFile *ramFile = NULL;
 
-	if (BitIsSet(access, File::STREAMING))
-		ramFile = newInstance( StreamingArchiveFile );
-	else
-		ramFile = newInstance( RAMFile );
+	if (m_mappedData != NULL) {
+		// TheSuperHackers @performance Return a view into the mapped BIG file. This also serves
+		// streaming access, because the operating system only pages in what is being read.
+		if (fileInfo->m_offset + (size_t)fileInfo->m_size > m_mappedSize) {
+			DEBUG_CRASH(("File %s exceeds the BIG file %s", filename, m_name.str()));
+			return NULL;
+		}
 
-	ramFile->deleteOnClose();
-	if (ramFile->openFromArchive(m_file, fileInfo->m_filename, fileInfo->m_offset, fileInfo->m_size) == FALSE) {
-		ramFile->close();
-		ramFile = NULL;
-		return NULL;
+		ramFile = newInstance( RAMFile );
+		ramFile->deleteOnClose();
+		if (ramFile->openFromMemory(fileInfo->m_filename, m_mappedData + fileInfo->m_offset, fileInfo->m_size) == FALSE) {
+			ramFile->close();
+			ramFile = NULL;
+			return NULL;
+		}
+	} else {
+		if (BitIsSet(access, File::STREAMING))
+			ramFile = newInstance( StreamingArchiveFile );
+		else
+			ramFile = newInstance( RAMFile );
+
+		ramFile->deleteOnClose();
+		if (ramFile->openFromArchive(m_file, fileInfo->m_filename, fileInfo->m_offset, fileInfo->m_size) == FALSE) {
+			ramFile->close();
+			ramFile = NULL;
+			return NULL;
+		}
 	}
 
 	if ((access & File::WRITE) == 0) {
@@ -34,6 +34,8 @@
 #include "Common/PerfTimer.h"
 #include "Win32Device/Common/Win32BIGFile.h"
 
+#include <windows.h>
+
 //============================================================================
 // Win32BIGFile::Win32BIGFile
 //============================================================================
@@ -41,6 +43,8 @@
 Win32BIGFile::Win32BIGFile(AsciiString name, AsciiString path)
 	: m_name(name)
 	, m_path(path)
+	, m_mappedData(NULL)
+	, m_mappedSize(0)
 {
 
 }
@@ -51,7 +55,68 @@ Win32BIGFile::Win32BIGFile(AsciiString name, AsciiString path)
 
 Win32BIGFile::~Win32BIGFile()
 {
+	unmapArchive();
+}
+
+//============================================================================
+// Win32BIGFile::mapArchive
+//============================================================================
+/**
+	* TheSuperHackers @performance Maps the whole BIG file into memory, so that its
+	* directory can be parsed from one buffer and its files can be opened without
+	* copying them. Returns FALSE if the file could not be mapped, for example when
+	* the address space is exhausted, in which case the files are read as before.
+	*/
+//============================================================================
+
+Bool Win32BIGFile::mapArchive( const Char *filename )
+{
+	unmapArchive();
+
+	HANDLE fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return FALSE;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart <= 0 || fileSize.QuadPart > INT_MAX) {
+		CloseHandle(fileHandle);
+		return FALSE;
+	}
 
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fileHandle);
+	if (mappingHandle == NULL) {
+		return FALSE;
+	}
+
+	// the view keeps the mapping alive
+	void *data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mappingHandle);
+	if (data == NULL) {
+		return FALSE;
+	}
+
+	m_mappedData = static_cast<const Char *>(data);
+	m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+
+	return TRUE;
+}
+
+//============================================================================
+// Win32BIGFile::unmapArchive
+//============================================================================
+
+void Win32BIGFile::unmapArchive( void )
+{
+	if (m_mappedData == NULL) {
+		return;
+	}
+
+	UnmapViewOfFile(m_mappedData);
+
+	m_mappedData = NULL;
+	m_mappedSize = 0;
 }
 
 //============================================================================
@@ -68,18 +133,36 @@ File* Win32BIGFile::openFile( const Char *filename, Int access )
 
 	RAMFile *ramFile = NULL;
 
-	if (BitIsSet(access, File::STREAMING))
-		ramFile = newInstance( StreamingArchiveFile );
-	else
-		ramFile = newInstance( RAMFile );
+	if (m_mappedData != NULL) {
+		// TheSuperHackers @performance Return a view into the mapped BIG file. This also serves
+		// streaming access, because the operating system only pages in what is being read.
+		if (fileInfo->m_offset + (size_t)fileInfo->m_size > m_mappedSize) {
+			DEBUG_CRASH(("File %s exceeds the BIG file %s", filename, m_name.str()));
+			return NULL;
+		}
 
-	ramFile->deleteOnClose();
-	if (ramFile->openFromArchive(m_file, fileInfo->m_filename, fileInfo->m_offset, fileInfo->m_size) == FALSE) {
-		ramFile->close();
-		ramFile = NULL;
-		return NULL;
+		ramFile = newInstance( RAMFile );
+		ramFile->deleteOnClose();
+		if (ramFile->openFromMemory(fileInfo->m_filename, m_mappedData + fileInfo->m_offset, fileInfo->m_size) == FALSE) {
+			ramFile->close();
+			ramFile = NULL;
+			return NULL;
+		}
+	} else {
+		if (BitIsSet(access, File::STREAMING))
+			ramFile = newInstance( StreamingArchiveFile );
+		else
+			ramFile = newInstance( RAMFile );
+
+		ramFile->deleteOnClose();
+		if (ramFile->openFromArchive(m_file, fileInfo->m_filename, fileInfo->m_offset, fileInfo->m_size) == FALSE) {
+			ramFile->close();
+			ramFile = NULL;
+			return NULL;
+		}
 	}
 
+
 	if ((access & File::WRITE) == 0) {
 		// requesting read only access. Just return the RAM file.
 		return ramFile;
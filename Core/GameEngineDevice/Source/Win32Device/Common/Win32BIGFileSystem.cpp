@@ -57,6 +57,9 @@ void Win32BIGFileSystem::init() {
 		return;
 	}
 
+	// TheSuperHackers @performance Unchanged archives are added from the index cache
+	loadIndexCache();
+
 	loadBigFilesFromDirectory("", "*.big");
 
 #if RTS_ZEROHOUR
@@ -68,6 +71,8 @@ void Win32BIGFileSystem::init() {
     if (!installPath.isEmpty())
       loadBigFilesFromDirectory(installPath, "*.big");
 #endif
+
+	m_indexCache.save();
 }
 
 void Win32BIGFileSystem::reset() {
@@ -86,6 +91,7 @@ ArchiveFile * Win32BIGFileSystem::openArchiveFile(const Char *filename) {
 	archiveFileName.toLower();
 	Int archiveFileSize = 0;
 	Int numLittleFiles = 0;
+	Int headerSize = 0;
 
 	DEBUG_LOG(("Win32BIGFileSystem::openArchiveFile - opening BIG file %s", filename));
 
@@ -94,62 +100,96 @@ ArchiveFile * Win32BIGFileSystem::openArchiveFile(const Char *filename) {
 		return NULL;
 	}
 
-	AsciiString asciibuf;
-	char buffer[_MAX_PATH];
-	fp->read(buffer, 4); // read the "BIG" at the beginning of the file.
-	buffer[4] = 0;
-	if (strcmp(buffer, BIGFileIdentifier) != 0) {
+	// TheSuperHackers @fix Mauller 23/04/2025 Create new file handle when necessary to prevent memory leak
+	Win32BIGFile *archiveFile = NEW Win32BIGFile(filename, AsciiString::TheEmptyString);
+
+	// TheSuperHackers @performance Parse the directory from one buffer instead of reading it
+	// field by field and byte by byte. Use the mapped archive if possible, otherwise read the
+	// header and the directory with two reads.
+	std::vector<char> directoryBuffer;
+	const char *data = NULL;
+	size_t dataSize = 0;
+
+	Bool mapped = archiveFile->mapArchive(fp->getName());
+
+	// TheSuperHackers @performance Skip parsing the directory if the archive did not change since it was cached.
+	if (m_indexCache.restoreArchive(filename, archiveFile)) {
+		archiveFile->attachFile(fp);
+		return archiveFile;
+	}
+
+	if (mapped) {
+		data = archiveFile->getMappedData();
+		dataSize = archiveFile->getMappedSize();
+	} else {
+		directoryBuffer.resize(0x10);
+		if (fp->read(&directoryBuffer[0], 0x10) == 0x10) {
+			memcpy(&headerSize, &directoryBuffer[12], 4);
+			headerSize = betoh(headerSize);
+			if (headerSize > 0x10 && headerSize <= fp->size()) {
+				directoryBuffer.resize(headerSize);
+				headerSize = 0x10 + fp->read(&directoryBuffer[0x10], headerSize - 0x10);
+			}
+			directoryBuffer.resize(headerSize > 0x10 ? headerSize : 0x10);
+			data = &directoryBuffer[0];
+			dataSize = directoryBuffer.size();
+		}
+	}
+
+	// check the "BIG" at the beginning of the file.
+	if (dataSize < 0x10 || memcmp(data, BIGFileIdentifier, 4) != 0) {
 		DEBUG_CRASH(("Error reading BIG file identifier in file %s", filename));
+		delete archiveFile;
 		fp->close();
 		fp = NULL;
 		return NULL;
 	}
 
 	// read in the file size.
-	fp->read(&archiveFileSize, 4);
+	memcpy(&archiveFileSize, data + 4, 4);
 
 	DEBUG_LOG(("Win32BIGFileSystem::openArchiveFile - size of archive file is %d bytes", archiveFileSize));
 
-//	char t;
-
 	// read in the number of files contained in this BIG file.
 	// change the order of the bytes cause the file size is in reverse byte order for some reason.
-	fp->read(&numLittleFiles, 4);
+	memcpy(&numLittleFiles, data + 8, 4);
 	numLittleFiles = betoh(numLittleFiles);
 
 	DEBUG_LOG(("Win32BIGFileSystem::openArchiveFile - %d are contained in archive", numLittleFiles));
-//	for (Int i = 0; i < 2; ++i) {
-//		t = buffer[i];
-//		buffer[i] = buffer[(4-i)-1];
-//		buffer[(4-i)-1] = t;
-//	}
-
-	// seek to the beginning of the directory listing.
-	fp->seek(0x10, File::START);
-	// read in each directory listing.
+
+	// the directory listing starts at 0x10.
+	size_t pos = 0x10;
+	char buffer[_MAX_PATH];
 	ArchivedFileInfo *fileInfo = NEW ArchivedFileInfo;
-	// TheSuperHackers @fix Mauller 23/04/2025 Create new file handle when necessary to prevent memory leak
-	ArchiveFile *archiveFile = NEW Win32BIGFile(filename, AsciiString::TheEmptyString);
+	fileInfo->m_archiveFilename = archiveFileName;
 
 	for (Int i = 0; i < numLittleFiles; ++i) {
 		Int filesize = 0;
 		Int fileOffset = 0;
-		fp->read(&fileOffset, 4);
-		fp->read(&filesize, 4);
+		if (pos + 8 > dataSize) {
+			DEBUG_CRASH(("Truncated directory in BIG file %s", filename));
+			break;
+		}
+		memcpy(&fileOffset, data + pos, 4);
+		memcpy(&filesize, data + pos + 4, 4);
+		pos += 8;
 
 		filesize = betoh(filesize);
 		fileOffset = betoh(fileOffset);
 
-		fileInfo->m_archiveFilename = archiveFileName;
 		fileInfo->m_offset = fileOffset;
 		fileInfo->m_size = filesize;
 
 		// read in the path name of the file.
-		Int pathIndex = -1;
-		do {
-			++pathIndex;
-			fp->read(buffer + pathIndex, 1);
-		} while (buffer[pathIndex] != 0);
+		const char *pathStart = data + pos;
+		const char *pathEnd = static_cast<const char *>(memchr(pathStart, 0, dataSize - pos));
+		if (pathEnd == NULL || pathEnd - pathStart >= _MAX_PATH) {
+			DEBUG_CRASH(("Bad file name in directory of BIG file %s", filename));
+			break;
+		}
+		Int pathIndex = (Int)(pathEnd - pathStart);
+		memcpy(buffer, pathStart, pathIndex + 1);
+		pos += pathIndex + 1;
 
 		Int filenameIndex = pathIndex;
 		while ((filenameIndex >= 0) && (buffer[filenameIndex] != '\\') && (buffer[filenameIndex] != '/')) {
@@ -163,10 +203,7 @@ ArchiveFile * Win32BIGFileSystem::openArchiveFile(const Char *filename) {
 		AsciiString path;
 		path = buffer;
 
-		AsciiString debugpath;
-		debugpath = path;
-		debugpath.concat(fileInfo->m_filename);
-//		DEBUG_LOG(("Win32BIGFileSystem::openArchiveFile - adding file %s to archive file %s, file number %d", debugpath.str(), fileInfo->m_archiveFilename.str(), i));
+//		DEBUG_LOG(("Win32BIGFileSystem::openArchiveFile - adding file %s%s to archive file %s, file number %d", path.str(), fileInfo->m_filename.str(), fileInfo->m_archiveFilename.str(), i));
 
 		archiveFile->addFile(path, fileInfo);
 	}
@@ -176,6 +213,8 @@ ArchiveFile * Win32BIGFileSystem::openArchiveFile(const Char *filename) {
 	delete fileInfo;
 	fileInfo = NULL;
 
+	m_indexCache.storeArchive(filename, archiveFile);
+
 	// leave fp open as the archive file will be using it.
 
 	return archiveFile;
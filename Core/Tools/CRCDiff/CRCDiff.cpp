@@ -16,6 +16,7 @@
 **	along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "CRCTree.h"
 #include "debug.h"
 #include "expander.h"
 #include "KVPair.h"
@@ -193,9 +194,33 @@ int main(int argc, char *argv[])
 	FILE *ifp[2] = {NULL, NULL};
 	std::string header, footer;
 
+	// TheSuperHackers @feature Diff two binary CRC tree files written by -crcTree. They are told
+	// apart from text logs by their header, so -tree is optional.
+	if (argc == 4 && strcmp(argv[1], "-tree") == 0)
+	{
+		for (int i = 2; i < 4; ++i)
+		{
+			if (!CRCTreeFile::isCRCTreeFile(argv[i]))
+			{
+				cout << argv[i] << " is not a CRC tree file" << endl;
+				return 1;
+			}
+		}
+		return diffCRCTreeFiles(argv[2], argv[3]);
+	}
+	if (argc == 3 && CRCTreeFile::isCRCTreeFile(argv[1]) && CRCTreeFile::isCRCTreeFile(argv[2]))
+	{
+		return diffCRCTreeFiles(argv[1], argv[2]);
+	}
+	if (argc == 7 && CRCTreeFile::isCRCTreeFile(argv[4]) && CRCTreeFile::isCRCTreeFile(argv[5]))
+	{
+		return diffCRCTreeFiles(argv[4], argv[5]);
+	}
+
 	if (argc != 7)
 	{
 		cout << "Usage: munkeeDiff top.html row.html bottom.html in1.txt in2.txt out.txt" << endl;
+		cout << "       munkeeDiff [-tree] in1.crct in2.crct" << endl;
 		header = readInFile("top.html");
 		tableRow = readInFile("row.html");
 		footer = readInFile("bottom.html");
@@ -0,0 +1,284 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ---------------------------------------------------------------------------
+// File: CRCTree.cpp
+// Description: Reads and diffs the binary CRC tree files written by -crcTree.
+// ---------------------------------------------------------------------------
+
+#include "CRCTree.h"
+#include <Utility/endian_compat.h>
+#include <Utility/iostream_adapter.h>
+#include <map>
+#include <string.h>
+
+#define CRCTREE_FILE_MAGIC		0x54435243	// "CRCT"
+#define CRCTREE_FILE_VERSION	1
+
+// Stop printing after this many diverging nodes, the first ones are the interesting ones.
+#define CRCTREE_MAX_DIFFS		50
+
+//=============================================================================
+
+static bool readUInt(FILE *fp, unsigned int& val)
+{
+	if (fread(&val, sizeof(val), 1, fp) != 1)
+		return false;
+	val = letoh(val);
+	return true;
+}
+
+static bool readUShort(FILE *fp, unsigned short& val)
+{
+	if (fread(&val, sizeof(val), 1, fp) != 1)
+		return false;
+	val = letoh(val);
+	return true;
+}
+
+//=============================================================================
+
+CRCTreeFile::CRCTreeFile( void ) : m_fp(NULL)
+{
+}
+
+CRCTreeFile::~CRCTreeFile( void )
+{
+	if (m_fp)
+		fclose(m_fp);
+}
+
+bool CRCTreeFile::isCRCTreeFile( const char *fname )
+{
+	FILE *fp = fopen(fname, "rb");
+	if (!fp)
+		return false;
+
+	unsigned int magic = 0;
+	bool ret = readUInt(fp, magic) && magic == CRCTREE_FILE_MAGIC;
+	fclose(fp);
+	return ret;
+}
+
+bool CRCTreeFile::open( const char *fname )
+{
+	m_fp = fopen(fname, "rb");
+	if (!m_fp)
+		return false;
+
+	unsigned int magic = 0;
+	unsigned int version = 0;
+	if (!readUInt(m_fp, magic) || !readUInt(m_fp, version) ||
+		magic != CRCTREE_FILE_MAGIC || version != CRCTREE_FILE_VERSION)
+	{
+		fclose(m_fp);
+		m_fp = NULL;
+		return false;
+	}
+	return true;
+}
+
+bool CRCTreeFile::readFrame( CRCTreeFrame& frame )
+{
+	if (!m_fp)
+		return false;
+
+	unsigned char tag;
+	while (fread(&tag, sizeof(tag), 1, m_fp) == 1)
+	{
+		if (tag == 'L')
+		{
+			unsigned short length;
+			if (!readUShort(m_fp, length))
+				return false;
+			std::string label(length, '\0');
+			if (length && fread(&label[0], length, 1, m_fp) != 1)
+				return false;
+			m_labels.push_back(label);
+		}
+		else if (tag == 'F')
+		{
+			unsigned int numNodes;
+			if (!readUInt(m_fp, frame.frame) || !readUInt(m_fp, frame.crc) || !readUInt(m_fp, numNodes))
+				return false;
+			frame.nodes.resize(numNodes);
+			for (unsigned int i = 0; i < numNodes; ++i)
+			{
+				CRCTreeNode& node = frame.nodes[i];
+				if (!readUShort(m_fp, node.label) || !readUShort(m_fp, node.depth) ||
+					!readUInt(m_fp, node.id) || !readUInt(m_fp, node.crc) || !readUInt(m_fp, node.subtreeSize))
+					return false;
+			}
+			return numNodes > 0;
+		}
+		else
+		{
+			cout << "Unknown record in CRC tree file" << endl;
+			return false;
+		}
+	}
+	return false;
+}
+
+const std::string& CRCTreeFile::getLabel( unsigned short label ) const
+{
+	static const std::string unknown("?");
+	if (label < m_labels.size())
+		return m_labels[label];
+	return unknown;
+}
+
+//=============================================================================
+
+struct CRCTreeSide
+{
+	const CRCTreeFile *file;
+	const CRCTreeFrame *frame;
+
+	std::string getName(size_t index) const
+	{
+		const CRCTreeNode& node = frame->nodes[index];
+		char buf[32];
+		sprintf(buf, "#%u", node.id);
+		return file->getLabel(node.label) + buf;
+	}
+};
+
+typedef std::map<std::string, size_t> ChildMap;
+
+static void printNode(const char *what, const std::string& path)
+{
+	cout << "  " << what << " " << path << endl;
+}
+
+//-----------------------------------------------------------------------------
+// Only descends into children whose CRC differs, so the cost depends on the
+// number of changed nodes rather than on the size of the tree.
+//-----------------------------------------------------------------------------
+static void diffNodes(const CRCTreeSide& left, size_t leftIndex,
+											const CRCTreeSide& right, size_t rightIndex,
+											const std::string& path, int& numDiffs)
+{
+	const CRCTreeNode& leftNode = left.frame->nodes[leftIndex];
+	const CRCTreeNode& rightNode = right.frame->nodes[rightIndex];
+
+	ChildMap rightChildren;
+	size_t i;
+	for (i = rightIndex + 1; i < rightIndex + rightNode.subtreeSize; i += right.frame->nodes[i].subtreeSize)
+	{
+		rightChildren[right.getName(i)] = i;
+	}
+
+	bool childDiffers = false;
+	for (i = leftIndex + 1; i < leftIndex + leftNode.subtreeSize; i += left.frame->nodes[i].subtreeSize)
+	{
+		if (numDiffs >= CRCTREE_MAX_DIFFS)
+			return;
+
+		std::string name = left.getName(i);
+		std::string childPath = path.empty() ? name : path + "/" + name;
+		ChildMap::iterator it = rightChildren.find(name);
+		if (it == rightChildren.end())
+		{
+			printNode("left only:", childPath);
+			childDiffers = true;
+			++numDiffs;
+			continue;
+		}
+
+		size_t rightChild = it->second;
+		rightChildren.erase(it);
+		if (left.frame->nodes[i].crc != right.frame->nodes[rightChild].crc)
+		{
+			diffNodes(left, i, right, rightChild, childPath, numDiffs);
+			childDiffers = true;
+		}
+	}
+
+	for (ChildMap::iterator it = rightChildren.begin(); it != rightChildren.end(); ++it)
+	{
+		if (numDiffs >= CRCTREE_MAX_DIFFS)
+			return;
+
+		printNode("right only:", path.empty() ? it->first : path + "/" + it->first);
+		childDiffers = true;
+		++numDiffs;
+	}
+
+	// All children match, so the data of this node itself differs
+	if (!childDiffers && numDiffs < CRCTREE_MAX_DIFFS)
+	{
+		printNode("differs:", path);
+		++numDiffs;
+	}
+}
+
+//=============================================================================
+
+int diffCRCTreeFiles( const char *fname1, const char *fname2 )
+{
+	CRCTreeFile file[2];
+	if (!file[0].open(fname1))
+	{
+		cout << "could not open CRC tree " << fname1 << endl;
+		return 1;
+	}
+	if (!file[1].open(fname2))
+	{
+		cout << "could not open CRC tree " << fname2 << endl;
+		return 1;
+	}
+
+	CRCTreeFrame frame[2];
+	bool fileOk[2];
+	fileOk[0] = file[0].readFrame(frame[0]);
+	fileOk[1] = file[1].readFrame(frame[1]);
+	while (fileOk[0] && fileOk[1])
+	{
+		// catch up if one of the files has frames the other does not have
+		if (frame[0].frame < frame[1].frame)
+		{
+			fileOk[0] = file[0].readFrame(frame[0]);
+			continue;
+		}
+		if (frame[1].frame < frame[0].frame)
+		{
+			fileOk[1] = file[1].readFrame(frame[1]);
+			continue;
+		}
+
+		if (frame[0].nodes[0].crc != frame[1].nodes[0].crc)
+		{
+			char buf[128];
+			sprintf(buf, "First divergence on frame %u (CRC %8.8X vs %8.8X):", frame[0].frame, frame[0].crc, frame[1].crc);
+			cout << buf << endl;
+
+			CRCTreeSide left = { &file[0], &frame[0] };
+			CRCTreeSide right = { &file[1], &frame[1] };
+			int numDiffs = 0;
+			diffNodes(left, 0, right, 0, std::string(), numDiffs);
+			return numDiffs;
+		}
+
+		fileOk[0] = file[0].readFrame(frame[0]);
+		fileOk[1] = file[1].readFrame(frame[1]);
+	}
+
+	cout << "No divergence found" << endl;
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ---------------------------------------------------------------------------
+// File: CRCTree.h
+// Description: Reads and diffs the binary CRC tree files written by -crcTree.
+//              The format is described in GameEngine/Include/Common/XferCRCTree.h
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+struct CRCTreeNode
+{
+	unsigned short label;
+	unsigned short depth;
+	unsigned int id;
+	unsigned int crc;
+	unsigned int subtreeSize;
+};
+
+struct CRCTreeFrame
+{
+	unsigned int frame;
+	unsigned int crc;
+	std::vector<CRCTreeNode> nodes;
+};
+
+class CRCTreeFile
+{
+public:
+	CRCTreeFile( void );
+	~CRCTreeFile( void );
+
+	static bool isCRCTreeFile( const char *fname );
+
+	bool open( const char *fname );
+	bool readFrame( CRCTreeFrame& frame );		///< reads the next frame, and the labels in front of it
+	const std::string& getLabel( unsigned short label ) const;
+
+private:
+	FILE *m_fp;
+	std::vector<std::string> m_labels;
+};
+
+/// Compare two CRC tree files and print the path of the first diverging nodes. Returns the number of differences.
+int diffCRCTreeFiles( const char *fname1, const char *fname2 );
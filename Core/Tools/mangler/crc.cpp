@@ -54,7 +54,9 @@
  * HISTORY:                                                                *
  *   05/09/1995 BRR : Created.                                             *
  *=========================================================================*/
-void Add_CRC(unsigned long *crc, unsigned char val)
+// TheSuperHackers @bugfix The CRC is 32 bits on every platform. An unsigned long made it 64 bits on
+// 64 bit Linux, where it came out different and was written over the header of the packet.
+void Add_CRC(unsigned int *crc, unsigned char val)
 {
 	int hibit;
 
@@ -89,9 +91,9 @@ void Build_Packet_CRC(unsigned char *buf, int len)
 		return;
 	}
 
-	*((unsigned long *)buf) = 0;
+	*((unsigned int *)buf) = 0;
 
-	unsigned long *crc_ptr = (unsigned long *)buf;
+	unsigned int *crc_ptr = (unsigned int *)buf;
 	unsigned char *packetptr = (unsigned char*) (buf+4);
 
 	len -= 4; // look past CRC
@@ -146,9 +148,9 @@ bool Passes_CRC_Check(unsigned char *buf, int len)
 		return false;
 	}
 
-	unsigned long crc = 0;
+	unsigned int crc = 0;
 
-	unsigned long *crc_ptr = &crc;
+	unsigned int *crc_ptr = &crc;
 	unsigned char *packetptr = (unsigned char*) (buf+4);
 
 	len -= 4; // remove the CRC from packet size - just look at payload
@@ -171,7 +173,7 @@ bool Passes_CRC_Check(unsigned char *buf, int len)
 */
 	crc = htonl(crc);
 
-	if (crc == *((unsigned long *)buf)) {
+	if (crc == *((unsigned int *)buf)) {
 		return (true);
 	}
 
@@ -25,6 +25,7 @@
 #endif
 
 #include "mangler.h"
+#include "manglerserver.h"
 #include "crc.h"
 #include "endian.h"
 
@@ -117,16 +118,8 @@ int main(int argc, char **argv)
 #endif
 
 
-	// Set up a UDP listener
-	uint8  *buff=new uint8[1024];
-	int     retval;
-	UDP     udp;
-	UDP     udp2;
-	UDP     udp3;
-	UDP     udp4;
 	int     port = 4321;
 	config.getInt("PORT", port);
-	uint8 blitz = 0;
 
 	uint32 localIP = 0;
 	Wstring hostIPStr = "";
@@ -141,6 +134,30 @@ int main(int argc, char **argv)
 		INFMSG("Binding to localhost:"<<port<<"-"<<(port+3));
 	}
 
+	int packet_size = sizeof(ManglerData);
+	INFMSG("sizeof(packet) == " << packet_size);
+
+#ifdef __linux__
+	// TheSuperHackers @performance Serve the probes from an epoll reactor with batched reads and
+	// writes. WORKERS sets the number of workers sharing the ports, 0 starts one per core.
+	int workers = 1;
+	config.getInt("WORKERS", workers);
+	ManglerServer server;
+	if (!server.init(localIP, port, workers))
+	{
+		ERRMSG("Couldn't bind");
+		exit(1);
+	}
+	server.run();
+#else
+	// Set up a UDP listener
+	int     retval;
+	UDP     udp;
+	UDP     udp2;
+	UDP     udp3;
+	UDP     udp4;
+	uint8 blitz = 0;
+
 	retval  =  udp.Bind(localIP,(uint16)port);
 	retval |= udp2.Bind(localIP,(uint16)port+1);
 	retval |= udp3.Bind(localIP,(uint16)port+2);
@@ -153,8 +170,6 @@ int main(int argc, char **argv)
 
 	unsigned char buf[1024];
 	struct sockaddr_in addr;
-	int packet_size = sizeof(ManglerData);
-	INFMSG("sizeof(packet) == " << packet_size);
 	unsigned char *theAddr;
 	fd_set fdset;
 	while (1)
@@ -175,20 +190,13 @@ int main(int argc, char **argv)
 			}
 			else
 			{
-				if (!Passes_CRC_Check(buf, packet_size))
+				if (!Mangle_Packet(buf, packet_size, addr))
 				{
 					WRNMSG("Recieved a bad packet - good length!");
 					continue;
 				}
-				packet->NetCommandType = 44;
-				packet->MyMangledPortNumber = addr.sin_port; // not changing to host order, cause its in network byte order now, and the game will expect it to stay that way.
-				packet->MyMangledAddress[0] = theAddr[0];
-				packet->MyMangledAddress[1] = theAddr[1];
-				packet->MyMangledAddress[2] = theAddr[2];
-				packet->MyMangledAddress[3] = theAddr[3];
 				blitz = packet->BlitzMe;
 				INFMSG("Packet ID = " << packet->packetID);
-				Build_Packet_CRC(buf, packet_size);
 				udp.Write(buf,packet_size,ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
 				INFMSG("Saw " << (int)theAddr[0] << "." << (int)theAddr[1] << "." << (int)theAddr[2] << "." << (int)theAddr[3] << ":" << ntohs(addr.sin_port) << ((blitz)?" Blitzed":"") );
 
@@ -201,6 +209,7 @@ int main(int argc, char **argv)
 			}
 		}
 	}
+#endif
 
 
 	return 0;
@@ -0,0 +1,436 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Utility/iostream_adapter.h>
+
+#ifdef _WIN32
+#include <process.h> // *MUST* be included before ANY Wnet/Wlib headers if _REENTRANT is defined
+#endif
+
+#include "mangler.h"
+#include "manglerserver.h"
+#include "crc.h"
+
+#include <wdebug.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+bool Mangle_Packet(unsigned char *buf, int len, const struct sockaddr_in &from)
+{
+	if (len != sizeof(ManglerData) || !Passes_CRC_Check(buf, len))
+		return false;
+
+	ManglerData *packet = (ManglerData *)buf;
+	const unsigned char *theAddr = (const unsigned char *)&(from.sin_addr.s_addr);
+	packet->NetCommandType = NET_MANGLER_RESPONSE;
+	packet->MyMangledPortNumber = from.sin_port; // not changing to host order, cause its in network byte order now, and the game will expect it to stay that way.
+	packet->MyMangledAddress[0] = theAddr[0];
+	packet->MyMangledAddress[1] = theAddr[1];
+	packet->MyMangledAddress[2] = theAddr[2];
+	packet->MyMangledAddress[3] = theAddr[3];
+	Build_Packet_CRC(buf, len);
+	return true;
+}
+
+#ifdef __linux__
+
+// =====================================================================
+// Worker
+// =====================================================================
+
+class ManglerWorker : public Runnable
+{
+public:
+	ManglerWorker(int index);
+	virtual ~ManglerWorker();
+
+	bool init(uint32 localIP, int port, bool sharePorts);
+	virtual void run(void *data);
+
+	// Adds the counters since the last call to 'counters'
+	void takeCounters(ManglerCounters &counters);
+
+private:
+	enum
+	{
+		BatchSize = 64 // packets read or written with one call
+	};
+
+	int openSocket(uint32 localIP, int port, bool sharePort);
+	void readProbes(void);
+	int sendReplies(int sock, struct mmsghdr *msgs, int count); // returns the replies it could not send
+
+	int m_index;
+	int m_sockets[1 + BLITZ_SIZE]; // the probes come in on the first, the others only send the blitz
+	int m_epoll;
+	uint32 m_queueOverflow; // the kernel's count of dropped probes, as of the last one read
+
+	CritSec m_countersLock;
+	ManglerCounters m_counters;
+
+	unsigned char m_packets[BatchSize][sizeof(ManglerData)]; // the replies are written over the probes
+	struct sockaddr_in m_from[BatchSize];
+	struct iovec m_iov[BatchSize];
+	char m_control[BatchSize][CMSG_SPACE(sizeof(uint32))];
+	struct mmsghdr m_probes[BatchSize];
+	struct mmsghdr m_replies[BatchSize];
+	struct mmsghdr m_blitzReplies[BLITZ_SIZE][BatchSize];
+	struct sockaddr_in m_blitzTo[BLITZ_SIZE][BatchSize];
+};
+
+ManglerWorker::ManglerWorker(int index)
+{
+	m_index = index;
+	for (int i=0; i<1+BLITZ_SIZE; ++i)
+		m_sockets[i] = -1;
+	m_epoll = -1;
+	m_queueOverflow = 0;
+	memset(&m_counters, 0, sizeof(m_counters));
+
+	memset(m_probes, 0, sizeof(m_probes));
+	memset(m_replies, 0, sizeof(m_replies));
+	memset(m_blitzReplies, 0, sizeof(m_blitzReplies));
+	for (int p=0; p<BatchSize; ++p)
+	{
+		m_iov[p].iov_base = m_packets[p];
+		m_iov[p].iov_len = sizeof(ManglerData);
+		m_probes[p].msg_hdr.msg_name = &m_from[p];
+		m_probes[p].msg_hdr.msg_iov = &m_iov[p];
+		m_probes[p].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+ManglerWorker::~ManglerWorker()
+{
+	for (int i=0; i<1+BLITZ_SIZE; ++i)
+	{
+		if (m_sockets[i] != -1)
+			close(m_sockets[i]);
+	}
+	if (m_epoll != -1)
+		close(m_epoll);
+}
+
+int ManglerWorker::openSocket(uint32 localIP, int port, bool sharePort)
+{
+	int sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, DEFAULT_PROTOCOL);
+	if (sock == -1)
+	{
+		ERRMSG("Worker " << m_index << " couldn't create a socket - error " << errno);
+		return -1;
+	}
+
+	int on = 1;
+	if (sharePort && setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)
+	{
+		ERRMSG("Worker " << m_index << " couldn't share port " << port << " - error " << errno);
+		close(sock);
+		return -1;
+	}
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16)port);
+	addr.sin_addr.s_addr = htonl(localIP);
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+	{
+		ERRMSG("Worker " << m_index << " couldn't bind port " << port << " - error " << errno);
+		close(sock);
+		return -1;
+	}
+	return sock;
+}
+
+bool ManglerWorker::init(uint32 localIP, int port, bool sharePorts)
+{
+	for (int i=0; i<1+BLITZ_SIZE; ++i)
+	{
+		m_sockets[i] = openSocket(localIP, port + i, sharePorts);
+		if (m_sockets[i] == -1)
+			return false;
+	}
+
+#ifdef SO_RXQ_OVFL
+	// have the kernel tell with every probe how many it dropped so far
+	int on = 1;
+	if (setsockopt(m_sockets[0], SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)) != 0)
+	{
+		WRNMSG("Worker " << m_index << " can't count the probes the kernel drops - error " << errno);
+	}
+#endif
+
+	m_epoll = epoll_create(1);
+	if (m_epoll == -1)
+	{
+		ERRMSG("Worker " << m_index << " couldn't create an epoll instance - error " << errno);
+		return false;
+	}
+
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = m_sockets[0];
+	if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_sockets[0], &event) != 0)
+	{
+		ERRMSG("Worker " << m_index << " couldn't wait on its socket - error " << errno);
+		return false;
+	}
+	return true;
+}
+
+void ManglerWorker::takeCounters(ManglerCounters &counters)
+{
+	m_countersLock.lock();
+	counters.received += m_counters.received;
+	counters.replied += m_counters.replied;
+	counters.blitzed += m_counters.blitzed;
+	counters.badSize += m_counters.badSize;
+	counters.badCRC += m_counters.badCRC;
+	counters.sendDrops += m_counters.sendDrops;
+	counters.queueDrops += m_counters.queueDrops;
+	memset(&m_counters, 0, sizeof(m_counters));
+	m_countersLock.unlock();
+}
+
+void ManglerWorker::run(void *data)
+{
+	struct epoll_event event;
+	while (1)
+	{
+		int retval = epoll_wait(m_epoll, &event, 1, -1);
+		if (retval > 0)
+		{
+			readProbes();
+		}
+		else if (retval == -1 && errno != EINTR)
+		{
+			ERRMSG("Worker " << m_index << " stopped waiting for probes - error " << errno);
+			return;
+		}
+	}
+}
+
+int ManglerWorker::sendReplies(int sock, struct mmsghdr *msgs, int count)
+{
+	int dropped = 0;
+	int next = 0;
+	while (next < count)
+	{
+		int retval = sendmmsg(sock, msgs + next, count - next, MSG_DONTWAIT);
+		if (retval > 0)
+		{
+			next += retval;
+		}
+		else if (retval == -1 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (retval == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			// no room in the send buffer, don't wait for it
+			dropped += count - next;
+			break;
+		}
+		else
+		{
+			// this one can't be sent, the rest may
+			DBGMSG("Worker " << m_index << " couldn't send a reply - error " << errno);
+			++dropped;
+			++next;
+		}
+	}
+	return dropped;
+}
+
+void ManglerWorker::readProbes(void)
+{
+	ManglerCounters counters;
+	memset(&counters, 0, sizeof(counters));
+
+	while (1)
+	{
+		for (int p=0; p<BatchSize; ++p)
+		{
+			m_probes[p].msg_hdr.msg_namelen = sizeof(m_from[p]);
+			m_probes[p].msg_hdr.msg_control = m_control[p];
+			m_probes[p].msg_hdr.msg_controllen = sizeof(m_control[p]);
+			m_probes[p].msg_hdr.msg_flags = 0;
+		}
+
+		int count = recvmmsg(m_sockets[0], m_probes, BatchSize, MSG_DONTWAIT, NULL);
+		if (count == -1 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			break;
+
+		int numReplies = 0;
+		int numBlitzed = 0;
+		for (int i=0; i<count; ++i)
+		{
+			struct msghdr &hdr = m_probes[i].msg_hdr;
+			for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+			{
+#ifdef SO_RXQ_OVFL
+				if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+				{
+					uint32 overflow;
+					memcpy(&overflow, CMSG_DATA(cmsg), sizeof(overflow));
+					counters.queueDrops += overflow - m_queueOverflow;
+					m_queueOverflow = overflow;
+				}
+#endif
+			}
+
+			const struct sockaddr_in &from = m_from[i];
+			const unsigned char *theAddr = (const unsigned char *)&(from.sin_addr.s_addr);
+			if (m_probes[i].msg_len != sizeof(ManglerData) || (hdr.msg_flags & MSG_TRUNC))
+			{
+				DBGMSG("Recieved mis-sized packet from " << (int)theAddr[0] << "." << (int)theAddr[1] << "." << (int)theAddr[2] << "." << (int)theAddr[3] << ":" << ntohs(from.sin_port));
+				++counters.badSize;
+				continue;
+			}
+			if (!Mangle_Packet(m_packets[i], sizeof(ManglerData), from))
+			{
+				DBGMSG("Recieved a bad packet - good length!");
+				++counters.badCRC;
+				continue;
+			}
+
+			struct msghdr &reply = m_replies[numReplies].msg_hdr;
+			reply.msg_name = &m_from[i];
+			reply.msg_namelen = sizeof(m_from[i]);
+			reply.msg_iov = &m_iov[i];
+			reply.msg_iovlen = 1;
+			++numReplies;
+
+			const ManglerData *packet = (const ManglerData *)m_packets[i];
+			DBGMSG("Saw " << (int)theAddr[0] << "." << (int)theAddr[1] << "." << (int)theAddr[2] << "." << (int)theAddr[3] << ":" << ntohs(from.sin_port) << ((packet->BlitzMe)?" Blitzed":""));
+			if (packet->BlitzMe)
+			{
+				for (int b=0; b<BLITZ_SIZE; ++b)
+				{
+					m_blitzTo[b][numBlitzed] = from;
+					m_blitzTo[b][numBlitzed].sin_port = htons(ntohs(from.sin_port) + 1 + b);
+
+					struct msghdr &blitz = m_blitzReplies[b][numBlitzed].msg_hdr;
+					blitz.msg_name = &m_blitzTo[b][numBlitzed];
+					blitz.msg_namelen = sizeof(m_blitzTo[b][numBlitzed]);
+					blitz.msg_iov = &m_iov[i];
+					blitz.msg_iovlen = 1;
+				}
+				++numBlitzed;
+			}
+		}
+
+		int dropped = sendReplies(m_sockets[0], m_replies, numReplies);
+		counters.replied += numReplies - dropped;
+		counters.sendDrops += dropped;
+		for (int b=0; b<BLITZ_SIZE; ++b)
+		{
+			counters.sendDrops += sendReplies(m_sockets[1 + b], m_blitzReplies[b], numBlitzed);
+		}
+		counters.blitzed += numBlitzed;
+		counters.received += count;
+
+		if (count < BatchSize)
+			break;
+	}
+
+	m_countersLock.lock();
+	m_counters.received += counters.received;
+	m_counters.replied += counters.replied;
+	m_counters.blitzed += counters.blitzed;
+	m_counters.badSize += counters.badSize;
+	m_counters.badCRC += counters.badCRC;
+	m_counters.sendDrops += counters.sendDrops;
+	m_counters.queueDrops += counters.queueDrops;
+	m_countersLock.unlock();
+}
+
+// =====================================================================
+// Server
+// =====================================================================
+
+ManglerServer::ManglerServer()
+{
+	m_workers = NULL;
+	m_numWorkers = 0;
+}
+
+ManglerServer::~ManglerServer()
+{
+	for (int w=0; w<m_numWorkers; ++w)
+		delete m_workers[w];
+	delete[] m_workers;
+}
+
+bool ManglerServer::init(uint32 localIP, int port, int numWorkers)
+{
+	if (numWorkers <= 0)
+	{
+		numWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+		if (numWorkers < 1)
+			numWorkers = 1;
+	}
+
+	m_workers = new ManglerWorker *[numWorkers];
+	for (m_numWorkers=0; m_numWorkers<numWorkers; ++m_numWorkers)
+	{
+		m_workers[m_numWorkers] = new ManglerWorker(m_numWorkers);
+		if (!m_workers[m_numWorkers]->init(localIP, port, numWorkers > 1))
+		{
+			++m_numWorkers; // so it gets deleted
+			return false;
+		}
+	}
+
+	INFMSG("Serving with " << m_numWorkers << " worker(s)");
+	return true;
+}
+
+void ManglerServer::run(void)
+{
+	for (int w=0; w<m_numWorkers; ++w)
+		m_workers[w]->startThread(NULL);
+
+	while (1)
+	{
+		sleep(1);
+
+		ManglerCounters counters;
+		memset(&counters, 0, sizeof(counters));
+		for (int w=0; w<m_numWorkers; ++w)
+			m_workers[w]->takeCounters(counters);
+
+		// quiet seconds are not worth a line in the log
+		if (counters.received == 0 && counters.queueDrops == 0)
+			continue;
+
+		INFMSG("Packets/s: " << counters.received << " received, " << counters.replied << " replied, "
+		       << counters.blitzed << " blitzed - drops/s: " << counters.badSize << " mis-sized, "
+		       << counters.badCRC << " bad CRC, " << counters.sendDrops << " send buffer full, "
+		       << counters.queueDrops << " receive queue full");
+	}
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <udp.h>
+
+// Turns a probe that came in from 'from' into the reply that tells the sender its mangled address.
+// Returns false if the packet is not a probe, in which case it gets no reply.
+bool Mangle_Packet(unsigned char *buf, int len, const struct sockaddr_in &from);
+
+#ifdef __linux__
+
+#include "threadfac.h"
+#include "critsec.h"
+
+struct ManglerCounters
+{
+	uint32 received;
+	uint32 replied;
+	uint32 blitzed;
+	uint32 badSize;     // dropped, not the size of a probe
+	uint32 badCRC;      // dropped, failed the CRC check
+	uint32 sendDrops;   // replies the socket had no room for
+	uint32 queueDrops;  // dropped by the kernel because the receive queue was full
+};
+
+class ManglerWorker;
+
+// TheSuperHackers @performance Serves the probes from one or more workers instead of answering one
+// packet at a time on a single socket.  Each worker owns its own set of sockets on the mangler ports,
+// shared through SO_REUSEPORT when there is more than one worker, and waits on them with epoll.
+// Probes are read and the replies written in batches with recvmmsg and sendmmsg, and replies that
+// do not fit into the send buffer are dropped rather than waited for, so a client that floods the
+// server cannot hold up the others.
+class ManglerServer
+{
+public:
+	ManglerServer();
+	~ManglerServer();
+
+	// numWorkers 0 starts one worker per core
+	bool init(uint32 localIP, int port, int numWorkers);
+
+	// Starts the workers and reports their counters every second.  Does not return.
+	void run(void);
+
+private:
+	ManglerWorker **m_workers;
+	int m_numWorkers;
+};
+
+#endif
@@ -20,6 +20,8 @@
 #include <Utility/iostream_adapter.h>
 
 #include <signal.h>
+#include <algorithm>
+#include <vector>
 #ifdef _WIN32
 #include <process.h> // *MUST* be included before ANY Wnet/Wlib headers if _REENTRANT is defined
 #endif
@@ -37,6 +39,7 @@
 #include <wstring.h>
 #include <wdebug.h>
 #include <udp.h>
+#include <wtime.h>
 
 // ST - 2/1/01 12:46PM
 bool BigEndian = false;
@@ -68,6 +71,65 @@ unsigned long ResolveIP(const char *Server)
   return ( ntohl(serverNode->s_addr) );
 }
 
+struct LoadSlot
+{
+	unsigned short id; // of the probe in flight in this slot
+	uint32 sent;       // usec into the test
+};
+
+struct LoadClient
+{
+	UDP udp;
+	uint16 port;
+	std::vector<LoadSlot> slots;
+};
+
+struct LoadCounters
+{
+	uint32 sent;
+	uint32 replies;
+	uint32 lost;      // no reply within TIMEOUT
+	uint32 late;      // reply after TIMEOUT
+	uint32 bad;       // mis-sized, failed the CRC check or not a reply
+	uint32 wrongPort;
+};
+
+// Microseconds from 'from' to 'to'.  Wtime only has milliseconds on Windows.
+uint32 UsecBetween(const Wtime &from, const Wtime &to)
+{
+	return (to.GetSec() - from.GetSec()) * 1000000 + to.GetUsec() - from.GetUsec();
+}
+
+// 'values' must be sorted
+uint32 Percentile(const std::vector<uint32> &values, double percent)
+{
+	size_t index = (size_t)(values.size() * percent / 100.0);
+	if (index >= values.size())
+		index = values.size() - 1;
+	return values[index];
+}
+
+// Sends a new probe from the slot, in place of the one that was in flight in it.  The IDs of the
+// probes of a slot step by the window size, so the slot of a reply is its ID modulo the window.
+void SendProbe(LoadClient &client, int slotIndex, unsigned char *buf, unsigned long server_addr, int port,
+	int doBlitz, uint32 now, LoadCounters &counters)
+{
+	LoadSlot &slot = client.slots[slotIndex];
+	slot.id = (unsigned short)(slot.id + client.slots.size());
+	slot.sent = now;
+
+	const int packet_size = sizeof(ManglerData);
+	ManglerData *packet = (ManglerData *)buf;
+	memset(buf, 0, packet_size);
+	packet->NetCommandType = NET_MANGLER_REQUEST;
+	packet->packetID = slot.id;
+	packet->BlitzMe = doBlitz;
+	packet->magic = htons((unsigned short)0xf00d);
+	Build_Packet_CRC(buf, packet_size);
+	client.udp.Write(buf, packet_size, server_addr, (uint16)port);
+	++counters.sent;
+}
+
 void DisplayHelp(const char *prog)
 {
 	cout << "Usage: " << prog << " <config file>" << endl;
@@ -148,35 +210,32 @@ int main(int argc, char **argv)
 #endif
 
 
-	// Set up a UDP listener
-	uint8  *buff=new uint8[1024];
-	int     retval;
-	UDP     udp;
-	int     port = 4321;
+	// TheSuperHackers @feature Keeps WINDOW probes in flight from each of CLIENTS sockets for
+	// DURATION seconds, and reports the replies per second and the latency of the replies.
+	int port = 4321;
 	config.getInt("MANGLERPORT", port);
-
 	int localport = 4444;
 	config.getInt("CLIENTPORT", localport);
-	retval = udp.Bind((uint32)0,(uint16)localport);
-	DBGMSG("Bind returned " << retval);
-
-	//-----------------------------------------------------------------------------------------
-	const int packet_size = sizeof(ManglerData);
-	INFMSG("sizeof(packet) == " << packet_size);
-
-	unsigned char buf[packet_size];
-	memset(buf, 0x44, packet_size);  // init to something known for memory dumps :)
-	struct sockaddr_in addr;
-
+	int numClients = 4;
+	config.getInt("CLIENTS", numClients);
+	int window = 16;
+	config.getInt("WINDOW", window);
+	int duration = 10;
+	config.getInt("DURATION", duration);
+	int timeout = 1000;
+	config.getInt("TIMEOUT", timeout);
 	int doBlitz = 0;
 	config.getInt("BLITZ", doBlitz);
-	if (doBlitz)
-	{
-		INFMSG("Requsting port blitz");
-	}
 
-	unsigned char *theAddr;
-	fd_set fdset;
+	if (numClients < 1)
+		numClients = 1;
+	if (numClients > FD_SETSIZE - 16)
+		numClients = FD_SETSIZE - 16; // leave some for the sockets and files that are open already
+	// the slot of a probe is its ID modulo the window, which must stay true when the ID wraps
+	int windowSize = 1;
+	while (windowSize < window && windowSize < 0x8000)
+		windowSize <<= 1;
+
 	unsigned long server_addr;
 	Wstring manglername = "localhost";
 	config.getString("MANGLERIP", manglername);
@@ -187,58 +246,146 @@ int main(int argc, char **argv)
 		return 1;
 	}
 
+	const int packet_size = sizeof(ManglerData);
+	INFMSG("sizeof(packet) == " << packet_size);
+	if (doBlitz)
+	{
+		INFMSG("Requsting port blitz, only the direct replies are timed");
+	}
+
+	// a blitz goes to the three ports after the client's, keep those free
+	int portStep = doBlitz ? 1 + BLITZ_SIZE : 1;
+	std::vector<LoadClient> clients(numClients);
+	fd_set clientSet;
+	FD_ZERO(&clientSet);
+	for (int c=0; c<numClients; ++c)
+	{
+		LoadClient &client = clients[c];
+		uint16 clientPort = localport ? (uint16)(localport + c * portStep) : 0;
+		if (client.udp.Bind((uint32)0, clientPort) != 0)
+		{
+			ERRMSG("Cannot bind client port " << clientPort);
+			return 1;
+		}
+		uint32 ip;
+		client.udp.getLocalAddr(ip, client.port);
+		client.slots.resize(windowSize);
+		for (int s=0; s<windowSize; ++s)
+			client.slots[s].id = (unsigned short)(s - windowSize); // the first probe of the slot gets ID s
+		FD_SET(client.udp.getFD(), &clientSet);
+	}
+
+	INFMSG("Sending to " << manglername.get() << ":" << port << " from " << numClients << " clients, "
+	       << windowSize << " probes in flight each, for " << duration << " seconds");
+
+	unsigned char buf[packet_size];
+	memset(buf, 0x44, packet_size);  // init to something known for memory dumps :)
 	ManglerData *packet = (ManglerData *)buf;
-	packet->NetCommandType = 12;
-	packet->packetID = 9999;
-	packet->BlitzMe = doBlitz;
-	packet->magic = htons((unsigned short)0xf00d);
-	Build_Packet_CRC(buf, packet_size);
-	DBGMSG("Writing to " << manglername.get() << ":" << port);
-	udp.Write(buf,packet_size,server_addr, 4321);
+	struct sockaddr_in addr;
+	fd_set fdset;
 
-	retval = udp.Wait(5, 0, fdset);
-	if (retval)
+	LoadCounters total;
+	memset(&total, 0, sizeof(total));
+	uint32 secondReplies = 0;
+	int second = 0;
+	std::vector<uint32> latencies;
+
+	const uint32 timeoutUsec = (uint32)timeout * 1000;
+	Wtime start;
+	Wtime now;
+	uint32 elapsed = 0;
+	uint32 lastSweep = 0;
+	for (int c=0; c<numClients; ++c)
 	{
-		DBGMSG("Wait returned " << retval);
-		retval = udp.Read(buf, packet_size, &addr);        // Wait until there is something on the socket
-		if (retval > 0)
+		for (int s=0; s<windowSize; ++s)
+			SendProbe(clients[c], s, buf, server_addr, port, doBlitz, elapsed, total);
+	}
+
+	while (1)
+	{
+		now.Update();
+		elapsed = UsecBetween(start, now);
+		if (elapsed / 1000000 != (uint32)second)
+		{
+			INFMSG("Second " << (second + 1) << ": " << secondReplies << " replies/s");
+			secondReplies = 0;
+			second = elapsed / 1000000;
+		}
+		if (second >= duration)
+			break;
+
+		// probes that got no reply in time are lost, send new ones in their place
+		if (elapsed - lastSweep >= 10000)
 		{
-			theAddr = (unsigned char *)&(addr.sin_addr.s_addr);
-			if (retval != packet_size)
+			for (int c=0; c<numClients; ++c)
 			{
-				WRNMSG("Recieved mis-sized packet (" << retval << " bytes) from " << theAddr[0] << "." << theAddr[1] << "." << theAddr[2] << "." << theAddr[3] << ":" << addr.sin_port);
+				LoadClient &client = clients[c];
+				for (int s=0; s<windowSize; ++s)
+				{
+					if (elapsed - client.slots[s].sent >= timeoutUsec)
+					{
+						++total.lost;
+						SendProbe(client, s, buf, server_addr, port, doBlitz, elapsed, total);
+					}
+				}
 			}
-			else
+			lastSweep = elapsed;
+		}
+
+		if (clients[0].udp.Wait(0, 10000, clientSet, fdset) <= 0)
+			continue;
+
+		for (int c=0; c<numClients; ++c)
+		{
+			LoadClient &client = clients[c];
+			if (!FD_ISSET(client.udp.getFD(), &fdset))
+				continue;
+
+			int retval;
+			while ((retval = client.udp.Read(buf, packet_size, &addr)) > 0)
 			{
-				int packetCommand;
-				packetCommand = packet->NetCommandType;
-				if (!Passes_CRC_Check(buf, packet_size))
+				now.Update();
+				elapsed = UsecBetween(start, now);
+				if (retval != packet_size || !Passes_CRC_Check(buf, packet_size) || packet->NetCommandType != NET_MANGLER_RESPONSE)
 				{
-					WRNMSG("CRC error!");
+					++total.bad;
+					continue;
 				}
-				else if (packetCommand != 13)
+				if (ntohs(packet->MyMangledPortNumber) != client.port)
 				{
-					WRNMSG("Returned packet had command type " << packetCommand);
+					// the server saw another port than the one the probe was sent from, no NAT on loopback
+					++total.wrongPort;
 				}
-				else
+
+				int slotIndex = packet->packetID & (windowSize - 1);
+				LoadSlot &slot = client.slots[slotIndex];
+				if (slot.id != packet->packetID)
 				{
-					int addr[4];
-					unsigned short retPort;
-					retPort = htons(packet->MyMangledPortNumber);
-					addr[0] = packet->MyMangledAddress[0];
-					addr[1] = packet->MyMangledAddress[1];
-					addr[2] = packet->MyMangledAddress[2];
-					addr[3] = packet->MyMangledAddress[3];
-					DBGMSG("Saw " << addr[0] << "." << addr[1] << "." << addr[2] << "." << addr[3] << ":" << retPort);
+					// a reply to a probe that was counted as lost already
+					++total.late;
+					continue;
 				}
+				latencies.push_back(elapsed - slot.sent);
+				++total.replies;
+				++secondReplies;
+				SendProbe(client, slotIndex, buf, server_addr, port, doBlitz, elapsed, total);
 			}
 		}
 	}
-	else
+
+	INFMSG("Sent " << total.sent << " probes, " << total.replies << " replies, " << total.lost << " lost, "
+	       << total.late << " late, " << total.bad << " bad, " << total.wrongPort << " with the wrong port");
+	if (duration > 0)
 	{
-		DBGMSG("Wait timed out");
+		INFMSG("Replies/s: " << (total.replies / duration));
+	}
+	if (!latencies.empty())
+	{
+		std::sort(latencies.begin(), latencies.end());
+		INFMSG("Latency (usec): 50% " << Percentile(latencies, 50.0) << ", 90% " << Percentile(latencies, 90.0)
+		       << ", 99% " << Percentile(latencies, 99.0) << ", 99.9% " << Percentile(latencies, 99.9)
+		       << ", max " << latencies.back());
 	}
-
 
 	return 0;
 }
@@ -92,7 +92,9 @@ bit8 ThreadFactory::startThread(Runnable &runable, void *data, bit8 destroy)
     pthread_attr_init(&threadAttr);
     pthread_attr_setdetachstate(&threadAttr, PTHREAD_CREATE_DETACHED);
     pthread_attr_setscope(&threadAttr,PTHREAD_SCOPE_SYSTEM);
-    retval=pthread_create(NULL,&threadAttr, threadClassLauncher, tInfo);
+    // TheSuperHackers @bugfix pthread_create() needs somewhere to put the thread id, even for a detached thread
+    pthread_t thread;
+    retval=pthread_create(&thread,&threadAttr, threadClassLauncher, tInfo);
     if (retval==0)
       return(TRUE);
     else
@@ -137,7 +139,9 @@ bit8 ThreadFactory::startThread(void (*start_func)(void *), void *data)
     pthread_attr_init(&threadAttr);
     pthread_attr_setdetachstate(&threadAttr, PTHREAD_CREATE_DETACHED);
     pthread_attr_setscope(&threadAttr,PTHREAD_SCOPE_SYSTEM);
-    retval=pthread_create(NULL,&threadAttr, threadFuncLauncher, tInfo);
+    // TheSuperHackers @bugfix pthread_create() needs somewhere to put the thread id, even for a detached thread
+    pthread_t thread;
+    retval=pthread_create(&thread,&threadAttr, threadFuncLauncher, tInfo);
     if (retval==0)
       return(TRUE);
     else
@@ -23,6 +23,7 @@
 #include <wstring.h>
 #include <tcp.h>
 #include <wdebug.h>
+#include <xtime.h>
 #include "mydebug.h"
 
 #include <ghttp/ghttp.h>
@@ -181,6 +182,8 @@ GeneralsMatcher::GeneralsMatcher()
 		quiet = false;
 
 	// Grab the weights for different parameters
+	weightLowPing = 1;
+	weightAvgPoints = 1;
 	Global.config.getInt("MATCH_WEIGHT_LOWPING", weightLowPing, "GENERALS");
 	Global.config.getInt("MATCH_WEIGHT_AVGPOINTS", weightAvgPoints, "GENERALS");
 	totalWeight = weightLowPing + weightAvgPoints;
@@ -189,17 +192,33 @@ GeneralsMatcher::GeneralsMatcher()
 	INFMSG("weightAvgPoints = " << weightAvgPoints);
 	INFMSG("totalWeight = " << totalWeight);
 
+	m_secondsBetweenPoolSizeAnnouncements = 0;
 	Global.config.getInt("SecondsBetweenPoolSizeAnnouncements", m_secondsBetweenPoolSizeAnnouncements, NULL);
 	if (m_secondsBetweenPoolSizeAnnouncements < 10)
 	{
 		m_secondsBetweenPoolSizeAnnouncements = 10;
 	}
 	m_nextPoolSizeAnnouncement = time(NULL);
+
+	m_matchTimeBudgetMsec = 50;
+	Global.config.getInt("MATCH_TIME_BUDGET_MS", m_matchTimeBudgetMsec, "GENERALS");
+	INFMSG("matchTimeBudgetMsec = " << m_matchTimeBudgetMsec);
+	m_firstPool = 0;
+
+	m_nonLadderEngine1v1.init(this, 2);
+	m_nonLadderEngine2v2.init(this, 4);
+	m_nonLadderEngine3v3.init(this, 6);
+	m_nonLadderEngine4v4.init(this, 8);
 }
 
 void GeneralsMatcher::init(void)
 {}
 
+void GeneralsMatcher::messagePlayer(const char *nick, const char *message)
+{
+	peerMessagePlayer(m_peer, nick, message, NormalMessage);
+}
+
 
 #define W(x) setw(x) <<
 void GeneralsMatcher::dumpUsers(void)
@@ -428,7 +447,7 @@ void GeneralsMatcher::sendMatchInfo(std::string name1, std::string name2, std::s
 		n.append(",");
 		n.append(name8);
 	}
-	peerMessagePlayer(m_peer, n.c_str(), s.c_str(), NormalMessage);
+	messagePlayer(n.c_str(), s.c_str());
 }
 
 void GeneralsMatcher::checkMatches(void)
@@ -440,17 +459,68 @@ void GeneralsMatcher::checkMatches(void)
 		m_nextPoolSizeAnnouncement = now + m_secondsBetweenPoolSizeAnnouncements;
 		showPoolSize = true;
 	}
-	checkMatchesInUserMap(m_nonLadderUsers1v1, 0, 2, showPoolSize);
-	checkMatchesInUserMap(m_nonLadderUsers2v2, 0, 4, showPoolSize);
-	checkMatchesInUserMap(m_nonLadderUsers3v3, 0, 6, showPoolSize);
-	checkMatchesInUserMap(m_nonLadderUsers4v4, 0, 8, showPoolSize);
 
+	// The pools share the time budget of the tick, a pool that gets none is looked at on the next tick.
+	// Start with another pool on every tick, so that busy pools cannot use up the budget of the others.
+	std::vector<MatchPool> pools;
+	pools.push_back(MatchPool(m_nonLadderUsers1v1, m_nonLadderEngine1v1, 0, 2));
+	pools.push_back(MatchPool(m_nonLadderUsers2v2, m_nonLadderEngine2v2, 0, 4));
+	pools.push_back(MatchPool(m_nonLadderUsers3v3, m_nonLadderEngine3v3, 0, 6));
+	pools.push_back(MatchPool(m_nonLadderUsers4v4, m_nonLadderEngine4v4, 0, 8));
 	for (LadderMap::iterator it = m_ladders.begin(); it != m_ladders.end(); ++it)
 	{
-		checkMatchesInUserMap(it->second, it->first, 2, showPoolSize);
+		pools.push_back(MatchPool(it->second, *findEngine(it->first, 2), it->first, 2));
+	}
+
+	m_firstPool = (m_firstPool + 1) % (int)pools.size();
+	Xtime tickStart;
+	for (int i=0; i<(int)pools.size(); ++i)
+	{
+		MatchPool& pool = pools[(m_firstPool + i) % pools.size()];
+		checkMatchesInUserMap(*pool.users, *pool.engine, pool.ladderID, pool.numPlayers, showPoolSize, tickStart);
 	}
 }
 
+MatchEngine* GeneralsMatcher::findEngine(int ladderID, int numPlayers)
+{
+	if (ladderID)
+	{
+		MatchEngine& engine = m_ladderEngines[ladderID];
+		if (!engine.isInitialized())
+			engine.init(this, 2);
+		return &engine;
+	}
+
+	switch (numPlayers)
+	{
+	case 2:
+		return &m_nonLadderEngine1v1;
+	case 4:
+		return &m_nonLadderEngine2v2;
+	case 6:
+		return &m_nonLadderEngine3v3;
+	case 8:
+		return &m_nonLadderEngine4v4;
+	}
+	return NULL;
+}
+
+MatchEngine* GeneralsMatcher::findEngineOfUser(const std::string& who)
+{
+	for (LadderEngineMap::iterator it = m_ladderEngines.begin(); it != m_ladderEngines.end(); ++it)
+	{
+		if (it->second.hasUser(who))
+			return &it->second;
+	}
+	for (int numPlayers=2; numPlayers<=8; numPlayers+=2)
+	{
+		MatchEngine *engine = findEngine(0, numPlayers);
+		if (engine->hasUser(who))
+			return engine;
+	}
+	return NULL;
+}
+
 double GeneralsMatcher::computeMatchFitness(const std::string& i1, const GeneralsUser *u1, const std::string& i2, const GeneralsUser *u2)
 {
 	//DBGMSG("matching "<<i1<< " vs "<<i2);
@@ -519,11 +589,10 @@ double GeneralsMatcher::computeMatchFitness(const std::string& i1, const General
 	return matchFitness;
 }
 
-void GeneralsMatcher::checkMatchesInUserMap(UserMap& userMap, int ladderID, int numPlayers, bool showPoolSize)
+void GeneralsMatcher::checkMatchesInUserMap(UserMap& userMap, MatchEngine& engine, int ladderID, int numPlayers, bool showPoolSize, const Xtime& tickStart)
 {
-	UserMap::iterator i1, i2, i3, i4, i5, i6, i7, i8;
-	GeneralsUser *u1, *u2, *u3, *u4, *u5, *u6, *u7, *u8;
-	static const double fitnessThreshold = 0.3;
+	UserMap::iterator i1;
+	GeneralsUser *u1;
 	time_t now = time(NULL);
 
 	std::string s;
@@ -538,7 +607,7 @@ void GeneralsMatcher::checkMatchesInUserMap(UserMap& userMap, int ladderID, int
 	{
 		if (showPoolSize)
 		{
-			peerMessagePlayer(m_peer, i1->first.c_str(), s.c_str(), NormalMessage);
+			messagePlayer(i1->first.c_str(), s.c_str());
 		}
 
 		u1 = i1->second;
@@ -549,208 +618,43 @@ void GeneralsMatcher::checkMatchesInUserMap(UserMap& userMap, int ladderID, int
 			for (int m=0; m<(int)u1->maps.size(); ++m)
 				u1->maps[m] = 1;
 			DBGMSG("Widening search for " << i1->first);
-			peerMessagePlayer(m_peer, i1->first.c_str(), "MBOT:WIDENINGSEARCH", NormalMessage);
+			messagePlayer(i1->first.c_str(), "MBOT:WIDENINGSEARCH");
+			engine.updateUser(i1->first);
 		}
 	}
 
-	// iterate through all users, looking for a match
-	for (i1 = userMap.begin(); i1 != userMap.end(); ++i1)
-	{
-		u1 = i1->second;
-		if (u1->status != STATUS_WORKING)
-			continue;
-
-		GeneralsUser *bestUser = NULL;
-		double bestMatchFitness = 0.0;
-		std::string bestName = "";
-
-		// look at everybody left
-		i2 = i1;
-		for (++i2; i2 != userMap.end(); ++i2)
-		{
-			u2 = i2->second;
-			if (u2->status != STATUS_WORKING)
-				continue;
-
-			double matchFitness = computeMatchFitness(i1->first, u1, i2->first, u2);
-			if (matchFitness > fitnessThreshold)
-			{
-				if (numPlayers == 2)
-				{
-					if (matchFitness > bestMatchFitness)
-					{
-						// possibly match 2 players
-						bestMatchFitness = matchFitness;
-						bestUser = u2;
-						bestName = i2->first;
-					}
-				}
-				else
-				{
-					i3 = i2;
-					for (++i3; i3 != userMap.end(); ++i3)
-					{
-						u3 = i3->second;
-						if (u3->status != STATUS_WORKING)
-							continue;
-
-						double matchFitness1 = computeMatchFitness(i1->first, u1, i3->first, u3);
-						double matchFitness2 = computeMatchFitness(i2->first, u2, i3->first, u3);
-						MapBitSet tmp = MapSetUnion(u1->maps, u2->maps);
-						tmp = MapSetUnion(tmp, u3->maps);
-						if (MapSetCount(tmp) && matchFitness1 > fitnessThreshold && matchFitness2 > fitnessThreshold)
-						{
-							i4 = i3;
-							for (++i4; i4 != userMap.end(); ++i4)
-							{
-								u4 = i4->second;
-								if (u4->status != STATUS_WORKING)
-									continue;
-
-								double matchFitness1 = computeMatchFitness(i1->first, u1, i4->first, u4);
-								double matchFitness2 = computeMatchFitness(i2->first, u2, i4->first, u4);
-								double matchFitness3 = computeMatchFitness(i3->first, u3, i4->first, u4);
-								MapBitSet tmp = MapSetUnion(u1->maps, u2->maps);
-								tmp = MapSetUnion(tmp, u3->maps);
-								tmp = MapSetUnion(tmp, u4->maps);
-								if (MapSetCount(tmp) && matchFitness1 > fitnessThreshold && matchFitness2 > fitnessThreshold && matchFitness3 > fitnessThreshold)
-								{
-									if (numPlayers == 4)
-									{
-										// match 4 players
-										sendMatchInfo(i1->first, i2->first, i3->first, i4->first, "", "", "", "",
-										              u1, u2, u3, u4, NULL, NULL, NULL, NULL, 4, ladderID);
-										break;
-									}
-									else
-									{
-
-										i5 = i4;
-										for (++i5; i5 != userMap.end(); ++i5)
-										{
-											u5 = i5->second;
-											if (u5->status != STATUS_WORKING)
-												continue;
-
-											double matchFitness1 = computeMatchFitness(i1->first, u1, i5->first, u5);
-											double matchFitness2 = computeMatchFitness(i2->first, u2, i5->first, u5);
-											double matchFitness3 = computeMatchFitness(i3->first, u3, i5->first, u5);
-											double matchFitness4 = computeMatchFitness(i4->first, u4, i5->first, u5);
-											MapBitSet tmp = MapSetUnion(u1->maps, u2->maps);
-											tmp = MapSetUnion(tmp, u3->maps);
-											tmp = MapSetUnion(tmp, u4->maps);
-											tmp = MapSetUnion(tmp, u5->maps);
-											if (MapSetCount(tmp) && matchFitness1 > fitnessThreshold && matchFitness2 > fitnessThreshold && matchFitness3 > fitnessThreshold && matchFitness4 > fitnessThreshold)
-											{
-												i6 = i5;
-												for (++i6; i6 != userMap.end(); ++i6)
-												{
-													u6 = i6->second;
-													if (u6->status != STATUS_WORKING)
-														continue;
-
-													double matchFitness1 = computeMatchFitness(i1->first, u1, i6->first, u6);
-													double matchFitness2 = computeMatchFitness(i2->first, u2, i6->first, u6);
-													double matchFitness3 = computeMatchFitness(i3->first, u3, i6->first, u6);
-													double matchFitness4 = computeMatchFitness(i4->first, u4, i6->first, u6);
-													double matchFitness5 = computeMatchFitness(i5->first, u5, i6->first, u6);
-													MapBitSet tmp = MapSetUnion(u1->maps, u2->maps);
-													tmp = MapSetUnion(tmp, u3->maps);
-													tmp = MapSetUnion(tmp, u4->maps);
-													tmp = MapSetUnion(tmp, u5->maps);
-													tmp = MapSetUnion(tmp, u6->maps);
-													if (MapSetCount(tmp) && matchFitness1 > fitnessThreshold && matchFitness2 > fitnessThreshold && matchFitness3 > fitnessThreshold && matchFitness4 > fitnessThreshold && matchFitness5 > fitnessThreshold)
-													{
-														if (numPlayers == 6)
-														{
-															// match 6 players
-															sendMatchInfo(i1->first, i2->first, i3->first, i4->first, i5->first, i6->first, "", "",
-															              u1, u2, u3, u4, u5, u6, NULL, NULL, 6, ladderID);
-															break;
-														}
-														else
-														{
-
-															i7 = i6;
-															for (++i7; i7 != userMap.end(); ++i7)
-															{
-																u7 = i7->second;
-																if (u7->status != STATUS_WORKING)
-																	continue;
-
-																double matchFitness1 = computeMatchFitness(i1->first, u1, i7->first, u7);
-																double matchFitness2 = computeMatchFitness(i2->first, u2, i7->first, u7);
-																double matchFitness3 = computeMatchFitness(i3->first, u3, i7->first, u7);
-																double matchFitness4 = computeMatchFitness(i4->first, u4, i7->first, u7);
-																double matchFitness5 = computeMatchFitness(i5->first, u5, i7->first, u7);
-																double matchFitness6 = computeMatchFitness(i6->first, u6, i7->first, u7);
-																MapBitSet tmp = MapSetUnion(u1->maps, u2->maps);
-																tmp = MapSetUnion(tmp, u3->maps);
-																tmp = MapSetUnion(tmp, u4->maps);
-																tmp = MapSetUnion(tmp, u5->maps);
-																tmp = MapSetUnion(tmp, u6->maps);
-																tmp = MapSetUnion(tmp, u7->maps);
-																if (MapSetCount(tmp) && matchFitness1 > fitnessThreshold && matchFitness2 > fitnessThreshold && matchFitness3 > fitnessThreshold && matchFitness4 > fitnessThreshold && matchFitness5 > fitnessThreshold && matchFitness6 > fitnessThreshold)
-																{
-																	i8 = i7;
-																	for (++i8; i8 != userMap.end(); ++i8)
-																	{
-																		u8 = i8->second;
-																		if (u8->status != STATUS_WORKING)
-																			continue;
-
-																		double matchFitness1 = computeMatchFitness(i1->first, u1, i8->first, u8);
-																		double matchFitness2 = computeMatchFitness(i2->first, u2, i8->first, u8);
-																		double matchFitness3 = computeMatchFitness(i3->first, u3, i8->first, u8);
-																		double matchFitness4 = computeMatchFitness(i4->first, u4, i8->first, u8);
-																		double matchFitness5 = computeMatchFitness(i5->first, u5, i8->first, u8);
-																		double matchFitness6 = computeMatchFitness(i6->first, u6, i8->first, u8);
-																		double matchFitness7 = computeMatchFitness(i7->first, u7, i8->first, u8);
-																		MapBitSet tmp = MapSetUnion(u1->maps, u2->maps);
-																		tmp = MapSetUnion(tmp, u3->maps);
-																		tmp = MapSetUnion(tmp, u4->maps);
-																		tmp = MapSetUnion(tmp, u5->maps);
-																		tmp = MapSetUnion(tmp, u6->maps);
-																		tmp = MapSetUnion(tmp, u7->maps);
-																		tmp = MapSetUnion(tmp, u8->maps);
-																		if (MapSetCount(tmp) && matchFitness1 > fitnessThreshold && matchFitness2 > fitnessThreshold && matchFitness3 > fitnessThreshold && matchFitness4 > fitnessThreshold && matchFitness5 > fitnessThreshold && matchFitness6 > fitnessThreshold && matchFitness7 > fitnessThreshold)
-																		{
-																			// match 8 players
-																			sendMatchInfo(i1->first, i2->first, i3->first, i4->first, i5->first, i6->first, i7->first, i8->first,
-																			              u1, u2, u3, u4, u5, u6, u7, u8, 8, ladderID);
-																			break;
-																		}
-																	}
-																}
-															}
-
-														}
-													}
-												}
-											}
-										}
-
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
+	// TheSuperHackers @performance The engine keeps who fits with whom as users come and go, and
+	// assembles the matches from the best pairs down, instead of trying every combination of the
+	// users here.  It makes as many matches per tick as the time budget allows.
+	std::vector<MatchEngine::Match> matches;
+	engine.findMatches(m_matchTimeBudgetMsec - elapsedMsec(tickStart), matches);
 
-		if (bestUser && numPlayers == 2)
+	for (int i=0; i<(int)matches.size(); ++i)
+	{
+		MatchEngine::Match& match = matches[i];
+		if (numPlayers == 2)
 		{
-			// we had a match.  send the info.
-			DBGMSG("Matching " << i1->first << " with " << bestName << ":"
-			       "\tmatch fitness: " << bestMatchFitness << "\n"
+			GeneralsUser *bestUser = match.users[1];
+			u1 = match.users[0];
+			DBGMSG("Matching " << match.names[0] << " with " << match.names[1] << ":"
+			       "\tmatch fitness: " << computeMatchFitness(match.names[0], u1, match.names[1], bestUser) << "\n"
 			       "\tpoint percentage: " << (1-bestUser->points/(double)u1->points)*100 << "\n"
-			       "\tpoints: " << u1->points << ", " << u2->points << "\n"
+			       "\tpoints: " << u1->points << ", " << bestUser->points << "\n"
 			       "\tping in ms: " << sqrt(1000000 * calcPingDelta(u1, bestUser) / (255*255*2)) << "\n"
 			       "\tprevious attempts: " << u1->widened << ", " << bestUser->widened);
-			sendMatchInfo(i1->first, bestName, "", "", "", "", "", "",
-			              u1, bestUser, NULL, NULL, NULL, NULL, NULL, NULL, 2, ladderID);
-			break;
+		}
+
+		sendMatchInfo(match.names[0], match.names[1], match.names[2], match.names[3],
+		              match.names[4], match.names[5], match.names[6], match.names[7],
+		              match.users[0], match.users[1], match.users[2], match.users[3],
+		              match.users[4], match.users[5], match.users[6], match.users[7],
+		              numPlayers, ladderID);
+
+		// Users that could not be sent off are still looking for a match
+		for (int m=0; m<numPlayers; ++m)
+		{
+			if (match.users[m]->status == STATUS_WORKING)
+				engine.addUser(match.names[m], match.users[m]);
 		}
 	}
 
@@ -769,13 +673,17 @@ bool GeneralsMatcher::handleUserWiden(const char *nick)
 	if (!userInfo)
 	{
 		DBGMSG("Got Widen from nick not needing one!");
-		peerMessagePlayer(m_peer, nick, "MBOT:CANTSENDWIDENNOW", NormalMessage);
+		messagePlayer(nick, "MBOT:CANTSENDWIDENNOW");
 		return false;
 	}
 	DBGMSG("Widening search for " << nick);
-	peerMessagePlayer(m_peer, nick, "MBOT:WIDENINGSEARCH", NormalMessage);
+	messagePlayer(nick, "MBOT:WIDENINGSEARCH");
 
 	userInfo->widened = true;
+
+	MatchEngine *engine = findEngineOfUser(nick);
+	if (engine)
+		engine->updateUser(nick);
 	return true;
 }
 
@@ -786,7 +694,7 @@ bool GeneralsMatcher::handleUserInfo(const char *nick, const std::string& msg)
 	if (!userInfo)
 	{
 		DBGMSG("Got UserInfo from nick not needing one!");
-		peerMessagePlayer(m_peer, nick, "MBOT:CANTSENDCINFONOW", NormalMessage);
+		messagePlayer(nick, "MBOT:CANTSENDCINFONOW");
 		return false;
 	}
 	DBGMSG("Looking at " << nick << " with user info [" << msg << "]");
@@ -853,7 +761,7 @@ bool GeneralsMatcher::handleUserInfo(const char *nick, const std::string& msg)
 			if (!v.length())
 			{
 				INFMSG("Bad maps from " << nick << ": [" << v << "]");
-				peerMessagePlayer(m_peer, nick, "MBOT:BADMAPS", NormalMessage);
+				messagePlayer(nick, "MBOT:BADMAPS");
 				return false;
 			}
 			const char *buf = v.c_str();
@@ -874,7 +782,7 @@ bool GeneralsMatcher::handleUserInfo(const char *nick, const std::string& msg)
 			        userInfo->numPlayers != 6 && userInfo->numPlayers != 8)
 			{
 				INFMSG("Bad numPlayers from " << nick << ": [" << userInfo->numPlayers << "]");
-				peerMessagePlayer(m_peer, nick, "MBOT:BADCINFO", NormalMessage);
+				messagePlayer(nick, "MBOT:BADCINFO");
 				return false;
 			}
 		}
@@ -899,7 +807,7 @@ bool GeneralsMatcher::handleUserInfo(const char *nick, const std::string& msg)
 			if (!v.length() || (v.length() % 2))
 			{
 				INFMSG("Bad pings from " << nick << ": [" << v << "]");
-				peerMessagePlayer(m_peer, nick, "MBOT:BADPINGS", NormalMessage);
+				messagePlayer(nick, "MBOT:BADPINGS");
 				return false;
 			}
 			int ping = 0;
@@ -926,13 +834,16 @@ bool GeneralsMatcher::handleUserInfo(const char *nick, const std::string& msg)
 		else
 		{
 			INFMSG("Unknown key/value pair in user info [" << k << "]/[" << v << "]");
-			peerMessagePlayer(m_peer, nick, "MBOT:BADCINFO", NormalMessage);
+			messagePlayer(nick, "MBOT:BADCINFO");
 			return false;
 		}
 	}
 
 	std::string s = "MBOT:WORKING ";
 
+	userInfo->status = STATUS_WORKING;
+	userInfo->matchStart = time(NULL);
+
 	if (ladderID)
 	{
 		addUserInLadder(nick, ladderID, userInfo);
@@ -958,9 +869,7 @@ bool GeneralsMatcher::handleUserInfo(const char *nick, const std::string& msg)
 		}
 	}
 
-	userInfo->status = STATUS_WORKING;
-	userInfo->matchStart = time(NULL);
-	peerMessagePlayer(m_peer, nick, s.c_str(), NormalMessage);
+	messagePlayer(nick, s.c_str());
 
 	DBGMSG("Player " << nick << " is matching now, ack was [" << s << "]");
 	return true;
@@ -1050,6 +959,7 @@ void GeneralsMatcher::addUser(const std::string& who)
 void GeneralsMatcher::addUserInLadder(const std::string& who, int ladderID, GeneralsUser *user)
 {
 	m_ladders[ladderID][who] = user;
+	findEngine(ladderID, 2)->addUser(who, user);
 }
 
 void GeneralsMatcher::addNonLadderUser(const std::string& who, GeneralsUser *user)
@@ -1068,7 +978,10 @@ void GeneralsMatcher::addNonLadderUser(const std::string& who, GeneralsUser *use
 	case 8:
 		m_nonLadderUsers4v4[who] = user;
 		break;
+	default:
+		return;
 	}
+	findEngine(0, user->numPlayers)->addUser(who, user);
 }
 
 void GeneralsMatcher::addNonMatchingUser(const std::string& who, GeneralsUser *user)
@@ -1114,6 +1027,7 @@ GeneralsUser* GeneralsMatcher::removeUserInLadder(const std::string& who, int la
 
 	GeneralsUser *user = uIt->second;
 	lIt->second.erase(uIt);
+	findEngine(ladderID, 2)->removeUser(who);
 	return user;
 }
 
@@ -1126,6 +1040,7 @@ GeneralsUser* GeneralsMatcher::removeUserInAnyLadder(const std::string& who)
 		{
 			GeneralsUser *user = uIt->second;
 			lIt->second.erase(uIt);
+			findEngine(lIt->first, 2)->removeUser(who);
 			return user;
 		}
 	}
@@ -1139,6 +1054,7 @@ GeneralsUser* GeneralsMatcher::removeNonLadderUser(const std::string& who)
 	{
 		GeneralsUser *user = it->second;
 		m_nonLadderUsers1v1.erase(it);
+		m_nonLadderEngine1v1.removeUser(who);
 		return user;
 	}
 
@@ -1147,6 +1063,7 @@ GeneralsUser* GeneralsMatcher::removeNonLadderUser(const std::string& who)
 	{
 		GeneralsUser *user = it->second;
 		m_nonLadderUsers2v2.erase(it);
+		m_nonLadderEngine2v2.removeUser(who);
 		return user;
 	}
 
@@ -1155,6 +1072,7 @@ GeneralsUser* GeneralsMatcher::removeNonLadderUser(const std::string& who)
 	{
 		GeneralsUser *user = it->second;
 		m_nonLadderUsers3v3.erase(it);
+		m_nonLadderEngine3v3.removeUser(who);
 		return user;
 	}
 
@@ -1163,6 +1081,7 @@ GeneralsUser* GeneralsMatcher::removeNonLadderUser(const std::string& who)
 	{
 		GeneralsUser *user = it->second;
 		m_nonLadderUsers4v4.erase(it);
+		m_nonLadderEngine4v4.removeUser(who);
 		return user;
 	}
 
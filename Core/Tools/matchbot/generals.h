@@ -26,6 +26,7 @@
 //#include <arraylist.h>
 #include "matcher.h"
 #include "global.h"
+#include "matchengine.h"
 
 #include <string>
 #include <bitset>
@@ -88,6 +89,7 @@ public:
 
 typedef std::map<std::string, GeneralsUser*> UserMap;
 typedef std::map<int, UserMap> LadderMap;
+typedef std::map<int, MatchEngine> LadderEngineMap;
 
 class GeneralsMatcher : public MatcherClass
 {
@@ -107,7 +109,12 @@ public:
 	virtual void handlePlayerChangedNick( const char *oldNick, const char *newNick );
 	virtual void handlePlayerEnum( bool success, int gameSpyIndex, const char *nick, int flags );
 
-private:
+protected:
+	friend class MatchEngine;
+
+	// Sends a private message to a player, or to a comma separated list of players
+	virtual void messagePlayer(const char *nick, const char *message);
+
 	LadderMap m_ladders;
 	UserMap m_nonLadderUsers1v1;
 	UserMap m_nonLadderUsers2v2;
@@ -115,6 +122,27 @@ private:
 	UserMap m_nonLadderUsers4v4;
 	UserMap m_nonMatchingUsers;
 
+	// The working users of the pools above, paired up by how well they fit
+	LadderEngineMap m_ladderEngines;
+	MatchEngine m_nonLadderEngine1v1;
+	MatchEngine m_nonLadderEngine2v2;
+	MatchEngine m_nonLadderEngine3v3;
+	MatchEngine m_nonLadderEngine4v4;
+
+	// One pool of users that are matched with each other
+	struct MatchPool
+	{
+		MatchPool(UserMap& u, MatchEngine& e, int l, int n) : users(&u), engine(&e), ladderID(l), numPlayers(n) {}
+
+		UserMap *users;
+		MatchEngine *engine;
+		int ladderID;
+		int numPlayers;
+	};
+
+	MatchEngine* findEngine(int ladderID, int numPlayers);
+	MatchEngine* findEngineOfUser(const std::string& who);
+
 	double computeMatchFitness(const std::string& i1, const GeneralsUser *u1, const std::string& i2, const GeneralsUser *u2);
 
 	GeneralsUser* findUser(const std::string& who);
@@ -135,7 +163,7 @@ private:
 	GeneralsUser* removeNonLadderUser(const std::string& who);
 	GeneralsUser* removeNonMatchingUser(const std::string& who);
 
-	void checkMatchesInUserMap(UserMap& userMap, int ladderID, int numPlayers, bool showPoolSize);
+	void checkMatchesInUserMap(UserMap& userMap, MatchEngine& engine, int ladderID, int numPlayers, bool showPoolSize, const Xtime& tickStart);
 
 	void dumpUsers(void);
 
@@ -158,6 +186,10 @@ private:
 	time_t m_nextPoolSizeAnnouncement;
 	int m_secondsBetweenPoolSizeAnnouncements;
 
+	// How long one checkMatches() may spend assembling matches
+	int m_matchTimeBudgetMsec;
+	int m_firstPool; // the pool that checkMatches() started with on the last tick
+
 	//typedef std::vector<std::string> StringVec;
 	//StringVec mapFileList;
 }
@@ -40,6 +40,7 @@
 #include <xtime.h>
 #include "global.h"
 #include "generals.h"
+#include "matchbench.h"
 #include "timezone.h"
 #include <threadfac.h>
 
@@ -113,6 +114,7 @@ int VerifyFileDescriptors(int requested)
 
 GeneralsMatcher *s_generalsMatcher = NULL;
 GeneralsClientMatcher *s_generalsClientMatcher = NULL;
+GeneralsBenchmarkMatcher *s_generalsBenchmarkMatcher = NULL;
 
 int main(int argc, char ** argv)
 {
@@ -234,6 +236,12 @@ int main(int argc, char ** argv)
 		s_generalsClientMatcher = new GeneralsClientMatcher;
 		s_generalsClientMatcher->connectAndLoop();
 	}
+	else if (gametype == "GeneralsBenchmark")
+	{
+		DBGMSG("Generals matching benchmark");
+		s_generalsBenchmarkMatcher = new GeneralsBenchmarkMatcher;
+		s_generalsBenchmarkMatcher->run();
+	}
 	else
 	{
 		cerr << "\nNo valid GAME entry found!" << endl;
@@ -246,6 +254,9 @@ int main(int argc, char ** argv)
 	delete s_generalsClientMatcher;
 	s_generalsClientMatcher = NULL;
 
+	delete s_generalsBenchmarkMatcher;
+	s_generalsBenchmarkMatcher = NULL;
+
 	return 0;
 }
 
@@ -0,0 +1,228 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef _WIN32
+#include <process.h>
+#endif
+
+#include <wstring.h>
+#include <wdebug.h>
+#include <xtime.h>
+#include "mydebug.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "matchbench.h"
+#include "global.h"
+
+// =====================================================================
+// Benchmark Matcher class
+// =====================================================================
+
+GeneralsBenchmarkMatcher::GeneralsBenchmarkMatcher()
+{
+	m_numUsers = 5000;
+	m_usersPerTick = 100;
+	m_numMaps = 32;
+	m_numLadders = 2;
+	int seed = 0;
+	Global.config.getInt("BENCHMARK_USERS", m_numUsers, "GENERALS");
+	Global.config.getInt("BENCHMARK_USERS_PER_TICK", m_usersPerTick, "GENERALS");
+	Global.config.getInt("BENCHMARK_MAPS", m_numMaps, "GENERALS");
+	Global.config.getInt("BENCHMARK_LADDERS", m_numLadders, "GENERALS");
+	Global.config.getInt("BENCHMARK_SEED", seed, "GENERALS");
+	if (m_usersPerTick < 1)
+		m_usersPerTick = 1;
+	if (m_numMaps < 1)
+		m_numMaps = 1;
+	m_rnd = RandClass(seed);
+
+	m_numMatches = 0;
+	m_numMatchedUsers = 0;
+}
+
+void GeneralsBenchmarkMatcher::messagePlayer(const char *nick, const char *message)
+{
+	if (strncmp(message, "MBOT:MATCHED ", 13) != 0)
+		return;
+
+	++m_numMatches;
+
+	// the players of a match get one message, addressed to all of them
+	std::string names = nick;
+	int start = 0;
+	while (start <= (int)names.length())
+	{
+		int end = names.find_first_of(',', start);
+		if (end < 0)
+			end = names.length();
+		m_matchedUsers.push_back(names.substr(start, end - start));
+		++m_numMatchedUsers;
+		start = end + 1;
+	}
+}
+
+// Makes up the user info a game client sends, see GeneralsMatcher::handleUserInfo()
+std::string GeneralsBenchmarkMatcher::makeUserInfo(void)
+{
+	char buf[64];
+	std::string s = "\\CINFO";
+
+	int ladderID = 0;
+	int numPlayers = 2;
+	if (m_numLadders > 0 && m_rnd.Int(0, 1))
+	{
+		ladderID = m_rnd.Int(1, m_numLadders);
+	}
+	else
+	{
+		static const int playerCounts[] = { 2, 2, 2, 2, 4, 4, 6, 8 };
+		numPlayers = playerCounts[m_rnd.Int(0, 7)];
+	}
+
+	sprintf(buf, "\\LadID\\%d\\NumPlayers\\%d", ladderID, numPlayers);
+	s.append(buf);
+
+	// points spread over a few orders of magnitude, like a real ladder
+	int points = m_rnd.Int(1, 1 << m_rnd.Int(4, 14));
+	sprintf(buf, "\\Points\\%d\\PointsMin\\0\\PointsMax\\%d", points, m_rnd.Int(2, 8));
+	s.append(buf);
+
+	sprintf(buf, "\\Discons\\%d\\DisconMax\\%d", m_rnd.Int(0, 4), m_rnd.Int(0, 4));
+	s.append(buf);
+
+	s.append("\\Pings\\");
+	for (int p=0; p<3; ++p)
+	{
+		sprintf(buf, "%02x", m_rnd.Int(0, 255));
+		s.append(buf);
+	}
+	sprintf(buf, "\\PingMax\\%d", m_rnd.Int(100, 400));
+	s.append(buf);
+
+	s.append("\\Maps\\");
+	for (int m=0; m<m_numMaps; ++m)
+	{
+		s.append(m_rnd.Int(0, 1) ? "1" : "0");
+	}
+
+	sprintf(buf, "\\Widen\\0\\IP\\%d\\NAT\\%d\\Side\\%d\\Color\\%d",
+	        m_rnd.Int(1, 0x7fffffff), m_rnd.Int(0, 3), m_rnd.Int(-1, 9), m_rnd.Int(-1, 7));
+	s.append(buf);
+
+	return s;
+}
+
+void GeneralsBenchmarkMatcher::removeMatchedUsers(void)
+{
+	for (int i=0; i<(int)m_matchedUsers.size(); ++i)
+	{
+		handlePlayerLeft(m_matchedUsers[i].c_str());
+	}
+	m_matchedUsers.clear();
+}
+
+// Whether a pool has pairs that checkMatches() did not get to yet
+bool GeneralsBenchmarkMatcher::hasWorkLeft(void)
+{
+	for (LadderEngineMap::iterator it = m_ladderEngines.begin(); it != m_ladderEngines.end(); ++it)
+	{
+		if (it->second.hasWorkLeft())
+			return true;
+	}
+	for (int numPlayers=2; numPlayers<=8; numPlayers+=2)
+	{
+		if (findEngine(0, numPlayers)->hasWorkLeft())
+			return true;
+	}
+	return false;
+}
+
+void GeneralsBenchmarkMatcher::run(void)
+{
+	INFMSG("Benchmark: " << m_numUsers << " users, " << m_usersPerTick << " per tick, "
+	       << m_numMaps << " maps, " << m_numLadders << " ladders");
+
+	int joined = 0;
+	int ticks = 0;
+	int joinMsec = 0;
+	int tickMsec = 0;
+	int maxTickMsec = 0;
+	bool widened = false;
+	char nick[32];
+
+	while (1)
+	{
+		Xtime joinStart;
+		for (int b=0; b<m_usersPerTick && joined<m_numUsers; ++b, ++joined)
+		{
+			sprintf(nick, "bench%06d", joined);
+			handlePlayerJoined(nick);
+			std::string info = makeUserInfo();
+			handlePlayerMessage(nick, info.c_str(), NormalMessage);
+		}
+		joinMsec += elapsedMsec(joinStart);
+
+		int matchesBefore = m_numMatches;
+		Xtime tickStart;
+		checkMatches();
+		int msec = elapsedMsec(tickStart);
+		tickMsec += msec;
+		if (msec > maxTickMsec)
+			maxTickMsec = msec;
+		++ticks;
+
+		removeMatchedUsers();
+
+		if (joined < m_numUsers || m_numMatches != matchesBefore || hasWorkLeft())
+			continue;
+
+		// Nobody joins anymore.  Let the ones left over widen the search, like the clients do after a while.
+		if (!widened)
+		{
+			std::vector<std::string> waiting;
+			UserMap *pools[] = { &m_nonLadderUsers1v1, &m_nonLadderUsers2v2, &m_nonLadderUsers3v3, &m_nonLadderUsers4v4 };
+			for (int p=0; p<4; ++p)
+			{
+				for (UserMap::iterator it = pools[p]->begin(); it != pools[p]->end(); ++it)
+					waiting.push_back(it->first);
+			}
+			for (LadderMap::iterator lIt = m_ladders.begin(); lIt != m_ladders.end(); ++lIt)
+			{
+				for (UserMap::iterator it = lIt->second.begin(); it != lIt->second.end(); ++it)
+					waiting.push_back(it->first);
+			}
+
+			INFMSG("Benchmark: widening the search for " << waiting.size() << " users after " << ticks << " ticks");
+			for (int w=0; w<(int)waiting.size(); ++w)
+			{
+				handlePlayerMessage(waiting[w].c_str(), "\\WIDEN", NormalMessage);
+			}
+			widened = true;
+			continue;
+		}
+
+		break;
+	}
+
+	INFMSG("Benchmark: " << m_numMatches << " matches of " << m_numMatchedUsers << " users, "
+	       << (m_numUsers - m_numMatchedUsers) << " users left waiting");
+	INFMSG("Benchmark: " << joinMsec << " ms handling user info, "
+	       << tickMsec << " ms in " << ticks << " ticks of checkMatches(), longest tick " << maxTickMsec << " ms");
+}
@@ -0,0 +1,58 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "generals.h"
+
+// =====================================================================
+// Benchmark Matcher class
+// =====================================================================
+
+// TheSuperHackers @feature Runs the Generals matcher on made up users instead of a GameSpy room, to
+// time it under load.  Users join the room in batches, send their CINFO and leave once matched,
+// with checkMatches() called after every batch.  Users that are still waiting when nobody else
+// joins widen their search once.  Reads its settings from the GENERALS section of the config file:
+// BENCHMARK_USERS, BENCHMARK_USERS_PER_TICK, BENCHMARK_MAPS, BENCHMARK_LADDERS and BENCHMARK_SEED.
+class GeneralsBenchmarkMatcher : public GeneralsMatcher
+{
+public:
+	GeneralsBenchmarkMatcher();
+	virtual ~GeneralsBenchmarkMatcher()
+	{}
+
+	void run(void);
+
+protected:
+	virtual void messagePlayer(const char *nick, const char *message);
+
+private:
+	std::string makeUserInfo(void);
+	void removeMatchedUsers(void);
+	bool hasWorkLeft(void);
+
+	RandClass m_rnd;
+	int m_numUsers;
+	int m_usersPerTick;
+	int m_numMaps;
+	int m_numLadders;
+
+	int m_numMatches;
+	int m_numMatchedUsers;
+	std::vector<std::string> m_matchedUsers; // leave the room after the tick
+};
@@ -0,0 +1,499 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef _WIN32
+#include <process.h>
+#endif
+
+#include <wdebug.h>
+#include <xtime.h>
+#include "mydebug.h"
+
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+#include "matchengine.h"
+#include "generals.h"
+
+// Pairs of users that fit less than this are not matched
+static const double fitnessThreshold = 0.3;
+
+// How many pairs are looked at between checks of the time budget
+static const int pairsBetweenTimeChecks = 32;
+
+int elapsedMsec(const Xtime& start)
+{
+	Xtime now;
+	return (now.getDay() - start.getDay()) * 24*60*60*1000 + now.getMsec() - start.getMsec();
+}
+
+// =====================================================================
+// Match engine
+// =====================================================================
+
+bool MatchEngine::RankedPair::operator<(const RankedPair& other) const
+{
+	// best pairs first, the rest in a fixed order
+	if (fitness != other.fitness)
+		return fitness > other.fitness;
+	if (first != other.first)
+		return first < other.first;
+	return second < other.second;
+}
+
+bool MatchEngine::isFitterPair(const Pair& a, const Pair& b)
+{
+	if (a.fitness != b.fitness)
+		return a.fitness > b.fitness;
+	return a.other < b.other;
+}
+
+MatchEngine::MatchEngine()
+{
+	m_matcher = NULL;
+	m_numPlayers = 2;
+	m_maxPairsPerUser = 0;
+	m_scanPosition = 0;
+	m_userCount = 0;
+	m_pairCount = 0;
+	m_dirty = false;
+}
+
+void MatchEngine::init(GeneralsMatcher *matcher, int numPlayers)
+{
+	m_matcher = matcher;
+	m_numPlayers = numPlayers;
+
+	// bigger matches need more of the users that fit with each other
+	m_maxPairsPerUser = PairsPerPlayer * numPlayers;
+}
+
+int MatchEngine::getBand(int points)
+{
+	int band = 0;
+	while (points > 1 && band < BandCount - 1)
+	{
+		points >>= 1;
+		++band;
+	}
+	return band;
+}
+
+// The bands of the users whose points are within the range this user asks for, see
+// GeneralsMatcher::computeMatchFitness().  A user that widened the search takes anybody.
+void MatchEngine::getBandRange(const GeneralsUser *user, int& lowBand, int& highBand) const
+{
+	lowBand = 0;
+	highBand = BandCount - 1;
+	if (user->widened)
+		return;
+
+	double points = user->points > 1 ? user->points : 1;
+	double lowPoints = floor(points * user->minPoints);
+	double highPoints = ceil(points * user->maxPoints);
+	if (highPoints < 1.0 || lowPoints > highPoints)
+	{
+		lowBand = 1;
+		highBand = 0;
+		return;
+	}
+
+	if (lowPoints > 1.0)
+		lowBand = getBand(lowPoints < (double)INT_MAX ? (int)lowPoints : INT_MAX);
+	if (highPoints < (double)INT_MAX)
+		highBand = getBand((int)highPoints);
+}
+
+void MatchEngine::packMaps(Candidate& candidate) const
+{
+	const MapBitSet& maps = candidate.user->maps;
+	candidate.maps.assign((maps.size() + 31) / 32, 0);
+	for (int i=0; i<(int)maps.size(); ++i)
+	{
+		if (maps[i])
+			candidate.maps[i / 32] |= 1u << (i % 32);
+	}
+}
+
+bool MatchEngine::sharesMaps(const std::vector<unsigned int>& maps, const Candidate& candidate) const
+{
+	if (maps.size() != candidate.maps.size())
+		return false;
+
+	for (int i=0; i<(int)maps.size(); ++i)
+	{
+		if (maps[i] & candidate.maps[i])
+			return true;
+	}
+	return false;
+}
+
+// A ranked pair is gone if one of its users left, or dropped its pairs since
+bool MatchEngine::isCurrent(const RankedPair& rankedPair) const
+{
+	const Candidate& first = m_slots[rankedPair.first];
+	const Candidate& second = m_slots[rankedPair.second];
+	return first.user && second.user &&
+	       first.generation == rankedPair.firstGeneration && second.generation == rankedPair.secondGeneration;
+}
+
+bool MatchEngine::hasUser(const std::string& name) const
+{
+	return m_slotsByName.find(name) != m_slotsByName.end();
+}
+
+void MatchEngine::addUser(const std::string& name, GeneralsUser *user)
+{
+	removeUser(name);
+
+	int slot;
+	if (m_freeSlots.empty())
+	{
+		slot = (int)m_slots.size();
+		m_slots.resize(slot + 1);
+		m_slots[slot].generation = 0;
+	}
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+
+	Candidate& candidate = m_slots[slot];
+	candidate.name = name;
+	candidate.user = user;
+	candidate.band = getBand(user->points);
+	candidate.leftPairsOut = false;
+	candidate.needsRefill = false;
+	packMaps(candidate);
+
+	m_slotsByName[name] = slot;
+	m_bands[candidate.band].push_back(slot);
+	++m_userCount;
+
+	addPairs(slot);
+}
+
+void MatchEngine::removeUser(const std::string& name)
+{
+	std::map<std::string, int>::iterator it = m_slotsByName.find(name);
+	if (it == m_slotsByName.end())
+		return;
+
+	takeSlot(it->second);
+}
+
+void MatchEngine::updateUser(const std::string& name)
+{
+	std::map<std::string, int>::iterator it = m_slotsByName.find(name);
+	if (it == m_slotsByName.end())
+		return;
+
+	int slot = it->second;
+	removePairs(slot);
+	packMaps(m_slots[slot]);
+	addPairs(slot);
+}
+
+// Work out who the user in the slot can play with.  It keeps no more than m_maxPairsPerUser of the
+// pairs it finds, the best ones, so the engine holds at most that many pairs per user in total.  A
+// single user can still end up with more, from the users that find it after it was added.
+void MatchEngine::addPairs(int slot)
+{
+	Candidate& candidate = m_slots[slot];
+	int lowBand, highBand;
+	getBandRange(candidate.user, lowBand, highBand);
+
+	std::vector<Pair> found;
+	for (int band=lowBand; band<=highBand; ++band)
+	{
+		const std::vector<int>& others = m_bands[band];
+		for (int i=0; i<(int)others.size(); ++i)
+		{
+			int otherSlot = others[i];
+			if (otherSlot == slot)
+				continue;
+
+			Candidate& other = m_slots[otherSlot];
+			if (!sharesMaps(candidate.maps, other))
+				continue;
+			if (!candidate.pairs.empty() && hasPair(slot, otherSlot))
+				continue;
+
+			double fitness = m_matcher->computeMatchFitness(candidate.name, candidate.user, other.name, other.user);
+			if (fitness <= fitnessThreshold)
+				continue;
+
+			Pair pair;
+			pair.fitness = fitness;
+			pair.other = otherSlot;
+			found.push_back(pair);
+		}
+	}
+
+	int room = m_maxPairsPerUser - (int)candidate.pairs.size();
+	if (room < 0)
+		room = 0;
+	if ((int)found.size() > room)
+	{
+		std::partial_sort(found.begin(), found.begin() + room, found.end(), isFitterPair);
+		found.resize(room);
+		candidate.leftPairsOut = true;
+	}
+
+	for (int f=0; f<(int)found.size(); ++f)
+	{
+		Candidate& other = m_slots[found[f].other];
+		Pair pair = found[f];
+		candidate.pairs.push_back(pair);
+		pair.other = slot;
+		other.pairs.push_back(pair);
+		++m_pairCount;
+
+		RankedPair rankedPair;
+		rankedPair.fitness = pair.fitness;
+		rankedPair.first = slot;
+		rankedPair.second = found[f].other;
+		rankedPair.firstGeneration = candidate.generation;
+		rankedPair.secondGeneration = other.generation;
+		m_newPairs.push_back(rankedPair);
+		m_dirty = true;
+	}
+}
+
+void MatchEngine::removePairs(int slot)
+{
+	Candidate& candidate = m_slots[slot];
+	for (int i=0; i<(int)candidate.pairs.size(); ++i)
+	{
+		Candidate& other = m_slots[candidate.pairs[i].other];
+		for (int j=0; j<(int)other.pairs.size(); ++j)
+		{
+			if (other.pairs[j].other == slot)
+			{
+				other.pairs[j] = other.pairs.back();
+				other.pairs.pop_back();
+				break;
+			}
+		}
+
+		// it left pairs out for the ones it had, look again once most of them are gone
+		if (other.leftPairsOut && !other.needsRefill && (int)other.pairs.size() * RefillFraction <= m_maxPairsPerUser)
+		{
+			other.needsRefill = true;
+			m_refillSlots.push_back(candidate.pairs[i].other);
+		}
+	}
+	m_pairCount -= (int)candidate.pairs.size();
+	candidate.pairs.clear();
+	candidate.leftPairsOut = false;
+	++candidate.generation;
+}
+
+bool MatchEngine::hasPair(int slot, int other) const
+{
+	const std::vector<Pair>& pairs = m_slots[slot].pairs;
+	for (int i=0; i<(int)pairs.size(); ++i)
+	{
+		if (pairs[i].other == other)
+			return true;
+	}
+	return false;
+}
+
+void MatchEngine::refillPairs(void)
+{
+	for (int i=0; i<(int)m_refillSlots.size(); ++i)
+	{
+		Candidate& candidate = m_slots[m_refillSlots[i]];
+		if (!candidate.user || !candidate.needsRefill)
+			continue;
+
+		candidate.needsRefill = false;
+		candidate.leftPairsOut = false;
+		addPairs(m_refillSlots[i]);
+	}
+	m_refillSlots.clear();
+}
+
+// Merge the new pairs into the ranking, and drop the ones that are gone on the way
+void MatchEngine::updateRanking(void)
+{
+	if (m_newPairs.empty())
+		return;
+
+	std::sort(m_newPairs.begin(), m_newPairs.end());
+
+	std::vector<RankedPair> ranking;
+	ranking.reserve(m_pairCount);
+	int r = 0;
+	int n = 0;
+	while (r < (int)m_ranking.size() || n < (int)m_newPairs.size())
+	{
+		const RankedPair *next;
+		if (n >= (int)m_newPairs.size() || (r < (int)m_ranking.size() && m_ranking[r] < m_newPairs[n]))
+			next = &m_ranking[r++];
+		else
+			next = &m_newPairs[n++];
+
+		if (isCurrent(*next))
+			ranking.push_back(*next);
+	}
+
+	m_ranking.swap(ranking);
+	m_newPairs.clear();
+}
+
+// The user that fits with every member of the group, best in total, and still shares a map with it
+int MatchEngine::findBestJoiner(const int *group, int groupSize, const std::vector<unsigned int>& groupMaps)
+{
+	int m;
+	for (m=0; m<groupSize; ++m)
+	{
+		const std::vector<Pair>& pairs = m_slots[group[m]].pairs;
+		for (int i=0; i<(int)pairs.size(); ++i)
+		{
+			++m_tallyCount[pairs[i].other];
+			m_tallyFitness[pairs[i].other] += pairs[i].fitness;
+		}
+	}
+
+	// everybody that fits with the whole group also fits with the first member
+	int best = -1;
+	double bestFitness = 0.0;
+	const std::vector<Pair>& pairs = m_slots[group[0]].pairs;
+	for (int j=0; j<(int)pairs.size(); ++j)
+	{
+		int other = pairs[j].other;
+		if (m_tallyCount[other] == groupSize && m_tallyFitness[other] > bestFitness && sharesMaps(groupMaps, m_slots[other]))
+		{
+			bestFitness = m_tallyFitness[other];
+			best = other;
+		}
+	}
+
+	for (m=0; m<groupSize; ++m)
+	{
+		const std::vector<Pair>& pairs = m_slots[group[m]].pairs;
+		for (int i=0; i<(int)pairs.size(); ++i)
+		{
+			m_tallyCount[pairs[i].other] = 0;
+			m_tallyFitness[pairs[i].other] = 0.0;
+		}
+	}
+
+	return best;
+}
+
+void MatchEngine::takeSlot(int slot)
+{
+	Candidate& candidate = m_slots[slot];
+	removePairs(slot);
+
+	std::vector<int>& band = m_bands[candidate.band];
+	std::vector<int>::iterator it = std::find(band.begin(), band.end(), slot);
+	if (it != band.end())
+	{
+		*it = band.back();
+		band.pop_back();
+	}
+
+	m_slotsByName.erase(candidate.name);
+	candidate.name.erase();
+	candidate.user = NULL;
+	candidate.needsRefill = false;
+	candidate.maps.clear();
+	m_freeSlots.push_back(slot);
+	--m_userCount;
+}
+
+void MatchEngine::findMatches(int budgetMsec, std::vector<Match>& matches)
+{
+	if (budgetMsec <= 0)
+		return;
+
+	Xtime start;
+
+	// Pairs only go away while nothing is added, so there is nothing new to find
+	refillPairs();
+	if (!m_dirty)
+		return;
+
+	// The pairs that came up during a pass wait for the next one, so that every pass gets to the end
+	if (m_scanPosition == 0)
+		updateRanking();
+
+	m_tallyCount.resize(m_slots.size(), 0);
+	m_tallyFitness.resize(m_slots.size(), 0.0);
+
+	int group[8];
+	std::vector<unsigned int> groupMaps;
+	for (int r=m_scanPosition; r<(int)m_ranking.size(); ++r)
+	{
+		if (r % pairsBetweenTimeChecks == 0 && r > m_scanPosition && elapsedMsec(start) > budgetMsec)
+		{
+			DBGMSG("Match time budget spent after " << r << " of " << m_ranking.size() << " pairs");
+			m_scanPosition = r;
+			return;
+		}
+
+		// Both users of the pair must still be free
+		const RankedPair& seed = m_ranking[r];
+		if (!isCurrent(seed))
+			continue;
+
+		group[0] = seed.first;
+		group[1] = seed.second;
+		int groupSize = 2;
+		groupMaps = m_slots[seed.first].maps;
+		for (int w=0; w<(int)groupMaps.size(); ++w)
+			groupMaps[w] &= m_slots[seed.second].maps[w];
+
+		// Grow the group with whoever fits best with all of it
+		while (groupSize < m_numPlayers)
+		{
+			int best = findBestJoiner(group, groupSize, groupMaps);
+			if (best < 0)
+				break;
+
+			group[groupSize++] = best;
+			for (int w=0; w<(int)groupMaps.size(); ++w)
+				groupMaps[w] &= m_slots[best].maps[w];
+		}
+
+		if (groupSize < m_numPlayers)
+			continue;
+
+		Match match;
+		for (int m=0; m<8; ++m)
+		{
+			match.users[m] = NULL;
+			if (m < groupSize)
+			{
+				match.names[m] = m_slots[group[m]].name;
+				match.users[m] = m_slots[group[m]].user;
+				takeSlot(group[m]);
+			}
+		}
+		matches.push_back(match);
+	}
+
+	m_scanPosition = 0;
+	m_dirty = !m_newPairs.empty();
+}
@@ -0,0 +1,142 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+class Xtime;
+class GeneralsUser;
+class GeneralsMatcher;
+
+// Milliseconds that passed since 'start' was taken
+int elapsedMsec(const Xtime& start);
+
+// =====================================================================
+// Match engine
+// =====================================================================
+
+// TheSuperHackers @performance The users of one matching pool, with the fitness of the pairs of
+// them that could play each other. The pairs are worked out when a user starts matching or widens
+// the search, and only against the users in the rating bands that its point range allows, so the
+// matcher no longer compares every user with every other user on each tick. Matches are assembled
+// greedily from the best pairs down, in a ranking that is kept sorted between ticks.
+class MatchEngine
+{
+public:
+	MatchEngine();
+
+	void init(GeneralsMatcher *matcher, int numPlayers);
+	bool isInitialized(void) const { return m_matcher != NULL; }
+
+	// The user must be working.  Users that are matched are taken out again by findMatches().
+	void addUser(const std::string& name, GeneralsUser *user);
+	void removeUser(const std::string& name);
+	void updateUser(const std::string& name); // the user widened the search
+	bool hasUser(const std::string& name) const;
+
+	struct Match
+	{
+		std::string names[8];
+		GeneralsUser *users[8];
+	};
+
+	// Assemble matches until no more can be made or the time budget runs out, in which case the
+	// rest is looked at on the next call.  The matched users are taken out of the engine.  Does
+	// nothing if there is no budget left.
+	void findMatches(int budgetMsec, std::vector<Match>& matches);
+
+	bool hasWorkLeft(void) const { return m_dirty || !m_refillSlots.empty(); }
+	int getUserCount(void) const { return m_userCount; }
+	int getPairCount(void) const { return m_pairCount; }
+
+private:
+	enum
+	{
+		BandCount = 32, // one band per power of two points
+		PairsPerPlayer = 64, // the best pairs a user keeps of the ones it finds, per player in the match
+		RefillFraction = 4 // look again when a user that found more pairs is down to this part of them
+	};
+
+	struct Pair
+	{
+		int other;
+		double fitness;
+	};
+
+	struct Candidate
+	{
+		std::string name;
+		GeneralsUser *user; // NULL if the slot is free
+		int generation; // changes whenever the pairs of this slot are dropped
+		std::vector<unsigned int> maps; // the maps bits, packed
+		int band;
+		bool leftPairsOut; // it found more pairs than it keeps
+		bool needsRefill;
+		std::vector<Pair> pairs; // the users this one can play with
+	};
+
+	struct RankedPair
+	{
+		double fitness;
+		int first;
+		int second;
+		int firstGeneration;
+		int secondGeneration;
+
+		bool operator<(const RankedPair& other) const;
+	};
+
+	static bool isFitterPair(const Pair& a, const Pair& b);
+	static int getBand(int points);
+	void getBandRange(const GeneralsUser *user, int& lowBand, int& highBand) const;
+	void packMaps(Candidate& candidate) const;
+	bool sharesMaps(const std::vector<unsigned int>& maps, const Candidate& candidate) const;
+	bool isCurrent(const RankedPair& rankedPair) const;
+
+	void addPairs(int slot);
+	void removePairs(int slot);
+	bool hasPair(int slot, int other) const;
+	void refillPairs(void);
+	void updateRanking(void);
+	int findBestJoiner(const int *group, int groupSize, const std::vector<unsigned int>& groupMaps);
+	void takeSlot(int slot);
+
+	GeneralsMatcher *m_matcher;
+	int m_numPlayers;
+	int m_maxPairsPerUser;
+
+	std::vector<Candidate> m_slots;
+	std::vector<int> m_freeSlots;
+	std::map<std::string, int> m_slotsByName;
+	std::vector<int> m_bands[BandCount];
+	std::vector<int> m_refillSlots;
+
+	std::vector<RankedPair> m_ranking; // best first, may still hold pairs that are gone
+	std::vector<RankedPair> m_newPairs; // not in the ranking yet
+	int m_scanPosition; // where findMatches() ran out of time in the ranking
+
+	std::vector<int> m_tallyCount; // scratch for findBestJoiner(), kept zeroed
+	std::vector<double> m_tallyFitness;
+
+	int m_userCount;
+	int m_pairCount;
+	bool m_dirty; // there may be matches that findMatches() did not look at yet
+};
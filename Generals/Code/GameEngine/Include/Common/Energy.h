@@ -105,6 +105,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "Energy"; }
 
 	void addProduction(Int amt);
 	void addConsumption(Int amt);
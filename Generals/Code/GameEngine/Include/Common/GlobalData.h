@@ -344,6 +344,17 @@ public:
 
 	std::vector<AsciiString> m_simulateReplays; ///< If not empty, simulate this list of replays and exit.
 	Int m_simulateReplayJobs; ///< Maximum number of processes to use for simulation, or SIMULATE_REPLAYS_SEQUENTIAL for sequential simulation
+	Int m_replaySnapshotInterval; ///< Keep a deep CRC snapshot every N frames during replay simulation, or 0 for none
+	Int m_replaySnapshotCount; ///< Maximum number of replay simulation snapshots kept in memory
+	Bool m_replaySnapshotDump; ///< Write the replay simulation snapshots to disk even if no mismatch occurred
+	AsciiString m_replayReportFile; ///< If not empty, write a JSON performance report of the replay simulation to this file
+	AsciiString m_crcTreeFile; ///< If not empty, append the CRC tree of every logic CRC to this file
+	AsciiString m_benchmarkPathfindMap; ///< If not empty, benchmark the pathfinder on this map and exit
+	AsciiString m_benchmarkPathfindWorkload; ///< If not empty, read the pathfind benchmark requests from this file, or write them to it if it does not exist
+	AsciiString m_benchmarkPathfindUnit; ///< Name of the unit that the pathfind benchmark finds paths for
+	Int m_benchmarkPathfindRequests; ///< Number of pathfind benchmark requests to generate
+	UnsignedInt m_benchmarkPathfindSeed; ///< Seed of the generated pathfind benchmark requests
+	Bool m_checkNetworkLoopback; ///< Send game commands over a network in memory, check that they arrive unchanged and exit
 
 	Int m_maxParticleCount;						///< maximum number of particles that can exist
 	Int m_maxFieldParticleCount;			///< maximum number of field-type particles that can exist (roughly)
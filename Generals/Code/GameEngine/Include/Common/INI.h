@@ -39,6 +39,7 @@
 class INI;
 class Xfer;
 class File;
+class FilePrefetcher;
 enum ScienceType CPP_11(: Int);
 
 //-------------------------------------------------------------------------------------------------
@@ -391,8 +392,10 @@ protected:
 
 	void readLine( void );
 
-//	FILE *m_file;															///< file pointer of file currently loading
-	File *m_file;															///< file pointer of file currently loading
+	char *m_fileData;													///< entire contents of the file currently loading
+	UnsignedInt m_fileDataSize;								///< number of bytes in m_fileData
+	UnsignedInt m_fileDataNext;								///< offset of the next unread char in m_fileData
+	FilePrefetcher *m_prefetcher;							///< files of the directory being loaded, read ahead of time
 	AsciiString m_filename;										///< filename of file currently loading
 	INILoadType m_loadType;										///< load time for current file
 	UnsignedInt m_lineNum;										///< current line number that's been read
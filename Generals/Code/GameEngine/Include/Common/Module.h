@@ -191,6 +191,8 @@ public:
 
 	inline NameKeyType getModuleTagNameKey() const { return getModuleData()->getModuleTagNameKey(); }
 
+	virtual AsciiString getSnapshotName() const { return KEYNAME(getModuleNameKey()); }
+
 	/** this is called after all the Modules for a given Thing are created; it
 		allows Modules to resolve any inter-Module dependencies.
 	*/
@@ -167,6 +167,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "PlayerRelationMap"; }
 
 };
 
@@ -697,6 +698,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "Player"; }
 
 	void deleteUpgradeList( void );															///< delete all our upgrades
 
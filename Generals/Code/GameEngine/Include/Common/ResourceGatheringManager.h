@@ -59,6 +59,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "ResourceGatheringManager"; }
 
 private:
 	/// @todo Make sure the allocator for std::list<> is a good one.  Otherwise override it.
@@ -102,6 +102,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "ScoreKeeper"; }
 
 private:
 
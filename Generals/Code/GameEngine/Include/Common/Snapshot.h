@@ -45,12 +45,16 @@ friend class GameState;
 friend class XferLoad;
 friend class XferSave;
 friend class XferCRC;
+friend class XferCRCTree;
 
 public:
 
 	Snapshot( void );
 	~Snapshot( void );
 
+	/// TheSuperHackers @feature The name of the nodes of this snapshot in a CRC tree
+	virtual AsciiString getSnapshotName( void ) const { return "Snapshot"; }
+
 protected:
 
 	/// run the "light" crc check on this data structure
@@ -63,6 +63,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "TeamRelationMap"; }
 
 };
 
@@ -131,6 +131,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "Upgrade"; }
 
 	const UpgradeTemplate *m_template;	///< template this upgrade instance is based on
 	UpgradeStatusType m_status;							///< status of upgrade
@@ -149,6 +149,7 @@ public:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess( void );
+	AsciiString getSnapshotName( void ) const { return "TAiData"; }
 
 	Real m_structureSeconds;		// Try to build a structure every N seconds.
 	Real m_teamSeconds;					// Try to build a team every N seconds.
@@ -267,6 +268,7 @@ public:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess( void );
+	AsciiString getSnapshotName( void ) const { return "AI"; }
 
 	// AI Groups -----------------------------------------------------------------------------------------------
 	AIGroupPtr createGroup( void ); ///< instantiate a new AI Group
@@ -854,6 +856,7 @@ public:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess( void );
+	AsciiString getSnapshotName( void ) const { return "AIGroup"; }
 
 #if !RETAIL_COMPATIBLE_AIGROUP
 	void Add_Ref() const { m_refCount.Add_Ref(); }
@@ -62,6 +62,8 @@ class WindowLayout;
 class TerrainLogic;
 class GhostObjectManager;
 class CommandButton;
+class XferCRC;
+class XferCRCTree;
 enum BuildableStatus CPP_11(: Int);
 
 typedef const CommandButton* ConstCommandButtonPtr;
@@ -132,6 +134,8 @@ public:
 	Bool hasUpdated() const { return m_hasUpdated; } ///< Returns true if the logic frame has advanced in the current client/render update
 	UnsignedInt getFrame( void );										///< Returns the current simulation frame number
 	UnsignedInt getCRC( Int mode = CRC_CACHED, AsciiString deepCRCFileName = AsciiString::TheEmptyString );		///< Returns the CRC
+	UnsignedInt recalculateCRC( XferCRC *xferCRC );		///< Recalculates the CRC into the given open xfer and closes it
+	UnsignedInt recalculateCRCTree( void );						///< Recalculates the CRC and appends its tree to the -crcTree file
 
 	void setObjectIDCounter( ObjectID nextObjID ) { m_nextObjID = nextObjID; }
 	ObjectID getObjectIDCounter( void ) { return m_nextObjID; }
@@ -269,6 +273,21 @@ private:
 	void remakeSleepyUpdate();
 	void validateSleepyUpdate() const;
 
+#ifdef SLEEPY_UPDATE_WHEEL
+	void pushSleepyWheel(UpdateModulePtr u);
+	void eraseSleepyWheel(UpdateModulePtr u);
+	void rescheduleSleepyWheel(UpdateModulePtr u);
+	UpdateModulePtr peekSleepyWheel(UnsignedInt lastPriority);
+	void clearSleepyWheel(UnsignedInt priority);
+	Int getSleepyWheelList(UnsignedInt priority) const;
+	void linkSleepyWheel(UpdateModulePtr u, Int list);
+	void unlinkSleepyWheel(UpdateModulePtr u);
+	void cascadeSleepyWheel(Int list);
+#ifdef VERIFY_SLEEPY_UPDATE_WHEEL
+	void verifySleepyWheel(UpdateModulePtr u, UnsignedInt now);
+#endif
+#endif
+
 private:
 
 	/**
@@ -291,6 +310,8 @@ private:
 	UnsignedInt	m_CRC;																			///< Cache of previous CRC value
 	std::map<Int, UnsignedInt> m_cachedCRCs;								///< CRCs we've seen this frame
 	Bool m_shouldValidateCRCs;															///< Should we validate CRCs this frame?
+	XferCRCTree *m_crcTree;																	///< CRC tree recorder, if -crcTree is used
+	FILE *m_crcTreeFile;																		///< File the CRC trees are appended to
 	//-----------------------------------------------------------------------------------------------
 	Bool m_loadingScene;
 
@@ -318,6 +339,37 @@ private:
 	// http://dogma.net/markn/articles/pq_stl/priority.htm)
 	std::vector<UpdateModulePtr> m_sleepyUpdates;
 
+#ifdef SLEEPY_UPDATE_WHEEL
+	// TheSuperHackers @performance Hierarchical timing wheel for the sleepy updates, keyed by the same
+	// frame and phase priority as the heap. The near wheel has a list for every priority of the current
+	// 256 frames, the far wheel a list for every 256 frames of the current 65536 frames, and everything
+	// later waits on the overflow list. Lists are cascaded down as the wheel turns, so a module is
+	// scheduled, woken and erased in constant time. Modules scheduled before the current priority,
+	// such as objects created later in the frame, wait on the overdue list, which is kept sorted.
+	enum
+	{
+		SLEEPY_WHEEL_NEAR_BITS = 10,
+		SLEEPY_WHEEL_FAR_BITS = 8,
+		SLEEPY_WHEEL_NEAR_SIZE = 1 << SLEEPY_WHEEL_NEAR_BITS,
+		SLEEPY_WHEEL_FAR_SIZE = 1 << SLEEPY_WHEEL_FAR_BITS,
+		SLEEPY_WHEEL_NEAR_LIST = 0,
+		SLEEPY_WHEEL_FAR_LIST = SLEEPY_WHEEL_NEAR_LIST + SLEEPY_WHEEL_NEAR_SIZE,
+		SLEEPY_WHEEL_OVERFLOW_LIST = SLEEPY_WHEEL_FAR_LIST + SLEEPY_WHEEL_FAR_SIZE,
+		SLEEPY_WHEEL_OVERDUE_LIST,
+		SLEEPY_WHEEL_LIST_COUNT
+	};
+
+	struct SleepyWheelList
+	{
+		UpdateModulePtr m_head;
+		UpdateModulePtr m_tail;
+	};
+
+	SleepyWheelList m_sleepyWheel[SLEEPY_WHEEL_LIST_COUNT];
+	UnsignedInt m_sleepyWheelPriority;											///< the priority the near wheel is at
+	Int m_sleepyWheelCount;
+#endif
+
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	// this is a plain old list, not a pq.
 	std::list<UpdateModulePtr> m_normalUpdates;
@@ -37,6 +37,16 @@
 
 #define DIRECT_UPDATEMODULE_ACCESS
 
+// TheSuperHackers @info Builds that keep the retail heap for sleepy updates run the timing wheel next to it in debug,
+// and check that both call modules on the same frames and phases in the same order.
+#if !USE_SLEEPY_UPDATE_WHEEL && defined(RTS_DEBUG)
+#define VERIFY_SLEEPY_UPDATE_WHEEL
+#endif
+
+#if USE_SLEEPY_UPDATE_WHEEL || defined(VERIFY_SLEEPY_UPDATE_WHEEL)
+#define SLEEPY_UPDATE_WHEEL
+#endif
+
 //-------------------------------------------------------------------------------------------------
 /** OBJECT UPDATE MODULE base class */
 //-------------------------------------------------------------------------------------------------
@@ -142,6 +152,11 @@ private:
 	// actually, it's not a real frame at all, it has phase info in the lower bits...
 	UnsignedInt m_nextCallFrameAndPhase;
 	Int m_indexInLogic;
+#ifdef SLEEPY_UPDATE_WHEEL
+	Int m_listInWheel;							///< which list of the GameLogic timing wheel we are on, or -1
+	UpdateModule* m_prevInWheel;
+	UpdateModule* m_nextInWheel;
+#endif
 
 protected:
 
@@ -220,6 +235,34 @@ public:
 		m_indexInLogic = i;
 	}
 
+#ifdef SLEEPY_UPDATE_WHEEL
+	UPDATEMODULE_FRIEND_DECLARATOR Int friend_getListInWheel() const
+	{
+		return m_listInWheel;
+	}
+
+	UPDATEMODULE_FRIEND_DECLARATOR void friend_setListInWheel(Int list)
+	{
+		m_listInWheel = list;
+	}
+
+	UPDATEMODULE_FRIEND_DECLARATOR UpdateModule* friend_getPrevInWheel() const
+	{
+		return m_prevInWheel;
+	}
+
+	UPDATEMODULE_FRIEND_DECLARATOR UpdateModule* friend_getNextInWheel() const
+	{
+		return m_nextInWheel;
+	}
+
+	UPDATEMODULE_FRIEND_DECLARATOR void friend_setLinksInWheel(UpdateModule* prev, UpdateModule* next)
+	{
+		m_prevInWheel = prev;
+		m_nextInWheel = next;
+	}
+#endif
+
 	UPDATEMODULE_FRIEND_DECLARATOR const Object* friend_getObject() const
 	{
 		return getObject();
@@ -229,6 +272,11 @@ public:
 inline UpdateModule::UpdateModule( Thing *thing, const ModuleData* moduleData ) :
 	BehaviorModule( thing, moduleData ),
 	m_indexInLogic(-1),
+#ifdef SLEEPY_UPDATE_WHEEL
+	m_listInWheel(-1),
+	m_prevInWheel(NULL),
+	m_nextInWheel(NULL),
+#endif
 	m_nextCallFrameAndPhase(0)
 {
 	// nothing
@@ -236,6 +284,9 @@ inline UpdateModule::UpdateModule( Thing *thing, const ModuleData* moduleData )
 inline UpdateModule::~UpdateModule()
 {
 	DEBUG_ASSERTCRASH(m_indexInLogic == -1, ("destroying an updatemodule still in the logic list"));
+#ifdef SLEEPY_UPDATE_WHEEL
+	DEBUG_ASSERTCRASH(m_listInWheel == -1, ("destroying an updatemodule still in the logic wheel"));
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -292,13 +292,11 @@ class PartitionCell : public Snapshot	// not MPO: allocated in an array
 {
 private:
 	CellAndObjectIntersection*		m_firstCoiInCell;	///< list of COIs in this cell (may be null).
-	ShroudLevel										m_shroudLevel[MAX_PLAYER_COUNT];
 #ifdef PM_CACHE_TERRAIN_HEIGHT
 	Real													m_loTerrainZ;			///< lowest terrain-pt in this cell
 	Real													m_hiTerrainZ;			///< highest terrain-pt in this cell
 #endif
-	Int														m_threatValue[MAX_PLAYER_COUNT];
-	Int														m_cashValue[MAX_PLAYER_COUNT];
+	Int														m_cellIndex;				///< index of this cell, also into the per player grids of the Partition Mgr
 	Short													m_coiCount;					///< number of COIs in this cell.
 	Short													m_cellX;						///< x-coord of this cell within the Partition Mgr coords (NOT in world coords)
 	Short													m_cellY;						///< y-coord of this cell within the Partition Mgr coords (NOT in world coords)
@@ -308,9 +306,9 @@ public:
 	// Note, we allocate these in arrays, thus we must have a default ctor (and NOT descend from MPO)
 	PartitionCell();
 #ifdef PM_CACHE_TERRAIN_HEIGHT
-	void init(Int x, Int y, Real loZ, Real hiZ) { m_cellX = x; m_cellY = y; m_loTerrainZ = loZ; m_hiTerrainZ = hiZ; }
+	void init(Int x, Int y, Int index, Real loZ, Real hiZ) { m_cellX = x; m_cellY = y; m_cellIndex = index; m_loTerrainZ = loZ; m_hiTerrainZ = hiZ; }
 #else
-	void init(Int x, Int y) { m_cellX = x; m_cellY = y; }
+	void init(Int x, Int y, Int index) { m_cellX = x; m_cellY = y; m_cellIndex = index; }
 #endif
 	~PartitionCell();
 
@@ -358,6 +356,11 @@ public:
 
 	// intended only for CellAndObjectIntersection.
 	void friend_removeFromCellList(CellAndObjectIntersection *coi);
+
+private:
+	inline ShroudLevel& shroudLevel( Int playerIndex ) const;
+	inline Int& threatValue( Int playerIndex ) const;
+	inline Int& cashValue( Int playerIndex ) const;
 };
 
 //=====================================
@@ -1181,6 +1184,58 @@ protected:
 #endif
 };
 
+//=====================================
+/**
+	TheSuperHackers @performance A fixed size set of range query results, meant to live on the caller's
+	stack. Filling it does no memory pool traffic and ordered queries are sorted in place, but the objects
+	come out in exactly the order a SimpleObjectIterator for the same query gives them. Should a query find
+	more objects than fit, the results move into a SimpleObjectIterator, so callers never miss any.
+*/
+class PartitionQueryResults
+{
+public:
+	PartitionQueryResults();
+	~PartitionQueryResults();
+
+	Object *first() { return firstWithNumeric(NULL); }
+	Object *next() { return nextWithNumeric(NULL); }
+
+	Object *firstWithNumeric(Real *num = NULL);
+	Object *nextWithNumeric(Real *num = NULL);
+
+	/// return the total number of objects found.
+	Int getCount() const { return m_overflow ? m_overflow->getCount() : m_count; }
+
+private:
+	friend class PartitionManager;
+
+	enum { MAX_RESULTS = 256 };
+
+	struct Result
+	{
+		Object	*m_obj;
+		Real		m_numeric;	// typically, dist-squared
+	};
+
+	typedef Real (*ResultCompareProc)(const Result& a, const Result& b);
+	static ResultCompareProc theResultCompareProcs[];
+
+	static Real sortNearToFar(const Result& a, const Result& b);
+	static Real sortFarToNear(const Result& a, const Result& b);
+	static Real sortCheapToExpensive(const Result& a, const Result& b);
+	static Real sortExpensiveToCheap(const Result& a, const Result& b);
+
+	void makeEmpty();
+	void insert(Object *obj, Real numeric);		///< append an object, in the order the query finds them
+	void finish(IterOrderType order);					///< put the objects in iteration order
+
+	Result m_results[MAX_RESULTS];
+	Result m_scratch[MAX_RESULTS];						///< merge buffer for sorting
+	Int m_count;
+	Int m_cur;
+	SimpleObjectIterator *m_overflow;					///< holds all results once they do not fit anymore
+};
+
 //=====================================
 /**
 	PartitionManager is the singleton class that manages the entire partition/collision
@@ -1206,6 +1261,13 @@ private:
 	Int							m_cellCountY;			///< number of cells, y
 	Int							m_totalCellCount;	///< x * y
 	PartitionCell*	m_cells;					///< array of cells
+
+	// TheSuperHackers @performance The per player data of the cells is stored as one grid per player, in
+	// the same order as m_cells, so that updating or reading one player's data walks contiguous memory.
+	ShroudLevel*		m_shroudLevels;		///< MAX_PLAYER_COUNT grids of m_totalCellCount shroud levels
+	Int*						m_threatValues;		///< MAX_PLAYER_COUNT grids of m_totalCellCount threat values
+	Int*						m_cashValues;			///< MAX_PLAYER_COUNT grids of m_totalCellCount cash values
+
 	PartitionData*	m_dirtyModules;
 	Bool						m_updatedSinceLastReset;	///< Used to force a return of OBJECTSHROUD_INVALID before update has been called.
 
@@ -1229,6 +1291,7 @@ protected:
 		DistanceCalculationType dc,
 		PartitionFilter **filters,
 		SimpleObjectIterator *iter,	// if nonnull, append ALL satisfactory objects to the iterator (not just the single closest)
+		PartitionQueryResults *results,	// if nonnull, append ALL satisfactory objects to the results (not just the single closest)
 		Real *closestDistArg,
 		Coord3D *closestVecArg
 	);
@@ -1255,6 +1318,8 @@ protected:
 
 	// These are all friend functions now. They will continue to function as before, but can be passed into
 	// the DiscreteCircle::drawCircle function.
+	friend class PartitionCell;
+
 	friend void hLineAddLooker(Int x1, Int x2, Int y, void *playerIndex);
 	friend void hLineRemoveLooker(Int x1, Int x2, Int y, void *playerIndex);
 	friend void hLineAddShrouder(Int x1, Int x2, Int y, void *playerIndex);
@@ -1283,6 +1348,7 @@ public:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess( void );
+	AsciiString getSnapshotName( void ) const { return "PartitionManager"; }
 
 	inline Bool getUpdatedSinceLastReset( void ) const { return m_updatedSinceLastReset; }
 
@@ -1303,6 +1369,11 @@ public:
 	PartitionCell *getCellAt(Int x, Int y);
 	const PartitionCell *getCellAt(Int x, Int y) const;
 
+	/// return the given player's grid of cell data, with getCellCountX() * getCellCountY() entries indexed by (y * getCellCountX() + x).
+	const ShroudLevel *getShroudLevelsForPlayer(Int playerIndex) const { return m_shroudLevels + playerIndex * m_totalCellCount; }
+	const Int *getThreatValuesForPlayer(Int playerIndex) const { return m_threatValues + playerIndex * m_totalCellCount; }
+	const Int *getCashValuesForPlayer(Int playerIndex) const { return m_cashValues + playerIndex * m_totalCellCount; }
+
 	/// A convenience funtion to reveal shroud at some location
 	// Queueing does not give you control of the timestamp to enforce the queue.  I own the delay, you don't.
 	void doShroudReveal( Real centerX, Real centerY, Real radius, PlayerMaskType playerMask);
@@ -1384,6 +1455,28 @@ public:
 		IterOrderType order = ITER_FASTEST
 	);
 
+	/**
+		Same as iterateObjectsInRange, but fills a caller owned PartitionQueryResults instead of
+		allocating an iterator.
+	*/
+	void collectObjectsInRange(
+		PartitionQueryResults &results,
+		const Object *obj,
+		Real maxDist,
+		DistanceCalculationType dc,
+		PartitionFilter **filters = NULL,
+		IterOrderType order = ITER_FASTEST
+	);
+
+	void collectObjectsInRange(
+		PartitionQueryResults &results,
+		const Coord3D *pos,
+		Real maxDist,
+		DistanceCalculationType dc,
+		PartitionFilter **filters = NULL,
+		IterOrderType order = ITER_FASTEST
+	);
+
 	SimpleObjectIterator *iterateAllObjects(PartitionFilter **filters = NULL);
 
 	/**
@@ -1397,6 +1490,15 @@ public:
 		Bool use2D = false
 	);
 
+	/// Same as iteratePotentialCollisions, but fills a caller owned PartitionQueryResults.
+	void collectPotentialCollisions(
+		PartitionQueryResults &results,
+		const Coord3D* pos,
+		const GeometryInfo& geom,
+		Real angle,
+		Bool use2D = false
+	);
+
 	Bool isColliding( const Object *a, const Object *b ) const;
 
 	/// Checks a geometry against an arbitrary geometry.
@@ -458,6 +458,125 @@ Int parseJobs(char *args[], int num)
 	return 1;
 }
 
+Int parseReplaySnapshotInterval(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replaySnapshotInterval = atoi(args[1]);
+		if (TheGlobalData->m_replaySnapshotInterval < 0)
+		{
+			printf("Invalid replay snapshot interval: %d\n", TheGlobalData->m_replaySnapshotInterval);
+			exit(1);
+		}
+		return 2;
+	}
+	return 1;
+}
+
+Int parseReplaySnapshotCount(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replaySnapshotCount = atoi(args[1]);
+		if (TheGlobalData->m_replaySnapshotCount < 1)
+		{
+			printf("Invalid replay snapshot count: %d\n", TheGlobalData->m_replaySnapshotCount);
+			exit(1);
+		}
+		return 2;
+	}
+	return 1;
+}
+
+Int parseReplaySnapshotDump(char *args[], int num)
+{
+	TheWritableGlobalData->m_replaySnapshotDump = TRUE;
+	return 1;
+}
+
+Int parseReplayReport(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_replayReportFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseCRCTree(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_crcTreeFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkPathfind(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_benchmarkPathfindMap = args[1];
+		parseHeadless(args, num);
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkPathfindWorkload(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_benchmarkPathfindWorkload = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkPathfindUnit(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_benchmarkPathfindUnit = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkPathfindRequests(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_benchmarkPathfindRequests = atoi(args[1]);
+		if (TheGlobalData->m_benchmarkPathfindRequests < 1)
+		{
+			printf("Invalid pathfind benchmark request count: %d\n", TheGlobalData->m_benchmarkPathfindRequests);
+			exit(1);
+		}
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkPathfindSeed(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_benchmarkPathfindSeed = (UnsignedInt)atoi(args[1]);
+		return 2;
+	}
+	return 1;
+}
+
+Int parseCheckNetworkLoopback(char *args[], int num)
+{
+	TheWritableGlobalData->m_checkNetworkLoopback = TRUE;
+	parseHeadless(args, num);
+	return 1;
+}
+
 Int parseXRes(char *args[], int num)
 {
 	if (num > 1)
@@ -1162,7 +1281,43 @@ static CommandLineParam paramsForStartup[] =
 	// Simulate each replay in a separate process and use 1..N processes at the same time.
 	// (If you have 4 cores, call it with -jobs 4)
 	// If you do not call this, all replays will be simulated in sequence in the same process.
+	// On non-Windows platforms with -headless, the workers are forked from this process after engine init.
 	{ "-jobs", parseJobs },
+
+	// TheSuperHackers @feature Keep a deep CRC snapshot of the game logic every N frames while simulating replays.
+	// When a mismatch occurs, the most recent snapshots are written to the ReplaySnapshots folder in the user
+	// data folder, so that they can be compared with the snapshots of a good run without simulating from frame 0.
+	// Use -replaySnapshotCount to set how many snapshots are kept in memory (default 8)
+	// and -replaySnapshotDump to write them even without a mismatch, for example from a reference build.
+	{ "-replaySnapshotInterval", parseReplaySnapshotInterval },
+	{ "-replaySnapshotCount", parseReplaySnapshotCount },
+	{ "-replaySnapshotDump", parseReplaySnapshotDump },
+
+	// TheSuperHackers @feature Write a JSON report with the simulation performance of each replay to the given file.
+	// It contains logic frames per second, a frame time histogram, the time spent in the main logic
+	// subsystems, the peak object count and the peak memory pool usage. Use with -headless.
+	{ "-replayReport", parseReplayReport },
+
+	// TheSuperHackers @feature Append a tree of sub CRCs of every logic CRC to the given binary file.
+	// The CRC values are unchanged. Run CRCDiff -tree on the files of two runs to find the first
+	// object and snapshot that diverged. Replays are simulated sequentially when this is set.
+	{ "-crcTree", parseCRCTree },
+
+	// TheSuperHackers @feature Load the given map without graphics, run a workload of pathfinding requests
+	// on it and print the cells examined, paths per second, latency percentiles and a hash of the paths.
+	// Pass the map path including .map afterwards. Implies -headless.
+	// -benchmarkPathfindWorkload reads the requests from the given file, or writes the generated ones to it
+	// if it does not exist yet. -benchmarkPathfindRequests and -benchmarkPathfindSeed control the generated
+	// requests. -benchmarkPathfindUnit names the unit that finds the paths, which must be able to attack.
+	{ "-benchmarkPathfind", parseBenchmarkPathfind },
+	{ "-benchmarkPathfindWorkload", parseBenchmarkPathfindWorkload },
+	{ "-benchmarkPathfindUnit", parseBenchmarkPathfindUnit },
+	{ "-benchmarkPathfindRequests", parseBenchmarkPathfindRequests },
+	{ "-benchmarkPathfindSeed", parseBenchmarkPathfindSeed },
+
+	// TheSuperHackers @feature Send game commands between two Transports over a network in memory, with
+	// latency and jitter, and check that they arrive unchanged. Exits with 0 if they did. Implies -headless.
+	{ "-checkNetworkLoopback", parseCheckNetworkLoopback },
 };
 
 // These Params are parsed during Engine Init before INI data is loaded
@@ -44,6 +44,7 @@
 #include "Common/MessageStream.h"
 #include "Common/ThingFactory.h"
 #include "Common/file.h"
+#include "Common/FilePrefetcher.h"
 #include "Common/FileSystem.h"
 #include "Common/ArchiveFileSystem.h"
 #include "Common/LocalFileSystem.h"
@@ -386,6 +387,10 @@ void GameEngine::init()
 		initSubsystem(TheLocalFileSystem, "TheLocalFileSystem", createLocalFileSystem(), NULL);
 		initSubsystem(TheArchiveFileSystem, "TheArchiveFileSystem", createArchiveFileSystem(), NULL); // this MUST come after TheLocalFileSystem creation
 
+		// TheSuperHackers @performance Start the threads that read INI files ahead of the parser. They
+		// serve every INI directory loaded during init.
+		TheFilePrefetcher = MSGNEW("GameEngineSubsystem") FilePrefetcher;
+
 		DEBUG_ASSERTCRASH(TheWritableGlobalData,("TheWritableGlobalData expected to be created"));
 		initSubsystem(TheWritableGlobalData, "TheWritableGlobalData", TheWritableGlobalData, &xferCRC, "Data\\INI\\Default\\GameData", "Data\\INI\\GameData");
 		TheWritableGlobalData->parseCustomDefinition();
@@ -587,6 +592,9 @@ void GameEngine::init()
 		RELEASE_CRASH(("Uncaught Exception during initialization."));
 	}
 
+	delete TheFilePrefetcher;
+	TheFilePrefetcher = NULL;
+
 	if(!TheGlobalData->m_playIntro)
 		TheWritableGlobalData->m_afterIntro = TRUE;
 
@@ -30,7 +30,9 @@
 
 #include "Common/FramePacer.h"
 #include "Common/GameEngine.h"
+#include "Common/PathfindBenchmark.h"
 #include "Common/ReplaySimulation.h"
+#include "GameNetwork/NetworkLoopbackCheck.h"
 
 
 /**
@@ -49,6 +51,14 @@ Int GameMain()
 	{
 		exitcode = ReplaySimulation::simulateReplays(TheGlobalData->m_simulateReplays, TheGlobalData->m_simulateReplayJobs);
 	}
+	else if (TheGlobalData->m_benchmarkPathfindMap.isNotEmpty())
+	{
+		exitcode = PathfindBenchmark::run(TheGlobalData->m_benchmarkPathfindMap);
+	}
+	else if (TheGlobalData->m_checkNetworkLoopback)
+	{
+		exitcode = NetworkLoopbackCheck::run();
+	}
 	else
 	{
 		// run it
@@ -974,6 +974,17 @@ GlobalData::GlobalData()
 
 	m_simulateReplays.clear();
 	m_simulateReplayJobs = SIMULATE_REPLAYS_SEQUENTIAL;
+	m_replaySnapshotInterval = 0;
+	m_replaySnapshotCount = 8;
+	m_replaySnapshotDump = FALSE;
+	m_replayReportFile.clear();
+	m_crcTreeFile.clear();
+	m_benchmarkPathfindMap.clear();
+	m_benchmarkPathfindWorkload.clear();
+	m_benchmarkPathfindUnit = "AmericaVehicleHumvee";
+	m_benchmarkPathfindRequests = 1000;
+	m_benchmarkPathfindSeed = 1;
+	m_checkNetworkLoopback = FALSE;
 
 	for (i = LEVEL_FIRST; i <= LEVEL_LAST; ++i)
 		m_healthBonus[i] = 1.0f;
@@ -37,6 +37,7 @@
 
 #include "Common/DamageFX.h"
 #include "Common/file.h"
+#include "Common/FilePrefetcher.h"
 #include "Common/FileSystem.h"
 #include "Common/GameAudio.h"
 #include "Common/Science.h"
@@ -174,7 +175,10 @@ Bool INI::isValidINIFilename( const char *filename )
 INI::INI( void )
 {
 
-	m_file							= NULL;
+	m_fileData					= NULL;
+	m_fileDataSize			= 0;
+	m_fileDataNext			= 0;
+	m_prefetcher				= NULL;
 	m_filename					= "None";
 	m_loadType					= INI_LOAD_INVALID;
 	m_lineNum						= 0;
@@ -255,6 +259,9 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 		TheFileSystem->getFileListInDirectory(dirName, "*.ini", filenameList, subdirs);
 		// Load the INI files in the dir now, in a sorted order.  This keeps things the same between machines
 		// in a network game.
+		std::vector<AsciiString> loadOrder;
+		loadOrder.reserve(filenameList.size());
+
 		FilenameList::const_iterator it = filenameList.begin();
 		while (it != filenameList.end())
 		{
@@ -263,7 +270,7 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 
 			if ((tempname.find('\\') == NULL) && (tempname.find('/') == NULL)) {
 				// this file doesn't reside in a subdirectory, load it first.
-				filesRead += load( *it, loadType, pXfer );
+				loadOrder.push_back(*it);
 			}
 			++it;
 		}
@@ -275,10 +282,40 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 			tempname = (*it).str() + dirName.getLength();
 
 			if ((tempname.find('\\') != NULL) || (tempname.find('/') != NULL)) {
-				filesRead += load( *it, loadType, pXfer );
+				loadOrder.push_back(*it);
 			}
 			++it;
 		}
+
+		// TheSuperHackers @performance Read the files on the worker threads of TheFilePrefetcher ahead of
+		// the parser. They are still parsed one after another in the order above. A directory that is
+		// loaded while another one is being loaded is not prefetched.
+		FilePrefetcher *prefetcher = NULL;
+		if( TheFilePrefetcher != NULL && !TheFilePrefetcher->isActive() )
+		{
+			prefetcher = TheFilePrefetcher;
+			prefetcher->start(loadOrder);
+		}
+		m_prefetcher = prefetcher;
+
+		try
+		{
+			for (size_t i = 0; i < loadOrder.size(); ++i)
+			{
+				filesRead += load( loadOrder[i], loadType, pXfer );
+			}
+		}
+		catch (...)
+		{
+			m_prefetcher = NULL;
+			if( prefetcher != NULL )
+				prefetcher->stop();
+			throw;
+		}
+
+		m_prefetcher = NULL;
+		if( prefetcher != NULL )
+			prefetcher->stop();
 	}
 	catch (...)
 	{
@@ -294,7 +331,7 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 void INI::prepFile( AsciiString filename, INILoadType loadType )
 {
 	// if we have a file open already -- we can't do another one
-	if( m_file != NULL )
+	if( m_fileData != NULL )
 	{
 
 		DEBUG_CRASH(( "INI::load, cannot open file '%s', file already open", filename.str() ));
@@ -302,9 +339,18 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 
 	}
 
+	// take the file if it was read ahead of time
+	if( m_prefetcher != NULL && m_prefetcher->takeFile( filename, m_fileData, m_fileDataSize ) )
+	{
+		m_fileDataNext = 0;
+		m_filename = filename;
+		m_loadType = loadType;
+		return;
+	}
+
 	// open the file
-	m_file = TheFileSystem->openFile(filename.str(), File::READ);
-	if( m_file == NULL )
+	File *file = TheFileSystem->openFile(filename.str(), File::READ);
+	if( file == NULL )
 	{
 
 		DEBUG_CRASH(( "INI::load, cannot open file '%s'", filename.str() ));
@@ -312,7 +358,12 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 
 	}
 
-	m_file = m_file->convertToRAMFile();
+	// TheSuperHackers @performance Take the whole file into memory up front so that readLine can
+	// scan for line ends in place rather than pulling every character through the File interface.
+	file = file->convertToRAMFile();
+	m_fileDataSize = file->size();
+	m_fileDataNext = 0;
+	m_fileData = file->readEntireAndClose();
 
 	// save our filename
 	m_filename = filename;
@@ -325,9 +376,11 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 //-------------------------------------------------------------------------------------------------
 void INI::unPrepFile()
 {
-	// close the file
-	m_file->close();
-	m_file = NULL;
+	// release the file contents
+	delete [] m_fileData;
+	m_fileData = NULL;
+	m_fileDataSize = 0;
+	m_fileDataNext = 0;
 	m_filename = "None";
 	m_loadType = INI_LOAD_INVALID;
 	m_lineNum = 0;
@@ -454,7 +507,7 @@ void INI::readLine( void )
 	Bool isComment = FALSE;
 
 	// sanity
-	DEBUG_ASSERTCRASH( m_file, ("readLine(), file pointer is NULL") );
+	DEBUG_ASSERTCRASH( m_fileData, ("readLine(), file data is NULL") );
 
 	// if we've reached end of file we'll just keep returning empty string in our buffer
 	if( m_endOfFile )
@@ -463,55 +516,50 @@ void INI::readLine( void )
 	}
 	else
 	{
-		// read up till the newline character or until out of space
-		Int i = 0;
-		Bool done = FALSE;
-		while( !done )
+		//
+		// TheSuperHackers @performance Find the end of line with memchr in the file image and copy the
+		// line in one go instead of reading it through the File interface one character at a time. The
+		// resulting line, including the trailing newline turned into a space, must stay byte identical
+		// to what the old per character loop produced, because it is fed into the INI CRC below.
+		//
+		const char *src = m_fileData + m_fileDataNext;
+		UnsignedInt scanLen = m_fileDataSize - m_fileDataNext;
+		if( scanLen > INI_MAX_CHARS_PER_LINE )
+			scanLen = INI_MAX_CHARS_PER_LINE;
+
+		const char *eol = (const char *)memchr( src, '\n', scanLen );
+		Int i = eol ? (Int)(eol - src) + 1 : (Int)scanLen;
+
+		memcpy( m_buffer, src, i );
+		m_fileDataNext += i;
+
+		// check for end of file
+		if( eol == NULL && scanLen < INI_MAX_CHARS_PER_LINE )
+			m_endOfFile = TRUE;
+
+		for( Int c = 0; c < i; ++c )
 		{
 
-			// read character
-			m_endOfFile = (m_file->read(m_buffer + i, 1) == 0);
-
-			// check for end of file
-			if( m_endOfFile )
-			{
-
-				done = TRUE;
-				m_buffer[ i ] = '\0';
-
-			}
-
-			// check for new line
-			if( m_buffer[ i ] == '\n' )
-				done = TRUE;
-
-			DEBUG_ASSERTCRASH(m_buffer[ i ] != '\t', ("tab characters are not allowed in INI files (%s). please check your editor settings. Line Number %d",m_filename.str(), getLineNum()));
+			DEBUG_ASSERTCRASH(m_buffer[ c ] != '\t', ("tab characters are not allowed in INI files (%s). please check your editor settings. Line Number %d",m_filename.str(), getLineNum()));
 
 			// make all whitespace characters actual spaces
-			if( isspace( m_buffer[ i ] ) )
-				m_buffer[ i ] = ' ';
+			if( isspace( m_buffer[ c ] ) )
+				m_buffer[ c ] = ' ';
 
 			// if this is a semicolon, that represents the start of a comment
-			if( m_buffer[ i ] == ';' )
+			if( m_buffer[ c ] == ';' )
 				isComment = TRUE;
 
 			// if we've set the comment flag, just insert terminators in the place of each character read
 			if( isComment == TRUE )
-				m_buffer[ i ] = '\0';
-
-			//
-			// when we've become done, as the last thing just set the current index position + 1
-			// to the string terminator
-			//
-			if( done == TRUE && i + 1 < INI_MAX_CHARS_PER_LINE )
-				m_buffer[ i + 1 ] = '\0';
-
-			// increase our buffer index, but watch out for the max
-			if( ++i == INI_MAX_CHARS_PER_LINE )
-				done = TRUE;
+				m_buffer[ c ] = '\0';
 
 		}
 
+		// terminate the line unless it filled the whole buffer
+		if( i < INI_MAX_CHARS_PER_LINE )
+			m_buffer[ i ] = '\0';
+
 		// increase our line count
 		m_lineNum++;
 
@@ -3044,6 +3044,11 @@ ParticleSystem *ParticleSystemManager::createParticleSystem( const ParticleSyste
 	if (sysTemplate == NULL)
 		return NULL;
 
+	// TheSuperHackers @performance Nobody sees the particles in headless mode, and the client does not
+	// update them, so do not create the systems that the game logic asks for. Callers must expect NULL.
+	if (TheGlobalData->m_headless)
+		return NULL;
+
 	m_uniqueSystemID = (ParticleSystemID)((UnsignedInt)m_uniqueSystemID + 1);
 	ParticleSystem *sys = newInstance(ParticleSystem)( sysTemplate, m_uniqueSystemID, createSlaves );
 	return sys;
@@ -3395,6 +3400,21 @@ void ParticleSystemManager::xfer( Xfer *xfer )
 
 			}
 
+			// TheSuperHackers @bugfix No particle systems are created in headless mode, but the data of
+			// this one still has to be read to get to the next. Read it into a system that is thrown away
+			// right after, and keep it and its particles out of the load post processing.
+			if( TheGlobalData->m_headless )
+			{
+				Bool postProcess = BitIsSet( xfer->getOptions(), XO_NO_POST_PROCESSING ) == FALSE;
+				xfer->setOptions( XO_NO_POST_PROCESSING );
+				system = newInstance(ParticleSystem)( systemTemplate, INVALID_PARTICLE_SYSTEM_ID, FALSE );
+				xfer->xferSnapshot( system );
+				deleteInstance( system );
+				if( postProcess )
+					xfer->clearOptions( XO_NO_POST_PROCESSING );
+				continue;
+			}
+
 			// create system
 			system = createParticleSystem( systemTemplate, FALSE );
 
@@ -1620,6 +1620,10 @@ void AIGroup::groupMoveToPosition( const Coord3D *pos, Bool addWaypoint, Command
 		}
 	}
 
+#if USE_GROUP_FLOW_FIELDS
+	TheAI->pathfinder()->addGroupMoveGoal(pos, getID(), (Int)m_memberListSize);
+#endif
+
 	if (tightenGroup)
 	{
 		isFormation = false;
@@ -1228,24 +1228,25 @@ PartitionCell::PartitionCell()
 	m_loTerrainZ = HUGE_DIST;		// huge positive
 	m_hiTerrainZ = -HUGE_DIST;	// huge negative
 #endif
-	/*
-		You may be asking yourself: why do we model the shroud for all players,
-		rather than just the local player? And the answer is: because this allows
-		us to checksum these values for net games, to help prevent "shroud cheaters"
-		(who use a trainer to disable the shroud on their system).
-	*/
-	for (int i = 0; i < MAX_PLAYER_COUNT; ++i)
-	{
-		// Default is "passive shroud".  1,0.
-		m_shroudLevel[i].m_currentShroud = 1;
-		m_shroudLevel[i].m_activeShroudLevel = 0;
+	m_cellIndex = 0;
+}
 
-		// default cash value is 0
-		m_cashValue[i] = 0;
+//-----------------------------------------------------------------------------
+inline ShroudLevel& PartitionCell::shroudLevel( Int playerIndex ) const
+{
+	return ThePartitionManager->m_shroudLevels[playerIndex * ThePartitionManager->m_totalCellCount + m_cellIndex];
+}
 
-		// default threat value is 0
-		m_threatValue[i] = 0;
-	}
+//-----------------------------------------------------------------------------
+inline Int& PartitionCell::threatValue( Int playerIndex ) const
+{
+	return ThePartitionManager->m_threatValues[playerIndex * ThePartitionManager->m_totalCellCount + m_cellIndex];
+}
+
+//-----------------------------------------------------------------------------
+inline Int& PartitionCell::cashValue( Int playerIndex ) const
+{
+	return ThePartitionManager->m_cashValues[playerIndex * ThePartitionManager->m_totalCellCount + m_cellIndex];
 }
 
 //-----------------------------------------------------------------------------
@@ -1269,15 +1270,15 @@ void PartitionCell::addLooker(Int playerIndex)
 {
 	CellShroudStatus oldShroud = getShroudStatusForPlayer( playerIndex );
 	// The decreasing Algorithm: A 1 will go straight to -1, otherwise it just gets decremented
-	m_shroudLevel[playerIndex].m_currentShroud = min( m_shroudLevel[playerIndex].m_currentShroud - 1, -1 );
+	shroudLevel(playerIndex).m_currentShroud = min( shroudLevel(playerIndex).m_currentShroud - 1, -1 );
 
 	CellShroudStatus newShroud = getShroudStatusForPlayer( playerIndex );
 
 //	DEBUG_LOG(( "ADD    %d, %d.  CS = %d, AS = %d for player %d.",
 //							m_cellX,
 //							m_cellY,
-//							m_shroudLevel[playerIndex].m_currentShroud,
-//							m_shroudLevel[playerIndex].m_activeShroudLevel,
+//							shroudLevel(playerIndex).m_currentShroud,
+//							shroudLevel(playerIndex).m_activeShroudLevel,
 //							playerIndex
 //							));
 
@@ -1300,20 +1301,20 @@ void PartitionCell::removeLooker(Int playerIndex)
 {
 	CellShroudStatus oldShroud = getShroudStatusForPlayer( playerIndex );
 	// the increasing Algorithm: a -1 goes up to min(1,activeLevel), otherwise it just gets incremented
-	if( m_shroudLevel[playerIndex].m_currentShroud == -1 )
-		m_shroudLevel[playerIndex].m_currentShroud = min( m_shroudLevel[playerIndex].m_activeShroudLevel, (Short)1 );
+	if( shroudLevel(playerIndex).m_currentShroud == -1 )
+		shroudLevel(playerIndex).m_currentShroud = min( shroudLevel(playerIndex).m_activeShroudLevel, (Short)1 );
 	else
 	{
-		DEBUG_ASSERTCRASH( m_shroudLevel[playerIndex].m_currentShroud < 0, ("Someone is RemoveLooker-ing on a cell that is not looked at.  This will make a permanent shroud blob.") );
-		m_shroudLevel[playerIndex].m_currentShroud++;
+		DEBUG_ASSERTCRASH( shroudLevel(playerIndex).m_currentShroud < 0, ("Someone is RemoveLooker-ing on a cell that is not looked at.  This will make a permanent shroud blob.") );
+		shroudLevel(playerIndex).m_currentShroud++;
 	}
 	CellShroudStatus newShroud = getShroudStatusForPlayer( playerIndex );
 
 //	DEBUG_LOG(( "REMOVE %d, %d.  CS = %d, AS = %d for player %d.",
 //							m_cellX,
 //							m_cellY,
-//							m_shroudLevel[playerIndex].m_currentShroud,
-//							m_shroudLevel[playerIndex].m_activeShroudLevel,
+//							shroudLevel(playerIndex).m_currentShroud,
+//							shroudLevel(playerIndex).m_activeShroudLevel,
 //							playerIndex
 //							));
 
@@ -1337,10 +1338,10 @@ void PartitionCell::addShrouder( Int playerIndex )
 	CellShroudStatus oldShroud = getShroudStatusForPlayer( playerIndex );
 	// Increasing active shroud: activeLevel gets incremented, and CS is set to 1 if at zero
 	// do the algorithm
-	m_shroudLevel[playerIndex].m_activeShroudLevel++;
-	if( m_shroudLevel[playerIndex].m_currentShroud == 0 )
+	shroudLevel(playerIndex).m_activeShroudLevel++;
+	if( shroudLevel(playerIndex).m_currentShroud == 0 )
 	{
-		m_shroudLevel[playerIndex].m_currentShroud = 1;
+		shroudLevel(playerIndex).m_currentShroud = 1;
 	}
 	CellShroudStatus newShroud = getShroudStatusForPlayer( playerIndex );
 
@@ -1363,15 +1364,15 @@ void PartitionCell::removeShrouder( Int playerIndex )
 {
 	// Decreasing active shroud: just decrement activeLevel.  This will never result in a client change.
 	// Either it was passive shroud and is now active, or it was being looked at and still is.
-	m_shroudLevel[playerIndex].m_activeShroudLevel--;
-	DEBUG_ASSERTCRASH( m_shroudLevel[playerIndex].m_activeShroudLevel >= 0, ("Shroud generation has gone negative.  This can't happen.") );
+	shroudLevel(playerIndex).m_activeShroudLevel--;
+	DEBUG_ASSERTCRASH( shroudLevel(playerIndex).m_activeShroudLevel >= 0, ("Shroud generation has gone negative.  This can't happen.") );
 }
 
 //-----------------------------------------------------------------------------
 //Bool PartitionCell::isShroudedForPlayer( Int playerIndex ) const
 //{
 	// There isn't an absolute answer.  This cell is only shrouded in regards to a person
-//	return (m_shroudLevel[playerIndex].m_currentShroud == 1);
+//	return (shroudLevel(playerIndex).m_currentShroud == 1);
 //}
 
 //-----------------------------------------------------------------------------
@@ -1379,9 +1380,9 @@ CellShroudStatus PartitionCell::getShroudStatusForPlayer( Int playerIndex ) cons
 {
 	// There are now three answers, but the question still requires "to whom"
 
-	if( m_shroudLevel[playerIndex].m_currentShroud == 1 )
+	if( shroudLevel(playerIndex).m_currentShroud == 1 )
 		return CELLSHROUD_SHROUDED;
-	else if( m_shroudLevel[playerIndex].m_currentShroud == 0 )
+	else if( shroudLevel(playerIndex).m_currentShroud == 0 )
 		return CELLSHROUD_FOGGED;// ie Nobody actively looking
 	else
 		return CELLSHROUD_CLEAR;
@@ -1391,7 +1392,7 @@ CellShroudStatus PartitionCell::getShroudStatusForPlayer( Int playerIndex ) cons
 UnsignedInt PartitionCell::getThreatValue( Int playerIndex )
 {
 	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-		return m_threatValue[playerIndex];
+		return threatValue(playerIndex);
 	}
 	return 0;
 }
@@ -1401,10 +1402,10 @@ void PartitionCell::addThreatValue( Int playerIndex, UnsignedInt threatValue )
 {
 	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
 #ifdef DEBUG_CRASHING
-		UnsignedInt oldThreatVal = m_threatValue[playerIndex];
+		UnsignedInt oldThreatVal = threatValue(playerIndex);
 		DEBUG_ASSERTCRASH(oldThreatVal <= oldThreatVal + threatValue, ("adding new threat value overflowed allotted storage."));
 #endif
-		m_threatValue[playerIndex] += threatValue;
+		threatValue(playerIndex) += threatValue;
 	}
 }
 
@@ -1413,10 +1414,10 @@ void PartitionCell::removeThreatValue( Int playerIndex, UnsignedInt threatValue
 {
 	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
 #ifdef DEBUG_CRASHING
-		UnsignedInt oldThreatVal = m_threatValue[playerIndex];
+		UnsignedInt oldThreatVal = threatValue(playerIndex);
 		DEBUG_ASSERTCRASH(oldThreatVal >= oldThreatVal - threatValue, ("removing new threat value underflowed allotted storage."));
 #endif
-		m_threatValue[playerIndex] -= threatValue;
+		threatValue(playerIndex) -= threatValue;
 	}
 }
 
@@ -1424,7 +1425,7 @@ void PartitionCell::removeThreatValue( Int playerIndex, UnsignedInt threatValue
 UnsignedInt PartitionCell::getCashValue( Int playerIndex )
 {
 	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
-		return m_cashValue[playerIndex];
+		return cashValue(playerIndex);
 	}
 	return 0;
 }
@@ -1434,10 +1435,10 @@ void PartitionCell::addCashValue( Int playerIndex, UnsignedInt cashValue )
 {
 	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
 #ifdef DEBUG_CRASHING
-		UnsignedInt oldCashVal = m_cashValue[playerIndex];
+		UnsignedInt oldCashVal = cashValue(playerIndex);
 		DEBUG_ASSERTCRASH(oldCashVal <= oldCashVal + cashValue, ("adding new cash value overflowed allotted storage."));
 #endif
-		m_cashValue[playerIndex] += cashValue;
+		cashValue(playerIndex) += cashValue;
 	}
 }
 
@@ -1446,10 +1447,10 @@ void PartitionCell::removeCashValue( Int playerIndex, UnsignedInt cashValue )
 {
 	if (playerIndex >= 0 && playerIndex < MAX_PLAYER_COUNT) {
 #ifdef DEBUG_CRASHING
-		UnsignedInt oldCashVal = m_cashValue[playerIndex];
+		UnsignedInt oldCashVal = cashValue(playerIndex);
 		DEBUG_ASSERTCRASH(oldCashVal >= oldCashVal - cashValue, ("removing new cash value underflowed allotted storage."));
 #endif
-		m_cashValue[playerIndex] -= cashValue;
+		cashValue(playerIndex) -= cashValue;
 	}
 }
 
@@ -1501,7 +1502,12 @@ void PartitionCell::validateCoiList()
 void PartitionCell::crc( Xfer *xfer )
 {
 
-	xfer->xferUser(&m_shroudLevel, sizeof(ShroudLevel) * MAX_PLAYER_COUNT);
+	// the shroud levels are checksummed per cell, as they were when the cells held them
+	ShroudLevel shroudLevels[MAX_PLAYER_COUNT];
+	for (Int i = 0; i < MAX_PLAYER_COUNT; ++i)
+		shroudLevels[i] = shroudLevel(i);
+
+	xfer->xferUser(&shroudLevels, sizeof(ShroudLevel) * MAX_PLAYER_COUNT);
 	xfer->xferUser(&m_cellX, sizeof(m_cellX));
 	xfer->xferUser(&m_cellY, sizeof(m_cellY));
 
@@ -1518,8 +1524,16 @@ void PartitionCell::xfer( Xfer *xfer )
 	XferVersion version = currentVersion;
 	xfer->xferVersion( &version, currentVersion );
 
-	// xfer shroud data
-	xfer->xferUser( &m_shroudLevel, sizeof( ShroudLevel ) * MAX_PLAYER_COUNT );
+	// xfer shroud data, laid out per cell as it was when the cells held it
+	ShroudLevel shroudLevels[MAX_PLAYER_COUNT];
+	Int i;
+	for (i = 0; i < MAX_PLAYER_COUNT; ++i)
+		shroudLevels[i] = shroudLevel(i);
+
+	xfer->xferUser( &shroudLevels, sizeof( ShroudLevel ) * MAX_PLAYER_COUNT );
+
+	for (i = 0; i < MAX_PLAYER_COUNT; ++i)
+		shroudLevel(i) = shroudLevels[i];
 
 }
 
@@ -1997,6 +2011,185 @@ Bool PartitionData::collidesWith(const PartitionData *that, CollideLocAndNormal
 	}
 }
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+PartitionQueryResults::ResultCompareProc PartitionQueryResults::theResultCompareProcs[] =
+{
+	NULL,						// "fastest" gets no proc
+	PartitionQueryResults::sortNearToFar,
+	PartitionQueryResults::sortFarToNear,
+	PartitionQueryResults::sortCheapToExpensive,
+	PartitionQueryResults::sortExpensiveToCheap
+};
+
+//-----------------------------------------------------------------------------
+PartitionQueryResults::PartitionQueryResults()
+{
+	m_count = 0;
+	m_cur = 0;
+	m_overflow = NULL;
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryResults::~PartitionQueryResults()
+{
+	makeEmpty();
+}
+
+//-----------------------------------------------------------------------------
+void PartitionQueryResults::makeEmpty()
+{
+	if (m_overflow)
+	{
+		deleteInstance(m_overflow);
+		m_overflow = NULL;
+	}
+	m_count = 0;
+	m_cur = 0;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionQueryResults::insert(Object *obj, Real numeric)
+{
+	DEBUG_ASSERTCRASH(obj, ("sorry, no nulls allowed here"));
+
+	if (m_overflow == NULL && m_count < MAX_RESULTS)
+	{
+		m_results[m_count].m_obj = obj;
+		m_results[m_count].m_numeric = numeric;
+		++m_count;
+		return;
+	}
+
+	if (m_overflow == NULL)
+	{
+		// out of room, hand everything found so far to an iterator, in the same order
+		m_overflow = newInstance(SimpleObjectIterator);
+		for (Int i = 0; i < m_count; ++i)
+		{
+			m_overflow->insert(m_results[i].m_obj, m_results[i].m_numeric);
+		}
+		m_count = 0;
+	}
+	m_overflow->insert(obj, numeric);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionQueryResults::finish(IterOrderType order)
+{
+	m_cur = 0;
+
+	if (m_overflow)
+	{
+		m_overflow->sort(order);
+		return;
+	}
+
+	// SimpleObjectIterator prepends every object it is given, so it hands them out last found first
+	Int lo, hi;
+	for (lo = 0, hi = m_count - 1; lo < hi; ++lo, --hi)
+	{
+		Result tmp = m_results[lo];
+		m_results[lo] = m_results[hi];
+		m_results[hi] = tmp;
+	}
+
+	ResultCompareProc cmpProc = theResultCompareProcs[order];
+	if (!cmpProc)
+		return;
+
+	// a bottom up mergesort, stable like the one in SimpleObjectIterator::sort, so equal objects
+	// keep their relative order and the result is the same.
+	Result *from = m_results;
+	Result *to = m_scratch;
+	for (Int width = 1; width < m_count; width *= 2)
+	{
+		for (Int start = 0; start < m_count; start += 2 * width)
+		{
+			Int a = start;
+			Int aEnd = min(start + width, m_count);
+			Int b = aEnd;
+			Int bEnd = min(start + 2 * width, m_count);
+			Int out = start;
+			while (a < aEnd && b < bEnd)
+			{
+				if ((*cmpProc)(from[a], from[b]) <= 0.0f)
+					to[out++] = from[a++];
+				else
+					to[out++] = from[b++];
+			}
+			while (a < aEnd)
+				to[out++] = from[a++];
+			while (b < bEnd)
+				to[out++] = from[b++];
+		}
+		Result *tmp = from;
+		from = to;
+		to = tmp;
+	}
+
+	if (from != m_results)
+	{
+		memcpy(m_results, from, m_count * sizeof(Result));
+	}
+}
+
+//-----------------------------------------------------------------------------
+Object *PartitionQueryResults::firstWithNumeric(Real *num)
+{
+	if (m_overflow)
+		return m_overflow->firstWithNumeric(num);
+
+	m_cur = 0;
+	return nextWithNumeric(num);
+}
+
+//-----------------------------------------------------------------------------
+Object *PartitionQueryResults::nextWithNumeric(Real *num)
+{
+	if (m_overflow)
+		return m_overflow->nextWithNumeric(num);
+
+	if (num)
+		*num = 0.0f;
+
+	if (m_cur >= m_count)
+		return NULL;
+
+	if (num)
+		*num = m_results[m_cur].m_numeric;
+	return m_results[m_cur++].m_obj;
+}
+
+//-----------------------------------------------------------------------------
+Real PartitionQueryResults::sortNearToFar(const Result& a, const Result& b)
+{
+	return a.m_numeric - b.m_numeric;
+}
+
+//-----------------------------------------------------------------------------
+Real PartitionQueryResults::sortFarToNear(const Result& a, const Result& b)
+{
+	return b.m_numeric - a.m_numeric;
+}
+
+//-----------------------------------------------------------------------------
+Real PartitionQueryResults::sortCheapToExpensive(const Result& a, const Result& b)
+{
+	return a.m_obj->getTemplate()->friend_getBuildCost() -
+				 b.m_obj->getTemplate()->friend_getBuildCost();
+}
+
+//-----------------------------------------------------------------------------
+Real PartitionQueryResults::sortExpensiveToCheap(const Result& a, const Result& b)
+{
+	return b.m_obj->getTemplate()->friend_getBuildCost() -
+				 a.m_obj->getTemplate()->friend_getBuildCost();
+}
+
 //-----------------------------------------------------------------------------
 /* See if thisObj collides with geom at pos & angle. */
 Bool PartitionManager::geomCollidesWithGeom(const Coord3D* pos1,
@@ -2566,6 +2759,9 @@ PartitionManager::PartitionManager()
 	m_cellCountY = 0;
 	m_totalCellCount = 0;
 	m_cells = NULL;
+	m_shroudLevels = NULL;
+	m_threatValues = NULL;
+	m_cashValues = NULL;
 	m_worldExtents.lo.zero();
 	m_worldExtents.hi.zero();
 	m_dirtyModules = NULL;
@@ -2640,13 +2836,33 @@ void PartitionManager::init()
 #ifdef PM_CACHE_TERRAIN_HEIGHT
 				Real loZ, hiZ;
 				calcHeights(m_worldExtents, m_cellSize, x, y, loZ, hiZ);
-				getCellAt(x, y)->init(x, y, loZ, hiZ);
+				getCellAt(x, y)->init(x, y, y * m_cellCountX + x, loZ, hiZ);
 #else
-				getCellAt(x, y)->init(x, y);
+				getCellAt(x, y)->init(x, y, y * m_cellCountX + x);
 #endif
 			}
 		}
 
+		/*
+			You may be asking yourself: why do we model the shroud for all players,
+			rather than just the local player? And the answer is: because this allows
+			us to checksum these values for net games, to help prevent "shroud cheaters"
+			(who use a trainer to disable the shroud on their system).
+		*/
+		const Int gridSize = MAX_PLAYER_COUNT * m_totalCellCount;
+		m_shroudLevels = MSGNEW("PartitionManager_ShroudLevels") ShroudLevel[gridSize];
+		m_threatValues = MSGNEW("PartitionManager_ThreatValues") Int[gridSize];
+		m_cashValues = MSGNEW("PartitionManager_CashValues") Int[gridSize];
+		for (Int i = 0; i < gridSize; ++i)
+		{
+			// Default is "passive shroud".  1,0.
+			m_shroudLevels[i].m_currentShroud = 1;
+			m_shroudLevels[i].m_activeShroudLevel = 0;
+		}
+		// default threat and cash values are 0
+		memset(m_threatValues, 0, gridSize * sizeof(Int));
+		memset(m_cashValues, 0, gridSize * sizeof(Int));
+
 #ifdef FASTER_GCO
 		calcRadiusVec();
 #endif
@@ -2721,6 +2937,12 @@ void PartitionManager::shutdown()
 
 	delete [] m_cells;
 	m_cells = NULL;
+	delete [] m_shroudLevels;
+	m_shroudLevels = NULL;
+	delete [] m_threatValues;
+	m_threatValues = NULL;
+	delete [] m_cashValues;
+	m_cashValues = NULL;
 
 	m_cellSize = m_cellSizeInv = 0.0f;
 	m_cellCountX = 0;
@@ -3196,6 +3418,7 @@ Object *PartitionManager::getClosestObjects(
 	DistanceCalculationType dc,
 	PartitionFilter **filters,
 	SimpleObjectIterator *iterArg,	// if nonnull, append ALL satisfactory objects to the iterator (not just the single closest)
+	PartitionQueryResults *resultsArg,	// if nonnull, append ALL satisfactory objects to the results (not just the single closest)
 	Real *closestDistArg,
 	Coord3D *closestVecArg
 )
@@ -3318,6 +3541,10 @@ Object *PartitionManager::getClosestObjects(
 				{
 					iterArg->insert(thisObj, thisDistSqr);
 				}
+				else if (resultsArg)
+				{
+					resultsArg->insert(thisObj, thisDistSqr);
+				}
 				else
 				{
 					// hey, this is the new closest object! cool.
@@ -3393,6 +3620,10 @@ Object *PartitionManager::getClosestObjects(
 			{
 				iterArg->insert(thisObj, thisDistSqr);
 			}
+			else if (resultsArg)
+			{
+				resultsArg->insert(thisObj, thisDistSqr);
+			}
 			else
 			{
 				closestObj = thisObj;
@@ -3449,7 +3680,7 @@ Object *PartitionManager::getClosestObject(
 	Coord3D *closestDistVec
 )
 {
-	return getClosestObjects(obj, NULL, maxDist, dc, filters, NULL, closestDist, closestDistVec);
+	return getClosestObjects(obj, NULL, maxDist, dc, filters, NULL, NULL, closestDist, closestDistVec);
 }
 
 //-----------------------------------------------------------------------------
@@ -3462,7 +3693,7 @@ Object *PartitionManager::getClosestObject(
 	Coord3D *closestDistVec
 )
 {
-	return getClosestObjects(NULL, pos, maxDist, dc, filters, NULL, closestDist, closestDistVec);
+	return getClosestObjects(NULL, pos, maxDist, dc, filters, NULL, NULL, closestDist, closestDistVec);
 }
 
 //-----------------------------------------------------------------------------
@@ -3599,7 +3830,7 @@ SimpleObjectIterator *PartitionManager::iterateObjectsInRange(
 	SimpleObjectIterator *iter = newInstance(SimpleObjectIterator);
 	iterHolder.hold(iter);
 
-	getClosestObjects(obj, NULL, maxDist, dc, filters, iter, NULL, NULL);
+	getClosestObjects(obj, NULL, maxDist, dc, filters, iter, NULL, NULL, NULL);
 
 	iter->sort(order);
 	iterHolder.release();
@@ -3619,7 +3850,7 @@ SimpleObjectIterator *PartitionManager::iterateObjectsInRange(
 	SimpleObjectIterator *iter = newInstance(SimpleObjectIterator);
 	iterHolder.hold(iter);
 
-	getClosestObjects(NULL, pos, maxDist, dc, filters, iter, NULL, NULL);
+	getClosestObjects(NULL, pos, maxDist, dc, filters, iter, NULL, NULL, NULL);
 
 	iter->sort(order);
 	iterHolder.release();
@@ -3644,12 +3875,62 @@ SimpleObjectIterator* PartitionManager::iteratePotentialCollisions(
 	PartitionFilterWouldCollide filter(*pos, geom, angle, true);
 	PartitionFilter *filters[] = { &filter, NULL };
 
-	getClosestObjects(NULL, pos, maxDist, use2D ? FROM_BOUNDINGSPHERE_2D : FROM_BOUNDINGSPHERE_3D, filters, iter, NULL, NULL);
+	getClosestObjects(NULL, pos, maxDist, use2D ? FROM_BOUNDINGSPHERE_2D : FROM_BOUNDINGSPHERE_3D, filters, iter, NULL, NULL, NULL);
 
 	iterHolder.release();
 	return iter;
 }
 
+//-----------------------------------------------------------------------------
+void PartitionManager::collectObjectsInRange(
+	PartitionQueryResults &results,
+	const Object *obj,
+	Real maxDist,
+	DistanceCalculationType dc,
+	PartitionFilter **filters,
+	IterOrderType order
+)
+{
+	results.makeEmpty();
+	getClosestObjects(obj, NULL, maxDist, dc, filters, NULL, &results, NULL, NULL);
+	results.finish(order);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionManager::collectObjectsInRange(
+	PartitionQueryResults &results,
+	const Coord3D *pos,
+	Real maxDist,
+	DistanceCalculationType dc,
+	PartitionFilter **filters,
+	IterOrderType order
+)
+{
+	results.makeEmpty();
+	getClosestObjects(NULL, pos, maxDist, dc, filters, NULL, &results, NULL, NULL);
+	results.finish(order);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionManager::collectPotentialCollisions(
+	PartitionQueryResults &results,
+	const Coord3D* pos,
+	const GeometryInfo& geom,
+	Real angle,
+	Bool use2D
+)
+{
+	Real maxDist = geom.getBoundingSphereRadius();
+	maxDist *= 1.1f;	// just a little slop
+
+	PartitionFilterWouldCollide filter(*pos, geom, angle, true);
+	PartitionFilter *filters[] = { &filter, NULL };
+
+	results.makeEmpty();
+	getClosestObjects(NULL, pos, maxDist, use2D ? FROM_BOUNDINGSPHERE_2D : FROM_BOUNDINGSPHERE_3D, filters, NULL, &results, NULL, NULL);
+	results.finish(ITER_FASTEST);
+}
+
 //-----------------------------------------------------------------------------
 Bool PartitionManager::isColliding( const Object *a, const Object *b ) const
 {
@@ -4748,19 +5029,26 @@ void PartitionManager::getMostValuableLocation( Int playerIndex, UnsignedInt whi
 		allPlayerMasks[i] = player->getPlayerMask();
 	}
 
+	// pick the grids to sum up front, so each cell only reads the players that count
+	const Int *playerValues[MAX_PLAYER_COUNT];
+	Int playerValuesCount = 0;
+	for (Int player = 0; player < MAX_PLAYER_COUNT; ++player) {
+		if (BitIsSet(allPlayerMasks[player], playerMask)) {
+			if (valType == VOT_CashValue) {
+				playerValues[playerValuesCount++] = getCashValuesForPlayer(player);
+			} else {
+				playerValues[playerValuesCount++] = getThreatValuesForPlayer(player);
+			}
+		}
+	}
+
 	Int greatestValueCell = -1;
 	Int maxCellValue = -1;
 	for (i = 0; i < cellCount; ++i) {
 		Int cellValue = 0;
 
-		for (Int player = 0; player < MAX_PLAYER_COUNT; ++player) {
-			if (BitIsSet(allPlayerMasks[player], playerMask)) {
-				if (valType == VOT_CashValue) {
-					cellValue += m_cells[i].getCashValue(player);
-				} else {
-					cellValue += m_cells[i].getThreatValue(player);
-				}
-			}
+		for (Int p = 0; p < playerValuesCount; ++p) {
+			cellValue += playerValues[p][i];
 		}
 
 		if (cellValue > maxCellValue) {
@@ -5628,16 +5916,20 @@ static void hLineAddThreat(Int x1, Int x2, Int y, void *threatValueParms)
 		return;
 
 	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
+	if (parms->playerIndex < 0 || parms->playerIndex >= MAX_PLAYER_COUNT)
+		return;
+
+	if (x1 < 0)
+		x1 = 0;
+	if (x2 >= ThePartitionManager->m_cellCountX)
+		x2 = ThePartitionManager->m_cellCountX - 1;
 
 	Real distance;
 	Real mulVal = 1.0f;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
+	Int* value = &ThePartitionManager->m_threatValues[parms->playerIndex * ThePartitionManager->m_totalCellCount + y * ThePartitionManager->m_cellCountX + x1];
+	for (Int x = x1; x <= x2; ++x, ++value)
 	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
 		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
 		mulVal = 1 - distance / parms->radius;
 		if (mulVal < 0.0f)
@@ -5645,7 +5937,12 @@ static void hLineAddThreat(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
-		cell->addThreatValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		const UnsignedInt delta = REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal);
+#ifdef DEBUG_CRASHING
+		UnsignedInt oldThreatVal = *value;
+		DEBUG_ASSERTCRASH(oldThreatVal <= oldThreatVal + delta, ("adding new threat value overflowed allotted storage."));
+#endif
+		*value += delta;
 	}
 }
 
@@ -5656,16 +5953,20 @@ static void hLineRemoveThreat(Int x1, Int x2, Int y, void *threatValueParms)
 		return;
 
 	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
+	if (parms->playerIndex < 0 || parms->playerIndex >= MAX_PLAYER_COUNT)
+		return;
+
+	if (x1 < 0)
+		x1 = 0;
+	if (x2 >= ThePartitionManager->m_cellCountX)
+		x2 = ThePartitionManager->m_cellCountX - 1;
 
 	Real distance;
 	Real mulVal = 1.0f;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
+	Int* value = &ThePartitionManager->m_threatValues[parms->playerIndex * ThePartitionManager->m_totalCellCount + y * ThePartitionManager->m_cellCountX + x1];
+	for (Int x = x1; x <= x2; ++x, ++value)
 	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
 		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
 		mulVal = 1 - distance / parms->radius;
 		if (mulVal < 0.0f)
@@ -5673,7 +5974,12 @@ static void hLineRemoveThreat(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
-		cell->removeThreatValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		const UnsignedInt delta = REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal);
+#ifdef DEBUG_CRASHING
+		UnsignedInt oldThreatVal = *value;
+		DEBUG_ASSERTCRASH(oldThreatVal >= oldThreatVal - delta, ("removing new threat value underflowed allotted storage."));
+#endif
+		*value -= delta;
 	}
 }
 
@@ -5684,16 +5990,20 @@ static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms)
 		return;
 
 	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
+	if (parms->playerIndex < 0 || parms->playerIndex >= MAX_PLAYER_COUNT)
+		return;
+
+	if (x1 < 0)
+		x1 = 0;
+	if (x2 >= ThePartitionManager->m_cellCountX)
+		x2 = ThePartitionManager->m_cellCountX - 1;
 
 	Real distance;
 	Real mulVal = 1.0f;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
+	Int* value = &ThePartitionManager->m_cashValues[parms->playerIndex * ThePartitionManager->m_totalCellCount + y * ThePartitionManager->m_cellCountX + x1];
+	for (Int x = x1; x <= x2; ++x, ++value)
 	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
 		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
 		mulVal = 1 - distance / parms->radius;
 		if (mulVal < 0.0f)
@@ -5701,7 +6011,12 @@ static void hLineAddValue(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
-		cell->addCashValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		const UnsignedInt delta = REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal);
+#ifdef DEBUG_CRASHING
+		UnsignedInt oldCashVal = *value;
+		DEBUG_ASSERTCRASH(oldCashVal <= oldCashVal + delta, ("adding new cash value overflowed allotted storage."));
+#endif
+		*value += delta;
 	}
 }
 
@@ -5712,16 +6027,20 @@ static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms)
 		return;
 
 	ThreatValueParms *parms = (ThreatValueParms*)threatValueParms;
+	if (parms->playerIndex < 0 || parms->playerIndex >= MAX_PLAYER_COUNT)
+		return;
+
+	if (x1 < 0)
+		x1 = 0;
+	if (x2 >= ThePartitionManager->m_cellCountX)
+		x2 = ThePartitionManager->m_cellCountX - 1;
 
 	Real distance;
 	Real mulVal = 1.0f;
 
-	PartitionCell* cell = &ThePartitionManager->m_cells[y * ThePartitionManager->m_cellCountX + x1];	// yes, this could be invalid. we'll skip the bad ones.
-	for (Int x = x1; x <= x2; ++x, ++cell)
+	Int* value = &ThePartitionManager->m_cashValues[parms->playerIndex * ThePartitionManager->m_totalCellCount + y * ThePartitionManager->m_cellCountX + x1];
+	for (Int x = x1; x <= x2; ++x, ++value)
 	{
-		if (x < 0 || x >= ThePartitionManager->m_cellCountX)
-			continue;
-
 		distance = sqrt( pow(x - parms->xCenter, 2) + pow(y - parms->yCenter, 2) );
 		mulVal = 1 - distance / parms->radius;
 		if (mulVal < 0.0f)
@@ -5729,7 +6048,12 @@ static void hLineRemoveValue(Int x1, Int x2, Int y, void *threatValueParms)
 		else if (mulVal > 1.0f)
 			mulVal = 1.0f;
 
-		cell->removeCashValue( parms->playerIndex, REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal) );
+		const UnsignedInt delta = REAL_TO_UNSIGNEDINT(parms->threatOrValue * mulVal);
+#ifdef DEBUG_CRASHING
+		UnsignedInt oldCashVal = *value;
+		DEBUG_ASSERTCRASH(oldCashVal >= oldCashVal - delta, ("removing new cash value underflowed allotted storage."));
+#endif
+		*value -= delta;
 	}
 }
 
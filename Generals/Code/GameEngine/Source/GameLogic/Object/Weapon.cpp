@@ -1276,7 +1276,8 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 	DeathType deathType = getDeathType();
 	if (getProjectileTemplate() == NULL || isProjectileDetonation)
 	{
-		SimpleObjectIterator *iter;
+		PartitionQueryResults victims;
+		Bool iterateVictims;
 		Object *curVictim;
 		Real curVictimDistSqr;
 
@@ -1292,8 +1293,9 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 		Real radius = max(primaryRadius, secondaryRadius);
 		if (radius > 0.0f)
 		{
-			iter = ThePartitionManager->iterateObjectsInRange(pos, radius, DAMAGE_RANGE_CALC_TYPE);
-			curVictim = iter->firstWithNumeric(&curVictimDistSqr);
+			ThePartitionManager->collectObjectsInRange(victims, pos, radius, DAMAGE_RANGE_CALC_TYPE);
+			iterateVictims = true;
+			curVictim = victims.firstWithNumeric(&curVictimDistSqr);
 		}
 		else
 		{
@@ -1301,13 +1303,12 @@ void WeaponTemplate::dealDamageInternal(ObjectID sourceID, ObjectID victimID, co
 			// check against victimID rather than primaryVictim, since we may have targeted a legitimate victim
 			// that got killed before the damage was dealt... (srj)
 			//DEBUG_ASSERTCRASH(victimID != 0, ("weapons without radii should always pass in specific victims"));
-			iter = NULL;
+			iterateVictims = false;
 			curVictim = primaryVictim;
 			curVictimDistSqr = 0.0f;
 		}
-		MemoryPoolObjectHolder hold(iter);
 
-		for (; curVictim != NULL; curVictim = iter ? iter->nextWithNumeric(&curVictimDistSqr) : NULL)
+		for (; curVictim != NULL; curVictim = iterateVictims ? victims.nextWithNumeric(&curVictimDistSqr) : NULL)
 		{
 			Bool killSelf = false;
 			if (source != NULL)
@@ -2084,9 +2085,9 @@ Bool Weapon::isWithinAttackRange(const Object *source, const Object *target) con
 		{
 			//We're close enough to fire off ranged weapons -- but in the case of contact weapons
 			//we want to do a more detailed check to see if we're actually colliding with the target.
-			ObjectIterator *iter = ThePartitionManager->iteratePotentialCollisions( source->getPosition(), source->getGeometryInfo(), 0.0f );
-			MemoryPoolObjectHolder hold( iter );
-			for( Object *them = iter->first(); them; them = iter->next() )
+			PartitionQueryResults collisions;
+			ThePartitionManager->collectPotentialCollisions( collisions, source->getPosition(), source->getGeometryInfo(), 0.0f );
+			for( Object *them = collisions.first(); them; them = collisions.next() )
 			{
 				if( target == them )
 				{
@@ -897,6 +897,8 @@ m_hard(true),
 m_delayEvaluationSeconds(0),
 m_conditionTime(0),
 m_conditionExecutedCount(0),
+m_conditionResult(false),
+m_conditionResultStamp(0),
 m_frameToEvaluateAt(0),
 m_isSubroutine(false),
 m_hasWarnings(false),
@@ -1058,6 +1060,7 @@ void Script::updateFrom(Script *pSrc)
 	deleteInstance(this->m_condition);
 	this->m_condition = pSrc->m_condition;
 	pSrc->m_condition = NULL;
+	this->m_conditionResultStamp = 0;
 
 	deleteInstance(this->m_action);
 	this->m_action = pSrc->m_action;
@@ -50,6 +50,7 @@
 #include "Common/Radar.h"
 #include "Common/RandomValue.h"
 #include "Common/Recorder.h"
+#include "Common/ReplayReport.h"
 #include "Common/StatsCollector.h"
 #include "Common/ThingFactory.h"
 #include "Common/Team.h"
@@ -58,6 +59,7 @@
 #include "Common/WellKnownKeys.h"
 #include "Common/Xfer.h"
 #include "Common/XferCRC.h"
+#include "Common/XferCRCTree.h"
 #include "Common/XferDeepCRC.h"
 
 #include "GameClient/ControlBar.h"
@@ -209,6 +211,8 @@ GameLogic::GameLogic( void )
 {
 	m_background = NULL;
 	m_CRC = 0;
+	m_crcTree = NULL;
+	m_crcTreeFile = NULL;
 	m_isInUpdate = FALSE;
 
 	m_rankPointsToAddAtGameStart = 0;
@@ -230,6 +234,15 @@ GameLogic::GameLogic( void )
 	m_height = 0;
 	m_objList = NULL;
 	m_curUpdateModule = NULL;
+#ifdef SLEEPY_UPDATE_WHEEL
+	for (Int list = 0; list < SLEEPY_WHEEL_LIST_COUNT; ++list)
+	{
+		m_sleepyWheel[list].m_head = NULL;
+		m_sleepyWheel[list].m_tail = NULL;
+	}
+	m_sleepyWheelPriority = 0;
+	m_sleepyWheelCount = 0;
+#endif
 	m_nextObjID = INVALID_ID;
 	m_startNewGame = FALSE;
 	m_gameMode = GAME_NONE;
@@ -267,6 +280,9 @@ void GameLogic::setDefaults( Bool saveGame )
 		(*it)->friend_setIndexInLogic(-1);
 	}
 	m_sleepyUpdates.clear();
+#ifdef SLEEPY_UPDATE_WHEEL
+	clearSleepyWheel(0);
+#endif
 	m_curUpdateModule = NULL;
 
 	//
@@ -358,6 +374,15 @@ GameLogic::~GameLogic()
 	delete TheScriptEngine;
 	TheScriptEngine = NULL;
 
+	delete m_crcTree;
+	m_crcTree = NULL;
+
+	if (m_crcTreeFile)
+	{
+		fclose(m_crcTreeFile);
+		m_crcTreeFile = NULL;
+	}
+
 	// Null out TheGameLogic
 	TheGameLogic = NULL;
 }
@@ -1442,6 +1467,7 @@ void GameLogic::startNewGame( Bool saveGame )
 				{
 					deleteInstance(scripts[i]);
 				}
+				TheScriptEngine->indexScripts();
 			}
 		}
 
@@ -2234,6 +2260,17 @@ void GameLogic::processDestroyList( void )
 		}
 #endif
 
+#if USE_SLEEPY_UPDATE_WHEEL
+		// TheSuperHackers @performance The wheel erases a module in place, so only this object's modules are visited.
+		for (BehaviorModule** b = currentObject->getBehaviorModules(); *b; ++b)
+		{
+			UpdateModulePtr u = (UpdateModulePtr)((*b)->getUpdate());
+			if (u && u->friend_getListInWheel() != -1)
+			{
+				eraseSleepyWheel(u);
+			}
+		}
+#else
 		/*
 			this looks odd, but is necessary; since erasing a single entry can shuffle others in the list
 			(in order to maintain its heap-ness), we must do two passes: one to find the updates for this
@@ -2265,7 +2302,11 @@ void GameLogic::processDestroyList( void )
 			DEBUG_ASSERTCRASH(m_sleepyUpdates[idx] == sleepyUpdatesForThisObject[numSUO], ("Hmm, expected update mismatch here"));
 			eraseSleepyUpdate(idx);
 			DEBUG_ASSERTCRASH(sleepyUpdatesForThisObject[numSUO]->friend_getIndexInLogic() == -1, ("Hmm, expected index to be -1 here"));
+#ifdef VERIFY_SLEEPY_UPDATE_WHEEL
+			eraseSleepyWheel(sleepyUpdatesForThisObject[numSUO]);
+#endif
 		}
+#endif
 
 		currentObject->removeFromList(&m_objList);//remove from object list
 
@@ -2726,6 +2767,226 @@ void GameLogic::popSleepyUpdate()
 	}
 }
 
+#ifdef SLEEPY_UPDATE_WHEEL
+// ------------------------------------------------------------------------------------------------
+/** Return the wheel list a module with the given priority goes on, given where the wheel is at. */
+// ------------------------------------------------------------------------------------------------
+Int GameLogic::getSleepyWheelList(UnsignedInt priority) const
+{
+	const UnsignedInt cur = m_sleepyWheelPriority;
+
+	if (priority < cur)
+		return SLEEPY_WHEEL_OVERDUE_LIST;
+
+	if ((priority >> SLEEPY_WHEEL_NEAR_BITS) == (cur >> SLEEPY_WHEEL_NEAR_BITS))
+		return SLEEPY_WHEEL_NEAR_LIST + (priority & (SLEEPY_WHEEL_NEAR_SIZE - 1));
+
+	if ((priority >> (SLEEPY_WHEEL_NEAR_BITS + SLEEPY_WHEEL_FAR_BITS)) == (cur >> (SLEEPY_WHEEL_NEAR_BITS + SLEEPY_WHEEL_FAR_BITS)))
+		return SLEEPY_WHEEL_FAR_LIST + ((priority >> SLEEPY_WHEEL_NEAR_BITS) & (SLEEPY_WHEEL_FAR_SIZE - 1));
+
+	return SLEEPY_WHEEL_OVERFLOW_LIST;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Append the module to the end of the list. */
+// ------------------------------------------------------------------------------------------------
+inline void GameLogic::linkSleepyWheel(UpdateModulePtr u, Int list)
+{
+	SleepyWheelList& l = m_sleepyWheel[list];
+
+	u->friend_setListInWheel(list);
+	u->friend_setLinksInWheel(l.m_tail, NULL);
+	if (l.m_tail)
+		l.m_tail->friend_setLinksInWheel(l.m_tail->friend_getPrevInWheel(), u);
+	else
+		l.m_head = u;
+	l.m_tail = u;
+}
+
+// ------------------------------------------------------------------------------------------------
+inline void GameLogic::unlinkSleepyWheel(UpdateModulePtr u)
+{
+	SleepyWheelList& l = m_sleepyWheel[u->friend_getListInWheel()];
+	UpdateModulePtr prev = u->friend_getPrevInWheel();
+	UpdateModulePtr next = u->friend_getNextInWheel();
+
+	if (prev)
+		prev->friend_setLinksInWheel(prev->friend_getPrevInWheel(), next);
+	else
+		l.m_head = next;
+
+	if (next)
+		next->friend_setLinksInWheel(prev, next->friend_getNextInWheel());
+	else
+		l.m_tail = prev;
+
+	u->friend_setListInWheel(-1);
+	u->friend_setLinksInWheel(NULL, NULL);
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Schedule the module for its next call frame and phase. Modules that are due on the same frame
+	* and phase are called in the order they were scheduled. */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::pushSleepyWheel(UpdateModulePtr u)
+{
+	USE_PERF_TIMER(SleepyMaintenance)
+
+	DEBUG_ASSERTCRASH(u != NULL, ("You may not pass null for sleepy update info"));
+	DEBUG_ASSERTCRASH(u->friend_getListInWheel() == -1, ("update module is already on the wheel"));
+
+	const UnsignedInt priority = u->friend_getPriority();
+	const Int list = getSleepyWheelList(priority);
+
+	if (list == SLEEPY_WHEEL_OVERDUE_LIST)
+	{
+		// keep the overdue list sorted, behind everything of the same priority
+		SleepyWheelList& l = m_sleepyWheel[list];
+		UpdateModulePtr prev = l.m_tail;
+		while (prev && prev->friend_getPriority() > priority)
+			prev = prev->friend_getPrevInWheel();
+
+		UpdateModulePtr next = prev ? prev->friend_getNextInWheel() : l.m_head;
+
+		u->friend_setListInWheel(list);
+		u->friend_setLinksInWheel(prev, next);
+		if (prev)
+			prev->friend_setLinksInWheel(prev->friend_getPrevInWheel(), u);
+		else
+			l.m_head = u;
+		if (next)
+			next->friend_setLinksInWheel(u, next->friend_getNextInWheel());
+		else
+			l.m_tail = u;
+	}
+	else
+	{
+		linkSleepyWheel(u, list);
+	}
+
+	++m_sleepyWheelCount;
+}
+
+// ------------------------------------------------------------------------------------------------
+void GameLogic::eraseSleepyWheel(UpdateModulePtr u)
+{
+	USE_PERF_TIMER(SleepyMaintenance)
+
+	DEBUG_ASSERTCRASH(u->friend_getListInWheel() >= 0, ("update module is not on the wheel"));
+
+	unlinkSleepyWheel(u);
+	--m_sleepyWheelCount;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Move the module to the list for its new next call frame and phase. */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::rescheduleSleepyWheel(UpdateModulePtr u)
+{
+	eraseSleepyWheel(u);
+	pushSleepyWheel(u);
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Move every module of the list down to the list it belongs on now that the wheel has turned,
+	* keeping their order. */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::cascadeSleepyWheel(Int list)
+{
+	SleepyWheelList& l = m_sleepyWheel[list];
+	UpdateModulePtr u = l.m_head;
+	l.m_head = NULL;
+	l.m_tail = NULL;
+
+	while (u)
+	{
+		UpdateModulePtr next = u->friend_getNextInWheel();
+		linkSleepyWheel(u, getSleepyWheelList(u->friend_getPriority()));
+		u = next;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Return the module to call next, if its priority is no later than the given one, or NULL.
+	* Turns the wheel up to that priority while looking. */
+// ------------------------------------------------------------------------------------------------
+UpdateModulePtr GameLogic::peekSleepyWheel(UnsignedInt lastPriority)
+{
+	USE_PERF_TIMER(SleepyMaintenance)
+
+	// anything overdue sorts before the wheel
+	if (m_sleepyWheel[SLEEPY_WHEEL_OVERDUE_LIST].m_head)
+		return m_sleepyWheel[SLEEPY_WHEEL_OVERDUE_LIST].m_head;
+
+	while (m_sleepyWheelPriority <= lastPriority)
+	{
+		UpdateModulePtr u = m_sleepyWheel[SLEEPY_WHEEL_NEAR_LIST + (m_sleepyWheelPriority & (SLEEPY_WHEEL_NEAR_SIZE - 1))].m_head;
+		if (u)
+			return u;
+
+		if (m_sleepyWheelPriority == lastPriority)
+			break;
+
+		++m_sleepyWheelPriority;
+		if ((m_sleepyWheelPriority & (SLEEPY_WHEEL_NEAR_SIZE - 1)) == 0)
+		{
+			// the near wheel is through, bring in the next span of the far wheel,
+			// after bringing in the next span of the overflow list if the far wheel is through, too
+			const Int farSlot = (m_sleepyWheelPriority >> SLEEPY_WHEEL_NEAR_BITS) & (SLEEPY_WHEEL_FAR_SIZE - 1);
+			if (farSlot == 0)
+				cascadeSleepyWheel(SLEEPY_WHEEL_OVERFLOW_LIST);
+			cascadeSleepyWheel(SLEEPY_WHEEL_FAR_LIST + farSlot);
+		}
+	}
+
+	return NULL;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Take every module off the wheel and set it to the given priority. */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::clearSleepyWheel(UnsignedInt priority)
+{
+	for (Int list = 0; list < SLEEPY_WHEEL_LIST_COUNT; ++list)
+	{
+		UpdateModulePtr u = m_sleepyWheel[list].m_head;
+		while (u)
+		{
+			UpdateModulePtr next = u->friend_getNextInWheel();
+			u->friend_setListInWheel(-1);
+			u->friend_setLinksInWheel(NULL, NULL);
+			u = next;
+		}
+		m_sleepyWheel[list].m_head = NULL;
+		m_sleepyWheel[list].m_tail = NULL;
+	}
+
+	m_sleepyWheelPriority = priority;
+	m_sleepyWheelCount = 0;
+}
+
+#ifdef VERIFY_SLEEPY_UPDATE_WHEEL
+// ------------------------------------------------------------------------------------------------
+/** Check that the wheel is due to call a module with the same frame and phase as the heap is.
+	* Modules with the same frame and phase may be called in a different order by either. */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::verifySleepyWheel(UpdateModulePtr u, UnsignedInt now)
+{
+	UpdateModulePtr w = peekSleepyWheel((now << 2) | PHASE_FINAL);
+	if (u->friend_getNextCallFrame() > now)
+	{
+		DEBUG_ASSERTCRASH(w == NULL, ("sleepy wheel calls a module the heap does not (%d %d)",w->friend_getNextCallFrame(),w->friend_getNextCallPhase()));
+	}
+	else
+	{
+		DEBUG_ASSERTCRASH(w != NULL && w->friend_getPriority() == u->friend_getPriority(), ("sleepy wheel and heap call different modules"));
+		DEBUG_ASSERTCRASH(w == NULL || w->friend_getListInWheel() == u->friend_getListInWheel(), ("sleepy wheel and heap call different modules"));
+	}
+	DEBUG_ASSERTCRASH(m_sleepyWheelCount == (Int)m_sleepyUpdates.size(), ("sleepy wheel and heap have different sizes"));
+}
+#endif
+#endif
+
 // ------------------------------------------------------------------------------------------------
 // this should be called only by UpdateModule, thanks.
 // ------------------------------------------------------------------------------------------------
@@ -2755,6 +3016,25 @@ void GameLogic::friend_awakenUpdateModule(Object* obj, UpdateModulePtr u, Unsign
 		return;
 	}
 
+#if USE_SLEEPY_UPDATE_WHEEL
+	Int idx = u->friend_getListInWheel();
+	if (obj->isInList(&m_objList))
+	{
+		if (idx < 0)
+		{
+			RELEASE_CRASH("fatal error! sleepy update module is not on the wheel.");
+			return;
+		}
+
+		// update the value.
+		u->friend_setNextCallFrame(whenToWakeUp);
+
+		// move it to the list for its new frame and phase.
+		rescheduleSleepyWheel(u);
+
+		return;
+	}
+#else
 	Int idx = u->friend_getIndexInLogic();
 	if (obj->isInList(&m_objList))
 	{
@@ -2775,12 +3055,16 @@ void GameLogic::friend_awakenUpdateModule(Object* obj, UpdateModulePtr u, Unsign
 
 		// rebalance.
 		rebalanceSleepyUpdate(idx);
+#ifdef VERIFY_SLEEPY_UPDATE_WHEEL
+		rescheduleSleepyWheel(u);
+#endif
 
 		// validate. (harmless except in debug mode)
 		validateSleepyUpdate();
 
 		return;
 	}
+#endif
 	else
 	{
 		if (idx != -1)
@@ -3166,12 +3450,14 @@ void GameLogic::update( void )
 
 	// update (execute) scripts
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_SCRIPT_ENGINE)
 		TheScriptEngine->UPDATE();
 	}
 
 	// Note - TerrainLogic update needs to happen after ScriptEngine update, but before object updates.  jba.
 	// This way changes in bridges are noted in the script engine before being cleared in TerrainLogic->update
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_TERRAIN_LOGIC)
 		TheTerrainLogic->UPDATE();
 	}
 
@@ -3189,6 +3475,7 @@ void GameLogic::update( void )
 
 	if (generateForSolo || generateForMP)
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_CRC)
 		m_CRC = getCRC( CRC_RECALC );
 		bool isPlayback = (TheRecorder && TheRecorder->isPlaybackMode());
 
@@ -3220,6 +3507,7 @@ void GameLogic::update( void )
 
 	// process client commands
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_COMMAND_LIST)
 		processCommandList( TheCommandList );
 	}
 
@@ -3249,6 +3537,13 @@ void GameLogic::update( void )
 #endif
 
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_SLEEPY_UPDATES)
+#if USE_SLEEPY_UPDATE_WHEEL
+		// the wheel only hands out modules that are due this frame; everyone else is sleeping.
+		UpdateModulePtr u;
+		while ((u = peekSleepyWheel((now << 2) | PHASE_FINAL)) != NULL)
+		{
+#else
 		while (!m_sleepyUpdates.empty())
 		{
 			UpdateModulePtr u = peekSleepyUpdate();
@@ -3259,12 +3554,17 @@ void GameLogic::update( void )
 				continue;
 			}
 
+#ifdef VERIFY_SLEEPY_UPDATE_WHEEL
+			verifySleepyWheel(u, now);
+#endif
+
 			// we're done, everyone else is sleeping.
 			// break from the loop BEFORE we pop this item off.
 			if (u->friend_getNextCallFrame() > now)
 			{
 				break;
 			}
+#endif
 
 			UpdateSleepTime sleepLen = UPDATE_SLEEP_NONE;	// default, if it is disabled.
 
@@ -3287,7 +3587,14 @@ void GameLogic::update( void )
 
 			// else defer it till next frame and re-push it
 			u->friend_setNextCallFrame(now + sleepLen);
+#if USE_SLEEPY_UPDATE_WHEEL
+			rescheduleSleepyWheel(u);
+#else
 			rebalanceSleepyUpdate(0);
+#ifdef VERIFY_SLEEPY_UPDATE_WHEEL
+			rescheduleSleepyWheel(u);
+#endif
+#endif
 		}
 	}
 
@@ -3295,6 +3602,7 @@ void GameLogic::update( void )
 
 	// update the Artificial Intelligence system
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_AI)
 		TheAI->UPDATE();
 	}
 
@@ -3305,6 +3613,7 @@ void GameLogic::update( void )
 
 	// update partition info
 	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_PARTITION_MANAGER)
 		ThePartitionManager->UPDATE();
 	}
 
@@ -3313,7 +3622,10 @@ void GameLogic::update( void )
 	//
 
 	// destroy all pending objects
-	processDestroyList();
+	{
+		REPLAY_REPORT_SECTION(REPLAYREPORT_DESTROY_LIST)
+		processDestroyList();
+	}
 
 	// reset the command list, destroying all messages
 	TheCommandList->reset();
@@ -3449,7 +3761,12 @@ void GameLogic::registerObject( Object *obj )
 #endif
 		{
 			DEBUG_ASSERTCRASH(u->friend_getNextCallFrame() >= now, ("you may not specify a zero initial sleep time for sleepy modules (%d %d)",u->friend_getNextCallFrame(),now));
+#ifdef SLEEPY_UPDATE_WHEEL
+			pushSleepyWheel(u);
+#endif
+#if !USE_SLEEPY_UPDATE_WHEEL
 			pushSleepyUpdate(u);
+#endif
 		}
 	}
 
@@ -3529,12 +3846,7 @@ UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 	if (mode != CRC_RECALC)
 		return m_CRC;
 
-	setFPMode();
-
-	LatchRestore<Bool> latch(inCRCGen, !isInGameLogicUpdate());
-
 	XferCRC *xferCRC;
-	AsciiString marker;
 	if (deepCRCFileName.isNotEmpty())
 	{
 		xferCRC = NEW XferDeepCRC;
@@ -3557,6 +3869,11 @@ UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 		}
 		else
 #endif // DEBUG_CRC
+		if (isInGameLogicUpdate() && TheGlobalData->m_crcTreeFile.isNotEmpty())
+		{
+			return recalculateCRCTree();
+		}
+		else
 		{
 			xferCRC = NEW XferCRC;
 			crcName = "lightCRC";
@@ -3564,6 +3881,48 @@ UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 		xferCRC->open(crcName);
 	}
 
+	UnsignedInt theCRC = recalculateCRC( xferCRC );
+
+	delete xferCRC;
+	xferCRC = NULL;
+
+	return theCRC;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** TheSuperHackers @feature Run the CRC calculation through a CRC tree and append the tree to the
+	* -crcTree file. The CRC is the same as the one of a plain XferCRC. */
+// ------------------------------------------------------------------------------------------------
+UnsignedInt GameLogic::recalculateCRCTree( void )
+{
+	if (m_crcTree == NULL)
+	{
+		m_crcTree = NEW XferCRCTree;
+		m_crcTreeFile = fopen(TheGlobalData->m_crcTreeFile.str(), "wb");
+		if (m_crcTreeFile == NULL)
+		{
+			DEBUG_LOG(("Cannot open CRC tree file '%s'", TheGlobalData->m_crcTreeFile.str()));
+		}
+	}
+
+	m_crcTree->open("lightCRC");
+	UnsignedInt theCRC = recalculateCRC( m_crcTree );
+	m_crcTree->writeFrame( m_crcTreeFile, m_frame );
+
+	return theCRC;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Run the CRC calculation through the given open xfer. The xfer is closed afterwards. */
+// ------------------------------------------------------------------------------------------------
+UnsignedInt GameLogic::recalculateCRC( XferCRC *xferCRC )
+{
+	setFPMode();
+
+	LatchRestore<Bool> latch(inCRCGen, !isInGameLogicUpdate());
+
+	AsciiString marker;
+
 	// calculate CRCs
 	Object *obj;
 	DEBUG_ASSERTCRASH(this == TheGameLogic, ("Not in GameLogic"));
@@ -3576,7 +3935,9 @@ UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 	xferCRC->xferAsciiString(&marker);
 	for( obj = m_objList; obj; obj=obj->getNextObject() )
 	{
+		xferCRC->beginNode( "Object", obj->getID() );
 		xferCRC->xferSnapshot( obj );
+		xferCRC->endNode();
 	}
 	UnsignedInt seed = GetGameLogicRandomSeedCRC();
 	if (isInGameLogicUpdate())
@@ -3641,9 +4002,6 @@ UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 
 	UnsignedInt theCRC = xferCRC->getCRC();
 
-	delete xferCRC;
-	xferCRC = NULL;
-
 	if (isInGameLogicUpdate())
 	{
 		CRCGEN_LOG(("CRC for frame %d is 0x%8.8X", m_frame, theCRC));
@@ -4317,6 +4675,13 @@ void GameLogic::xfer( Xfer *xfer )
 	if( xfer->getXferMode() == XFER_LOAD )
 		prepareLogicForObjectLoad();
 
+#if USE_GROUP_FLOW_FIELDS
+	// TheSuperHackers @bugfix The group move goals and flow fields of the pathfinder are not saved. Drop them
+	// on both sides, so the game that goes on after saving finds the same paths as the game that is loaded.
+	if( xfer->getXferMode() == XFER_SAVE || xfer->getXferMode() == XFER_LOAD )
+		TheAI->pathfinder()->resetFlowFields();
+#endif
+
 	// object count
 	UnsignedInt objectCount = getObjectCount();
 	xfer->xferUnsignedInt( &objectCount );
@@ -4634,6 +4999,9 @@ void GameLogic::loadPostProcess( void )
 		(*it)->friend_setIndexInLogic(-1);
 	}
 	m_sleepyUpdates.clear();
+#ifdef SLEEPY_UPDATE_WHEEL
+	clearSleepyWheel(TheGameLogic->getFrame() << 2);
+#endif
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	m_normalUpdates.clear();
 #else
@@ -4675,16 +5043,23 @@ void GameLogic::loadPostProcess( void )
 				u->friend_setNextCallFrame(now);
 #endif
 			{
+#ifdef SLEEPY_UPDATE_WHEEL
+				pushSleepyWheel(u);
+#endif
+#if !USE_SLEEPY_UPDATE_WHEEL
 				m_sleepyUpdates.push_back(u);
 				u->friend_setIndexInLogic(m_sleepyUpdates.size() - 1);
+#endif
 			}
 
 		}
 
 	}
 
+#if !USE_SLEEPY_UPDATE_WHEEL
 	// re-sort the priority queue all at once now that all modules are on it
 	remakeSleepyUpdate();
+#endif
 
 }
 
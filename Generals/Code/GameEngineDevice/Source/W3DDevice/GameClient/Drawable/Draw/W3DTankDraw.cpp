@@ -131,11 +131,14 @@ void W3DTankDraw::createEmitters( void )
 		if (sysTemplate)
 		{
 			m_treadDebrisLeft = TheParticleSystemManager->createParticleSystem( sysTemplate );
-			m_treadDebrisLeft->attachToDrawable(getDrawable());
-			// important: mark it as do-not-save, since we'll just re-create it when we reload.
-			m_treadDebrisLeft->setSaveable(FALSE);
-			// they come into being stopped.
-	  	m_treadDebrisLeft->stop();
+			if (m_treadDebrisLeft)
+			{
+				m_treadDebrisLeft->attachToDrawable(getDrawable());
+				// important: mark it as do-not-save, since we'll just re-create it when we reload.
+				m_treadDebrisLeft->setSaveable(FALSE);
+				// they come into being stopped.
+				m_treadDebrisLeft->stop();
+			}
 		}
 	}
 	if (!m_treadDebrisRight)
@@ -145,11 +148,14 @@ void W3DTankDraw::createEmitters( void )
 		if (sysTemplate)
 		{
 			m_treadDebrisRight = TheParticleSystemManager->createParticleSystem( sysTemplate );
-			m_treadDebrisRight->attachToDrawable(getDrawable());
-			// important: mark it as do-not-save, since we'll just re-create it when we reload.
-			m_treadDebrisRight->setSaveable(FALSE);
-			// they come into being stopped.
-	  	m_treadDebrisRight->stop();
+			if (m_treadDebrisRight)
+			{
+				m_treadDebrisRight->attachToDrawable(getDrawable());
+				// important: mark it as do-not-save, since we'll just re-create it when we reload.
+				m_treadDebrisRight->setSaveable(FALSE);
+				// they come into being stopped.
+				m_treadDebrisRight->stop();
+			}
 		}
 	}
 }
@@ -239,9 +239,12 @@ void W3DTankTruckDraw::createEmitters( void )
 			if (sysTemplate)
 			{
 				m_dustEffect = TheParticleSystemManager->createParticleSystem( sysTemplate );
-				m_dustEffect->attachToObject(getDrawable()->getObject());
-				// important: mark it as do-not-save, since we'll just re-create it when we reload.
-				m_dustEffect->setSaveable(FALSE);
+				if (m_dustEffect)
+				{
+					m_dustEffect->attachToObject(getDrawable()->getObject());
+					// important: mark it as do-not-save, since we'll just re-create it when we reload.
+					m_dustEffect->setSaveable(FALSE);
+				}
 			}	else {
 				if (!getW3DTankTruckDrawModuleData()->m_dustEffectName.isEmpty()) {
 					DEBUG_LOG(("*** ERROR - Missing particle system '%s' in thing '%s'",
@@ -255,9 +258,12 @@ void W3DTankTruckDraw::createEmitters( void )
 			if (sysTemplate)
 			{
 				m_dirtEffect = TheParticleSystemManager->createParticleSystem( sysTemplate );
-				m_dirtEffect->attachToObject(getDrawable()->getObject());
-				// important: mark it as do-not-save, since we'll just re-create it when we reload.
-				m_dirtEffect->setSaveable(FALSE);
+				if (m_dirtEffect)
+				{
+					m_dirtEffect->attachToObject(getDrawable()->getObject());
+					// important: mark it as do-not-save, since we'll just re-create it when we reload.
+					m_dirtEffect->setSaveable(FALSE);
+				}
 			}	else {
 				if (!getW3DTankTruckDrawModuleData()->m_dirtEffectName.isEmpty()) {
 					DEBUG_LOG(("*** ERROR - Missing particle system '%s' in thing '%s'",
@@ -270,9 +276,12 @@ void W3DTankTruckDraw::createEmitters( void )
 			if (sysTemplate)
 			{
 				m_powerslideEffect = TheParticleSystemManager->createParticleSystem( sysTemplate );
-				m_powerslideEffect->attachToObject(getDrawable()->getObject());
-				// important: mark it as do-not-save, since we'll just re-create it when we reload.
-				m_powerslideEffect->setSaveable(FALSE);
+				if (m_powerslideEffect)
+				{
+					m_powerslideEffect->attachToObject(getDrawable()->getObject());
+					// important: mark it as do-not-save, since we'll just re-create it when we reload.
+					m_powerslideEffect->setSaveable(FALSE);
+				}
 			}	else {
 				if (!getW3DTankTruckDrawModuleData()->m_powerslideEffectName.isEmpty()) {
 					DEBUG_LOG(("*** ERROR - Missing particle system '%s' in thing '%s'",
@@ -180,9 +180,12 @@ void W3DTruckDraw::createEmitters( void )
 			if (sysTemplate)
 			{
 				m_dustEffect = TheParticleSystemManager->createParticleSystem( sysTemplate );
-				m_dustEffect->attachToObject(getDrawable()->getObject());
-				// important: mark it as do-not-save, since we'll just re-create it when we reload.
-				m_dustEffect->setSaveable(FALSE);
+				if (m_dustEffect)
+				{
+					m_dustEffect->attachToObject(getDrawable()->getObject());
+					// important: mark it as do-not-save, since we'll just re-create it when we reload.
+					m_dustEffect->setSaveable(FALSE);
+				}
 			}	else {
 				if (!getW3DTruckDrawModuleData()->m_dustEffectName.isEmpty()) {
 					DEBUG_LOG(("*** ERROR - Missing particle system '%s' in thing '%s'",
@@ -196,9 +199,12 @@ void W3DTruckDraw::createEmitters( void )
 			if (sysTemplate)
 			{
 				m_dirtEffect = TheParticleSystemManager->createParticleSystem( sysTemplate );
-				m_dirtEffect->attachToObject(getDrawable()->getObject());
-				// important: mark it as do-not-save, since we'll just re-create it when we reload.
-				m_dirtEffect->setSaveable(FALSE);
+				if (m_dirtEffect)
+				{
+					m_dirtEffect->attachToObject(getDrawable()->getObject());
+					// important: mark it as do-not-save, since we'll just re-create it when we reload.
+					m_dirtEffect->setSaveable(FALSE);
+				}
 			}	else {
 				if (!getW3DTruckDrawModuleData()->m_dirtEffectName.isEmpty()) {
 					DEBUG_LOG(("*** ERROR - Missing particle system '%s' in thing '%s'",
@@ -211,9 +217,12 @@ void W3DTruckDraw::createEmitters( void )
 			if (sysTemplate)
 			{
 				m_powerslideEffect = TheParticleSystemManager->createParticleSystem( sysTemplate );
-				m_powerslideEffect->attachToObject(getDrawable()->getObject());
-				// important: mark it as do-not-save, since we'll just re-create it when we reload.
-				m_powerslideEffect->setSaveable(FALSE);
+				if (m_powerslideEffect)
+				{
+					m_powerslideEffect->attachToObject(getDrawable()->getObject());
+					// important: mark it as do-not-save, since we'll just re-create it when we reload.
+					m_powerslideEffect->setSaveable(FALSE);
+				}
 			}	else {
 				if (!getW3DTruckDrawModuleData()->m_powerslideEffectName.isEmpty()) {
 					DEBUG_LOG(("*** ERROR - Missing particle system '%s' in thing '%s'",
@@ -109,6 +109,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "Energy"; }
 
 	void addProduction(Int amt);
 	void addConsumption(Int amt);
@@ -39,6 +39,7 @@
 class INI;
 class Xfer;
 class File;
+class FilePrefetcher;
 enum ScienceType CPP_11(: Int);
 
 //-------------------------------------------------------------------------------------------------
@@ -395,15 +396,10 @@ protected:
 
 	void readLine( void );
 
-	File *m_file;															///< file pointer of file currently loading
-
-  enum
-  {
-    INI_READ_BUFFER = 8192                  ///< size of internal read buffer
-  };
-  char m_readBuffer[INI_READ_BUFFER];       ///< internal read buffer
-  unsigned m_readBufferNext;                ///< next char in read buffer
-  unsigned m_readBufferUsed;                ///< number of bytes in read buffer
+	char *m_fileData;													///< entire contents of the file currently loading
+	UnsignedInt m_fileDataSize;								///< number of bytes in m_fileData
+	UnsignedInt m_fileDataNext;								///< offset of the next unread char in m_fileData
+	FilePrefetcher *m_prefetcher;							///< files of the directory being loaded, read ahead of time
 
 	AsciiString m_filename;										///< filename of file currently loading
 	INILoadType m_loadType;										///< load time for current file
@@ -194,6 +194,8 @@ public:
 
 	inline NameKeyType getModuleTagNameKey() const { return getModuleData()->getModuleTagNameKey(); }
 
+	virtual AsciiString getSnapshotName() const { return KEYNAME(getModuleNameKey()); }
+
 	/** this is called after all the Modules for a given Thing are created; it
 		allows Modules to resolve any inter-Module dependencies.
 	*/
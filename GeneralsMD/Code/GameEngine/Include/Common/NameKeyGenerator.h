@@ -34,6 +34,7 @@
 #include "Common/SubsystemInterface.h"
 #include "Common/GameMemory.h"
 #include "Common/AsciiString.h"
+#include "Common/STLTypedefs.h"
 
 //-------------------------------------------------------------------------------------------------
 /**
@@ -50,27 +51,6 @@ enum NameKeyType CPP_11(: Int)
 	FORCE_NAMEKEYTYPE_LONG	= 0x7fffffff	// a trick to ensure the NameKeyType is a 32-bit int
 };
 
-//-------------------------------------------------------------------------------------------------
-/** A bucket entry for the name key generator */
-//-------------------------------------------------------------------------------------------------
-class Bucket : public MemoryPoolObject
-{
-
-	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE( Bucket, "NameKeyBucketPool" );
-
-public:
-
-	Bucket();
-//~Bucket();
-
-	Bucket				*m_nextInSocket;
-	NameKeyType		m_key;
-	AsciiString		m_nameString;
-};
-
-inline Bucket::Bucket() : m_nextInSocket(NULL), m_key(NAMEKEY_INVALID) { }
-inline Bucket::~Bucket() { }
-
 //-------------------------------------------------------------------------------------------------
 /** This class implements the conversion of an arbitrary string into a unique
 	* integer "key". Calling the nameToKey() method with the same string is
@@ -101,9 +81,7 @@ public:
 
 	/**
 		given a key, return the name. this is almost never needed,
-		except for a few rare cases like object serialization. also
-		note that it's not particularly fast; it does a dumb linear
-		search for the key.
+		except for a few rare cases like object serialization.
 	*/
 	AsciiString keyToName(NameKeyType key);
 
@@ -114,6 +92,8 @@ private:
 
 	enum
 	{
+		ARENA_BLOCK_SIZE = 64 * 1024,	///< bytes per block of the name arena
+
 		// socketcount should be prime, and not "close" to a power of 2, for best results.
 		SOCKET_COUNT = 45007
 	};
@@ -122,12 +102,30 @@ private:
 	Bool addReservedKey();
 #endif
 
+	// TheSuperHackers @performance The names are kept in one entry per key, indexed by the key, because
+	// the keys are handed out in order. The entries of a socket are chained by key. The name strings
+	// are copied into large blocks and never freed before the generator resets.
+	struct Entry
+	{
+		const char		*m_name;					///< Name string in the name arena
+		NameKeyType		m_nextInSocket;		///< Next key in the same socket
+	};
+
 	NameKeyType nameToKeyImpl(const char* name);
 	NameKeyType nameToLowercaseKeyImpl(const char *name);
+	NameKeyType addName(const char* name, UnsignedInt socket);
+	const char* copyToArena(const char* name);
+#if defined(RTS_DEBUG)
+	void checkSockets();
+#endif
 
 	void freeSockets();
 
-	Bucket*				m_sockets[SOCKET_COUNT];			///< Catalog of all Buckets already generated
+	NameKeyType		m_sockets[SOCKET_COUNT];			///< First key of each socket
+	std::vector<Entry> m_entries;								///< Entry of each key, entry 0 belongs to NAMEKEY_INVALID
+	std::vector<char*> m_arenaBlocks;						///< Blocks of the name arena
+	char*					m_arenaCursor;								///< Free space in the last block of the name arena
+	UnsignedInt		m_arenaRemaining;							///< Bytes of free space at m_arenaCursor
 	UnsignedInt		m_nextID;											///< Next available ID
 
 };
@@ -225,6 +225,7 @@ protected:
 	PathfindCell *m_cell;															///< Cell this info belongs to currently.
 
 	UnsignedShort m_totalCost, m_costSoFar;	///< cost estimates for A* search
+	UnsignedShort m_openCost;								///< total cost this cell was sorted into the open list with
 
 	/// have to include cell's coordinates, since cells are often accessed via pointer only
 	ICoord2D m_pos;
@@ -318,6 +319,9 @@ public:
 	/// remove all cells from closed list.
 	static Int releaseOpenList( PathfindCell *list );
 
+	/// forget the cost index of the open list, for when the list is dropped without removing its cells.
+	static void resetOpenListIndex( void );
+
 	inline PathfindCell *getNextOpen(void) {return m_info->m_nextOpen?m_info->m_nextOpen->m_cell:NULL;}
 
 	inline UnsignedShort getXIndex(void) const {return m_info->m_pos.x;}
@@ -364,6 +368,11 @@ public:
 	PathfindLayerEnum getConnectLayer( void ) const { return (PathfindLayerEnum)m_connectsToLayer; }				///< get the cell layer connect id
 
 private:
+	static void syncOpenListIndex( PathfindCell *list );
+	static PathfindCellInfo *findOpenListTail( UnsignedShort cost );
+	static void addToOpenListIndex( PathfindCellInfo *info );
+	static void removeFromOpenListIndex( PathfindCellInfo *info );
+
 	PathfindCellInfo *m_info;
 	zoneStorageType m_zone:14;			///< Zone. Each zone is a set of adjacent terrain type.  If from & to in the same zone, you can successfully pathfind.  If not,
 														// you still may be able to if you can cross multiple terrain types.
@@ -443,6 +452,31 @@ enum { PATHFIND_QUEUE_LEN=512};
 
 struct TCheckMovementInfo;
 
+#if USE_INCREMENTAL_PATHFIND_ZONES
+/**
+ * TheSuperHackers @performance Two zones of neighboring cells, or of a cell and the bridge it connects to,
+ * and the equivalency tables calculateZones links them in. Each zone block keeps the links of its cells to
+ * the cells to their left and above, so that the tables can be linked anew after some blocks were rezoned,
+ * without looking at the cells of the whole map again.
+ */
+struct PathfindZoneLink
+{
+	enum
+	{
+		HIERARCHICAL = 0x01,
+		TERRAIN = 0x02,
+		CRUSHER = 0x04,
+		GROUND_WATER = 0x08,
+		GROUND_RUBBLE = 0x10,
+		GROUND_CLIFF = 0x20
+	};
+
+	zoneStorageType m_zone;
+	zoneStorageType m_otherZone;
+	UnsignedByte m_tables;
+};
+#endif
+
 /**
  * This class is a helper class for zone manager.  It maintains information regarding the
  * LocomotorSurfaceTypeMask equivalencies within a ZONE_BLOCK_SIZE x ZONE_BLOCK_SIZE area of
@@ -466,9 +500,23 @@ public:
 	Bool getInteractsWithBridge(void) const {return m_interactsWithBridge;}
 	void setInteractsWithBridge(Bool interacts) {m_interactsWithBridge = interacts;}
 
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	zoneStorageType getFirstZone(void) const {return m_firstZone;}
+	UnsignedShort getNumZones(void) const {return m_numZones;}
+	void offsetZones(Int offset);	///< Move the zones of this block, after the blocks before it changed their number of zones.
+
+	void blockCalculateLinks(PathfindCell **map, PathfindLayer layers[], const IRegion2D &bounds, const IRegion2D &globalBounds);	///< Find the links of the cells to their left and upper neighbors.
+	void renumberLinks(const zoneStorageType *newZones);
+	Int getNumLinks(void) const {return (Int)m_links.size();}
+	const PathfindZoneLink &getLink(Int i) const {return m_links[i];}
+#endif
+
 protected:
 	void allocateZones(void);
 	void freeZones(void);
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	void addLink(zoneStorageType zone, zoneStorageType otherZone, UnsignedByte tables);
+#endif
 
 protected:
 	ICoord2D		m_cellOrigin;
@@ -485,9 +533,37 @@ protected:
 	zoneStorageType *m_crusherZones;
 	Bool					m_interactsWithBridge;
 	Bool					m_markedPassable;
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	std::vector<PathfindZoneLink> m_links;
+#endif
 };
 typedef ZoneBlock *ZoneBlockP;
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+/**
+ * TheSuperHackers @performance A route between two zone blocks, as found by the hierarchical pathfinder.
+ * It holds the cells the search went through between the start and the goal cell, so that a later search
+ * from the same zone of the start block to the same zone of the goal block can take the route as it is.
+ */
+struct PathfindZoneRoute
+{
+	enum { MAX_CELLS = 128 };
+
+	ICoord2D m_fromBlock;
+	ICoord2D m_toBlock;
+	zoneStorageType m_fromZone;
+	zoneStorageType m_toZone;
+	LocomotorSurfaceTypeMask m_surfaces;
+	Bool m_crusher;
+	Bool m_isHuman;
+	Bool m_crossesBridge;							///< some of the cells are on a bridge layer
+	Int m_cellsExamined;							///< how many cells the search that found the route examined
+	Int m_numCells;
+	ICoord2D m_cells[MAX_CELLS];			///< ordered from the goal end to the start end
+	UnsignedByte m_cellLayers[MAX_CELLS];
+};
+#endif
+
 /**
  * This class manages the zones in the map.  A zone is an area in the map that
  * is one contiguous type of terrain (clear, cliff, water, building).  If
@@ -500,6 +576,7 @@ class PathfindZoneManager
 {
 public:
 	enum {INITIAL_ZONES = 256};
+	enum {MAX_ZONES = 24000};	///< calculateZones has room for this many zones.
 	enum {ZONE_BLOCK_SIZE = 10};	// Zones are calculated in blocks of 20x20.  This way, the raw zone numbers can be used to
 	enum {UNINITIALIZED_ZONE = 0};
 																// compute hierarchically between the 20x20 blocks of cells. jba.
@@ -512,6 +589,9 @@ public:
  	void markZonesDirty( Bool insert ) ; ///< Called when the zones need to be recalculated.
  	void updateZonesForModify( PathfindCell **map,  PathfindLayer layers[], const IRegion2D &structureBounds, const IRegion2D &globalBounds ) ; ///< Called to recalculate an area when a structure has been removed.
 	void calculateZones(	PathfindCell **map, PathfindLayer layers[], const IRegion2D &bounds);	///< Does zone calculations.
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	void updateZoneBlocks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &cellBounds, const IRegion2D &globalBounds );	///< Rezone the blocks of cells that changed type.
+#endif
 	zoneStorageType getEffectiveZone(LocomotorSurfaceTypeMask acceptableSurfaces, Bool crusher, zoneStorageType zone) const;
 	zoneStorageType getEffectiveTerrainZone(zoneStorageType zone) const;
 
@@ -530,6 +610,16 @@ public:
 
 	void setAllPassable(void);
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	const PathfindZoneRoute *findRoute( const PathfindZoneRoute &key );	///< Returns the cached route between the blocks and zones of key, if any.
+	void addRoute( const PathfindZoneRoute &route );
+	void clearRoutes( void );
+	void invalidateBridgeRoutes( void );	///< Drops the routes that cross a bridge, for when a bridge breaks or is repaired.
+	UnsignedInt getRouteCacheHits( void ) const { return m_routeCacheHits; }
+	UnsignedInt getRouteCacheMisses( void ) const { return m_routeCacheMisses; }
+	UnsignedInt getRouteCacheCellsSaved( void ) const { return m_routeCacheCellsSaved; }	///< cells the reused routes did not have to examine again
+#endif
+
 	void setBridge(Int cellX, Int cellY, Bool bridge);
 	Bool interactsWithBridge(Int cellX, Int cellY) const;
 
@@ -537,6 +627,15 @@ private:
 	void allocateZones(void);
 	void freeZones(void);
 	void freeBlocks(void);
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	Int labelBlockZones( PathfindCell **map, const IRegion2D &bounds, ZoneBlock &block, Int firstZone );
+	void calculateLinks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds );
+	void linkZoneTables( void );
+#if defined(RTS_DEBUG)
+	void verifyZoneBlocks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds );
+	void getZones( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds, std::vector<zoneStorageType> &zones ) const;
+#endif
+#endif
 
 private:
 	ZoneBlock			*m_blockOfZoneBlocks;			///< Zone blocks - Info for hierarchical pathfinding at a "blocky" level.
@@ -552,8 +651,96 @@ private:
 	zoneStorageType *m_terrainZones;
 	zoneStorageType *m_crusherZones;
 	zoneStorageType *m_hierarchicalZones;
+
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	Bool m_linksCalculated;											///< The zone blocks hold the links of the current zones.
+	std::vector<zoneStorageType> m_newZones;		///< The zone each zone moved to in the last update, or 0 if its block was rezoned.
+	std::vector<Int> m_zoneBlockOffsets;				///< How far the zones of each block moved in the last update.
+	std::vector<zoneStorageType> m_zoneValues;				///< Scratch space to flatten the equivalency tables.
+#endif
+
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	enum { MAX_CACHED_ROUTES = 64 };
+
+	void invalidateRoutes( const IRegion2D &cellBounds );
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	void renumberRoutes( void );
+#endif
+
+	PathfindZoneRoute m_routes[MAX_CACHED_ROUTES];
+	UnsignedInt m_routeLastUsed[MAX_CACHED_ROUTES];	///< 0 if the route is not in use
+	UnsignedInt m_routeClock;
+	UnsignedInt m_routeCacheHits;
+	UnsignedInt m_routeCacheMisses;
+	UnsignedInt m_routeCacheCellsSaved;
+#endif
 };
 
+#if USE_GROUP_FLOW_FIELDS
+/**
+ * TheSuperHackers @performance A flow field holds, for every ground cell that can reach one goal cell,
+ * the direction of the cheapest step towards that goal for one kind of mover. The Pathfinder builds it with
+ * a search outwards from the goal, a part at a time within the pathfinding budget of each frame. It is
+ * shared by the members of a group that was ordered to the same place, so each of them reads its path off
+ * the field instead of running A*, as soon as the search has settled the cell it starts from.
+ */
+class PathfindFlowField
+{
+public:
+	enum
+	{
+		NUM_DIRECTIONS = 8,				///< directions below this are steps to a neighbor cell
+		NO_DIRECTION = 0xff,			///< the goal can not be reached from this cell
+		GOAL_DIRECTION = 0xfe			///< this is the goal cell
+	};
+
+	PathfindFlowField( void );
+	~PathfindFlowField();
+
+	Bool matches( const ICoord2D &goal, LocomotorSurfaceTypeMask surfaces, Bool crusher, Bool isHuman ) const;
+	UnsignedByte getDirection( Int x, Int y ) const;
+	Bool isSettled( Int x, Int y ) const;
+
+private:
+	friend class Pathfinder;
+
+	struct OpenCell
+	{
+		UnsignedInt m_cost;
+		Int m_index;
+
+		// Ordered so that the std heap functions keep the cheapest cell on top, lowest index first.
+		Bool operator<( const OpenCell &other ) const
+		{
+			return m_cost > other.m_cost || (m_cost == other.m_cost && m_index > other.m_index);
+		}
+	};
+
+	void allocate( const IRegion2D &extent );
+	void release( void );
+
+	UnsignedByte *m_directions;							///< index into the neighbor deltas of the step towards the goal, per cell
+	IRegion2D m_extent;											///< cells covered by m_directions
+	Int m_width;
+	ICoord2D m_goal;
+	LocomotorSurfaceTypeMask m_surfaces;
+	Bool m_crusher;
+	Bool m_isHuman;
+	Bool m_isValid;													///< false once the map changed under the field
+	Bool m_isComplete;											///< true once the search has reached every cell it can
+	UnsignedInt m_lastUsedFrame;
+	std::vector<UnsignedInt> m_costs;				///< cost to the goal per cell, while the search runs
+	std::vector<OpenCell> m_open;						///< cells left to expand, while the search runs
+};
+
+inline UnsignedByte PathfindFlowField::getDirection( Int x, Int y ) const
+{
+	if (x < m_extent.lo.x || x > m_extent.hi.x || y < m_extent.lo.y || y > m_extent.hi.y)
+		return NO_DIRECTION;
+	return m_directions[(y - m_extent.lo.y) * m_width + (x - m_extent.lo.x)];
+}
+#endif
+
 /**
  * The pathfinding services interface provides access to the 3 expensive path find calls:
  * findPath, findClosestPath, and findAttackPath.
@@ -613,6 +800,9 @@ private:
 	virtual Path *patchPath( const Object *obj, const LocomotorSet& locomotorSet,
 		Path *originalPath, Bool blocked );
 
+	// TheSuperHackers @feature The pathfind benchmark calls the search routines directly.
+	friend class PathfindBenchmark;
+
 public:
 	Pathfinder( void );
 	~Pathfinder() ;
@@ -623,6 +813,7 @@ public:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess( void );
+	AsciiString getSnapshotName( void ) const { return "Pathfinder"; }
 
 	Bool clientSafeQuickDoesPathExist( const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *to );  ///< Can we build any path at all between the locations	(terrain & buildings check - fast)
 	Bool clientSafeQuickDoesPathExistForUI( const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *to );  ///< Can we build any path at all between the locations	(terrain onlyk - fast)
@@ -633,6 +824,11 @@ public:
 	void processPathfindQueue(void); ///< Process some or all of the queued pathfinds.
 	void forceMapRecalculation( );	///< Force pathfind map recomputation. If region is given, only that area is recomputed
 
+#if USE_GROUP_FLOW_FIELDS
+	void addGroupMoveGoal( const Coord3D *goal, UnsignedInt groupID, Int numMembers );	///< A group was ordered to the goal, let its members share a flow field there.
+	void resetFlowFields( void );	///< Forget the group goals and the flow fields. The pathfinder is not saved, so this runs at save and load.
+#endif
+
 	/** Returns an aircraft path to the goal.  */
 	Path *getAircraftPath( const Object *obj, const Coord3D *to);
 	Path *findGroundPath( const Coord3D *from, const Coord3D *to, Int pathRadius,
@@ -807,6 +1003,9 @@ protected:
 																																If 'insert' is true, object is being added
 																																If 'insert' is false, object is being removed */
 	void classifyFence( Object *obj, Bool insert );	/** Classify the cells under the given fence object. */
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	void updateZonesForFootprint( const IRegion2D &cellBounds, Bool insert );	///< Rezone the cells of a footprint that was classified.
+#endif
 	void classifyUnitFootprint( Object *obj, Bool insert, Bool remove, Bool update );	/** Classify the cells under the given object If 'insert' is true, object is being added */
 	/// Convert world coordinate to array index
 	void worldToGrid( const Coord3D *pos, ICoord2D *cellIndex );
@@ -821,6 +1020,12 @@ protected:
 	Path *buildGroundPath( Bool isCrusher,const Coord3D *fromPos, PathfindCell *goalCell,
 		Bool center, Int pathDiameter );	///< Work backwards from goal cell to construct final path
 	Path *buildHierachicalPath( const Coord3D *fromPos, PathfindCell *goalCell);	///< Work backwards from goal cell to construct final path
+	void markPassableAroundPathStart( const Path *path );	///< Let the search get around units near the start of a hierarchical path
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	Path *buildCachedHierarchicalPath( const Coord3D *fromPos, PathfindCell *startCell, PathfindCell *goalCell,
+		const PathfindZoneRoute &route );	///< Construct a hierarchical path along a cached route
+	void recordHierarchicalRoute( PathfindZoneRoute &route, PathfindCell *goalCell, Int cellsExamined );	///< Cache the route the search found to goal cell
+#endif
 
 	void  prependCells( Path *path, const Coord3D *fromPos,
 																	PathfindCell *goalCell, Bool center ); ///< Add pathfind cells to a path.
@@ -832,6 +1037,16 @@ protected:
 
 	bool checkCellOutsideExtents(ICoord2D& cell);
 
+#if USE_GROUP_FLOW_FIELDS
+	Path *findFlowFieldPath( Object *obj, const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *to );
+	PathfindFlowField *getFlowField( const ICoord2D &goal, LocomotorSurfaceTypeMask surfaces, Bool crusher, Bool isHuman );
+	void startFlowField( PathfindFlowField *field );
+	void buildFlowField( PathfindFlowField *field, Int maxCells, const ICoord2D *startCell );
+	void continueFlowFields( void );
+	void invalidateFlowFields( void );
+	void releaseFlowFields( void );
+#endif
+
 #if defined(RTS_DEBUG)
 	void doDebugIcons(void) ;
 #endif
@@ -872,6 +1087,30 @@ private:
 	Int						m_queuePRHead;
 	Int						m_queuePRTail;
 	Int						m_cumulativeCellsAllocated;
+
+#if USE_GROUP_FLOW_FIELDS
+	enum
+	{
+		MAX_FLOW_FIELDS = 4,
+		MAX_FLOW_FIELD_GOALS = 8,
+		FLOW_FIELD_MIN_GROUP_SIZE = 8,											///< smaller groups are cheaper to path one by one
+		FLOW_FIELD_GOAL_RADIUS = 8,													///< how many cells a member's destination may be from the group goal
+		FLOW_FIELD_GOAL_FRAMES = 10*LOGICFRAMES_PER_SECOND	///< how long the members of a group may use its goal
+	};
+
+	struct FlowFieldGoal
+	{
+		ICoord2D m_cell;
+		UnsignedInt m_groupID;		///< only members of this group may use the goal
+		UnsignedInt m_expireFrame;
+	};
+
+	// Flow fields
+	PathfindFlowField	m_flowFields[MAX_FLOW_FIELDS];
+	FlowFieldGoal	m_flowFieldGoals[MAX_FLOW_FIELD_GOALS];
+	Int						m_nextFlowFieldGoal;
+	std::vector<ICoord2D> m_flowFieldPathCells;		///< scratch space for reading a path off a field
+#endif
 };
 
 
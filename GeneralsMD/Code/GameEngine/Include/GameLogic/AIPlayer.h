@@ -216,6 +216,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "AIPlayer"; }
 
 	virtual void doBaseBuilding(void);
 	virtual void checkReadyTeams(void);
@@ -64,6 +64,7 @@ public:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess( void );
+	AsciiString getSnapshotName( void ) const { return "ExperienceTracker"; }
 
 private:
 	Object*						m_parent;														///< Object I am owned by
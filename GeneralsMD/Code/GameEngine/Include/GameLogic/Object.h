@@ -642,6 +642,7 @@ protected:
 	void crc( Xfer *xfer );
 	void xfer( Xfer *xfer );
 	void loadPostProcess();
+	AsciiString getSnapshotName() const { return "Object"; }
 
 	void handleShroud();
 	void handleValueMap();
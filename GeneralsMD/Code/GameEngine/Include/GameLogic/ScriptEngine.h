@@ -84,12 +84,15 @@ struct TCounter
 	Int value;
 	AsciiString name;
 	Bool isCountdownTimer;
+	UnsignedInt changeStamp;		///< Condition stamp of the last change of the value or timer state
+	UnsignedInt expiryStamp;		///< Condition stamp of the last change of whether the timer has expired
 };
 
 struct TFlag
 {
 	Bool value;
 	AsciiString name;
+	UnsignedInt changeStamp;		///< Condition stamp of the last change of the value
 };
 
 typedef std::list<AsciiString> ListAsciiString;
@@ -119,6 +122,9 @@ typedef AllObjectTypes::iterator AllObjectTypesIt;
 typedef std::vector<NamedReveal> VecNamedReveal;
 typedef VecNamedReveal::iterator VecNamedRevealIt;
 
+typedef std::hash_map<AsciiString, Script *, rts::hash<AsciiString>, rts::equal_to<AsciiString> > ScriptNameMap;
+typedef std::hash_map<AsciiString, ScriptGroup *, rts::hash<AsciiString>, rts::equal_to<AsciiString> > ScriptGroupNameMap;
+
 // TheSuperHackers @build xezon 17/03/2025 Fixes destructor visibility by removing MemoryPoolObject base class.
 // MemoryPoolObject looks to be unnecessary because it is never dynamically allocated.
 class AttackPriorityInfo : public Snapshot
@@ -288,6 +294,7 @@ public:
 	virtual void notifyOfAcquiredScience				( Int playerIndex, ScienceType science );
 
 	virtual void signalUIInteract(const AsciiString& hookName);	///< Notify that a UI button was pressed and some flag should go true, for one frame only.
+	void notifyOfNamedObjectChange( void ) { m_namedObjectsStamp = nextConditionStamp(); }	///< A named object died or came back to life
 
 	virtual Bool isVideoComplete( const AsciiString& completedVideo, Bool removeFromList );	///< Determine whether a video has completed
 	virtual Bool isSpeechComplete( const AsciiString& completedSpeech, Bool removeFromList );	///< Determine whether a speech has completed
@@ -346,6 +353,8 @@ public:
 	//Kris: Moved to public... so that I can refresh it when building abilities in script dialogs.
 	void createNamedCache( void );
 
+	void indexScripts( void );	///< Index the scripts and groups of all sides by name. Call again after adding scripts.
+
 	///Begin VTUNE
 	void setEnableVTune(Bool value);
 	Bool getEnableVTune() const;
@@ -388,6 +397,10 @@ protected:
 	void disableScript( ScriptAction *pAction );
 	void callSubroutine( ScriptAction *pAction );
 	void checkConditionsForTeamNames(Script *pScript);
+	UnsignedInt nextConditionStamp( void ) { return ++m_conditionStamp; }
+	void markCounterChanged( Int counterNdx );
+	void markFlagChanged( Int flagNdx );
+	Bool areConditionInputsUnchanged( Script *pScript );
 	Bool evaluateCounter( Condition *pCondition );
 	Bool evaluateFlag( Condition *pCondition );
 	Bool evaluateTimer( Condition *pCondition );
@@ -438,6 +451,20 @@ protected:
 	Team							*m_conditionTeam;				///< Team that is being used to evaluate conditions, used for THIS_TEAM
 	Object						*m_conditionObject;				///< Unit that is being used to evaluate conditions, used for THIS_OBJECT
 	VecNamedRequests	m_namedObjects;
+
+	// TheSuperHackers @performance The scripts and groups are looked up by name, instead of by walking all
+	// scripts of all sides.
+	ScriptNameMap			m_scriptsByName;
+	ScriptGroupNameMap m_groupsByName;
+	Bool							m_scriptsIndexed;
+
+	// TheSuperHackers @performance Every change to an input of the conditions that the engine keeps track of
+	// takes a new stamp. A script whose conditions only read such inputs keeps the result of its conditions
+	// until one of them changes. See areConditionInputsUnchanged.
+	UnsignedInt				m_conditionStamp;
+	UnsignedInt				m_allConditionsStamp;		///< Stamp of a change to inputs that are not tracked one by one
+	UnsignedInt				m_namedObjectsStamp;		///< Stamp of the last change to the named objects
+	UnsignedInt				m_uiInteractionsStamp;	///< Stamp of the last change to the UI interactions
 	Bool							m_firstUpdate;
 	Player						*m_currentPlayer;
 	Player						*m_skirmishHumanPlayer;
@@ -489,6 +516,10 @@ protected:
 	double						m_totalUpdateTime;
 	double						m_maxUpdateTime;
 	double						m_curUpdateTime;
+	double						m_conditionTypeTime[Condition::NUM_ITEMS];	///< Time spent to evaluate each type of condition
+	Int								m_conditionTypeCount[Condition::NUM_ITEMS];
+	Int								m_numConditionsEvaluated;
+	Int								m_numConditionsCached;		///< Evaluations of script conditions that used the kept result
 #endif
 #endif
 
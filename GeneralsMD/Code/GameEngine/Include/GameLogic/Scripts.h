@@ -632,6 +632,8 @@ protected:	// Note - If you add any member vars, you must take them into account
 	Real				m_conditionTime;		///< Amount of time (cum) to evaluate conditions.
 	Real				m_curTime;		///< Amount of time (cum) to evaluate conditions.
 	Int					m_conditionExecutedCount; ///< Number of times conditions evaluated.
+	Bool				m_conditionResult; ///< Runtime result of the conditions, kept by ScriptEngine while their inputs do not change.
+	UnsignedInt m_conditionResultStamp; ///< Script engine condition stamp when m_conditionResult was evaluated, 0 if never.
 
 public:
 	Script();
@@ -661,12 +663,15 @@ public:
 	void incrementConditionCount(void) {m_conditionExecutedCount++;}
 	void addToConditionTime(Real time) {m_conditionTime += time;}
 	void setCurTime(Real time) {m_curTime	= time;}
+	void setConditionResult(Bool result, UnsignedInt stamp) {m_conditionResult = result; m_conditionResultStamp = stamp;}
 	void setDelayEvalSeconds(Int delay) {m_delayEvaluationSeconds = delay;}
 
 	UnsignedInt getFrameToEvaluate(void) {return m_frameToEvaluateAt;}
 	Int getConditionCount(void) {return m_conditionExecutedCount;}
 	Real getConditionTime(void) {return m_conditionTime;}
 	Real getCurTime(void) {return m_curTime;}
+	Bool getConditionResult(void) const {return m_conditionResult;}
+	UnsignedInt getConditionResultStamp(void) const {return m_conditionResultStamp;}
 	Int getDelayEvalSeconds(void) {return m_delayEvaluationSeconds;}
 
 	AsciiString getName(void) const { return m_scriptName;}
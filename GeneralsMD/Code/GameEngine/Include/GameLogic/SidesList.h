@@ -272,6 +272,7 @@ protected:
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
+	virtual AsciiString getSnapshotName( void ) const { return "BuildListInfo"; }
 
 	AsciiString			m_buildingName;			///< The name of this building.
 	AsciiString			m_templateName;			///< The thing template name for this model's info.
@@ -36,6 +36,7 @@
 
 #include "Common/DamageFX.h"
 #include "Common/file.h"
+#include "Common/FilePrefetcher.h"
 #include "Common/FileSystem.h"
 #include "Common/GameAudio.h"
 #include "Common/Science.h"
@@ -179,8 +180,10 @@ Bool INI::isValidINIFilename( const char *filename )
 INI::INI( void )
 {
 
-	m_file							= NULL;
-  m_readBufferNext=m_readBufferUsed=0;
+	m_fileData					= NULL;
+	m_fileDataSize			= 0;
+	m_fileDataNext			= 0;
+	m_prefetcher				= NULL;
 	m_filename					= "None";
 	m_loadType					= INI_LOAD_INVALID;
 	m_lineNum						= 0;
@@ -261,6 +264,9 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 		TheFileSystem->getFileListInDirectory(dirName, "*.ini", filenameList, subdirs);
 		// Load the INI files in the dir now, in a sorted order.  This keeps things the same between machines
 		// in a network game.
+		std::vector<AsciiString> loadOrder;
+		loadOrder.reserve(filenameList.size());
+
 		FilenameList::const_iterator it = filenameList.begin();
 		while (it != filenameList.end())
 		{
@@ -269,7 +275,7 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 
 			if ((tempname.find('\\') == NULL) && (tempname.find('/') == NULL)) {
 				// this file doesn't reside in a subdirectory, load it first.
-				filesRead += load( *it, loadType, pXfer );
+				loadOrder.push_back(*it);
 			}
 			++it;
 		}
@@ -281,10 +287,40 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 			tempname = (*it).str() + dirName.getLength();
 
 			if ((tempname.find('\\') != NULL) || (tempname.find('/') != NULL)) {
-				filesRead += load( *it, loadType, pXfer );
+				loadOrder.push_back(*it);
 			}
 			++it;
 		}
+
+		// TheSuperHackers @performance Read the files on the worker threads of TheFilePrefetcher ahead of
+		// the parser. They are still parsed one after another in the order above. A directory that is
+		// loaded while another one is being loaded is not prefetched.
+		FilePrefetcher *prefetcher = NULL;
+		if( TheFilePrefetcher != NULL && !TheFilePrefetcher->isActive() )
+		{
+			prefetcher = TheFilePrefetcher;
+			prefetcher->start(loadOrder);
+		}
+		m_prefetcher = prefetcher;
+
+		try
+		{
+			for (size_t i = 0; i < loadOrder.size(); ++i)
+			{
+				filesRead += load( loadOrder[i], loadType, pXfer );
+			}
+		}
+		catch (...)
+		{
+			m_prefetcher = NULL;
+			if( prefetcher != NULL )
+				prefetcher->stop();
+			throw;
+		}
+
+		m_prefetcher = NULL;
+		if( prefetcher != NULL )
+			prefetcher->stop();
 	}
 	catch (...)
 	{
@@ -300,7 +336,7 @@ UnsignedInt INI::loadDirectory( AsciiString dirName, INILoadType loadType, Xfer
 void INI::prepFile( AsciiString filename, INILoadType loadType )
 {
 	// if we have a file open already -- we can't do another one
-	if( m_file != NULL )
+	if( m_fileData != NULL )
 	{
 
 		DEBUG_CRASH(( "INI::load, cannot open file '%s', file already open", filename.str() ));
@@ -308,9 +344,18 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 
 	}
 
+	// take the file if it was read ahead of time
+	if( m_prefetcher != NULL && m_prefetcher->takeFile( filename, m_fileData, m_fileDataSize ) )
+	{
+		m_fileDataNext = 0;
+		m_filename = filename;
+		m_loadType = loadType;
+		return;
+	}
+
 	// open the file
-	m_file = TheFileSystem->openFile(filename.str(), File::READ);
-	if( m_file == NULL )
+	File *file = TheFileSystem->openFile(filename.str(), File::READ);
+	if( file == NULL )
 	{
 
 		DEBUG_CRASH(( "INI::load, cannot open file '%s'", filename.str() ));
@@ -318,7 +363,12 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 
 	}
 
-	m_file = m_file->convertToRAMFile();
+	// TheSuperHackers @performance Take the whole file into memory up front so that readLine can
+	// scan for line ends in place rather than pulling every character through the File interface.
+	file = file->convertToRAMFile();
+	m_fileDataSize = file->size();
+	m_fileDataNext = 0;
+	m_fileData = file->readEntireAndClose();
 
 	// save our filename
 	m_filename = filename;
@@ -331,10 +381,11 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 //-------------------------------------------------------------------------------------------------
 void INI::unPrepFile()
 {
-	// close the file
-	m_file->close();
-	m_file = NULL;
-  m_readBufferUsed=m_readBufferNext=0;
+	// release the file contents
+	delete [] m_fileData;
+	m_fileData = NULL;
+	m_fileDataSize = 0;
+	m_fileDataNext = 0;
 	m_filename = "None";
 	m_loadType = INI_LOAD_INVALID;
 	m_lineNum = 0;
@@ -459,39 +510,34 @@ UnsignedInt INI::load( AsciiString filename, INILoadType loadType, Xfer *pXfer )
 void INI::readLine( void )
 {
 	// sanity
-	DEBUG_ASSERTCRASH( m_file, ("readLine(), file pointer is NULL") );
+	DEBUG_ASSERTCRASH( m_fileData, ("readLine(), file data is NULL") );
 
   if (m_endOfFile)
     *m_buffer=0;
   else
   {
+    // TheSuperHackers @performance Find the end of line with memchr in the file image and copy the
+    // line in one go. The resulting line must stay byte identical to what the old per character
+    // loop produced, because it is fed into the INI CRC below.
+    const char *src=m_fileData+m_fileDataNext;
+    UnsignedInt scanLen=m_fileDataSize-m_fileDataNext;
+    if (scanLen>INI_MAX_CHARS_PER_LINE)
+      scanLen=INI_MAX_CHARS_PER_LINE;
+
+    const char *eol=(const char *)memchr(src,'\n',scanLen);
+    UnsignedInt lineLen=eol ? (UnsignedInt)(eol-src) : scanLen;
+
+    memcpy(m_buffer,src,lineLen);
+    m_fileDataNext+=eol ? lineLen+1 : lineLen;
+
+    // EOF?
+    if (!eol && scanLen<INI_MAX_CHARS_PER_LINE)
+      m_endOfFile=true;
+
     char *p=m_buffer;
-    while (p!=m_buffer+INI_MAX_CHARS_PER_LINE)
+    char *end=m_buffer+lineLen;
+    for (; p!=end; p++)
     {
-      // get next character
-      if (m_readBufferNext==m_readBufferUsed)
-      {
-        // refill buffer
-        m_readBufferNext=0;
-        m_readBufferUsed=m_file->read(m_readBuffer,INI_READ_BUFFER);
-
-        // EOF?
-        if (!m_readBufferUsed)
-        {
-          m_endOfFile=true;
-          *p=0;
-          break;
-        }
-      }
-      *p=m_readBuffer[m_readBufferNext++];
-
-      // CR?
-      if (*p=='\n')
-      {
-        *p=0;
-        break;
-      }
-
       DEBUG_ASSERTCRASH(*p != '\t', ("tab characters are not allowed in INI files (%s). please check your editor settings. Line Number %d",m_filename.str(), getLineNum()));
 
       // comment?
@@ -500,7 +546,6 @@ void INI::readLine( void )
       // whitespace?
       else if (*p>0&&*p<32)
         *p=' ';
-      p++;
     }
     *p=0;
 
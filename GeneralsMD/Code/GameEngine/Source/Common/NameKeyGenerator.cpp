@@ -38,9 +38,11 @@ NameKeyGenerator::NameKeyGenerator()
 {
 
 	m_nextID = (UnsignedInt)NAMEKEY_INVALID;  // uninitialized system
+	m_arenaCursor = NULL;
+	m_arenaRemaining = 0;
 
 	for (Int i = 0; i < SOCKET_COUNT; ++i)
-		m_sockets[i] = NULL;
+		m_sockets[i] = NAMEKEY_INVALID;
 
 }
 
@@ -76,15 +78,16 @@ void NameKeyGenerator::reset()
 void NameKeyGenerator::freeSockets()
 {
 	for (Int i = 0; i < SOCKET_COUNT; ++i)
-	{
-		Bucket *next;
-		for (Bucket *b = m_sockets[i]; b; b = next)
-		{
-			next = b->m_nextInSocket;
-			deleteInstance(b);
-		}
-		m_sockets[i] = NULL;
-	}
+		m_sockets[i] = NAMEKEY_INVALID;
+
+	m_entries.clear();
+
+	for (size_t j = 0; j < m_arenaBlocks.size(); ++j)
+		delete [] m_arenaBlocks[j];
+
+	m_arenaBlocks.clear();
+	m_arenaCursor = NULL;
+	m_arenaRemaining = 0;
 
 }
 
@@ -111,14 +114,9 @@ inline UnsignedInt calcHashForLowercaseString(const char* p)
 //-------------------------------------------------------------------------------------------------
 AsciiString NameKeyGenerator::keyToName(NameKeyType key)
 {
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
-	{
-		for (Bucket *b = m_sockets[i]; b; b = b->m_nextInSocket)
-		{
-			if (key == b->m_key)
-				return b->m_nameString;
-		}
-	}
+	if (key > NAMEKEY_INVALID && (size_t)key < m_entries.size())
+		return AsciiString(m_entries[key].m_name);
+
 	return AsciiString::TheEmptyString;
 }
 
@@ -166,82 +164,93 @@ NameKeyType NameKeyGenerator::nameToLowercaseKey(const char *name)
 //-------------------------------------------------------------------------------------------------
 NameKeyType NameKeyGenerator::nameToKeyImpl(const char* nameString)
 {
-	Bucket *b;
-
 	UnsignedInt hash = calcHashForString(nameString) % SOCKET_COUNT;
 
 	// hmm, do we have it already?
-	for (b = m_sockets[hash]; b; b = b->m_nextInSocket)
+	for (NameKeyType key = m_sockets[hash]; key != NAMEKEY_INVALID; key = m_entries[key].m_nextInSocket)
 	{
-		if (strcmp(nameString, b->m_nameString.str()) == 0)
-			return b->m_key;
+		if (strcmp(nameString, m_entries[key].m_name) == 0)
+			return key;
 	}
 
 	// nope, guess not. let's allocate it.
-	b = newInstance(Bucket);
-	b->m_key = (NameKeyType)m_nextID++;
-	b->m_nameString = nameString;
-	b->m_nextInSocket = m_sockets[hash];
-	m_sockets[hash] = b;
+	return addName(nameString, hash);
+}
 
-	NameKeyType result = b->m_key;
+//-------------------------------------------------------------------------------------------------
+NameKeyType NameKeyGenerator::nameToLowercaseKeyImpl(const char* nameString)
+{
+	UnsignedInt hash = calcHashForLowercaseString(nameString) % SOCKET_COUNT;
 
-#if defined(RTS_DEBUG)
-	// reality-check to be sure our hasher isn't going bad.
-	const Int maxThresh = 3;
-	Int numOverThresh = 0;
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
+	// hmm, do we have it already?
+	for (NameKeyType key = m_sockets[hash]; key != NAMEKEY_INVALID; key = m_entries[key].m_nextInSocket)
 	{
-		Int numInThisSocket = 0;
-		for (b = m_sockets[i]; b; b = b->m_nextInSocket)
-			++numInThisSocket;
-
-		if (numInThisSocket > maxThresh)
-			++numOverThresh;
+		if (_stricmp(nameString, m_entries[key].m_name) == 0)
+			return key;
 	}
 
-	// if more than a small percent of the sockets are getting deep, probably want to increase the socket count.
-	if (numOverThresh > SOCKET_COUNT/20)
+	// nope, guess not. let's allocate it.
+	return addName(nameString, hash);
+}
+
+//-------------------------------------------------------------------------------------------------
+NameKeyType NameKeyGenerator::addName(const char* nameString, UnsignedInt socket)
+{
+	if (m_entries.empty())
 	{
-		DEBUG_CRASH(("hmm, might need to increase the number of bucket-sockets for NameKeyGenerator (numOverThresh %d = %f%%)",numOverThresh,(Real)numOverThresh/(Real)(SOCKET_COUNT/20)));
+		Entry invalidEntry;
+		invalidEntry.m_name = "";
+		invalidEntry.m_nextInSocket = NAMEKEY_INVALID;
+		m_entries.push_back(invalidEntry);
 	}
+
+	const NameKeyType result = (NameKeyType)m_nextID++;
+	DEBUG_ASSERTCRASH(m_entries.size() == (size_t)result, ("NameKeyGenerator entries are out of step with the keys"));
+
+	Entry entry;
+	entry.m_name = copyToArena(nameString);
+	entry.m_nextInSocket = m_sockets[socket];
+	m_entries.push_back(entry);
+	m_sockets[socket] = result;
+
+#if defined(RTS_DEBUG)
+	checkSockets();
 #endif
 
 	return result;
-
 }
 
 //-------------------------------------------------------------------------------------------------
-NameKeyType NameKeyGenerator::nameToLowercaseKeyImpl(const char* nameString)
+const char* NameKeyGenerator::copyToArena(const char* nameString)
 {
-	Bucket *b;
-
-	UnsignedInt hash = calcHashForLowercaseString(nameString) % SOCKET_COUNT;
-
-	// hmm, do we have it already?
-	for (b = m_sockets[hash]; b; b = b->m_nextInSocket)
+	const UnsignedInt size = (UnsignedInt)strlen(nameString) + 1;
+	if (size > m_arenaRemaining)
 	{
-		if (_stricmp(nameString, b->m_nameString.str()) == 0)
-			return b->m_key;
+		// the rest of the last block is left unused. a name longer than a block gets a block of its own.
+		const UnsignedInt blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+		m_arenaCursor = MSGNEW("NameKeyArena") char[blockSize];
+		m_arenaRemaining = blockSize;
+		m_arenaBlocks.push_back(m_arenaCursor);
 	}
 
-	// nope, guess not. let's allocate it.
-	b = newInstance(Bucket);
-	b->m_key = (NameKeyType)m_nextID++;
-	b->m_nameString = nameString;
-	b->m_nextInSocket = m_sockets[hash];
-	m_sockets[hash] = b;
-
-	NameKeyType result = b->m_key;
+	char* name = m_arenaCursor;
+	memcpy(name, nameString, size);
+	m_arenaCursor += size;
+	m_arenaRemaining -= size;
+	return name;
+}
 
 #if defined(RTS_DEBUG)
+//-------------------------------------------------------------------------------------------------
+void NameKeyGenerator::checkSockets()
+{
 	// reality-check to be sure our hasher isn't going bad.
 	const Int maxThresh = 3;
 	Int numOverThresh = 0;
 	for (Int i = 0; i < SOCKET_COUNT; ++i)
 	{
 		Int numInThisSocket = 0;
-		for (b = m_sockets[i]; b; b = b->m_nextInSocket)
+		for (NameKeyType key = m_sockets[i]; key != NAMEKEY_INVALID; key = m_entries[key].m_nextInSocket)
 			++numInThisSocket;
 
 		if (numInThisSocket > maxThresh)
@@ -253,11 +262,8 @@ NameKeyType NameKeyGenerator::nameToLowercaseKeyImpl(const char* nameString)
 	{
 		DEBUG_CRASH(("hmm, might need to increase the number of bucket-sockets for NameKeyGenerator (numOverThresh %d = %f%%)",numOverThresh,(Real)numOverThresh/(Real)(SOCKET_COUNT/20)));
 	}
-#endif
-
-	return result;
-
 }
+#endif
 
 //-------------------------------------------------------------------------------------------------
 // Get a string out of the INI. Store it into a NameKeyType
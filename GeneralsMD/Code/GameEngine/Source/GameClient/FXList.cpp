@@ -804,6 +804,11 @@ void FXList::clear()
 //-------------------------------------------------------------------------------------------------
 void FXList::doFXPos(const Coord3D *primary, const Matrix3D* primaryMtx, const Real primarySpeed, const Coord3D *secondary, const Real overrideRadius ) const
 {
+	// TheSuperHackers @performance The effects are client only and never seen in headless mode.
+	// The shroud test below shows that the game logic cannot depend on them.
+	if (TheGlobalData->m_headless)
+		return;
+
 	const Int playerIndex = rts::getObservedOrLocalPlayer()->getPlayerIndex();
 
 	if (ThePartitionManager->getShroudStatusForPlayer(playerIndex, primary) != CELLSHROUD_CLEAR)
@@ -818,6 +823,9 @@ void FXList::doFXPos(const Coord3D *primary, const Matrix3D* primaryMtx, const R
 //-------------------------------------------------------------------------------------------------
 void FXList::doFXObj(const Object* primary, const Object* secondary) const
 {
+	if (TheGlobalData->m_headless)
+		return;
+
 	const Int playerIndex = rts::getObservedOrLocalPlayer()->getPlayerIndex();
 
 	if (primary && primary->getShroudedStatus(playerIndex) > OBJECTSHROUD_PARTIAL_CLEAR)
@@ -1658,6 +1658,10 @@ void AIGroup::groupMoveToPosition( const Coord3D *p_posIn, Bool addWaypoint, Com
 
 
 
+#if USE_GROUP_FLOW_FIELDS
+	TheAI->pathfinder()->addGroupMoveGoal(pos, getID(), (Int)m_memberListSize);
+#endif
+
 	if (tightenGroup)
 	{
 		isFormation = false;
@@ -1118,6 +1118,7 @@ void Pathfinder::forceCleanCells()
 {
 	PathfindCellInfo::forceCleanPathFindCellInfos();
 	m_openList = NULL;
+	PathfindCell::resetOpenListIndex();
 	m_closedList = NULL;
 
 	for (int j = 0; j <= m_extent.hi.y; ++j) {
@@ -1550,11 +1551,148 @@ Bool PathfindCell::removeObstacle( Object *obstacle )
 	return true;
 }
 
+// TheSuperHackers @performance The open list stays a doubly linked list sorted by total cost, so cells
+// are searched in the same order as before, but it is now indexed by cost and insertion no longer walks
+// the list. For every cost on the list the index keeps the last cell with that cost, and a three level
+// bitmap of the costs present finds the largest cost at or below a given one in a few steps. A new cell
+// goes right after that cell, which is where the insertion sort put it, behind all cells of equal cost.
+// The index describes the list starting at s_openListIndexHead. The searches also set the head of the
+// list directly, so it is rebuilt from the list whenever it is handed a different head.
+enum
+{
+	OPEN_LIST_COSTS = 0x10000,
+	OPEN_LIST_COST_WORDS = OPEN_LIST_COSTS / 32,
+	OPEN_LIST_WORD_WORDS = OPEN_LIST_COST_WORDS / 32,
+	OPEN_LIST_GROUP_WORDS = OPEN_LIST_WORD_WORDS / 32
+};
+
+static PathfindCellInfo *s_openListTails[OPEN_LIST_COSTS];				///< last cell with each cost, valid while the cost bit is set
+static UnsignedInt s_openListCostBits[OPEN_LIST_COST_WORDS];			///< one bit per cost on the list
+static UnsignedInt s_openListWordBits[OPEN_LIST_WORD_WORDS];			///< one bit per non zero word of s_openListCostBits
+static UnsignedInt s_openListGroupBits[OPEN_LIST_GROUP_WORDS];		///< one bit per non zero word of s_openListWordBits
+static PathfindCell *s_openListIndexHead = NULL;									///< the open list the index describes
+
+static inline Int highestBit( UnsignedInt bits )
+{
+	Int bit = 0;
+	if (bits & 0xffff0000) { bits >>= 16; bit += 16; }
+	if (bits & 0x0000ff00) { bits >>= 8; bit += 8; }
+	if (bits & 0x000000f0) { bits >>= 4; bit += 4; }
+	if (bits & 0x0000000c) { bits >>= 2; bit += 2; }
+	if (bits & 0x00000002) { bit += 1; }
+	return bit;
+}
+
+/// mask of the bits at and below the given bit
+static inline UnsignedInt bitsUpTo( Int bit )
+{
+	return bit >= 31 ? 0xffffffff : ((2u << bit) - 1);
+}
+
+/// mask of the bits below the given bit
+static inline UnsignedInt bitsBelow( Int bit )
+{
+	return (1u << bit) - 1;
+}
+
+/// forget the cost index of the open list
+void PathfindCell::resetOpenListIndex( void )
+{
+	memset(s_openListCostBits, 0, sizeof(s_openListCostBits));
+	memset(s_openListWordBits, 0, sizeof(s_openListWordBits));
+	memset(s_openListGroupBits, 0, sizeof(s_openListGroupBits));
+	s_openListIndexHead = NULL;
+}
+
+/// make the cost index describe the given open list
+void PathfindCell::syncOpenListIndex( PathfindCell *list )
+{
+	if (list == s_openListIndexHead)
+		return;
+
+	resetOpenListIndex();
+	if (list == NULL || list->m_info == NULL)
+		return;
+
+	for (PathfindCellInfo *info = list->m_info; info; info = info->m_nextOpen)
+	{
+		info->m_openCost = info->m_totalCost;
+		addToOpenListIndex(info);
+	}
+	s_openListIndexHead = list;
+}
+
+/// return the last cell on the open list with the largest cost at or below the given one, if any
+PathfindCellInfo *PathfindCell::findOpenListTail( UnsignedShort cost )
+{
+	Int word = cost >> 5;
+	UnsignedInt bits = s_openListCostBits[word] & bitsUpTo(cost & 31);
+	if (bits == 0)
+	{
+		Int group = word >> 5;
+		bits = s_openListWordBits[group] & bitsBelow(word & 31);
+		if (bits == 0)
+		{
+			Int superGroup = group >> 5;
+			bits = s_openListGroupBits[superGroup] & bitsBelow(group & 31);
+			while (bits == 0)
+			{
+				if (superGroup == 0)
+					return NULL;
+				bits = s_openListGroupBits[--superGroup];
+			}
+			group = (superGroup << 5) + highestBit(bits);
+			bits = s_openListWordBits[group];
+		}
+		word = (group << 5) + highestBit(bits);
+		bits = s_openListCostBits[word];
+	}
+	return s_openListTails[(word << 5) + highestBit(bits)];
+}
+
+/// record a cell that was just linked in behind all cells of equal cost
+void PathfindCell::addToOpenListIndex( PathfindCellInfo *info )
+{
+	const Int cost = info->m_openCost;
+	s_openListTails[cost] = info;
+	s_openListCostBits[cost >> 5] |= 1u << (cost & 31);
+	s_openListWordBits[cost >> 10] |= 1u << ((cost >> 5) & 31);
+	s_openListGroupBits[cost >> 15] |= 1u << ((cost >> 10) & 31);
+}
+
+/// drop a cell that is about to be unlinked
+void PathfindCell::removeFromOpenListIndex( PathfindCellInfo *info )
+{
+	const Int cost = info->m_openCost;
+	const Int word = cost >> 5;
+	const UnsignedInt bit = 1u << (cost & 31);
+	if ((s_openListCostBits[word] & bit) == 0 || s_openListTails[cost] != info)
+		return;
+
+	if (info->m_prevOpen && info->m_prevOpen->m_openCost == cost)
+	{
+		s_openListTails[cost] = info->m_prevOpen;
+		return;
+	}
+
+	s_openListCostBits[word] &= ~bit;
+	if (s_openListCostBits[word] == 0)
+	{
+		const Int group = word >> 5;
+		s_openListWordBits[group] &= ~(1u << (word & 31));
+		if (s_openListWordBits[group] == 0)
+		{
+			s_openListGroupBits[group >> 5] &= ~(1u << (group & 31));
+		}
+	}
+}
+
 /// put self on "open" list in ascending cost order, return new list
 PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
 {
 	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
 	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
+	syncOpenListIndex(list);
 	if (list == NULL)
 	{
 		list = this;
@@ -1563,9 +1701,16 @@ PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
 	}
 	else
 	{
-		// insertion sort
-		PathfindCell *c, *lastCell = NULL;
-		for( c = list; c; c = c->getNextOpen() )
+		// insertion sort, starting behind the last cell that does not cost more
+		PathfindCell *c = list, *lastCell = NULL;
+		PathfindCellInfo *tail = findOpenListTail(m_info->m_totalCost);
+		if (tail)
+		{
+			lastCell = tail->m_cell;
+			c = tail->m_nextOpen ? tail->m_nextOpen->m_cell : NULL;
+		}
+
+		for( ; c; c = c->getNextOpen() )
 		{
 			if (c->m_info->m_totalCost > m_info->m_totalCost)
 				break;
@@ -1596,6 +1741,10 @@ PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
 		}
 	}
 
+	m_info->m_openCost = m_info->m_totalCost;
+	addToOpenListIndex(m_info);
+	s_openListIndexHead = list;
+
 	// mark newCell as being on open list
 	m_info->m_open = true;
 	m_info->m_closed = false;
@@ -1608,6 +1757,12 @@ PathfindCell *PathfindCell::removeFromOpenList( PathfindCell *list )
 {
 	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
 	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
+	syncOpenListIndex(list);
+	// a cell without a predecessor that is not the head is not on this list, and unlinking it
+	// replaces the list, so the index has to be rebuilt
+	const Bool onList = m_info->m_prevOpen != NULL || list == this;
+	removeFromOpenListIndex(m_info);
+
 	if (m_info->m_nextOpen)
 		m_info->m_nextOpen->m_prevOpen = m_info->m_prevOpen;
 
@@ -1620,6 +1775,11 @@ PathfindCell *PathfindCell::removeFromOpenList( PathfindCell *list )
 	m_info->m_nextOpen = NULL;
 	m_info->m_prevOpen = NULL;
 
+	if (onList)
+		s_openListIndexHead = list;
+	else
+		resetOpenListIndex();
+
 	return list;
 }
 
@@ -1627,6 +1787,7 @@ PathfindCell *PathfindCell::removeFromOpenList( PathfindCell *list )
 Int PathfindCell::releaseOpenList( PathfindCell *list )
 {
 	Int count = 0;
+	resetOpenListIndex();
 	while (list) {
 		count++;
 		DEBUG_ASSERTCRASH(list->m_info, ("Has to have info."));
@@ -2022,6 +2183,125 @@ inline void applyBlockZone(PathfindCell &targetCell, const PathfindCell &sourceC
 
 }
 
+#if USE_INCREMENTAL_PATHFIND_ZONES || USE_HIERARCHICAL_ROUTE_CACHE
+static inline Bool isBlockInRegion( Int blockX, Int blockY, const IRegion2D &blocks )
+{
+	return blockX >= blocks.lo.x && blockX <= blocks.hi.x && blockY >= blocks.lo.y && blockY <= blocks.hi.y;
+}
+#endif
+
+#if USE_INCREMENTAL_PATHFIND_ZONES
+// The cells of a zone block, bounded as calculateZones bounds them.
+static void getZoneBlockBounds( Int xBlock, Int yBlock, const IRegion2D &globalBounds, IRegion2D &bounds )
+{
+	bounds.lo.x = globalBounds.lo.x + xBlock*PathfindZoneManager::ZONE_BLOCK_SIZE;
+	bounds.lo.y = globalBounds.lo.y + yBlock*PathfindZoneManager::ZONE_BLOCK_SIZE;
+	bounds.hi.x = bounds.lo.x + PathfindZoneManager::ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
+	bounds.hi.y = bounds.lo.y + PathfindZoneManager::ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
+	if (bounds.hi.x > globalBounds.hi.x) {
+		bounds.hi.x = globalBounds.hi.x;
+	}
+	if (bounds.hi.y > globalBounds.hi.y) {
+		bounds.hi.y = globalBounds.hi.y;
+	}
+}
+
+// Follow the links of a zone to the zone at their end, shortening them on the way.
+static inline Int findRootZone( zoneStorageType *zones, Int zone )
+{
+	while (zones[zone] != zone) {
+		zones[zone] = zones[zones[zone]];
+		zone = zones[zone];
+	}
+	return zone;
+}
+
+// Link two zones, so that both end at the lower of their two roots, as resolveZones keeps the lower zone.
+static inline void joinZones( zoneStorageType *zones, Int zone1, Int zone2 )
+{
+	zone1 = findRootZone(zones, zone1);
+	zone2 = findRootZone(zones, zone2);
+	if (zone1 < zone2) {
+		zones[zone2] = zone1;
+	} else if (zone2 < zone1) {
+		zones[zone1] = zone2;
+	}
+}
+
+// Point every zone straight at its root. Zones only link to lower zones, so the links of the zones
+// below are straight already when a zone gets to them.
+static void straightenZones( zoneStorageType *zones, Int sizeOfZones )
+{
+	Int i;
+	for (i=0; i<sizeOfZones; i++) {
+		zones[i] = zones[zones[i]];
+	}
+}
+
+/* Comes to the same table as flattenZones. Rather than going over the whole table each time resolveZones
+combines two zones, the zones the entries of the table hold are linked in values, where each zone leads
+to the zone that the entries that held it hold now. */
+static void flattenZonesQuickly( zoneStorageType *zoneArray, const zoneStorageType *zoneHierarchical, Int sizeOfZones,
+																std::vector<zoneStorageType> &values )
+{
+	Int i;
+	for (i=0; i<sizeOfZones; i++) {
+		Int zone1 = zoneArray[i];
+		Int zone2 = zoneHierarchical[zone1];
+		zone1 = zoneArray[zone2];
+		zone2 = zoneHierarchical[zone1];
+		zoneArray[i] = zone2;
+	}
+
+	values.resize(sizeOfZones);
+	zoneStorageType *value = &values[0];
+	for (i=0; i<sizeOfZones; i++) {
+		value[i] = i;
+	}
+	for (i=0; i<sizeOfZones; i++) {
+		Int zone1 = findRootZone(value, zoneArray[i]);
+		Int zone2 = zoneHierarchical[i];
+		if (zone1!=zone2) {
+			// resolveZones(zone1, zone2, zoneArray, sizeOfZones)
+			Int srcZone = findRootZone(value, zoneArray[zone1]);
+			Int targetZone = findRootZone(value, zoneArray[zone2]);
+			Int finalZone = findRootZone(value, zoneArray[targetZone<srcZone ? targetZone : srcZone]);
+			value[srcZone] = finalZone;
+			value[targetZone] = finalZone;
+		}
+	}
+	for (i=0; i<sizeOfZones; i++) {
+		zoneArray[i] = findRootZone(value, zoneArray[i]);
+	}
+}
+
+// The tables calculateZones links the zones of two neighboring cells in.
+static UnsignedByte getZoneLinkTables( const PathfindCell &cell, const PathfindCell &neighbor, Bool leftNeighbor )
+{
+	if (cell.getType() == neighbor.getType()) {
+		return PathfindZoneLink::HIERARCHICAL;
+	}
+	UnsignedByte tables = 0;
+	if (terrain(cell, neighbor)) {
+		tables |= PathfindZoneLink::TERRAIN;
+	}
+	if (crusherGround(cell, neighbor)) {
+		tables |= PathfindZoneLink::CRUSHER;
+	}
+	if (leftNeighbor && tables != 0) {
+		return tables; // calculateZones skips the rest for the left neighbor.
+	}
+	if (waterGround(cell, neighbor)) {
+		tables |= PathfindZoneLink::GROUND_WATER;
+	} else if (groundRubble(cell, neighbor)) {
+		tables |= PathfindZoneLink::GROUND_RUBBLE;
+	} else if (groundCliff(cell, neighbor)) {
+		tables |= PathfindZoneLink::GROUND_CLIFF;
+	}
+	return tables;
+}
+#endif
+
 //------------------------  ZoneBlock  -------------------------------
 ZoneBlock::ZoneBlock() : m_firstZone(0),
 m_numZones(0),
@@ -2219,6 +2499,78 @@ void ZoneBlock::allocateZones(void)
 }
 
 
+#if USE_INCREMENTAL_PATHFIND_ZONES
+/* Move the zones of this block, after the blocks before it got more or fewer zones. */
+void ZoneBlock::offsetZones(Int offset)
+{
+	m_firstZone = (zoneStorageType)(m_firstZone + offset);
+	if (m_groundCliffZones == NULL) {
+		return;
+	}
+	Int i;
+	for (i=0; i<m_zonesAllocated; i++) {
+		m_groundCliffZones[i] = (zoneStorageType)(m_groundCliffZones[i] + offset);
+		m_groundWaterZones[i] = (zoneStorageType)(m_groundWaterZones[i] + offset);
+		m_groundRubbleZones[i] = (zoneStorageType)(m_groundRubbleZones[i] + offset);
+		m_crusherZones[i] = (zoneStorageType)(m_crusherZones[i] + offset);
+	}
+}
+
+void ZoneBlock::addLink(zoneStorageType zone, zoneStorageType otherZone, UnsignedByte tables)
+{
+	for (size_t i=0; i<m_links.size(); i++) {
+		if (m_links[i].m_zone == zone && m_links[i].m_otherZone == otherZone) {
+			m_links[i].m_tables |= tables;
+			return;
+		}
+	}
+	PathfindZoneLink link;
+	link.m_zone = zone;
+	link.m_otherZone = otherZone;
+	link.m_tables = tables;
+	m_links.push_back(link);
+}
+
+/* Find the zones calculateZones links the zones of this block with, from each cell to the cells
+to its left and above it, and to the bridge it connects to. */
+void ZoneBlock::blockCalculateLinks(PathfindCell **map, PathfindLayer layers[], const IRegion2D &bounds, const IRegion2D &globalBounds)
+{
+	m_links.clear();
+	Int i, j;
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			const PathfindCell &cell = map[i][j];
+			if ( (cell.getConnectLayer() > LAYER_GROUND) &&
+				(cell.getType() == PathfindCell::CELL_CLEAR) ) {
+				addLink(cell.getZone(), (zoneStorageType)layers[cell.getConnectLayer()].getZone(), PathfindZoneLink::HIERARCHICAL);
+			}
+			if (i>globalBounds.lo.x && cell.getZone()!=map[i-1][j].getZone()) {
+				UnsignedByte tables = getZoneLinkTables(cell, map[i-1][j], TRUE);
+				if (tables != 0) {
+					addLink(cell.getZone(), map[i-1][j].getZone(), tables);
+				}
+			}
+			if (j>globalBounds.lo.y && cell.getZone()!=map[i][j-1].getZone()) {
+				UnsignedByte tables = getZoneLinkTables(cell, map[i][j-1], FALSE);
+				if (tables != 0) {
+					addLink(cell.getZone(), map[i][j-1].getZone(), tables);
+				}
+			}
+		}
+	}
+}
+
+/* Move the links along with the zones, after the zones of other blocks were updated. */
+void ZoneBlock::renumberLinks(const zoneStorageType *newZones)
+{
+	for (size_t i=0; i<m_links.size(); i++) {
+		m_links[i].m_zone = newZones[m_links[i].m_zone];
+		m_links[i].m_otherZone = newZones[m_links[i].m_otherZone];
+		DEBUG_ASSERTCRASH(m_links[i].m_zone != 0 && m_links[i].m_otherZone != 0, ("Zone link into a block that was rezoned."));
+	}
+}
+#endif
+
 //------------------------  PathfindZoneManager  -------------------------------
 PathfindZoneManager::PathfindZoneManager() : m_maxZone(0),
 m_nextFrameToCalculateZones(0),
@@ -2234,6 +2586,18 @@ m_zonesAllocated(0)
 {
 	m_zoneBlockExtent.x = 0;
 	m_zoneBlockExtent.y = 0;
+
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	m_linksCalculated = FALSE;
+#endif
+
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	m_routeClock = 0;
+	m_routeCacheHits = 0;
+	m_routeCacheMisses = 0;
+	m_routeCacheCellsSaved = 0;
+	clearRoutes();
+#endif
 }
 
 PathfindZoneManager::~PathfindZoneManager()
@@ -2322,12 +2686,17 @@ void PathfindZoneManager::reset(void)  ///< Called when the map is reset.
 {
 	freeZones();
 	freeBlocks();
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	m_linksCalculated = FALSE;
+#endif
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	clearRoutes();
+#endif
 }
 
 
 void PathfindZoneManager::markZonesDirty( Bool insert )  ///< Called when the zones need to be recalculated.
 {
-
 	if (TheGameLogic->getFrame()<2) {
 		m_nextFrameToCalculateZones = 2;
 		return;
@@ -2363,8 +2732,16 @@ void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer laye
 #endif
 #endif
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	// zones are numbered anew, so the cached zones mean nothing any more.
+	clearRoutes();
+#endif
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	m_linksCalculated = FALSE;
+#endif
+
 	m_maxZone = 1;	// we start using zone 0 as a flag.
-	const Int maxZones=24000;
+	const Int maxZones=MAX_ZONES;
 	zoneStorageType zoneEquivalency[maxZones];
 	Int i, j;
 	for (i=0; i<maxZones; i++) {
@@ -2700,6 +3077,10 @@ void PathfindZoneManager::updateZonesForModify(PathfindCell **map, PathfindLayer
 		bounds.hi.y = globalBounds.hi.y;
 	}
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	invalidateRoutes(bounds);
+#endif
+
 	Int xBlock, yBlock;
 	for (xBlock = 0; xBlock<m_zoneBlockExtent.x; xBlock++) {
 		for (yBlock=0; yBlock<m_zoneBlockExtent.y; yBlock++) {
@@ -2811,9 +3192,354 @@ void PathfindZoneManager::updateZonesForModify(PathfindCell **map, PathfindLayer
 			}
 		}
 	}
-#endif
+#endif
+
+}
+
+#if USE_INCREMENTAL_PATHFIND_ZONES
+/**
+ * TheSuperHackers @performance Rezone the zone blocks with cells that changed type, when a structure
+ * was placed or removed. Those blocks get their zones anew, and the zones of the blocks after them move,
+ * so that all zones are numbered as calculateZones numbers them. The equivalency tables are then linked
+ * from the zone links the blocks keep, which only the rezoned blocks and their neighbors to the right and
+ * below have to find again. This comes to the same zones and tables as calculateZones, without looking at
+ * every cell of the map, and without the frame processPathfindQueue spends on calculateZones.
+ */
+void PathfindZoneManager::updateZoneBlocks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &cellBounds, const IRegion2D &globalBounds )
+{
+	if (m_nextFrameToCalculateZones != 0xffffffff) {
+		return; // all zones are calculated anew soon.
+	}
+
+	IRegion2D bounds = cellBounds;
+	if (bounds.lo.x < globalBounds.lo.x) {
+		bounds.lo.x = globalBounds.lo.x;
+	}
+	if (bounds.lo.y < globalBounds.lo.y) {
+		bounds.lo.y = globalBounds.lo.y;
+	}
+	if (bounds.hi.x > globalBounds.hi.x) {
+		bounds.hi.x = globalBounds.hi.x;
+	}
+	if (bounds.hi.y > globalBounds.hi.y) {
+		bounds.hi.y = globalBounds.hi.y;
+	}
+	if (bounds.lo.x > bounds.hi.x || bounds.lo.y > bounds.hi.y) {
+		return;
+	}
+
+	if (!m_linksCalculated) {
+		calculateLinks(map, layers, globalBounds);
+	}
+
+	IRegion2D blocks;
+	blocks.lo.x = (bounds.lo.x - globalBounds.lo.x)/ZONE_BLOCK_SIZE;
+	blocks.lo.y = (bounds.lo.y - globalBounds.lo.y)/ZONE_BLOCK_SIZE;
+	blocks.hi.x = (bounds.hi.x - globalBounds.lo.x)/ZONE_BLOCK_SIZE;
+	blocks.hi.y = (bounds.hi.y - globalBounds.lo.y)/ZONE_BLOCK_SIZE;
+
+	// The cells to the right of and below the rezoned blocks link to their zones.
+	IRegion2D linkBlocks = blocks;
+	if (linkBlocks.hi.x < m_zoneBlockExtent.x-1) {
+		linkBlocks.hi.x++;
+	}
+	if (linkBlocks.hi.y < m_zoneBlockExtent.y-1) {
+		linkBlocks.hi.y++;
+	}
+
+	const Int oldMaxZone = m_maxZone;
+	m_newZones.resize(oldMaxZone);
+	m_newZones[UNINITIALIZED_ZONE] = UNINITIALIZED_ZONE;
+	m_zoneBlockOffsets.resize(m_zoneBlockExtent.x*m_zoneBlockExtent.y);
+
+	// The zones are numbered block by block, in the order calculateZones goes through the blocks.
+	Bool zonesMoved = FALSE;
+	Int oldZone = 1;
+	Int newZone = 1;
+	Int xBlock, yBlock;
+	Int i, j, zone;
+	for (xBlock = 0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock = 0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			ZoneBlock &block = m_zoneBlocks[xBlock][yBlock];
+			const Int firstZone = block.getFirstZone();
+			const Int numZones = block.getNumZones();
+			const Int offset = newZone - firstZone;
+			DEBUG_ASSERTCRASH(firstZone == oldZone, ("Zone blocks are not numbered in order."));
+
+			IRegion2D blockBounds;
+			getZoneBlockBounds(xBlock, yBlock, globalBounds, blockBounds);
+			if (isBlockInRegion(xBlock, yBlock, blocks)) {
+				// Every cell of the block could become a zone of its own.
+				const Int maxBlockZones = (blockBounds.hi.x-blockBounds.lo.x+1)*(blockBounds.hi.y-blockBounds.lo.y+1);
+				if (newZone + maxBlockZones + (oldMaxZone-oldZone) - numZones >= MAX_ZONES) {
+					DEBUG_CRASH(("Ran out of pathfind zones.  SERIOUS ERROR!"));
+					// calculateZones zones every cell anew, whatever was rezoned so far.
+					calculateZones(map, layers, globalBounds);
+					return;
+				}
+				for (zone = firstZone; zone < firstZone+numZones; zone++) {
+					m_newZones[zone] = UNINITIALIZED_ZONE;
+				}
+				newZone += labelBlockZones(map, blockBounds, block, newZone);
+				block.blockCalculateZones(map, layers, blockBounds);
+			} else {
+				for (zone = firstZone; zone < firstZone+numZones; zone++) {
+					m_newZones[zone] = (zoneStorageType)(zone + offset);
+				}
+				if (offset != 0) {
+					for( j=blockBounds.lo.y; j<=blockBounds.hi.y; j++ )	{
+						for( i=blockBounds.lo.x; i<=blockBounds.hi.x; i++ )	{
+							map[i][j].setZone((zoneStorageType)(map[i][j].getZone() + offset));
+						}
+					}
+					block.offsetZones(offset);
+					zonesMoved = TRUE;
+				}
+				newZone += numZones;
+			}
+			m_zoneBlockOffsets[xBlock*m_zoneBlockExtent.y + yBlock] = offset;
+			oldZone += numZones;
+		}
+	}
+
+	// The bridge layers have the zones after the blocks.
+	DEBUG_ASSERTCRASH(oldMaxZone - oldZone == LAYER_LAST+1, ("Unexpected number of layer zones."));
+	const Int layerOffset = newZone - oldZone;
+	for (zone = oldZone; zone < oldMaxZone; zone++) {
+		m_newZones[zone] = (zoneStorageType)(zone + layerOffset);
+	}
+	if (layerOffset != 0) {
+		for (i=0; i<=LAYER_LAST; i++) {
+			layers[i].setZone(layers[i].getZone() + layerOffset);
+			layers[i].applyZone();
+		}
+		zonesMoved = TRUE;
+	}
+	m_maxZone = oldMaxZone + layerOffset;
+
+	// The blocks the bridges end in interact with them, as calculateZones marks them.
+	for (i=0; i<=LAYER_LAST; i++) {
+		if (!layers[i].isUnused() && !layers[i].isDestroyed()) {
+			ICoord2D ndx;
+			layers[i].getStartCellIndex(&ndx);
+			setBridge(ndx.x, ndx.y, true);
+			layers[i].getEndCellIndex(&ndx);
+			setBridge(ndx.x, ndx.y, true);
+		}
+	}
+
+	for (xBlock = 0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock = 0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			ZoneBlock &block = m_zoneBlocks[xBlock][yBlock];
+			if (isBlockInRegion(xBlock, yBlock, linkBlocks)) {
+				IRegion2D blockBounds;
+				getZoneBlockBounds(xBlock, yBlock, globalBounds, blockBounds);
+				block.blockCalculateLinks(map, layers, blockBounds, globalBounds);
+			} else if (zonesMoved) {
+				block.renumberLinks(&m_newZones[0]);
+			}
+		}
+	}
+	linkZoneTables();
+
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	invalidateRoutes(bounds);
+	if (zonesMoved) {
+		renumberRoutes();
+	}
+#endif
+
+#if defined(RTS_DEBUG)
+	verifyZoneBlocks(map, layers, globalBounds);
+#endif
+}
+
+/* Zone the cells of one block, numbering the zones from firstZone in the order their first cells come,
+as calculateZones numbers them. Returns the number of zones. */
+Int PathfindZoneManager::labelBlockZones( PathfindCell **map, const IRegion2D &bounds, ZoneBlock &block, Int firstZone )
+{
+	zoneStorageType zoneEquivalency[ZONE_BLOCK_SIZE*ZONE_BLOCK_SIZE+1];
+	zoneStorageType collapsedZones[ZONE_BLOCK_SIZE*ZONE_BLOCK_SIZE+1];
+	Int totalZones = 1;	// we start using zone 0 as a flag.
+	Int i, j;
+
+	block.setInteractsWithBridge(false);
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			PathfindCell *cell = &map[i][j];
+			Int zone = 0;
+			if (i>bounds.lo.x && cell->getType() == map[i-1][j].getType()) {
+				zone = map[i-1][j].getZone();
+			}
+			if (j>bounds.lo.y && cell->getType() == map[i][j-1].getType()) {
+				if (zone == 0) {
+					zone = map[i][j-1].getZone();
+				} else {
+					joinZones(zoneEquivalency, zone, map[i][j-1].getZone());
+				}
+			}
+			if (zone == 0) {
+				zone = totalZones;
+				zoneEquivalency[zone] = zone;
+				totalZones++;
+			}
+			cell->setZone(zone);
+			if (cell->getConnectLayer() > LAYER_GROUND) {
+				block.setInteractsWithBridge(true);
+			}
+		}
+	}
+
+	// Collapse the zones into a firstZone, firstZone+1... sequence.
+	Int numZones = 0;
+	for (i=1; i<totalZones; i++) {
+		Int zone = findRootZone(zoneEquivalency, i);
+		if (zone == i) {
+			collapsedZones[i] = firstZone + numZones;
+			numZones++;
+		} else {
+			collapsedZones[i] = collapsedZones[zone];
+		}
+	}
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			map[i][j].setZone(collapsedZones[map[i][j].getZone()]);
+		}
+	}
+	return numZones;
+}
+
+/* Find the zone links of all blocks, for the zones calculateZones came to. */
+void PathfindZoneManager::calculateLinks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds )
+{
+	Int xBlock, yBlock;
+	for (xBlock = 0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock = 0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			IRegion2D bounds;
+			getZoneBlockBounds(xBlock, yBlock, globalBounds, bounds);
+			m_zoneBlocks[xBlock][yBlock].blockCalculateLinks(map, layers, bounds, globalBounds);
+		}
+	}
+	m_linksCalculated = TRUE;
+}
+
+/* Link the equivalency tables from the zone links of all blocks. */
+void PathfindZoneManager::linkZoneTables( void )
+{
+	allocateZones();
+
+	Int i;
+	for (i=0; i<m_zonesAllocated; i++) {
+		m_groundCliffZones[i] = m_groundWaterZones[i] = m_groundRubbleZones[i] = m_terrainZones[i] = m_crusherZones[i] = m_hierarchicalZones[i] = i;
+	}
+
+	Int xBlock, yBlock;
+	for (xBlock = 0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock = 0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			const ZoneBlock &block = m_zoneBlocks[xBlock][yBlock];
+			for (i=0; i<block.getNumLinks(); i++) {
+				const PathfindZoneLink &link = block.getLink(i);
+				if (link.m_tables & PathfindZoneLink::HIERARCHICAL) {
+					joinZones(m_hierarchicalZones, link.m_zone, link.m_otherZone);
+				}
+				if (link.m_tables & PathfindZoneLink::TERRAIN) {
+					joinZones(m_terrainZones, link.m_zone, link.m_otherZone);
+				}
+				if (link.m_tables & PathfindZoneLink::CRUSHER) {
+					joinZones(m_crusherZones, link.m_zone, link.m_otherZone);
+				}
+				if (link.m_tables & PathfindZoneLink::GROUND_WATER) {
+					joinZones(m_groundWaterZones, link.m_zone, link.m_otherZone);
+				}
+				if (link.m_tables & PathfindZoneLink::GROUND_RUBBLE) {
+					joinZones(m_groundRubbleZones, link.m_zone, link.m_otherZone);
+				}
+				if (link.m_tables & PathfindZoneLink::GROUND_CLIFF) {
+					joinZones(m_groundCliffZones, link.m_zone, link.m_otherZone);
+				}
+			}
+		}
+	}
+
+	straightenZones(m_hierarchicalZones, m_maxZone);
+	straightenZones(m_terrainZones, m_maxZone);
+	straightenZones(m_crusherZones, m_maxZone);
+	straightenZones(m_groundWaterZones, m_maxZone);
+	straightenZones(m_groundRubbleZones, m_maxZone);
+	straightenZones(m_groundCliffZones, m_maxZone);
+
+	flattenZonesQuickly(m_groundCliffZones, m_hierarchicalZones, m_maxZone, m_zoneValues);
+	flattenZonesQuickly(m_groundWaterZones, m_hierarchicalZones, m_maxZone, m_zoneValues);
+	flattenZonesQuickly(m_groundRubbleZones, m_hierarchicalZones, m_maxZone, m_zoneValues);
+	flattenZonesQuickly(m_terrainZones, m_hierarchicalZones, m_maxZone, m_zoneValues);
+	flattenZonesQuickly(m_crusherZones, m_hierarchicalZones, m_maxZone, m_zoneValues);
+}
+
+#if defined(RTS_DEBUG)
+/* Collect the zones of all cells and layers, and the equivalency tables. */
+void PathfindZoneManager::getZones( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds, std::vector<zoneStorageType> &zones ) const
+{
+	zones.clear();
+	Int i, j;
+	for( j=globalBounds.lo.y; j<=globalBounds.hi.y; j++ )	{
+		for( i=globalBounds.lo.x; i<=globalBounds.hi.x; i++ )	{
+			zones.push_back(map[i][j].getZone());
+		}
+	}
+	for (i=0; i<=LAYER_LAST; i++) {
+		zones.push_back((zoneStorageType)layers[i].getZone());
+	}
+	for (i=0; i<m_maxZone; i++) {
+		zones.push_back(m_groundCliffZones[i]);
+		zones.push_back(m_groundWaterZones[i]);
+		zones.push_back(m_groundRubbleZones[i]);
+		zones.push_back(m_terrainZones[i]);
+		zones.push_back(m_crusherZones[i]);
+		zones.push_back(m_hierarchicalZones[i]);
+	}
+}
+
+/* Check that updating the zone blocks came to the zones calculateZones comes to. The zones to compare
+with are calculated by a manager of their own, so that this one keeps its zone blocks, links and routes,
+and the cells and layers get their updated zones back afterwards. Debug builds then go on with the same
+zones and routes as release builds. */
+void PathfindZoneManager::verifyZoneBlocks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds )
+{
+	std::vector<zoneStorageType> updatedZones;
+	std::vector<zoneStorageType> calculatedZones;
+	getZones(map, layers, globalBounds, updatedZones);
+
+	PathfindZoneManager *reference = MSGNEW("PathfindZoneManager") PathfindZoneManager;
+	reference->allocateBlocks(globalBounds);
+	reference->calculateZones(map, layers, globalBounds);
+	reference->getZones(map, layers, globalBounds, calculatedZones);
+	DEBUG_ASSERTCRASH(updatedZones == calculatedZones, ("Updating the zone blocks came to other zones than calculating them."));
+
+	Int xBlock, yBlock;
+	for (xBlock = 0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock = 0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			const ZoneBlock &updated = m_zoneBlocks[xBlock][yBlock];
+			const ZoneBlock &calculated = reference->m_zoneBlocks[xBlock][yBlock];
+			DEBUG_ASSERTCRASH(updated.getFirstZone() == calculated.getFirstZone() && updated.getNumZones() == calculated.getNumZones() &&
+				updated.getInteractsWithBridge() == calculated.getInteractsWithBridge(), ("Updating the zone blocks came to other blocks than calculating them."));
+		}
+	}
+	delete reference;
 
+	std::vector<zoneStorageType>::const_iterator zone = updatedZones.begin();
+	Int i, j;
+	for( j=globalBounds.lo.y; j<=globalBounds.hi.y; j++ )	{
+		for( i=globalBounds.lo.x; i<=globalBounds.hi.x; i++ )	{
+			map[i][j].setZone(*zone++);
+		}
+	}
+	for (i=0; i<=LAYER_LAST; i++) {
+		layers[i].setZone(*zone++);
+		layers[i].applyZone();
+	}
 }
+#endif
+#endif
 
 //
 // Clear the passable flags.
@@ -2841,6 +3567,122 @@ void PathfindZoneManager::setAllPassable( )
 	}
 }
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+//
+// Return the cached route between the blocks and zones of key, for the same kind of mover, or NULL.
+//
+const PathfindZoneRoute *PathfindZoneManager::findRoute( const PathfindZoneRoute &key )
+{
+	for (Int i=0; i<MAX_CACHED_ROUTES; i++) {
+		if (m_routeLastUsed[i] == 0) {
+			continue;
+		}
+		const PathfindZoneRoute &route = m_routes[i];
+		if (route.m_fromBlock.x == key.m_fromBlock.x && route.m_fromBlock.y == key.m_fromBlock.y &&
+				route.m_toBlock.x == key.m_toBlock.x && route.m_toBlock.y == key.m_toBlock.y &&
+				route.m_fromZone == key.m_fromZone && route.m_toZone == key.m_toZone &&
+				route.m_surfaces == key.m_surfaces && route.m_crusher == key.m_crusher && route.m_isHuman == key.m_isHuman) {
+			m_routeLastUsed[i] = ++m_routeClock;
+			m_routeCacheHits++;
+			m_routeCacheCellsSaved += route.m_cellsExamined;
+			return &route;
+		}
+	}
+	m_routeCacheMisses++;
+	return NULL;
+}
+
+//
+// Cache a route. If the cache is full, it replaces the route that was used longest ago.
+//
+void PathfindZoneManager::addRoute( const PathfindZoneRoute &route )
+{
+	Int slot = 0;
+	for (Int i=1; i<MAX_CACHED_ROUTES; i++) {
+		if (m_routeLastUsed[i] < m_routeLastUsed[slot]) {
+			slot = i;
+		}
+	}
+	m_routes[slot] = route;
+	m_routeLastUsed[slot] = ++m_routeClock;
+}
+
+//
+// Forget all cached routes.
+//
+void PathfindZoneManager::clearRoutes( void )
+{
+	for (Int i=0; i<MAX_CACHED_ROUTES; i++) {
+		m_routeLastUsed[i] = 0;
+	}
+}
+
+//
+// Forget the cached routes that start, end or pass in any block that overlaps these cells.
+//
+void PathfindZoneManager::invalidateRoutes( const IRegion2D &cellBounds )
+{
+	IRegion2D blocks;
+	blocks.lo.x = cellBounds.lo.x/ZONE_BLOCK_SIZE;
+	blocks.lo.y = cellBounds.lo.y/ZONE_BLOCK_SIZE;
+	blocks.hi.x = cellBounds.hi.x/ZONE_BLOCK_SIZE;
+	blocks.hi.y = cellBounds.hi.y/ZONE_BLOCK_SIZE;
+
+	for (Int i=0; i<MAX_CACHED_ROUTES; i++) {
+		if (m_routeLastUsed[i] == 0) {
+			continue;
+		}
+		const PathfindZoneRoute &route = m_routes[i];
+		Bool overlaps = isBlockInRegion(route.m_fromBlock.x, route.m_fromBlock.y, blocks) ||
+			isBlockInRegion(route.m_toBlock.x, route.m_toBlock.y, blocks);
+		// every block the route passes has one of its cells, where the route enters the block.
+		for (Int j=0; !overlaps && j<route.m_numCells; j++) {
+			overlaps = isBlockInRegion(route.m_cells[j].x/ZONE_BLOCK_SIZE, route.m_cells[j].y/ZONE_BLOCK_SIZE, blocks);
+		}
+		if (overlaps) {
+			m_routeLastUsed[i] = 0;
+		}
+	}
+}
+
+//
+// Forget the cached routes that go over a bridge.
+//
+void PathfindZoneManager::invalidateBridgeRoutes( void )
+{
+	for (Int i=0; i<MAX_CACHED_ROUTES; i++) {
+		if (m_routes[i].m_crossesBridge) {
+			m_routeLastUsed[i] = 0;
+		}
+	}
+}
+#if USE_INCREMENTAL_PATHFIND_ZONES
+//
+// Move the zones of the cached routes along with the zones of their blocks.
+//
+void PathfindZoneManager::renumberRoutes( void )
+{
+	for (Int i=0; i<MAX_CACHED_ROUTES; i++) {
+		if (m_routeLastUsed[i] == 0) {
+			continue;
+		}
+		PathfindZoneRoute &route = m_routes[i];
+		for (Int end=0; end<2; end++) {
+			const ICoord2D &blockIndex = end ? route.m_toBlock : route.m_fromBlock;
+			zoneStorageType &zone = end ? route.m_toZone : route.m_fromZone;
+			const ZoneBlock &block = m_zoneBlocks[blockIndex.x][blockIndex.y];
+			const Int offset = m_zoneBlockOffsets[blockIndex.x*m_zoneBlockExtent.y + blockIndex.y];
+			// Movers that go everywhere use zone 1, which belongs to the first block and never moves.
+			const Int oldFirstZone = block.getFirstZone() - offset;
+			if (zone >= oldFirstZone && zone < oldFirstZone + block.getNumZones()) {
+				zone = (zoneStorageType)(zone + offset);
+			}
+		}
+	}
+}
+#endif
+#endif
+
 //
 // Set the passable flag for the block at this location.
 //
@@ -3652,6 +4494,81 @@ void PathfindLayer::classifyWallMapCell( Int i, Int j , PathfindCell *cell, Obje
 	}
 }
 
+#if USE_GROUP_FLOW_FIELDS
+//----------------------- PathfindFlowField ---------------------------------------
+
+PathfindFlowField::PathfindFlowField( void ) :
+	m_directions(NULL),
+	m_width(0),
+	m_surfaces(0),
+	m_crusher(false),
+	m_isHuman(false),
+	m_isValid(false),
+	m_isComplete(false),
+	m_lastUsedFrame(0)
+{
+	// an empty extent, so getDirection never looks at m_directions
+	m_extent.lo.x = m_extent.lo.y = 0;
+	m_extent.hi.x = m_extent.hi.y = -1;
+	m_goal.x = m_goal.y = 0;
+}
+
+PathfindFlowField::~PathfindFlowField()
+{
+	release();
+}
+
+Bool PathfindFlowField::matches( const ICoord2D &goal, LocomotorSurfaceTypeMask surfaces, Bool crusher, Bool isHuman ) const
+{
+	return m_isValid && m_goal.x == goal.x && m_goal.y == goal.y && m_surfaces == surfaces &&
+		m_crusher == crusher && m_isHuman == isHuman;
+}
+
+/**
+ * A cell is settled once the search has found its cheapest way to the goal. Its direction, and those of
+ * all the cells on the way from it to the goal, will not change any more.
+ */
+Bool PathfindFlowField::isSettled( Int x, Int y ) const
+{
+	if (getDirection(x, y) == NO_DIRECTION) {
+		return false;
+	}
+	if (m_isComplete) {
+		return true;
+	}
+	// every cell left to expand costs at least as much, so no step can make this one cheaper.
+	const UnsignedInt cost = m_costs[(y - m_extent.lo.y) * m_width + (x - m_extent.lo.x)];
+	return m_open.empty() || cost <= m_open.front().m_cost;
+}
+
+void PathfindFlowField::allocate( const IRegion2D &extent )
+{
+	Int width = extent.hi.x - extent.lo.x + 1;
+	Int height = extent.hi.y - extent.lo.y + 1;
+	Int oldHeight = m_extent.hi.y - m_extent.lo.y + 1;
+	if (m_directions == NULL || width != m_width || height != oldHeight) {
+		release();
+		m_directions = MSGNEW("PathfindFlowField") UnsignedByte[width*height];
+	}
+	m_extent = extent;
+	m_width = width;
+	m_isComplete = false;
+}
+
+void PathfindFlowField::release( void )
+{
+	delete [] m_directions;
+	m_directions = NULL;
+	m_width = 0;
+	m_extent.lo.x = m_extent.lo.y = 0;
+	m_extent.hi.x = m_extent.hi.y = -1;
+	m_isValid = false;
+	m_isComplete = false;
+	std::vector<UnsignedInt>().swap(m_costs);
+	std::vector<OpenCell>().swap(m_open);
+}
+#endif
+
 //----------------------- Pathfinder ---------------------------------------
 
 Pathfinder::Pathfinder( void ) :m_map(NULL)
@@ -3686,6 +4603,7 @@ void Pathfinder::reset( void )
 	m_extent.lo.x=m_extent.lo.y=m_extent.hi.x=m_extent.hi.y=0;
 	m_logicalExtent.lo.x=m_logicalExtent.lo.y=m_logicalExtent.hi.x=m_logicalExtent.hi.y=0;
 	m_openList = NULL;
+	PathfindCell::resetOpenListIndex();
 	m_closedList = NULL;
 
 	m_ignoreObstacleID = INVALID_ID;
@@ -3727,6 +4645,10 @@ void Pathfinder::reset( void )
 	}
 	m_zoneManager.reset();
 
+#if USE_GROUP_FLOW_FIELDS
+	resetFlowFields();
+#endif
+
 #if RETAIL_COMPATIBLE_PATHFINDING
 	s_useFixedPathfinding = false;
 	s_forceCleanCells = false;
@@ -3902,10 +4824,32 @@ void Pathfinder::classifyFence( Object *obj, Bool insert )
  		}
  	}
 	if (didAnything) {
+#if USE_GROUP_FLOW_FIELDS
+		invalidateFlowFields();
+#endif
+#if USE_INCREMENTAL_PATHFIND_ZONES
+		updateZonesForFootprint(cellBounds, insert);
+#else
 		m_zoneManager.markZonesDirty( insert );
 		m_zoneManager.updateZonesForModify(m_map, m_layers, cellBounds, m_extent);
+#endif
+	}
+}
+
+#if USE_INCREMENTAL_PATHFIND_ZONES
+/**
+ * TheSuperHackers @performance Rezone the cells of a footprint right away, rather than recalculating
+ * the zones of the whole map some frames later. Until the map is ready, the zones are calculated anew.
+ */
+void Pathfinder::updateZonesForFootprint( const IRegion2D &cellBounds, Bool insert )
+{
+	if (!m_isMapReady) {
+		m_zoneManager.markZonesDirty( insert );
+		return;
 	}
+	m_zoneManager.updateZoneBlocks(m_map, m_layers, cellBounds, m_extent);
 }
+#endif
 
 /**
  * Classify the cells under the given object
@@ -4006,7 +4950,12 @@ void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 	{
 		case GEOMETRY_BOX:
 		{
+#if !USE_INCREMENTAL_PATHFIND_ZONES
 			m_zoneManager.markZonesDirty( insert );
+#endif
+#if USE_GROUP_FLOW_FIELDS
+			invalidateFlowFields();
+#endif
 
 			Real angle = obj->getOrientation();
 
@@ -4065,7 +5014,12 @@ void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 		case GEOMETRY_SPHERE:	// not quite right, but close enough
 		case GEOMETRY_CYLINDER:
 		{
+#if !USE_INCREMENTAL_PATHFIND_ZONES
 			m_zoneManager.markZonesDirty( insert );
+#endif
+#if USE_GROUP_FLOW_FIELDS
+			invalidateFlowFields();
+#endif
 			// fill in all cells that overlap as obstacle cells
 			/// @todo This is a very inefficient circle-rasterizer
 			ICoord2D topLeft, bottomRight;
@@ -4120,7 +5074,9 @@ void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 		}
 		break;
 	}
+#if !USE_INCREMENTAL_PATHFIND_ZONES
 	m_zoneManager.updateZonesForModify(m_map, m_layers, cellBounds, m_extent);
+#endif
 
 	Int i, j;
 	cellBounds.lo.x -= 2;
@@ -4225,6 +5181,11 @@ void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 			}
 		}
 	}
+
+#if USE_INCREMENTAL_PATHFIND_ZONES
+	// The cells that were cleared or closed off above are rezoned too.
+	updateZonesForFootprint(cellBounds, insert);
+#endif
 }
 
 /**
@@ -4402,6 +5363,9 @@ void Pathfinder::classifyMap(void)
 		m_layers[LAYER_WALL].classifyWallCells(m_wallPieces, m_numWallPieces);
 	}
 	m_zoneManager.calculateZones(m_map, m_layers, m_extent);
+#if USE_GROUP_FLOW_FIELDS
+	invalidateFlowFields();
+#endif
 }
 
 
@@ -5606,6 +6570,18 @@ void Pathfinder::processPathfindQueue(void)
 	bounds.hi.y = REAL_TO_INT_FLOOR(terrainExtent.hi.y / PATHFIND_CELL_SIZE_F);
 	bounds.hi.x--;
 	bounds.hi.y--;
+#if USE_GROUP_FLOW_FIELDS || USE_HIERARCHICAL_ROUTE_CACHE
+	// the flow fields and cached routes for human players stay inside the logical extent.
+	if (bounds.lo.x != m_logicalExtent.lo.x || bounds.lo.y != m_logicalExtent.lo.y ||
+			bounds.hi.x != m_logicalExtent.hi.x || bounds.hi.y != m_logicalExtent.hi.y) {
+#if USE_GROUP_FLOW_FIELDS
+		invalidateFlowFields();
+#endif
+#if USE_HIERARCHICAL_ROUTE_CACHE
+		m_zoneManager.clearRoutes();
+#endif
+	}
+#endif
 	m_logicalExtent = bounds;
 
 	m_cumulativeCellsAllocated = 0;	// Number of pathfind cells examined.
@@ -5630,6 +6606,9 @@ void Pathfinder::processPathfindQueue(void)
 			m_queuePRHead = 0;
 		}
 	}
+#if USE_GROUP_FLOW_FIELDS
+	continueFlowFields();
+#endif
 	if (pathsFound>0) {
 #ifdef DEBUG_QPF
 #ifdef DEBUG_LOGGING
@@ -5639,6 +6618,10 @@ void Pathfinder::processPathfindQueue(void)
 		{
 			DEBUG_LOG(("%d Pathfind queue: %d paths, %d cells --", TheGameLogic->getFrame(), pathsFound, m_cumulativeCellsAllocated));
 			DEBUG_LOG(("time %f (%f)", timeToUpdate, (::GetTickCount()-startTimeMS)/1000.0f));
+#if USE_HIERARCHICAL_ROUTE_CACHE
+			DEBUG_LOG(("route cache: %u hits, %u misses, %u cells saved", m_zoneManager.getRouteCacheHits(),
+				m_zoneManager.getRouteCacheMisses(), m_zoneManager.getRouteCacheCellsSaved()));
+#endif
 		}
 #endif
 #endif
@@ -5959,82 +6942,536 @@ Int Pathfinder::examineNeighboringCells(PathfindCell *parentCell, PathfindCell *
 				newCostSoFar += COST_ORTHOGONAL;
 			}
 
-			newCell->setBlockedByAlly(false);
-			if (info.allyFixedCount>0) {
-				newCostSoFar += 3*COST_DIAGONAL;
-				if (!canPathThroughUnits)
-					newCell->setBlockedByAlly(true);
+			newCell->setBlockedByAlly(false);
+			if (info.allyFixedCount>0) {
+				newCostSoFar += 3*COST_DIAGONAL;
+				if (!canPathThroughUnits)
+					newCell->setBlockedByAlly(true);
+			}
+
+			Int costRemaining = 0;
+			if (goalCell) {
+				if (attackDistance == NO_ATTACK)  {
+					costRemaining = newCell->costToGoal( goalCell );
+				}	else {
+					dx = newCellCoord.x - goalCell->getXIndex();
+					dy = newCellCoord.y - goalCell->getYIndex();
+					costRemaining = COST_ORTHOGONAL*sqrt(dx*dx + dy*dy);
+					costRemaining -= attackDistance/2;
+					if (costRemaining<0)
+						costRemaining=0;
+					if (info.allyGoal) {
+						if (obj->isKindOf(KINDOF_VEHICLE)) {
+							newCostSoFar += 3*COST_ORTHOGONAL;
+						}	else {
+							// Infantry can pass through infantry.
+							newCostSoFar += COST_ORTHOGONAL;
+						}
+					}
+				}
+			}
+
+			if (notZonePassable) {
+				newCostSoFar += 100*COST_ORTHOGONAL;
+			}
+
+			if (newCell->getType()==PathfindCell::CELL_OBSTACLE) {
+				newCostSoFar += 100*COST_ORTHOGONAL;
+			}
+
+			if (m_isTunneling) {
+				if (!validMovementPosition( isCrusher, locomotorSet.getValidSurfaces(), newCell, parentCell )) {
+					newCostSoFar += 10*COST_ORTHOGONAL;
+				}
+			}
+
+			newCell->setCostSoFar(newCostSoFar);
+			// keep track of path we're building - point back to cell we moved here from
+			newCell->setParentCell(parentCell) ;
+			if (m_isTunneling) {
+				costRemaining = 0; // find the closest valid cell.
+			}
+			newCell->setTotalCost(newCell->getCostSoFar() + costRemaining) ;
+
+			// if newCell was on closed list, remove it from the list
+			if (newCell->getClosed())
+				m_closedList = newCell->removeFromClosedList( m_closedList );
+
+			// if the newCell was already on the open list, remove it so it can be re-inserted in order
+			if (newCell->getOpen())
+				m_openList = newCell->removeFromOpenList( m_openList );
+
+			// insert newCell in open list such that open list is sorted, smallest total path cost first
+			m_openList = newCell->putOnSortedOpenList( m_openList );
+		}
+	return cellCount;
+}
+
+
+/**
+ * Find a short, valid path between given locations.
+ * Uses A* algorithm.
+ */
+#if USE_GROUP_FLOW_FIELDS
+// Same neighbor order as in examineNeighboringCells, the flow field directions index into it.
+static const ICoord2D s_flowFieldDelta[] =
+{
+	{ 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 },
+	{ 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 }
+};
+static const Int s_flowFieldOpposite[] = { 2, 3, 0, 1, 6, 7, 4, 5 };
+static const UnsignedInt FLOW_FIELD_UNREACHED = 0xffffffff;
+
+/**
+ * A group of at least FLOW_FIELD_MIN_GROUP_SIZE members was ordered to goal. For a while, the paths of
+ * the members of that group that are headed near the goal are read off a shared flow field instead of
+ * being searched.
+ */
+void Pathfinder::addGroupMoveGoal( const Coord3D *goal, UnsignedInt groupID, Int numMembers )
+{
+	if (numMembers < FLOW_FIELD_MIN_GROUP_SIZE) {
+		return;
+	}
+
+	ICoord2D cell;
+	worldToCell(goal, &cell);
+	const UnsignedInt expireFrame = TheGameLogic->getFrame() + FLOW_FIELD_GOAL_FRAMES;
+
+	for (Int i=0; i<MAX_FLOW_FIELD_GOALS; i++) {
+		if (m_flowFieldGoals[i].m_cell.x == cell.x && m_flowFieldGoals[i].m_cell.y == cell.y &&
+				m_flowFieldGoals[i].m_groupID == groupID) {
+			m_flowFieldGoals[i].m_expireFrame = expireFrame;
+			return;
+		}
+	}
+
+	m_flowFieldGoals[m_nextFlowFieldGoal].m_cell = cell;
+	m_flowFieldGoals[m_nextFlowFieldGoal].m_groupID = groupID;
+	m_flowFieldGoals[m_nextFlowFieldGoal].m_expireFrame = expireFrame;
+	m_nextFlowFieldGoal = (m_nextFlowFieldGoal + 1) % MAX_FLOW_FIELD_GOALS;
+}
+
+/**
+ * The pathfind map changed, so no flow field can be trusted any more.
+ */
+void Pathfinder::invalidateFlowFields( void )
+{
+	for (Int i=0; i<MAX_FLOW_FIELDS; i++) {
+		m_flowFields[i].m_isValid = false;
+	}
+}
+
+void Pathfinder::releaseFlowFields( void )
+{
+	for (Int i=0; i<MAX_FLOW_FIELDS; i++) {
+		m_flowFields[i].release();
+	}
+	std::vector<ICoord2D>().swap(m_flowFieldPathCells);
+}
+
+/**
+ * Forget the group goals along with the flow fields. Neither is part of a saved game, and the members of a
+ * group that can no longer find its goal search their paths with A*, so this is called at save and at load
+ * to keep a saved game and the game that goes on after saving in step.
+ */
+void Pathfinder::resetFlowFields( void )
+{
+	releaseFlowFields();
+	for (Int i=0; i<MAX_FLOW_FIELD_GOALS; ++i)
+	{
+		m_flowFieldGoals[i].m_cell.x = m_flowFieldGoals[i].m_cell.y = 0;
+		m_flowFieldGoals[i].m_groupID = 0;
+		m_flowFieldGoals[i].m_expireFrame = 0;
+	}
+	m_nextFlowFieldGoal = 0;
+}
+
+/**
+ * Return the flow field towards goal for this kind of mover, starting a new one if it is not cached.
+ * When all fields are in use, the one that was used longest ago is started over.
+ */
+PathfindFlowField *Pathfinder::getFlowField( const ICoord2D &goal, LocomotorSurfaceTypeMask surfaces, Bool crusher, Bool isHuman )
+{
+	const UnsignedInt now = TheGameLogic->getFrame();
+	PathfindFlowField *field = NULL;
+	Int i;
+	for (i=0; i<MAX_FLOW_FIELDS; i++) {
+		if (m_flowFields[i].matches(goal, surfaces, crusher, isHuman)) {
+			m_flowFields[i].m_lastUsedFrame = now;
+			return &m_flowFields[i];
+		}
+	}
+
+	for (i=0; i<MAX_FLOW_FIELDS; i++) {
+		if (!m_flowFields[i].m_isValid) {
+			field = &m_flowFields[i];
+			break;
+		}
+		if (field == NULL || m_flowFields[i].m_lastUsedFrame < field->m_lastUsedFrame) {
+			field = &m_flowFields[i];
+		}
+	}
+
+	field->m_goal = goal;
+	field->m_surfaces = surfaces;
+	field->m_crusher = crusher;
+	field->m_isHuman = isHuman;
+	field->m_lastUsedFrame = now;
+	startFlowField(field);
+	return field;
+}
+
+/**
+ * Clear the field and put its goal cell up as the first cell to expand. The search itself runs in
+ * buildFlowField.
+ */
+void Pathfinder::startFlowField( PathfindFlowField *field )
+{
+	field->allocate(m_extent);
+	const Int width = field->m_width;
+	const Int numCells = width * (m_extent.hi.y - m_extent.lo.y + 1);
+
+	memset(field->m_directions, PathfindFlowField::NO_DIRECTION, numCells);
+	field->m_costs.assign(numCells, FLOW_FIELD_UNREACHED);
+	field->m_open.clear();
+	field->m_isValid = true;
+
+	ICoord2D goal = field->m_goal;
+	PathfindCell *goalCell = getCell(LAYER_GROUND, goal.x, goal.y);
+	if (goalCell == NULL || !validMovementPosition(field->m_crusher, field->m_surfaces, goalCell) ||
+			(field->m_isHuman && checkCellOutsideExtents(goal))) {
+		field->m_isComplete = true;
+		std::vector<UnsignedInt>().swap(field->m_costs);
+		return;
+	}
+
+	PathfindFlowField::OpenCell open;
+	open.m_cost = 0;
+	open.m_index = (goal.y - m_extent.lo.y) * width + (goal.x - m_extent.lo.x);
+	field->m_costs[open.m_index] = 0;
+	field->m_directions[open.m_index] = PathfindFlowField::GOAL_DIRECTION;
+	field->m_open.push_back(open);
+}
+
+/**
+ * Search the ground layer outwards from the goal of the field, cheapest cell first, and store for each
+ * cell reached the step towards the goal. Moves follow the rules of examineNeighboringCells, with its
+ * terrain costs. Costs that depend on units, and the cost of turns, are left out, because they depend
+ * on the mover. Ties are broken by cell index, so every client builds the same field.
+ * The search goes on where it stopped last time, and stops again after maxCells cells, or as soon as
+ * startCell is settled. The cells are counted against the pathfinding budget of the frame.
+ */
+void Pathfinder::buildFlowField( PathfindFlowField *field, Int maxCells, const ICoord2D *startCell )
+{
+	DEBUG_ASSERTCRASH(m_ignoreObstacleID == INVALID_ID, ("Flow fields must not ignore an obstacle."));
+
+	const Int width = field->m_width;
+	const LocomotorSurfaceTypeMask surfaces = field->m_surfaces;
+	const Bool crusher = field->m_crusher;
+	const Bool isHuman = field->m_isHuman;
+	const Int firstDiagonal = 4;
+	std::vector<UnsignedInt> &costs = field->m_costs;
+	std::vector<PathfindFlowField::OpenCell> &openCells = field->m_open;
+	PathfindFlowField::OpenCell open;
+	Int numCellsExpanded = 0;
+
+	while (!openCells.empty()) {
+		if (numCellsExpanded >= maxCells) {
+			break;
+		}
+		if (startCell != NULL && field->isSettled(startCell->x, startCell->y)) {
+			break;
+		}
+
+		std::pop_heap(openCells.begin(), openCells.end());
+		const PathfindFlowField::OpenCell current = openCells.back();
+		openCells.pop_back();
+		if (current.m_cost != costs[current.m_index]) {
+			continue; // a cheaper way to this cell was expanded already.
+		}
+		numCellsExpanded++;
+
+		ICoord2D cellCoord;
+		cellCoord.x = m_extent.lo.x + current.m_index % width;
+		cellCoord.y = m_extent.lo.y + current.m_index / width;
+		PathfindCell *cell = getCell(LAYER_GROUND, cellCoord.x, cellCoord.y);
+
+		// the terrain cost of stepping onto this cell, as in examineNeighboringCells.
+		UnsignedInt enterCost = 0;
+		Bool checkCliffHeight = false;
+		Real cellHeight = 0.0f;
+		if (cell->getType() == PathfindCell::CELL_CLIFF && !cell->getPinched()) {
+			checkCliffHeight = true;
+			cellHeight = TheTerrainLogic->getGroundHeight(cellCoord.x * PATHFIND_CELL_SIZE_F, cellCoord.y * PATHFIND_CELL_SIZE_F);
+		} else if (cell->getPinched()) {
+			enterCost += COST_DIAGONAL + COST_ORTHOGONAL;
+		}
+		if (cell->getType() == PathfindCell::CELL_OBSTACLE) {
+			enterCost += 100*COST_ORTHOGONAL;
+		}
+
+		for (Int i=0; i<PathfindFlowField::NUM_DIRECTIONS; i++) {
+			// fromCoord is a cell that could step onto this one.
+			ICoord2D fromCoord;
+			fromCoord.x = cellCoord.x + s_flowFieldDelta[i].x;
+			fromCoord.y = cellCoord.y + s_flowFieldDelta[i].y;
+			PathfindCell *fromCell = getCell(LAYER_GROUND, fromCoord.x, fromCoord.y);
+			if (fromCell == NULL) {
+				continue;
 			}
 
-			Int costRemaining = 0;
-			if (goalCell) {
-				if (attackDistance == NO_ATTACK)  {
-					costRemaining = newCell->costToGoal( goalCell );
-				}	else {
-					dx = newCellCoord.x - goalCell->getXIndex();
-					dy = newCellCoord.y - goalCell->getYIndex();
-					costRemaining = COST_ORTHOGONAL*sqrt(dx*dx + dy*dy);
-					costRemaining -= attackDistance/2;
-					if (costRemaining<0)
-						costRemaining=0;
-					if (info.allyGoal) {
-						if (obj->isKindOf(KINDOF_VEHICLE)) {
-							newCostSoFar += 3*COST_ORTHOGONAL;
-						}	else {
-							// Infantry can pass through infantry.
-							newCostSoFar += COST_ORTHOGONAL;
-						}
-					}
+			if (i >= firstDiagonal) {
+				// make sure one of the adjacent sides is open.
+				ICoord2D side1, side2;
+				side1.x = cellCoord.x + s_flowFieldDelta[i].x;
+				side1.y = cellCoord.y;
+				side2.x = cellCoord.x;
+				side2.y = cellCoord.y + s_flowFieldDelta[i].y;
+				Bool side1Open = validMovementPosition(crusher, surfaces, getCell(LAYER_GROUND, side1.x, side1.y), fromCell) &&
+					!(isHuman && checkCellOutsideExtents(side1));
+				Bool side2Open = validMovementPosition(crusher, surfaces, getCell(LAYER_GROUND, side2.x, side2.y), fromCell) &&
+					!(isHuman && checkCellOutsideExtents(side2));
+				if (!side1Open && !side2Open) {
+					continue;
 				}
 			}
 
-			if (notZonePassable) {
-				newCostSoFar += 100*COST_ORTHOGONAL;
+			const Int fromIndex = current.m_index + s_flowFieldDelta[i].y * width + s_flowFieldDelta[i].x;
+			UnsignedInt cost = current.m_cost + enterCost + (i < firstDiagonal ? COST_ORTHOGONAL : COST_DIAGONAL);
+			if (checkCliffHeight) {
+				Real fromHeight = TheTerrainLogic->getGroundHeight(fromCoord.x * PATHFIND_CELL_SIZE_F, fromCoord.y * PATHFIND_CELL_SIZE_F);
+				if (fabs(fromHeight - cellHeight) < PATHFIND_CELL_SIZE_F) {
+					cost += 7*COST_DIAGONAL;
+				}
 			}
-
-			if (newCell->getType()==PathfindCell::CELL_OBSTACLE) {
-				newCostSoFar += 100*COST_ORTHOGONAL;
+			if (cost >= costs[fromIndex]) {
+				continue;
 			}
 
-			if (m_isTunneling) {
-				if (!validMovementPosition( isCrusher, locomotorSet.getValidSurfaces(), newCell, parentCell )) {
-					newCostSoFar += 10*COST_ORTHOGONAL;
-				}
-			}
+			costs[fromIndex] = cost;
+			field->m_directions[fromIndex] = (UnsignedByte)s_flowFieldOpposite[i];
 
-			newCell->setCostSoFar(newCostSoFar);
-			// keep track of path we're building - point back to cell we moved here from
-			newCell->setParentCell(parentCell) ;
-			if (m_isTunneling) {
-				costRemaining = 0; // find the closest valid cell.
+			// A unit may start in a cell it could not move into, but no path leads through one.
+			if (!validMovementPosition(crusher, surfaces, fromCell) || (isHuman && checkCellOutsideExtents(fromCoord))) {
+				continue;
 			}
-			newCell->setTotalCost(newCell->getCostSoFar() + costRemaining) ;
+			open.m_cost = cost;
+			open.m_index = fromIndex;
+			openCells.push_back(open);
+			std::push_heap(openCells.begin(), openCells.end());
+		}
+	}
 
-			// if newCell was on closed list, remove it from the list
-			if (newCell->getClosed())
-				m_closedList = newCell->removeFromClosedList( m_closedList );
+	if (openCells.empty()) {
+		field->m_isComplete = true;
+		std::vector<UnsignedInt>().swap(costs);
+		std::vector<PathfindFlowField::OpenCell>().swap(openCells);
+	}
 
-			// if the newCell was already on the open list, remove it so it can be re-inserted in order
-			if (newCell->getOpen())
-				m_openList = newCell->removeFromOpenList( m_openList );
+	m_cumulativeCellsAllocated += numCellsExpanded;
+}
 
-			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = newCell->putOnSortedOpenList( m_openList );
+/**
+ * Spend what is left of the pathfinding budget of this frame on the flow fields that are still being
+ * searched, so the members of their groups that ask for a path later find them settled.
+ */
+void Pathfinder::continueFlowFields( void )
+{
+	const UnsignedInt now = TheGameLogic->getFrame();
+	for (Int i=0; i<MAX_FLOW_FIELDS; i++) {
+		if (m_cumulativeCellsAllocated >= PATHFIND_CELLS_PER_FRAME) {
+			return;
 		}
-	return cellCount;
+		PathfindFlowField *field = &m_flowFields[i];
+		if (!field->m_isValid || field->m_isComplete || field->m_lastUsedFrame + FLOW_FIELD_GOAL_FRAMES <= now) {
+			continue;
+		}
+		buildFlowField(field, PATHFIND_CELLS_PER_FRAME - m_cumulativeCellsAllocated, NULL);
+	}
 }
 
-
 /**
- * Find a short, valid path between given locations.
- * Uses A* algorithm.
+ * If obj is a member of a group that was just ordered to move, read its path off the flow field
+ * towards the group goal. Returns NULL if the flow field can not be used, and the caller should
+ * search for the path as usual.
  */
+Path *Pathfinder::findFlowFieldPath( Object *obj, const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *rawTo )
+{
+	if (obj == NULL || !m_isMapReady || m_ignoreObstacleID != INVALID_ID || locomotorSet.isDownhillOnly()) {
+		return NULL;
+	}
+	// dozers may path through friendly structures, which a shared field does not know about.
+	if (obj->getLayer() != LAYER_GROUND || obj->isKindOf(KINDOF_DOZER)) {
+		return NULL;
+	}
+	// only the members of the group that was ordered to the goal share its field.
+	AIGroup *group = obj->getGroup();
+	if (group == NULL) {
+		return NULL;
+	}
+	const UnsignedInt groupID = group->getID();
+	// The field only covers the ground layer, so it would not find the way over a bridge.
+	Int i;
+	for (i=LAYER_GROUND+1; i<LAYER_WALL; i++) {
+		if (!m_layers[i].isUnused() && !m_layers[i].isDestroyed()) {
+			return NULL;
+		}
+	}
+
+	Coord3D adjustTo = *rawTo;
+	Coord3D clipFrom = *from;
+	clip(&clipFrom, &adjustTo);
+
+	Bool centerInCell = true;
+	Int radius = 0;
+	getRadiusAndCenter(obj, radius, centerInCell);
+	if (!centerInCell) {
+		adjustTo.x += PATHFIND_CELL_SIZE_F/2;
+		adjustTo.y += PATHFIND_CELL_SIZE_F/2;
+	}
+	if (TheTerrainLogic->getLayerForDestination(&adjustTo) != LAYER_GROUND) {
+		return NULL;
+	}
+
+	ICoord2D goalCellNdx;
+	worldToCell(&adjustTo, &goalCellNdx);
+	const UnsignedInt now = TheGameLogic->getFrame();
+	const FlowFieldGoal *flowGoal = NULL;
+	for (i=0; i<MAX_FLOW_FIELD_GOALS; i++) {
+		const FlowFieldGoal &candidate = m_flowFieldGoals[i];
+		if (candidate.m_expireFrame <= now || candidate.m_groupID != groupID) {
+			continue;
+		}
+		if (abs(candidate.m_cell.x - goalCellNdx.x) <= FLOW_FIELD_GOAL_RADIUS &&
+				abs(candidate.m_cell.y - goalCellNdx.y) <= FLOW_FIELD_GOAL_RADIUS) {
+			flowGoal = &candidate;
+			break;
+		}
+	}
+	if (flowGoal == NULL) {
+		return NULL;
+	}
+
+	Bool isHuman = true;
+	if (obj->getControllingPlayer() && (obj->getControllingPlayer()->getPlayerType()==PLAYER_COMPUTER)) {
+		isHuman = false; // computer gets to cheat.
+	}
+	const Bool isCrusher = obj->getCrusherLevel() > 0;
+	const LocomotorSurfaceTypeMask surfaces = locomotorSet.getValidSurfaces();
+
+	PathfindCell *goalCell = getCell(LAYER_GROUND, goalCellNdx.x, goalCellNdx.y);
+	if (!validMovementPosition(isCrusher, surfaces, goalCell) || (isHuman && checkCellOutsideExtents(goalCellNdx))) {
+		return NULL;
+	}
+	if (!checkDestination(obj, goalCellNdx.x, goalCellNdx.y, LAYER_GROUND, radius, centerInCell)) {
+		return NULL;
+	}
+
+	PathfindFlowField *field = getFlowField(flowGoal->m_cell, surfaces, isCrusher, isHuman);
+	ICoord2D cellNdx;
+	worldToCell(&clipFrom, &cellNdx);
+	// Search on within the budget of this frame until our start cell is settled. If it is not settled by
+	// then, the path is searched with A* as usual, and a member that asks later may find the field ready.
+	if (!field->isSettled(cellNdx.x, cellNdx.y)) {
+		buildFlowField(field, PATHFIND_CELLS_PER_FRAME - m_cumulativeCellsAllocated, &cellNdx);
+		if (!field->isSettled(cellNdx.x, cellNdx.y)) {
+			return NULL;
+		}
+	}
+
+	// Follow the field until our own goal is in a straight line, then head there. The directions always
+	// lead to a cheaper cell, so the walk ends at the goal of the field at the latest.
+	Coord3D goalPos;
+	adjustCoordToCell(goalCellNdx.x, goalCellNdx.y, centerInCell, goalPos, LAYER_GROUND);
+	Coord3D cellPos;
+	Bool reachedGoal = false;
+	m_flowFieldPathCells.clear();
+	for (;;) {
+		m_flowFieldPathCells.push_back(cellNdx);
+		if (cellNdx.x == goalCellNdx.x && cellNdx.y == goalCellNdx.y) {
+			reachedGoal = true;
+			break;
+		}
+		if (abs(cellNdx.x - goalCellNdx.x) <= FLOW_FIELD_GOAL_RADIUS && abs(cellNdx.y - goalCellNdx.y) <= FLOW_FIELD_GOAL_RADIUS) {
+			adjustCoordToCell(cellNdx.x, cellNdx.y, centerInCell, cellPos, LAYER_GROUND);
+			if (isLinePassable(obj, surfaces, LAYER_GROUND, cellPos, goalPos, false, true)) {
+				m_flowFieldPathCells.push_back(goalCellNdx);
+				reachedGoal = true;
+				break;
+			}
+		}
+		UnsignedByte direction = field->getDirection(cellNdx.x, cellNdx.y);
+		if (direction >= PathfindFlowField::NUM_DIRECTIONS) {
+			break; // at the goal of the field, without a straight line to ours.
+		}
+		cellNdx.x += s_flowFieldDelta[direction].x;
+		cellNdx.y += s_flowFieldDelta[direction].y;
+	}
+	if (!reachedGoal) {
+		return NULL;
+	}
+
+	Int numPathCells = (Int)m_flowFieldPathCells.size();
+	m_cumulativeCellsAllocated += numPathCells;
+
+	// Build the path back to front, like prependCells does for a search.
+	Int last = numPathCells-1;
+	if (last > 0) {
+		PathfindCell *lastCell = getCell(LAYER_GROUND, m_flowFieldPathCells[last].x, m_flowFieldPathCells[last].y);
+		PathfindCell *beforeLastCell = getCell(LAYER_GROUND, m_flowFieldPathCells[last-1].x, m_flowFieldPathCells[last-1].y);
+		if (lastCell->getPinched() && !beforeLastCell->getPinched()) {
+			last--;
+		}
+	}
+
+	Path *path = newInstance(Path);
+	Coord3D pos;
+	PathfindCell *prevCell = NULL;
+	// the start cell is left out, the unit's own position stands in for it, unless it is the whole path.
+	Int first = (last > 0) ? 1 : 0;
+	for (i=last; i>=first; i--) {
+		const ICoord2D &pathCell = m_flowFieldPathCells[i];
+		PathfindCell *cell = getCell(LAYER_GROUND, pathCell.x, pathCell.y);
+		adjustCoordToCell(pathCell.x, pathCell.y, centerInCell, pos, LAYER_GROUND);
+
+		Bool canOptimize = true;
+		if (cell->getType() == PathfindCell::CELL_CLIFF) {
+			if (prevCell && prevCell->getType() != PathfindCell::CELL_CLIFF) {
+				path->getFirstNode()->setCanOptimize(false);
+			}
+		}	else {
+			if (prevCell && prevCell->getType() == PathfindCell::CELL_CLIFF) {
+				canOptimize = false;
+			}
+		}
+
+		path->prependNode( &pos, LAYER_GROUND );
+		path->getFirstNode()->setCanOptimize(canOptimize);
+		prevCell = cell;
+	}
+
+	// put actual start position as first node on the path, so it begins right at the unit's feet
+	if (from->x != path->getFirstNode()->getPosition()->x || from->y != path->getFirstNode()->getPosition()->y) {
+		path->prependNode( from, LAYER_GROUND );
+	}
+
+	path->optimize(obj, surfaces, false);
+	return path;
+}
+#endif
+
 Path *Pathfinder::findPath( Object *obj, const LocomotorSet& locomotorSet, const Coord3D *from,
 													 const Coord3D *rawTo)
 {
 	if (!clientSafeQuickDoesPathExist(locomotorSet, from, rawTo)) {
 		return NULL;
 	}
+#if USE_GROUP_FLOW_FIELDS
+	Path *flowPath = findFlowFieldPath(obj, locomotorSet, from, rawTo);
+	if (flowPath) {
+		return flowPath;
+	}
+#endif
 	Bool isHuman = true;
 	if (obj && obj->getControllingPlayer() && (obj->getControllingPlayer()->getPlayerType()==PLAYER_COMPUTER)) {
 		isHuman = false; // computer gets to cheat.
@@ -6468,24 +7905,7 @@ Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *go
 
 	prependCells(path, fromPos, goalCell, true);
 
-	// Expand the hierarchical path around the starting point. jba [8/24/2003]
-	// This allows the unit to get around friendly units that may be near it.
-	Coord3D pos = *path->getFirstNode()->getPosition();
-	Coord3D minPos = pos;
-	minPos.x -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	minPos.y -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	Coord3D maxPos = pos;
-	maxPos.x += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	maxPos.y += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	ICoord2D cellNdxMin, cellNdxMax;
-	worldToCell(&minPos, &cellNdxMin);
-	worldToCell(&maxPos, &cellNdxMax);
-	Int i, j;
-	for (i=cellNdxMin.x; i<=cellNdxMax.x; i++) {
-		for (j=cellNdxMin.y; j<=cellNdxMax.y; j++) {
-			m_zoneManager.setPassable(i, j, true);
-		}
-	}
+	markPassableAroundPathStart(path);
 
 #if defined(RTS_DEBUG)
 	if (TheGlobalData->m_debugAI==AI_DEBUG_PATHS)
@@ -6517,6 +7937,115 @@ Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *go
 }
 
 
+/**
+ * Expand the hierarchical path around the starting point. jba [8/24/2003]
+ * This allows the unit to get around friendly units that may be near it.
+ */
+void Pathfinder::markPassableAroundPathStart( const Path *path )
+{
+	Coord3D pos = *path->getFirstNode()->getPosition();
+	Coord3D minPos = pos;
+	minPos.x -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	minPos.y -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	Coord3D maxPos = pos;
+	maxPos.x += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	maxPos.y += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	ICoord2D cellNdxMin, cellNdxMax;
+	worldToCell(&minPos, &cellNdxMin);
+	worldToCell(&maxPos, &cellNdxMax);
+	Int i, j;
+	for (i=cellNdxMin.x; i<=cellNdxMax.x; i++) {
+		for (j=cellNdxMin.y; j<=cellNdxMax.y; j++) {
+			m_zoneManager.setPassable(i, j, true);
+		}
+	}
+}
+
+#if USE_HIERARCHICAL_ROUTE_CACHE
+/**
+ * Keep the route the hierarchical search found to goal cell, for the blocks and zones already set in route.
+ * Routes with more cells than a cached route can hold are not kept.
+ */
+void Pathfinder::recordHierarchicalRoute( PathfindZoneRoute &route, PathfindCell *goalCell, Int cellsExamined )
+{
+	route.m_numCells = 0;
+	route.m_crossesBridge = false;
+	route.m_cellsExamined = cellsExamined;
+
+	// the start cell has no parent, and is not part of the route.
+	for (PathfindCell *cell = goalCell->getParentCell(); cell && cell->getParentCell(); cell = cell->getParentCell()) {
+		if (route.m_numCells >= PathfindZoneRoute::MAX_CELLS) {
+			return;
+		}
+		route.m_cells[route.m_numCells].x = cell->getXIndex();
+		route.m_cells[route.m_numCells].y = cell->getYIndex();
+		route.m_cellLayers[route.m_numCells] = (UnsignedByte)cell->getLayer();
+		if (cell->getLayer() != LAYER_GROUND) {
+			route.m_crossesBridge = true;
+		}
+		route.m_numCells++;
+	}
+
+	m_zoneManager.addRoute(route);
+}
+
+/**
+ * Construct the path that buildHierachicalPath would, from the start cell along a cached route to the goal cell.
+ */
+Path *Pathfinder::buildCachedHierarchicalPath( const Coord3D *fromPos, PathfindCell *startCell, PathfindCell *goalCell,
+	const PathfindZoneRoute &route )
+{
+	Path *path = newInstance(Path);
+
+	Coord3D pos;
+	m_zoneManager.setPassable(goalCell->getXIndex(), goalCell->getYIndex(), true);
+	adjustCoordToCell(goalCell->getXIndex(), goalCell->getYIndex(), true, pos, goalCell->getLayer());
+	path->prependNode( &pos, goalCell->getLayer() );
+	path->getFirstNode()->setCanOptimize(true);
+
+	// same as prependCells, for the cells of the route.
+	PathfindCell *prevCell = goalCell;
+	for (Int i=0; i<route.m_numCells; i++) {
+		PathfindLayerEnum layer = (PathfindLayerEnum)route.m_cellLayers[i];
+		PathfindCell *cell = getCell(layer, route.m_cells[i].x, route.m_cells[i].y);
+		m_zoneManager.setPassable(route.m_cells[i].x, route.m_cells[i].y, true);
+		if (cell->getXIndex()==prevCell->getXIndex() && cell->getYIndex()==prevCell->getYIndex()) {
+			// transitioning layers.
+			if (layer==LAYER_GROUND) {
+				layer = prevCell->getLayer();
+			}
+			path->getFirstNode()->setLayer(layer);
+			continue;
+		}
+
+		Bool canOptimize = true;
+		if (cell->getType() == PathfindCell::CELL_CLIFF) {
+			if (prevCell->getType() != PathfindCell::CELL_CLIFF) {
+				path->getFirstNode()->setCanOptimize(false);
+			}
+		}	else {
+			if (prevCell->getType() == PathfindCell::CELL_CLIFF) {
+				canOptimize = false;
+			}
+		}
+
+		adjustCoordToCell(route.m_cells[i].x, route.m_cells[i].y, true, pos, layer);
+		path->prependNode( &pos, layer );
+		path->getFirstNode()->setCanOptimize(canOptimize);
+		prevCell = cell;
+	}
+
+	m_zoneManager.setPassable(startCell->getXIndex(), startCell->getYIndex(), true);
+	// put actual start position as first node on the path, so it begins right at the unit's feet
+	if (fromPos->x != path->getFirstNode()->getPosition()->x || fromPos->y != path->getFirstNode()->getPosition()->y) {
+		path->prependNode( fromPos, startCell->getLayer() );
+	}
+
+	markPassableAroundPathStart(path);
+	return path;
+}
+#endif
+
 struct MADStruct
 {
 	Pathfinder					*thePathfinder;
@@ -7197,6 +8726,34 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 		return NULL;
 	}
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+	// TheSuperHackers @performance Take the route of an earlier search between the same zones of the same two blocks.
+	PathfindZoneRoute routeKey;
+	Bool cacheRoute = parentCell->getLayer()==LAYER_GROUND && goalCell->getLayer()==LAYER_GROUND;
+	if (cacheRoute) {
+		routeKey.m_fromBlock.x = parentCell->getXIndex()/PathfindZoneManager::ZONE_BLOCK_SIZE;
+		routeKey.m_fromBlock.y = parentCell->getYIndex()/PathfindZoneManager::ZONE_BLOCK_SIZE;
+		routeKey.m_toBlock.x = goalCell->getXIndex()/PathfindZoneManager::ZONE_BLOCK_SIZE;
+		routeKey.m_toBlock.y = goalCell->getYIndex()/PathfindZoneManager::ZONE_BLOCK_SIZE;
+		// within one block the search ends right away.
+		cacheRoute = routeKey.m_fromBlock.x != routeKey.m_toBlock.x || routeKey.m_fromBlock.y != routeKey.m_toBlock.y;
+	}
+	if (cacheRoute) {
+		routeKey.m_fromZone = m_zoneManager.getBlockZone(locomotorSurface, crusher, parentCell->getXIndex(), parentCell->getYIndex(), m_map);
+		routeKey.m_toZone = m_zoneManager.getBlockZone(locomotorSurface, crusher, goalCell->getXIndex(), goalCell->getYIndex(), m_map);
+		routeKey.m_surfaces = locomotorSurface;
+		routeKey.m_crusher = crusher;
+		routeKey.m_isHuman = isHuman;
+		const PathfindZoneRoute *route = m_zoneManager.findRoute(routeKey);
+		if (route) {
+			Path *path = buildCachedHierarchicalPath(from, parentCell, goalCell, *route);
+			goalCell->releaseInfo();
+			parentCell->releaseInfo();
+			return path;
+		}
+	}
+#endif
+
 	parentCell->startPathfind(goalCell);
 
 	// "closed" list is initially empty
@@ -7424,6 +8981,12 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 			}
 			// success - found a path to the goal
 
+#if USE_HIERARCHICAL_ROUTE_CACHE
+			if (cacheRoute) {
+				recordHierarchicalRoute(routeKey, goalCell, cellCount);
+			}
+#endif
+
 			m_isTunneling = false;
 			// construct and return path
 			Path *path =  buildHierachicalPath( from, goalCell );
@@ -9532,6 +11095,13 @@ void Pathfinder::changeBridgeState( PathfindLayerEnum layer, Bool repaired)
 	if (m_layers[layer].isUnused()) return;
 	if (m_layers[layer].setDestroyed(!repaired)) {
 		m_zoneManager.markZonesDirty( repaired );
+#if USE_HIERARCHICAL_ROUTE_CACHE
+		// A bridge has no area that updateZonesForModify could drop the routes of, so drop the routes that cross a bridge.
+		m_zoneManager.invalidateBridgeRoutes();
+#endif
+#if USE_GROUP_FLOW_FIELDS
+		invalidateFlowFields();
+#endif
 	}
 }
 
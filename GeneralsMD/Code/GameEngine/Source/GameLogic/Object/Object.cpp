@@ -1996,6 +1996,10 @@ void Object::healCompletely()
 //-------------------------------------------------------------------------------------------------
 void Object::setEffectivelyDead(Bool dead)
 {
+	// TheSuperHackers @performance The script engine keeps the results of conditions on named units until one of them changes.
+	if (dead != isEffectivelyDead() && getName().isNotEmpty() && TheScriptEngine)
+		TheScriptEngine->notifyOfNamedObjectChange();
+
 	if (dead)
 		BitSet(m_privateStatus, EFFECTIVELY_DEAD);
 	else
@@ -442,6 +442,11 @@ m_conditionTeam(NULL),
 m_conditionObject(NULL),
 m_currentPlayer(NULL),
 m_skirmishHumanPlayer(NULL),
+m_scriptsIndexed(FALSE),
+m_conditionStamp(0),
+m_allConditionsStamp(0),
+m_namedObjectsStamp(0),
+m_uiInteractionsStamp(0),
 m_fade(FADE_NONE),
 m_freezeByScript(FALSE),
 m_frameObjectCountChanged(0),
@@ -553,6 +558,12 @@ void ScriptEngine::init( void )
 	m_numFrames=0;
 	m_totalUpdateTime=0;
 	m_maxUpdateTime=0;
+	for (Int type=0; type<Condition::NUM_ITEMS; type++) {
+		m_conditionTypeTime[type] = 0;
+		m_conditionTypeCount[type] = 0;
+	}
+	m_numConditionsEvaluated = 0;
+	m_numConditionsCached = 0;
 #endif
 #endif
 
@@ -5292,11 +5303,15 @@ void ScriptEngine::reset( void )
 		m_counters[i].value = 0;
 		m_counters[i].isCountdownTimer = false;
 		m_counters[i].name.clear();
+		m_counters[i].changeStamp = 0;
+		m_counters[i].expiryStamp = 0;
 	}
 	for (i=0; i<MAX_FLAGS; i++) {
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
+		m_flags[i].changeStamp = 0;
 	}
+	m_allConditionsStamp = nextConditionStamp();
 
 	m_breezeInfo.m_direction = PI/3;
 	m_breezeInfo.m_directionVec.x = Sin(m_breezeInfo.m_direction);
@@ -5360,6 +5375,34 @@ void ScriptEngine::reset( void )
 		}
 		DEBUG_LOG(("***"));
 	}
+
+	if (m_numConditionsEvaluated + m_numConditionsCached > 0) {
+		DEBUG_LOG(("***CONDITION STATS %d scripts evaluated, %d kept their result:", m_numConditionsEvaluated, m_numConditionsCached));
+		for (numToDump=0; numToDump<10; numToDump++) {
+			double maxTime = 0;
+			Int maxType = -1;
+			for (i=0; i<Condition::NUM_ITEMS; i++) {
+				if (m_conditionTypeTime[i] > maxTime) {
+					maxTime = m_conditionTypeTime[i];
+					maxType = i;
+				}
+			}
+			if (maxType < 0) {
+				break;
+			}
+			DEBUG_LOG(("   CONDITION %s total time %f seconds, evaluated %d times, avg execution %2.3f msec",
+				m_conditionTemplates[maxType].m_internalName.str(), maxTime, m_conditionTypeCount[maxType],
+				1000*maxTime/m_conditionTypeCount[maxType]));
+			m_conditionTypeTime[maxType] = 0;
+		}
+		DEBUG_LOG(("***"));
+	}
+	for (i=0; i<Condition::NUM_ITEMS; i++) {
+		m_conditionTypeTime[i] = 0;
+		m_conditionTypeCount[i] = 0;
+	}
+	m_numConditionsEvaluated = 0;
+	m_numConditionsCached = 0;
 #endif
 #endif
 
@@ -5408,6 +5451,9 @@ void ScriptEngine::reset( void )
 	}
 
 	ScriptList::reset(); // Deletes scripts loaded when the map was loaded.
+	m_scriptsByName.clear();
+	m_groupsByName.clear();
+	m_scriptsIndexed = FALSE;
 
 	// reset the attack priority data
 	for( i = 0; i < MAX_ATTACK_PRIORITIES; ++i )
@@ -5433,12 +5479,16 @@ void ScriptEngine::newMap( void )
 		m_counters[i].value = 0;
 		m_counters[i].isCountdownTimer = false;
 		m_counters[i].name.clear();
+		m_counters[i].changeStamp = 0;
+		m_counters[i].expiryStamp = 0;
 	}
 	m_numFlags = 1;
 	for (i=0; i<MAX_FLAGS; i++) {
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
+		m_flags[i].changeStamp = 0;
 	}
+	m_allConditionsStamp = nextConditionStamp();
 	m_endGameTimer = -1;
 	m_closeWindowTimer = -1;
 #ifdef SPECIAL_SCRIPT_PROFILING
@@ -5478,6 +5528,7 @@ void ScriptEngine::newMap( void )
 			}
 		}
 	}
+	indexScripts();
 	m_firstUpdate = true;
 
 	m_fade = FADE_MULTIPLY; //default to a fade in from black.
@@ -5565,6 +5616,11 @@ void ScriptEngine::update( void )
 			// If counter has any time left, decrement.  Counters go to -1 and stop.
 			if (m_counters[i].value >= 0) {
 				m_counters[i].value--;
+				// The timer expires when it gets to 0, until then only counter conditions see the change.
+				m_counters[i].changeStamp = nextConditionStamp();
+				if (m_counters[i].value == 0) {
+					m_counters[i].expiryStamp = m_counters[i].changeStamp;
+				}
 			}
 		}
 	}
@@ -5593,7 +5649,10 @@ void ScriptEngine::update( void )
 	ThePlayerList->updateTeamStates();
 
 	// Clear the UI Interaction flags.
-	m_uiInteractions.clear();
+	if (!m_uiInteractions.empty()) {
+		m_uiInteractions.clear();
+		m_uiInteractionsStamp = nextConditionStamp();
+	}
 
 	// update all sequential stuff.
 	evaluateAndProgressAllSequentialScripts();
@@ -5770,6 +5829,7 @@ void ScriptEngine::clearFlag(const AsciiString &name)
 		for (i=1; i<m_numFlags; i++) {
 			if ((modName==m_flags[i].name)) {
 				m_flags[i].value = FALSE;
+				markFlagChanged(i);
 			}
 		}
 	}
@@ -6286,6 +6346,11 @@ Int ScriptEngine::allocateFlag( const AsciiString& name)
 //-------------------------------------------------------------------------------------------------
 ScriptGroup  *ScriptEngine::findGroup(const AsciiString& name)
 {
+	if (m_scriptsIndexed) {
+		ScriptGroupNameMap::const_iterator it = m_groupsByName.find(name);
+		return it != m_groupsByName.end() ? it->second : NULL;
+	}
+
 	Int i;
 	for (i=0; i<TheSidesList->getNumSides(); i++) {
 		ScriptList *pSL = TheSidesList->getSideInfo(i)->getScriptList();
@@ -6305,6 +6370,11 @@ ScriptGroup  *ScriptEngine::findGroup(const AsciiString& name)
 //-------------------------------------------------------------------------------------------------
 Script  *ScriptEngine::findScript(const AsciiString& name)
 {
+	if (m_scriptsIndexed) {
+		ScriptNameMap::const_iterator it = m_scriptsByName.find(name);
+		return it != m_scriptsByName.end() ? it->second : NULL;
+	}
+
 	Int i;
 	for (i=0; i<TheSidesList->getNumSides(); i++) {
 		ScriptList *pSL = TheSidesList->getSideInfo(i)->getScriptList();
@@ -6327,6 +6397,34 @@ Script  *ScriptEngine::findScript(const AsciiString& name)
 	return 0; // Shouldn't ever happen.
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Index the scripts and groups by name. Where names repeat, the index keeps the one that comes
+	* first in the order findScript and findGroup used to search them in. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::indexScripts( void )
+{
+	m_scriptsByName.clear();
+	m_groupsByName.clear();
+
+	Int i;
+	for (i=0; i<TheSidesList->getNumSides(); i++) {
+		ScriptList *pSL = TheSidesList->getSideInfo(i)->getScriptList();
+		if (pSL==NULL) continue;
+		Script *pScr;
+		for (pScr = pSL->getScript(); pScr; pScr=pScr->getNext()) {
+			m_scriptsByName.insert(ScriptNameMap::value_type(pScr->getName(), pScr));
+		}
+		ScriptGroup *pGroup;
+		for (pGroup = pSL->getScriptGroup(); pGroup; pGroup=pGroup->getNext()) {
+			m_groupsByName.insert(ScriptGroupNameMap::value_type(pGroup->getName(), pGroup));
+			for (pScr = pGroup->getScript(); pScr; pScr=pScr->getNext()) {
+				m_scriptsByName.insert(ScriptNameMap::value_type(pScr->getName(), pScr));
+			}
+		}
+	}
+	m_scriptsIndexed = TRUE;
+}
+
 //-------------------------------------------------------------------------------------------------
 /** Evaluates a counter condition */
 //-------------------------------------------------------------------------------------------------
@@ -6364,6 +6462,7 @@ void ScriptEngine::setCounter( ScriptAction *pAction )
 	}
 	Int value = pAction->getParameter(1)->getInt();
 	m_counters[counterNdx].value = value;
+	markCounterChanged(counterNdx);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6432,6 +6531,7 @@ void ScriptEngine::addCounter( ScriptAction *pAction )
 		pAction->getParameter(1)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].value += value;
+	markCounterChanged(counterNdx);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6447,6 +6547,7 @@ void ScriptEngine::subCounter( ScriptAction *pAction )
 		pAction->getParameter(1)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].value -= value;
+	markCounterChanged(counterNdx);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6491,6 +6592,24 @@ void ScriptEngine::setFlag( ScriptAction *pAction )
 	}
 	Bool value = pAction->getParameter(1)->getInt();
 	m_flags[flagNdx].value = value;
+	markFlagChanged(flagNdx);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Notes that the value or timer state of a counter changed */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::markCounterChanged( Int counterNdx )
+{
+	m_counters[counterNdx].changeStamp = nextConditionStamp();
+	m_counters[counterNdx].expiryStamp = m_counters[counterNdx].changeStamp;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Notes that the value of a flag changed */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::markFlagChanged( Int flagNdx )
+{
+	m_flags[flagNdx].changeStamp = nextConditionStamp();
 }
 
 
@@ -6753,6 +6872,7 @@ void ScriptEngine::setTimer( ScriptAction *pAction, Bool millisecondTimer, Bool
 		m_counters[counterNdx].value = value;
 	}
 	m_counters[counterNdx].isCountdownTimer = true;
+	markCounterChanged(counterNdx);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6767,6 +6887,7 @@ void ScriptEngine::pauseTimer( ScriptAction *pAction )
 		pAction->getParameter(0)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].isCountdownTimer = false;
+	markCounterChanged(counterNdx);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6782,6 +6903,7 @@ void ScriptEngine::restartTimer( ScriptAction *pAction )
 	}
 	if (m_counters[counterNdx].value > 0) {
 		m_counters[counterNdx].isCountdownTimer = true;
+		markCounterChanged(counterNdx);
 	}
 }
 
@@ -6807,6 +6929,7 @@ void ScriptEngine::adjustTimer( ScriptAction *pAction, Bool millisecondTimer, Bo
 			value = -value;
 		m_counters[counterNdx].value += value;
 	}
+	markCounterChanged(counterNdx);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7095,6 +7218,8 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 		return;
 	}
 
+	m_namedObjectsStamp = nextConditionStamp();
+
 	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
 		if (it->first == objName) {
 			if (it->second == NULL) {
@@ -7134,6 +7259,7 @@ void ScriptEngine::removeObjectFromCache( Object* pDeadObject )
 	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
 		if (pDeadObject == (it->second)) {
 			it->second = NULL;	// Don't remove it, cause we want to check whether we ever knew a name later
+			m_namedObjectsStamp = nextConditionStamp();
 			break;
 		}
 	}
@@ -7155,6 +7281,8 @@ void ScriptEngine::transferObjectName( const AsciiString& unitName, Object *pNew
 		return;
 	}
 
+	m_namedObjectsStamp = nextConditionStamp();
+
 	//John Ahlquist: When transferring an object name, make sure the new object isn't already in
 	//							 the vector. If so, remove it, or it'll end up there twice and cause a crash.
 	if( pNewObject->getName().isNotEmpty() )
@@ -7260,6 +7388,7 @@ void ScriptEngine::notifyOfAcquiredScience( Int playerIndex, ScienceType science
 void ScriptEngine::signalUIInteract(const AsciiString& hookName)
 {
 	m_uiInteractions.push_front(hookName);
+	m_uiInteractionsStamp = nextConditionStamp();
 #ifdef DEBUG_LOGGING
 	AppendDebugMessage(hookName, false); // don't bother in Release
 #endif
@@ -7575,6 +7704,18 @@ void ScriptEngine::adjustToppleDirection( Object *object, Coord3D *direction)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *player )
 {
+	// TheSuperHackers @performance Conditions that read nothing but counters, flags, timers and the
+	// life of named units give the same result until one of those changes.
+	if (areConditionInputsUnchanged(pScript)) {
+#ifdef SPECIAL_SCRIPT_PROFILING
+#ifdef DEBUG_LOGGING
+		m_numConditionsCached++;
+#endif
+#endif
+		return pScript->getConditionResult();
+	}
+	const UnsignedInt conditionStamp = m_conditionStamp;
+
 	LatchRestore<Team*> latch(m_callingTeam, thisTeam);
 	if (thisTeam) player = thisTeam->getControllingPlayer();
 	if (player==NULL) player=m_currentPlayer;
@@ -7598,7 +7739,23 @@ Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *
 		if (!pCondition) continue; // No conditions, so go to the next or.
 		Bool andTerm = true;
 		while (pCondition && andTerm) {
+#ifdef SPECIAL_SCRIPT_PROFILING
+#ifdef DEBUG_LOGGING
+			__int64 conditionStartTime64;
+			QueryPerformanceCounter((LARGE_INTEGER *)&conditionStartTime64);
+			const Bool conditionValue = evaluateCondition(pCondition);
+			__int64 conditionEndTime64,conditionFreq64;
+			QueryPerformanceCounter((LARGE_INTEGER *)&conditionEndTime64);
+			QueryPerformanceFrequency((LARGE_INTEGER *)&conditionFreq64);
+			m_conditionTypeTime[pCondition->getConditionType()] += (double)(conditionEndTime64-conditionStartTime64) / (double)conditionFreq64;
+			m_conditionTypeCount[pCondition->getConditionType()]++;
+			if (!conditionValue) {
+#else
 			if (!evaluateCondition(pCondition)) {
+#endif
+#else
+			if (!evaluateCondition(pCondition)) {
+#endif
 				andTerm = false;
 				break; // Short circuit the and evauation - after the first false, we can quit.
 			}
@@ -7614,11 +7771,76 @@ Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *
 	timeToEvaluate = ((Real)(endTime64-startTime64) / (Real)(freq64));
 	pScript->incrementConditionCount();
 	pScript->addToConditionTime(timeToEvaluate);
+#endif
+#ifdef SPECIAL_SCRIPT_PROFILING
+#ifdef DEBUG_LOGGING
+	m_numConditionsEvaluated++;
+#endif
 #endif
 
+	pScript->setConditionResult(testValue, conditionStamp);
 	return testValue; // If none of the or's fired, then it is false.
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Returns true if the script has a kept condition result and none of the inputs of its conditions
+	* changed since. Any condition that reads other state makes the script evaluate every time. */
+//-------------------------------------------------------------------------------------------------
+Bool ScriptEngine::areConditionInputsUnchanged( Script *pScript )
+{
+	const UnsignedInt stamp = pScript->getConditionResultStamp();
+	if (stamp == 0 || m_allConditionsStamp > stamp) {
+		return false;
+	}
+
+	OrCondition *pCurCondition;
+	for (pCurCondition = pScript->getOrCondition(); pCurCondition; pCurCondition = pCurCondition->getNextOrCondition()) {
+		Condition *pCondition;
+		for (pCondition = pCurCondition->getFirstAndCondition(); pCondition; pCondition = pCondition->getNext()) {
+			Int ndx;
+			switch (pCondition->getConditionType()) {
+				default:
+					return false;
+
+				case Condition::CONDITION_FALSE:
+				case Condition::CONDITION_TRUE:
+					break;
+
+				case Condition::COUNTER:
+					ndx = pCondition->getParameter(0)->getInt();
+					if (ndx == 0 || m_counters[ndx].changeStamp > stamp) {
+						return false; // Not allocated yet, or changed.
+					}
+					break;
+
+				case Condition::TIMER_EXPIRED:
+					ndx = pCondition->getParameter(0)->getInt();
+					if (ndx == 0 || m_counters[ndx].expiryStamp > stamp) {
+						return false;
+					}
+					break;
+
+				case Condition::FLAG:
+					ndx = pCondition->getParameter(0)->getInt();
+					if (ndx == 0 || m_flags[ndx].changeStamp > stamp || m_uiInteractionsStamp > stamp) {
+						return false;
+					}
+					break;
+
+				case Condition::NAMED_DESTROYED:
+				case Condition::NAMED_DYING:
+				case Condition::NAMED_TOTALLY_DEAD:
+				case Condition::NAMED_NOT_DESTROYED:
+					if (m_namedObjectsStamp > stamp || pCondition->getParameter(0)->getString() == THIS_OBJECT) {
+						return false;
+					}
+					break;
+			}
+		}
+	}
+	return true;
+}
+
 
 
 //-------------------------------------------------------------------------------------------------
@@ -7711,6 +7933,7 @@ const ConditionTemplate * ScriptEngine::getConditionTemplate( Int ndx )
 void ScriptEngine::createNamedCache( void )
 {
 	m_namedObjects.clear();
+	m_namedObjectsStamp = nextConditionStamp();
 
 	if( !TheGameLogic )
 	{
@@ -9320,6 +9543,8 @@ void ScriptEngine::xfer( Xfer *xfer )
 // ------------------------------------------------------------------------------------------------
 void ScriptEngine::loadPostProcess( void )
 {
+	// The loaded counters, flags and objects are not tracked one by one.
+	m_allConditionsStamp = nextConditionStamp();
 
 	// Now that we've loaded everything, go through and set them all back in sync with what we
 	// currently think they should be.
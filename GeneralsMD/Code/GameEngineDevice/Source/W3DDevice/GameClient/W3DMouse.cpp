@@ -69,6 +69,7 @@ public:
 
 void MouseThreadClass::Thread_Function()
 {
+	ScopedThreadMemoryPoolCaches threadMemoryPoolCaches;
 
 	//poll mouse and update position
 